@@ -168,6 +168,59 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+/* heap_tlsf.c size classes cover blocks below 2^14 bytes: keep above configTOTAL_HEAP_SIZE */
+#define configTLSF_FL_INDEX_MAX                  14
+/* Lean kernel profile: CLZ ready-list lookup instead of the generic C scan
+   (the port allows it up to 32 priorities), the priority count sized to the
+   tasks in task_model.h and unused kernel objects compiled out. 0 keeps the
+   CubeMX settings above. Counting semaphores stay on: the CMSIS-RTOS2 memory
+   pool needs them (freertos_os2.h) and --gc-sections drops them when unused. */
+#define configKERNEL_LEAN                        1
+#if (configKERNEL_LEAN == 1)
+  /* Highest thread is osPriorityNormal (24), one spare level above it */
+  #undef  configMAX_PRIORITIES
+  #define configMAX_PRIORITIES                   ( 26 )
+  #undef  configUSE_PORT_OPTIMISED_TASK_SELECTION
+  #define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+  #define configUSE_OS2_REDUCED_PRIORITIES       1
+  #undef  configUSE_RECURSIVE_MUTEXES
+  #define configUSE_RECURSIVE_MUTEXES            0
+  #undef  configQUEUE_REGISTRY_SIZE
+  #define configQUEUE_REGISTRY_SIZE              0
+  #undef  configUSE_OS2_EVENTFLAGS_FROM_ISR
+  #define configUSE_OS2_EVENTFLAGS_FROM_ISR      0
+  #undef  configUSE_OS2_THREAD_ENUMERATE
+  #define configUSE_OS2_THREAD_ENUMERATE         0
+  #undef  configUSE_OS2_THREAD_SUSPEND_RESUME
+  #define configUSE_OS2_THREAD_SUSPEND_RESUME    0
+#endif
+/* Software timers carry the periodic HMI work (main.c); callbacks only post
+   to the work queue, so the timer task stays small. The priority is
+   osPriorityBelowNormal1, TASK_TIMER_PRIO in task_model.h. */
+#undef  configTIMER_TASK_PRIORITY
+#define configTIMER_TASK_PRIORITY                ( 17 )
+#undef  configTIMER_QUEUE_LENGTH
+#define configTIMER_QUEUE_LENGTH                 4
+#undef  configTIMER_TASK_STACK_DEPTH
+#define configTIMER_TASK_STACK_DEPTH             128
+/* No task calls into newlib's reentrant parts (text goes through fmt.c, the
+   kernel heap is TLSF): drop the struct _reent carried by every TCB */
+#undef  configUSE_NEWLIB_REENTRANT
+#define configUSE_NEWLIB_REENTRANT               0
+/* FPU context accounting (fpu_ctx.c): tasks declare FPU use, the switch-out
+   hook counts extended frames per task. Keeps its entry in the task tag. */
+#define configUSE_FPU_CTX_STATS                  1
+#if (configUSE_FPU_CTX_STATS == 1)
+  #define configUSE_APPLICATION_TASK_TAG         1
+  #if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+    #include "fpu_ctx.h"
+  #endif
+#endif
+/* Scheduling trace recorder (trace_recorder.c) hooks the kernel trace macros */
+#define configUSE_TRACE_RECORDER                 1
+#if (configUSE_TRACE_RECORDER == 1) && (defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__))
+  #include "trace_recorder.h"
+#endif
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,30 @@
+#ifndef __ADC_SCAN_H__
+#define __ADC_SCAN_H__
+
+#include <stdint.h>
+#include "level_comp.h"
+
+// Level acquisition: one ADC1 scan per water slot, moved by DMA2 Stream0
+// (channel 0, normal mode) with no interrupt. Rank 1 is the level (PA4,
+// 3 cycles); every ADC_SCAN_REF_EVERY blocks the sequence runs on into
+// VREFINT and the temperature sensor (480 cycles each, over the 10 us they
+// need in every clock profile). The water task waits for rank 1 only, as it
+// did for the single conversion; the reference pair lands while it runs
+// the slot and is folded into the compensation (level_comp.h) at the start
+// of the next block, so the internal channels add no wakeup and no wait.
+#define ADC_SCAN_REF_EVERY  10      // blocks: a reference pair once a second
+#define ADC_SCAN_RANKS      3       // level, VREFINT, temperature (MX_ADC1_Init)
+
+typedef struct {
+    uint32_t blocks;
+    uint32_t ref_blocks;
+    uint32_t ref_late;      // reference pair not complete at the next block: skipped
+} adc_scan_stats_t;
+
+extern level_comp_t adc_comp;
+extern adc_scan_stats_t adc_scan_stats;
+
+void adc_scan_init(void);       // after MX_ADC1_Init: DMA stream, ADC on, one reference pair
+uint16_t adc_scan_block(void);  // water task, once per slot: compensated level counts
+
+#endif // __ADC_SCAN_H__
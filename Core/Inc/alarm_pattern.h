@@ -0,0 +1,45 @@
+#ifndef __ALARM_PATTERN_H__
+#define __ALARM_PATTERN_H__
+
+#include <stdint.h>
+
+// Indicator patterns played without the CPU: TIM1 update events pace
+// DMA2 Stream5 (channel 6, circular) writing one GPIOC->BSRR word per slot.
+// PC0-PC3 have no timer channel, so PWM is not an option; a slot writes a
+// set or reset bit for every indicator pin, so each slot is the complete
+// PC0-PC3 state in one BSRR write. Steady outputs (indicator.c) are merged
+// into every slot of the playing pattern.
+#define PATTERN_SLOT_MS     20       // output resolution
+#define PATTERN_MAX_SLOTS   128      // longest cycle: 2.56 s
+#define PATTERN_YELLOW      0x1U     // PC1
+#define PATTERN_RED         0x2U     // PC2
+#define PATTERN_BUZZER      0x4U     // PC3
+#define PATTERN_GREEN       0x8U     // PC0
+
+typedef enum {
+    PATTERN_OFF = 0,
+    PATTERN_WARNING,        // slow yellow blink
+    PATTERN_FLOOD,          // red on, fast beeps
+    PATTERN_MANUAL,         // red on, double chirp (IR override)
+    PATTERN_COUNT
+} pattern_id_t;
+
+typedef struct {
+    uint16_t ms;            // rounded to PATTERN_SLOT_MS, at least one slot
+    uint8_t outputs;        // PATTERN_* bits on during this step
+} pattern_step_t;
+
+typedef struct {
+    const pattern_step_t *steps;
+    uint8_t nsteps;
+} pattern_t;
+
+extern const pattern_t patterns[PATTERN_COUNT];
+
+void pattern_init(void);            // after MX_GPIO_Init; starts PATTERN_OFF
+void pattern_play(pattern_id_t id, uint8_t steady);    // water task (actuator owner); no-op if unchanged
+pattern_id_t pattern_current(void);
+uint32_t pattern_expand(const pattern_t *p, uint8_t steady, uint32_t *slots, uint32_t max);  // BSRR words, 0 if too long
+extern uint32_t pattern_restarts;   // times the stream was reprogrammed
+
+#endif // __ALARM_PATTERN_H__
@@ -0,0 +1,64 @@
+#ifndef __BARRIER_FSM_H__
+#define __BARRIER_FSM_H__
+
+#include <stdint.h>
+
+// Barrier control as one table-driven state machine. The water task is the
+// only caller and the only actuator writer: level events come from its own
+// slot, IR commands arrive through an event queue (main.c). AUTO is the
+// parent of NORMAL/WARNING/FLOOD; an event a leaf does not handle falls
+// through to its parent, so dispatch is at most two table lookups.
+// Hysteresis is in the table: FLOOD holds the barrier up until the level
+// is back under NORMAL_RAIN_MM, WARNING leaves it down until WARNING_RAIN_MM.
+// The machine is pure: actions only change the outputs in barrier_fsm_t.
+typedef enum {
+    BARRIER_NORMAL = 0,     // AUTO, barrier down
+    BARRIER_WARNING,        // AUTO, between the thresholds, barrier down
+    BARRIER_FLOOD,          // AUTO, barrier up (level, predicted flood or sensor fault)
+    BARRIER_MANUAL,         // IR override, barrier as commanded
+    BARRIER_ESTOP,          // servo unpowered, alarm on; only IR "auto" leaves it
+    BARRIER_AUTO,           // parent of the first three, never current
+    BARRIER_STATES
+} barrier_state_t;
+
+typedef enum {
+    BEV_LEVEL_LOW = 0,      // below NORMAL_RAIN_MM, no flood predicted
+    BEV_LEVEL_MID,          // between the thresholds
+    BEV_LEVEL_HIGH,         // at or above WARNING_RAIN_MM, or flood predicted
+    BEV_SENSOR_FAULT,       // fail-safe raise (SENSOR_FAULT_FAILSAFE_RAISE)
+    BEV_IR_TOGGLE,          // unmapped key: raise into MANUAL, or lower back to AUTO
+    BEV_IR_UP,
+    BEV_IR_DOWN,            // lowering ends MANUAL: the level decides again
+    BEV_IR_STOP,            // MANUAL: servo off where it stands
+    BEV_IR_AUTO,            // back to AUTO; the only way out of ESTOP
+    BEV_IR_ESTOP,
+    BARRIER_EVENTS
+} barrier_event_t;
+
+typedef enum {
+    SERVO_DOWN = 0,
+    SERVO_UP,
+    SERVO_OFF,              // no pulses: the servo holds nothing
+} servo_cmd_t;
+
+typedef struct {
+    uint8_t state;          // barrier_state_t, a leaf
+    uint8_t level;          // last BEV_LEVEL_* / BEV_SENSOR_FAULT, for returning to AUTO
+    uint8_t servo;          // servo_cmd_t
+    uint8_t barrier_up;     // last commanded position, kept through SERVO_OFF
+} barrier_fsm_t;
+
+typedef struct {
+    uint8_t next;           // barrier_state_t; BARRIER_STATES: not handled here
+    uint8_t action;         // barrier_action_t (barrier_fsm.c)
+} barrier_transition_t;
+
+extern const barrier_transition_t barrier_table[BARRIER_STATES][BARRIER_EVENTS];
+extern const char *const barrier_state_text[BARRIER_STATES];
+
+void barrier_fsm_init(barrier_fsm_t *f);                    // NORMAL, barrier down
+void barrier_fsm_dispatch(barrier_fsm_t *f, uint8_t event);  // unknown events are ignored
+uint8_t barrier_fsm_manual(const barrier_fsm_t *f);         // indicator/clock "manual" input (ESTOP included)
+uint8_t barrier_fsm_raised(const barrier_fsm_t *f);         // indicator/clock "barrier up" input
+
+#endif // __BARRIER_FSM_H__
@@ -0,0 +1,37 @@
+#ifndef __BOOT_TRACE_H__
+#define __BOOT_TRACE_H__
+
+#include <stdint.h>
+
+// Boot timeline: DWT cycle stamps of the boot milestones, taken once each,
+// converted with the core clock in force during every segment (HSI until
+// SystemClock_Config). Reported on USART2 once the LCD is up; the figure
+// that matters is time-to-first-decision after any reset (brown-out mid
+// storm included), so the reset cause is recorded too.
+typedef enum {
+    BOOT_ENTRY = 0,         // main(), DWT started
+    BOOT_CLOCKS,            // PLL running
+    BOOT_SAFETY_IO,         // GPIO, ADC, servo PWM
+    BOOT_PERIPHERALS,       // I2C, USART, IR timer
+    BOOT_FILTERS,           // calibration, median, slosh, fault classifier, risk model
+    BOOT_KERNEL_START,
+    BOOT_FIRST_DECISION,    // water task released the actuators once
+    BOOT_LCD_READY,         // HD44780 init finished in the background
+    BOOT_MARKS
+} boot_mark_t;
+
+typedef struct {
+    uint32_t cycles[BOOT_MARKS];
+    uint32_t hz[BOOT_MARKS];        // SystemCoreClock when the mark was taken
+    uint32_t us[BOOT_MARKS];        // since BOOT_ENTRY, filled by boot_trace_report()
+    uint32_t reset_flags;           // RCC->CSR at entry
+    uint8_t seen;                   // bit per mark
+} boot_trace_t;
+
+extern boot_trace_t boot_trace;
+
+void boot_trace_start(void);        // first thing in main()
+void boot_mark(boot_mark_t mark);   // keeps the first stamp only
+void boot_trace_report(void);       // task context (UART)
+
+#endif // __BOOT_TRACE_H__
@@ -0,0 +1,83 @@
+#ifndef __CALIB_H__
+#define __CALIB_H__
+
+#include <stdint.h>
+
+// Site calibration: level thresholds, sensor scale, the early-raise risk
+// and the IR remotes learned on site (ir_keymap.h).
+// The block is stored in flash (calib_store.c) and updated over USART2
+// (Tools/calib.py); the defines below are the factory values, in force until
+// a valid block is stored, and what the host tools run with (Tools/replay,
+// Tools/fleet). The water task only reads a calib_t: everything derived from
+// the stored values is computed once when a block is applied.
+#define NORMAL_RAIN_MM    15.0f    // 보통 비(mm)
+#define WARNING_RAIN_MM   34.0f    // 폭우 경고(mm)
+#define SENSOR_MAX_MM     40.0f    // 빨간 수위센서 측정 최대 높이(mm), at full scale (4095)
+#define SENSOR_CLAMP_RAW  4000     // counts above this are clamped (top of the probe)
+#define FLOOD_RISK_RAISE  192      // P(flood) * 256 needed to raise before WARNING_RAIN_MM
+
+#define CALIB_MAGIC       0x424C4143U  // "CALB"
+#define CALIB_VERSION     1            // layout of calib_record_t
+#define CALIB_ADC_FULL    4095
+#define CALIB_IR_REMOTES  4            // learned remotes per record
+#define CALIB_IR_KEYS     5            // commands per remote: BEV_IR_UP .. BEV_IR_ESTOP in order
+
+typedef enum {
+    CALIB_OK = 0,
+    CALIB_ERR_FORMAT,       // magic, version or size
+    CALIB_ERR_CRC,
+    CALIB_ERR_RANGE,        // thresholds out of order or out of the sensor range, too many remotes
+    CALIB_ERR_FULL,         // no erased record left: the stale slot waits for a quiet slot
+    CALIB_ERR_FLASH,        // program or read-back failed
+    CALIB_ERRORS
+} calib_err_t;
+
+extern const char *const calib_err_text[CALIB_ERRORS];
+
+typedef struct {
+    uint16_t address;       // ir_frame_t.address
+    uint8_t command[CALIB_IR_KEYS];
+    uint8_t reserved;       // 0
+} calib_ir_remote_t;
+
+// Stored form, 64 bytes, little endian (Tools/calib.py packs the same
+// layout). crc is CRC-32 (zlib) of the bytes before it. Remotes live in
+// what were reserved zero words: a record without any is unchanged.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;          // sizeof(calib_record_t)
+    uint32_t seq;           // update count: the highest valid record is in force
+    float normal_mm;
+    float warning_mm;
+    float sensor_max_mm;
+    uint16_t raw_clamp;
+    uint8_t risk_raise;
+    uint8_t ir_remotes;     // entries of ir[] in use; the rest are 0
+    calib_ir_remote_t ir[CALIB_IR_REMOTES];
+    uint32_t crc;
+} calib_record_t;
+
+_Static_assert(sizeof(calib_record_t) == 64, "calib_record_t is a 64-byte flash record");
+
+// Applied form: what the water slot reads, precomputed from a record
+typedef struct {
+    float normal_mm;
+    float warning_mm;
+    float mm_per_count;     // sensor_max_mm / CALIB_ADC_FULL: one multiply per sample
+    uint16_t raw_clamp;
+    uint8_t risk_raise;
+    uint8_t ir_remotes;     // read by the IR side (work thread), not the water slot
+    calib_ir_remote_t ir[CALIB_IR_REMOTES];
+    uint32_t seq;           // record it came from, 0 for the factory values
+} calib_t;
+
+extern const calib_t calib_factory;
+
+uint32_t calib_crc32(const void *data, uint32_t len);
+void calib_defaults(calib_record_t *rec);                   // factory values, seq 0, CRC set
+void calib_seal(calib_record_t *rec);                       // header and CRC for the current contents
+calib_err_t calib_check(const calib_record_t *rec);         // format, CRC and ranges
+void calib_apply(calib_t *cal, const calib_record_t *rec);  // rec must pass calib_check()
+
+#endif // __CALIB_H__
@@ -0,0 +1,59 @@
+#ifndef __CALIB_STORE_H__
+#define __CALIB_STORE_H__
+
+#include <stdint.h>
+#include "calib.h"
+
+// Calibration in flash: two A/B slots, sectors 6 and 7, outside the linker
+// FLASH region. Each slot is a log of 64-byte records appended in order, the
+// CRC word last; the valid record with the highest seq is in force, so a
+// reset mid-write or a corrupted record falls back to the one before it.
+// Updates only program words (a word stalls flash fetches for up to 100 us).
+// A sector erase stalls the whole CPU for a second or two, so boot never
+// erases: once the active slot is half full the stale one is due, and it is
+// erased on the work thread (calib_store_reclaim()) when the water task next
+// reports a quiet slot (calib_store_quiet(): NORMAL, barrier down, no manual
+// override). Nothing else erases: a write that finds its slot full while the
+// other is not yet erased is refused (ERR full) until that quiet slot comes.
+//
+// USART2 commands, one line each (Tools/calib.py):
+//   R            -> C <128 hex digits>   record in force
+//   W <128 hex>  -> OK <seq> | ERR <why> store a record (its CRC as sent is checked)
+//   F            -> OK <seq> | ERR <why> store the factory values, keeping the learned remotes
+//   K            -> K <16 hex digits>    last valid IR frame word and frame count (ir_nec.h)
+// An update is applied from the next water slot: the water task reads
+// calib_store_active() once per slot and the store swaps that pointer only
+// after the new block is in flash.
+#ifndef CALIB_FLASH_BASE
+#define CALIB_FLASH_BASE    0x08040000U    // FLASH_SECTOR_6
+#endif
+#define CALIB_SECTOR_FIRST  6
+#define CALIB_SLOTS         2
+#define CALIB_SLOT_BYTES    0x20000U       // one 128 KB sector
+#define CALIB_SLOT_RECORDS  (CALIB_SLOT_BYTES / sizeof(calib_record_t))
+#define CALIB_LINE_MAX      136            // "W " + 128 hex digits, with slack
+#define CALIB_LINES         2              // line buffers: one being answered, the next arriving
+#define CALIB_RECLAIM_NONE   0
+#define CALIB_RECLAIM_DUE    1             // stale slot to erase at the next quiet slot
+#define CALIB_RECLAIM_POSTED 2
+
+typedef struct {
+    uint32_t writes;            // records stored since boot
+    uint32_t errors;            // updates refused or failed
+    uint32_t skipped;           // torn or corrupted records passed over at boot
+    uint32_t erases;
+    uint32_t lines_dropped;     // command lines lost: no free line buffer or the work queue full
+} calib_store_stats_t;
+
+extern calib_store_stats_t calib_store_stats;
+
+int calib_store_init(void);                     // boot, before the scheduler, reads only: 0 flash block, 1 factory values
+int calib_store_start(void);                    // after osKernelInitialize, before USART2 RX: the line pool; 0 or -1
+const calib_t *calib_store_active(void);        // block in force; any task
+const calib_record_t *calib_store_record(void); // its stored form (factory: seq 0)
+calib_err_t calib_store_write(calib_record_t *rec);  // work thread: store as the next seq, then apply; never erases
+int calib_store_reclaim(void);                  // work thread: erase the stale slot if due, stalling the CPU 1-2 s; 0 or -1
+void calib_store_quiet(void);                   // water task, nothing to move: posts the reclaim once it is due
+void calib_store_rx(uint8_t byte);              // USART2 RX ISR: a complete line is posted to the work thread
+
+#endif // __CALIB_STORE_H__
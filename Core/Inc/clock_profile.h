@@ -0,0 +1,77 @@
+#ifndef __CLOCK_PROFILE_H__
+#define __CLOCK_PROFILE_H__
+
+#include <stdint.h>
+
+// Core clock profiles: full speed while the barrier may have to move,
+// a slower PLL setting at a lower regulator scale while the level is
+// NORMAL. Every clock derived from SYSCLK is recomputed from the table on
+// a switch (clock_timing()), so the 1 MHz servo/IR counters, the 10 kHz
+// pattern timer, the 1 kHz kernel and HAL ticks, 115200 baud and the
+// 100 kHz I2C clock hold in every profile. WCET budgets in task_model.h
+// scale with the slowest profile (task_model_check()).
+typedef enum {
+    CLOCK_LOW = 0,          // NORMAL, barrier down: 48 MHz, VOS scale 3
+    CLOCK_FULL,             // WARNING/FLOOD, sensor fault, barrier up, manual: 100 MHz
+    CLOCK_PROFILE_COUNT
+} clock_profile_id_t;
+
+#define CLOCK_BOOT              CLOCK_FULL
+#define CLOCK_LOW_HOLD_SLOTS    50      // water slots of NORMAL before stepping down (5 s)
+#define CLOCK_APB1_MAX_HZ       50000000U
+#define CLOCK_ADC_MAX_HZ        36000000U
+#define CLOCK_SERVO_HZ          1000000U    // TIM3: pulse widths in us
+#define CLOCK_IR_HZ             1000000U    // TIM4: NEC edge spacing in us
+#define CLOCK_PATTERN_HZ        10000U      // TIM1: alarm_pattern.c slots
+#define CLOCK_HALTICK_HZ        1000000U    // TIM9: stm32f4xx_hal_timebase_tim.c
+#define CLOCK_UART_BAUD         115200U
+#define CLOCK_UART_MAX_PPM      5000U       // 0.5 %: a quarter of the receiver's tolerance
+#define CLOCK_I2C_HZ            100000U
+
+typedef struct {
+    const char *name;
+    uint32_t sysclk_hz;
+    uint8_t pllm;           // HSI / M = 2 MHz VCO input (lowest jitter)
+    uint16_t plln;
+    uint8_t pllp;           // 2, 4, 6 or 8
+    uint8_t pllq;           // USB/SDIO clock, unused: kept at or below 48 MHz
+    uint8_t apb1_div;       // 1, 2, 4, 8, 16
+    uint8_t apb2_div;
+    uint8_t flash_ws;       // wait states for sysclk_hz at 2.7-3.6 V
+    uint8_t vos;            // regulator scale: 1 up to 100 MHz, 3 up to 64 MHz
+} clock_profile_t;
+
+// Register values derived from one profile
+typedef struct {
+    uint32_t pclk1_hz, pclk2_hz;
+    uint32_t tim_apb1_hz, tim_apb2_hz;  // x2 when the bus prescaler is not 1
+    uint16_t tim3_psc, tim4_psc, tim1_psc, tim9_psc;
+    uint16_t usart2_brr;                // 16x oversampling
+    uint32_t usart2_ppm;                // baud error
+    uint8_t i2c_freq;                   // CR2.FREQ, PCLK1 in MHz
+    uint16_t i2c_ccr;                   // standard mode, 50 % duty
+    uint8_t i2c_trise;
+    uint32_t systick_load;
+    uint32_t adc_hz;                    // PCLK2 / 4 (MX_ADC1_Init)
+} clock_timing_t;
+
+typedef struct {
+    uint32_t switches;
+    uint32_t failures;      // RCC timeouts: the previous profile was restored
+    uint32_t servo_waits;   // switches held back for a servo pulse in flight
+    uint32_t masked_cycles; // longest switch with interrupts masked, core cycles partly at HSI: / 16 for at most us
+    uint32_t ms[CLOCK_PROFILE_COUNT];   // residency up to the last switch
+} clock_profile_stats_t;
+
+extern const clock_profile_t clock_profiles[CLOCK_PROFILE_COUNT];
+extern clock_profile_stats_t clock_profile_stats;
+
+int clock_timing(const clock_profile_t *p, clock_timing_t *t);     // 0 if every derived clock is exact
+const clock_timing_t *clock_timing_now(void);                       // profile in force
+clock_profile_id_t clock_profile_current(void);
+int clock_profile_boot(void);                                       // SystemClock_Config(); 0 on success
+int clock_profile_set(clock_profile_id_t id);                       // work thread (I2C idle); 0 on success
+clock_profile_id_t clock_profile_for(uint8_t status, uint8_t barrier_up, uint8_t manual);
+void clock_profile_request(clock_profile_id_t id);  // water task, every slot: up at once, down after CLOCK_LOW_HOLD_SLOTS
+
+#endif // __CLOCK_PROFILE_H__
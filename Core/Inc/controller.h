@@ -0,0 +1,39 @@
+#ifndef __CONTROLLER_H__
+#define __CONTROLLER_H__
+
+#include <stdint.h>
+#include "water_ctrl.h"
+#include "barrier_fsm.h"
+#include "indicator.h"
+#include "ir_keymap.h"
+
+// One barrier controller as a context: level pipeline, state machine,
+// indicator state and IR key hold tracking, with no globals and no hardware
+// access. Calls return which outputs changed; the caller writes them. The
+// firmware runs one instance from the water task (main.c drives the servo
+// and the pattern DMA); the host tools run the same code per virtual unit
+// (Tools/replay, Tools/fleet).
+#define CTRL_SERVO      0x01U   // fsm.servo differs from the last one returned
+#define CTRL_INDICATOR  0x02U   // indicator_out holds new outputs to play
+#define CTRL_STATE      0x04U   // fsm.state changed
+#define CTRL_STATUS     0x08U   // slot.status changed (controller_slot() only)
+#define CTRL_NO_EVENT   BARRIER_EVENTS
+
+typedef struct {
+    water_ctrl_t water;
+    barrier_fsm_t fsm;
+    indicator_t indicator;
+    water_slot_t slot;                      // last slot: level, status, level event
+    const indicator_out_t *indicator_out;   // last outputs returned with CTRL_INDICATOR
+    uint8_t servo_out;                      // servo_cmd_t last returned, 0xFF before the first
+    // IR side only (work thread): the key being held, one event per press
+    uint32_t ir_frame;                      // its frame word, IR_NEC_REPEAT when none
+    uint32_t ir_last_ms;                    // its last frame or repeat code
+} controller_t;
+
+void controller_init(controller_t *c, const calib_t *cal);    // cal: calib_factory or calib_store_active()
+uint8_t controller_slot(controller_t *c, uint16_t raw);        // one water slot; CTRL_* of what changed
+uint8_t controller_dispatch(controller_t *c, uint8_t event);   // IR command or level event; CTRL_*
+uint8_t controller_ir_event(controller_t *c, uint32_t frame, uint32_t now_ms);  // ir_nec.h word or IR_NEC_REPEAT -> event, CTRL_NO_EVENT to ignore
+
+#endif // __CONTROLLER_H__
@@ -0,0 +1,124 @@
+#ifndef __DSP_CONFIG_H__
+#define __DSP_CONFIG_H__
+
+// CMSIS-DSP FFT table selection. This header is pre-included into every
+// C file (CubeIDE: Include files (-include), EWARM: Preinclude file) so the
+// CMSIS sources see the same ARM_TABLE_* switches as the application.
+//
+// Declare the transforms the firmware uses with 1, then regenerate the
+// tables:  python3 Tools/gen_fft_tables.py > Core/Src/dsp_tables.c
+// Only the declared twiddle/bit-reversal tables and arm_cfft_sR_f32_len*
+// instances are compiled; `python3 Tools/gen_fft_tables.py --report` prints
+// the flash they take versus the full table set.
+
+// arm_rfft_fast_f32 lengths (32 .. 4096)
+#define DSP_RFFT_F32_32      0
+#define DSP_RFFT_F32_64      0
+#define DSP_RFFT_F32_128     1       // slosh_filter.c (SLOSH_FFT_LEN)
+#define DSP_RFFT_F32_256     0
+#define DSP_RFFT_F32_512     0
+#define DSP_RFFT_F32_1024    0
+#define DSP_RFFT_F32_2048    0
+#define DSP_RFFT_F32_4096    0
+
+// arm_cfft_f32 lengths (16 .. 4096)
+#define DSP_CFFT_F32_16      0
+#define DSP_CFFT_F32_32      0
+#define DSP_CFFT_F32_64      0
+#define DSP_CFFT_F32_128     0
+#define DSP_CFFT_F32_256     0
+#define DSP_CFFT_F32_512     0
+#define DSP_CFFT_F32_1024    0
+#define DSP_CFFT_F32_2048    0
+#define DSP_CFFT_F32_4096    0
+
+// For compile-time checks: #if !DSP_RFFT_F32(SLOSH_FFT_LEN)
+#define DSP_CAT_(a, b)       a##b
+#define DSP_CAT(a, b)        DSP_CAT_(a, b)
+#define DSP_RFFT_F32(n)      DSP_CAT(DSP_RFFT_F32_, n)
+#define DSP_CFFT_F32(n)      DSP_CAT(DSP_CFFT_F32_, n)
+
+/* ---- declarations -> CMSIS table switches (no edits needed below) ---- */
+#define ARM_DSP_CONFIG_TABLES
+#define ARM_FFT_ALLOW_TABLES
+
+// A real FFT of length N runs a complex FFT of N/2 plus its own twiddles
+#if DSP_RFFT_F32_32
+#define ARM_TABLE_TWIDDLECOEF_RFFT_F32_32
+#define ARM_TABLE_TWIDDLECOEF_F32_16
+#define ARM_TABLE_BITREVIDX_FLT_16
+#endif
+#if DSP_RFFT_F32_64
+#define ARM_TABLE_TWIDDLECOEF_RFFT_F32_64
+#define ARM_TABLE_TWIDDLECOEF_F32_32
+#define ARM_TABLE_BITREVIDX_FLT_32
+#endif
+#if DSP_RFFT_F32_128
+#define ARM_TABLE_TWIDDLECOEF_RFFT_F32_128
+#define ARM_TABLE_TWIDDLECOEF_F32_64
+#define ARM_TABLE_BITREVIDX_FLT_64
+#endif
+#if DSP_RFFT_F32_256
+#define ARM_TABLE_TWIDDLECOEF_RFFT_F32_256
+#define ARM_TABLE_TWIDDLECOEF_F32_128
+#define ARM_TABLE_BITREVIDX_FLT_128
+#endif
+#if DSP_RFFT_F32_512
+#define ARM_TABLE_TWIDDLECOEF_RFFT_F32_512
+#define ARM_TABLE_TWIDDLECOEF_F32_256
+#define ARM_TABLE_BITREVIDX_FLT_256
+#endif
+#if DSP_RFFT_F32_1024
+#define ARM_TABLE_TWIDDLECOEF_RFFT_F32_1024
+#define ARM_TABLE_TWIDDLECOEF_F32_512
+#define ARM_TABLE_BITREVIDX_FLT_512
+#endif
+#if DSP_RFFT_F32_2048
+#define ARM_TABLE_TWIDDLECOEF_RFFT_F32_2048
+#define ARM_TABLE_TWIDDLECOEF_F32_1024
+#define ARM_TABLE_BITREVIDX_FLT_1024
+#endif
+#if DSP_RFFT_F32_4096
+#define ARM_TABLE_TWIDDLECOEF_RFFT_F32_4096
+#define ARM_TABLE_TWIDDLECOEF_F32_2048
+#define ARM_TABLE_BITREVIDX_FLT_2048
+#endif
+
+#if DSP_CFFT_F32_16
+#define ARM_TABLE_TWIDDLECOEF_F32_16
+#define ARM_TABLE_BITREVIDX_FLT_16
+#endif
+#if DSP_CFFT_F32_32
+#define ARM_TABLE_TWIDDLECOEF_F32_32
+#define ARM_TABLE_BITREVIDX_FLT_32
+#endif
+#if DSP_CFFT_F32_64
+#define ARM_TABLE_TWIDDLECOEF_F32_64
+#define ARM_TABLE_BITREVIDX_FLT_64
+#endif
+#if DSP_CFFT_F32_128
+#define ARM_TABLE_TWIDDLECOEF_F32_128
+#define ARM_TABLE_BITREVIDX_FLT_128
+#endif
+#if DSP_CFFT_F32_256
+#define ARM_TABLE_TWIDDLECOEF_F32_256
+#define ARM_TABLE_BITREVIDX_FLT_256
+#endif
+#if DSP_CFFT_F32_512
+#define ARM_TABLE_TWIDDLECOEF_F32_512
+#define ARM_TABLE_BITREVIDX_FLT_512
+#endif
+#if DSP_CFFT_F32_1024
+#define ARM_TABLE_TWIDDLECOEF_F32_1024
+#define ARM_TABLE_BITREVIDX_FLT_1024
+#endif
+#if DSP_CFFT_F32_2048
+#define ARM_TABLE_TWIDDLECOEF_F32_2048
+#define ARM_TABLE_BITREVIDX_FLT_2048
+#endif
+#if DSP_CFFT_F32_4096
+#define ARM_TABLE_TWIDDLECOEF_F32_4096
+#define ARM_TABLE_BITREVIDX_FLT_4096
+#endif
+
+#endif // __DSP_CONFIG_H__
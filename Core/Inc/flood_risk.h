@@ -0,0 +1,40 @@
+#ifndef __FLOOD_RISK_H__
+#define __FLOOD_RISK_H__
+
+#include <stdint.h>
+#include "nn_runtime.h"
+
+// Flood-risk score from level history: FLOOD_RISK_HIST one-second level
+// samples plus short/long rates are quantised to int8 and run through the
+// network in flood_risk_model.c (generated by Tools/train_flood_risk.py).
+#define FLOOD_RISK_HIST      8       // history length (model input, 1 Hz)
+#define FLOOD_RISK_DECIM     10      // level samples averaged per history step (10 Hz in)
+#define FLOOD_RISK_RATE_FULL 1.0f    // mm/s mapped to +1.0 (must match the trainer)
+
+typedef enum {
+    FLOOD_RISK_SAFE = 0,
+    FLOOD_RISK_RISING,
+    FLOOD_RISK_FLOOD        // warning level expected within the training horizon
+} flood_risk_class_t;
+
+// One instance per level channel, with its own network arena
+typedef struct {
+    float hist[FLOOD_RISK_HIST];        // oldest first
+    uint8_t hist_fill;
+    float decim_sum;
+    uint8_t decim_n;
+    int8_t probs[3];
+    uint8_t risk;
+    flood_risk_class_t risk_class;
+    uint8_t ready;                      // the model loaded
+    nn_instance_t nn;
+} flood_risk_instance_t;
+
+int flood_risk_init(flood_risk_instance_t *S);
+void flood_risk_push(flood_risk_instance_t *S, float level_mm);
+uint8_t flood_risk_get(const flood_risk_instance_t *S);    // P(flood) scaled to 0..255, 0 until the history is full
+flood_risk_class_t flood_risk_class(const flood_risk_instance_t *S);
+
+extern const nn_model_t flood_risk_model;
+
+#endif // __FLOOD_RISK_H__
@@ -0,0 +1,27 @@
+#ifndef __FMT_H__
+#define __FMT_H__
+
+#include <stdint.h>
+
+// Fixed-width text formatting without libc: no printf, no heap, no _reent.
+// Each call writes exactly `width` characters at dst (no terminator) and
+// returns dst + width, so fields chain into a line buffer. Numbers are right
+// aligned and space padded; a number that does not fit fills the field with
+// '#' like an overflowing display. width 0 writes as many characters as the
+// value needs (free-form log lines).
+#define FMT_OVERFLOW    '#'
+
+char *fmt_uint(char *dst, uint32_t v, uint8_t width);
+char *fmt_int(char *dst, int32_t v, uint8_t width);
+char *fmt_fixed(char *dst, int32_t v, uint8_t frac_digits, uint8_t width);  // v / 10^frac_digits
+char *fmt_str(char *dst, const char *s, uint8_t width);     // left aligned, space padded, truncated
+char *fmt_copy(char *dst, const char *s, uint32_t n);
+
+// String literal with its length known at compile time
+#define fmt_lit(dst, lit)   fmt_copy((dst), ("" lit), sizeof(lit) - 1)
+
+// Compile-time check that a layout of field widths fits a line buffer
+#define FMT_FITS(line, total) \
+    _Static_assert((total) <= sizeof(line) - 1, "fields overflow " #line)
+
+#endif // __FMT_H__
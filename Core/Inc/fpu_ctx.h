@@ -0,0 +1,48 @@
+#ifndef __FPU_CTX_H__
+#define __FPU_CTX_H__
+
+#include <stdint.h>
+
+// FPU context accounting for the ARM_CM4F port. With lazy stacking a task
+// gets the extended frame only after its first FP instruction and keeps it:
+// from then on every switch-out stacks S16-S31 in PendSV (plus S0-S15 and
+// FPSCR by hardware when the FPU was live). Tasks declare FPU use
+// (task_model.h TASK_*_FPU); the switch-out hook reads the EXC_RETURN that
+// PendSV has just saved and counts the extended frames per task. Included
+// from FreeRTOSConfig.h when configUSE_FPU_CTX_STATS is 1, so no kernel
+// includes here. What an extended frame costs per switch is kernel_bench's
+// fpu switch against its switch; those cycles are not yet measured.
+#define FPU_CTX_MAX_TASKS   8       // declared tasks
+#define FPU_CTX_ASSERT      0       // 1: configASSERT when an integer-only task stacks FPU context
+
+typedef struct {
+    void *task;             // TaskHandle_t
+    uint8_t uses_fpu;       // declared
+    uint32_t switches;      // switch-outs
+    uint32_t fpu_saves;     // of which stacked the FPU context
+} fpu_ctx_task_t;
+
+typedef struct {
+    uint32_t switches;
+    uint32_t fpu_saves;
+    uint32_t violations;    // FPU saves of tasks declared integer-only
+    void *last_violator;    // TaskHandle_t
+    fpu_ctx_task_t tasks[FPU_CTX_MAX_TASKS];
+    uint8_t ntasks;
+} fpu_ctx_stats_t;
+
+extern fpu_ctx_stats_t fpu_ctx;
+
+void fpu_ctx_declare(void *task, uint8_t uses_fpu);   // before the task first runs
+void fpu_ctx_switched_out(void *task, void *tag, const uint32_t *top_of_stack);
+
+// PendSV stacks {r4-r11, EXC_RETURN} before vTaskSwitchContext; bit 4 of
+// EXC_RETURN clear means an extended (FPU) frame
+#define FPU_CTX_EXC_RETURN_SLOT   8
+#define FPU_CTX_EXC_RETURN_BASIC  0x10U
+
+#define traceTASK_SWITCHED_OUT() \
+    fpu_ctx_switched_out(pxCurrentTCB, (void *)pxCurrentTCB->pxTaskTag, \
+                         (const uint32_t *)pxCurrentTCB->pxTopOfStack)
+
+#endif // __FPU_CTX_H__
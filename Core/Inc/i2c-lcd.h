@@ -5,12 +5,14 @@
 
 // LCD ?? (?? 0x27 ?? 0x3F ? ?? ??? ??)
 #define LCD_I2C_ADDR (0x27 << 1)  // ??? ?? ? ?? ? 0x3F? ?? ??
+#define LCD_COLS     16
 
 // ?? ?? I2C ??? ?? (main.c? ??)
 extern I2C_HandleTypeDef hi2c1;
 
 // LCD ?? ??
-void lcd_init(void);
+void lcd_init(void);             // blocking, ~115 ms
+uint32_t lcd_init_step(void);    // next init command; ms to wait before the next call, 0 when ready
 void lcd_send_cmd(uint8_t cmd);
 void lcd_send_data(uint8_t data);
 void lcd_send_string(char *str);
@@ -0,0 +1,39 @@
+#ifndef __INDICATOR_H__
+#define __INDICATOR_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "alarm_pattern.h"
+
+// Status indicators (PC0-PC3) as a pure function of the control state: a
+// const table maps level x barrier x manual to the steady outputs and the
+// pattern to play, and alarm_pattern.c writes all four pins with each BSRR
+// word. indicator_update() returns the outputs only when they change; the
+// actuator owner plays them (pattern_play()).
+typedef enum { RAIN_NORMAL = 0, RAIN_WARNING, RAIN_FLOOD, RAIN_SENSOR_ERR } rain_status_t;
+
+#define INDICATOR_STATE(status, barrier_up, manual) \
+    (((status) & 3U) | ((barrier_up) ? 4U : 0U) | ((manual) ? 8U : 0U))
+#define INDICATOR_STATES    16
+
+typedef struct {
+    uint8_t steady;         // PATTERN_* bits held on under the pattern
+    uint8_t pattern;        // pattern_id_t
+} indicator_out_t;
+
+typedef struct {
+    uint32_t updates;       // indicator_update() calls
+    uint32_t writes;        // calls that changed the outputs
+} indicator_stats_t;
+
+typedef struct {
+    uint8_t last;           // table index in force, 0xFF before the first update
+    indicator_stats_t stats;
+} indicator_t;
+
+extern const indicator_out_t indicator_table[INDICATOR_STATES];
+
+void indicator_init(indicator_t *ind);     // the first update always returns outputs
+const indicator_out_t *indicator_update(indicator_t *ind, uint8_t status, uint8_t barrier_up, uint8_t manual);  // NULL if unchanged
+
+#endif // __INDICATOR_H__
@@ -0,0 +1,29 @@
+#ifndef __IR_KEYMAP_H__
+#define __IR_KEYMAP_H__
+
+#include <stdint.h>
+#include "ir_nec.h"
+#include "calib.h"
+
+// IR frame -> barrier event. The built-in remote's keys are a perfect hash
+// generated by Tools/gen_ir_keymap.py (ir_keymap_table.c): one multiply,
+// one compare. Remotes learned on site (calib.h, up to CALIB_IR_REMOTES)
+// are matched first, by address and then by their five commands. Any other
+// key of a known remote is the single-button toggle; a remote that is
+// neither built in nor learned is ignored.
+#define IR_HASH_BITS    4           // 16 slots
+
+typedef struct {
+    uint16_t address;       // ir_frame_t.address
+    uint8_t command;
+    uint8_t event;          // barrier_event_t
+} ir_key_t;
+
+extern const ir_key_t ir_keys[];
+extern const uint8_t ir_key_count;
+extern const uint32_t ir_hash_seed;
+extern const uint8_t ir_hash_slot[1 << IR_HASH_BITS];
+
+uint8_t ir_keymap_lookup(const calib_t *cal, const ir_frame_t *f);  // barrier_event_t; BARRIER_EVENTS: unknown remote
+
+#endif // __IR_KEYMAP_H__
@@ -0,0 +1,55 @@
+#ifndef __IR_NEC_H__
+#define __IR_NEC_H__
+
+#include <stdint.h>
+
+// NEC receiver: the EXTI callback feeds it the spacing of falling edges
+// (TIM4, 1 MHz), one call per edge; it assembles the 32 bits of a frame in
+// the order they arrive (LSB first: address, ~address, command, ~command)
+// and recognises repeat codes. A frame is only handed on once the command
+// byte matches its complement; the address is kept as both bytes, so
+// standard (8-bit, complemented) and extended (16-bit) NEC remotes both map
+// by their 16-bit address (ir_keymap.h).
+//
+//   frame   9 ms mark, 4.5 ms space: leader edge spacing 13.5 ms, then 32 bits
+//           of 1.125 ms (0) or 2.25 ms (1) edge to edge
+//   repeat  9 ms mark, 2.25 ms space, stop mark: 11.25 ms, every 108 ms while held
+#define IR_NEC_LEADER_MIN_US    12000
+#define IR_NEC_LEADER_MAX_US    15000
+#define IR_NEC_REPEAT_MIN_US    9500
+#define IR_NEC_ZERO_MIN_US      800
+#define IR_NEC_ZERO_MAX_US      1500
+#define IR_NEC_ONE_MIN_US       1900
+#define IR_NEC_ONE_MAX_US       2700
+#define IR_NEC_HOLD_GAP_MS      150 // a held key sends every 108 ms: a longer gap is a release
+#define IR_NEC_REPEAT           0U  // frame word of a repeat code: never a valid frame (command complement)
+
+typedef enum {
+    IR_NEC_NONE = 0,        // edge taken, nothing complete
+    IR_NEC_FRAME,           // rx->word holds a frame that passed its command complement
+    IR_NEC_HOLD,            // repeat code
+} ir_nec_result_t;
+
+typedef struct {
+    uint32_t word;          // bits so far; the frame once IR_NEC_FRAME is returned
+    uint8_t bits;           // 0xFF: waiting for a leader
+    uint32_t frames;        // valid frames (Tools/calib.py --learn watches this)
+    uint32_t last;          // last valid frame word
+    uint32_t errors;        // bad bit spacing or failed complement
+} ir_nec_rx_t;
+
+typedef struct {
+    uint16_t address;       // byte 0 | byte 1 << 8: 0xFF00 is standard NEC address 0x00
+    uint8_t command;
+} ir_frame_t;
+
+void ir_nec_init(ir_nec_rx_t *rx);
+ir_nec_result_t ir_nec_edge(ir_nec_rx_t *rx, uint32_t us);     // EXTI: spacing since the previous falling edge
+int ir_nec_frame(uint32_t word, ir_frame_t *f);                // 0 if the command complement holds
+
+/* Frame word for an address/command pair (host tools, tests) */
+static inline uint32_t ir_nec_word(uint16_t address, uint8_t command) {
+    return address | (uint32_t)command << 16 | (uint32_t)(uint8_t)~command << 24;
+}
+
+#endif // __IR_NEC_H__
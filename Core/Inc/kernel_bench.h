@@ -0,0 +1,34 @@
+#ifndef __KERNEL_BENCH_H__
+#define __KERNEL_BENCH_H__
+
+#include <stdint.h>
+
+// Kernel latency benchmark (main.c USE_KERNEL_BENCH): a driver task wakes a
+// higher-priority waiter, first with osThreadFlagsSet from task context,
+// then from an ISR (EXTI0 pended in software), then a second waiter that
+// does float math and so switches with the FPU frame. DWT cycles from the
+// wake-up call to the waiter running; results go to USART2 and kernel_bench.
+// Build once per kernel profile (configKERNEL_LEAN) to compare, with
+// Tools/footprint.py --compare on the two map files for flash and RAM.
+// Not yet run on a board: the lean against stock figures are still open.
+#define KBENCH_ROUNDS   1000
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint32_t n;
+} kbench_stat_t;
+
+typedef struct {
+    kbench_stat_t task_switch;  // osThreadFlagsSet in a task -> waiter running
+    kbench_stat_t isr_to_task;  // IRQ pended -> waiter running
+    kbench_stat_t task_switch_fpu;  // as task_switch, waiter with FPU context
+    uint8_t done;
+} kernel_bench_t;
+
+extern kernel_bench_t kernel_bench;
+
+void kernel_bench_start(void);  // after osKernelInitialize, instead of the application tasks
+
+#endif // __KERNEL_BENCH_H__
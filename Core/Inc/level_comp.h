@@ -0,0 +1,58 @@
+#ifndef __LEVEL_COMP_H__
+#define __LEVEL_COMP_H__
+
+#include <stdint.h>
+
+// Supply and temperature compensation of the level counts, all integer.
+// The ADC measures against VDDA, which the regulator lets wander by a few
+// percent with load and temperature; VREFINT (1.21 V, factory-measured at
+// VDDA = 3.3 V) gives the VDDA ratio, and the die temperature sensor,
+// itself corrected by that ratio, gives the temperature for the probe's
+// drift polynomial
+//     gain(T) = 1 + K1 (T - T0) + K2 (T - T0)^2
+// Both factors are folded into one Q16 gain per reference pair (level_comp_ref,
+// about once a second); every block is then one multiply (level_comp_apply).
+// K1 and K2 are properties of the probe, fitted on the bench like the
+// sensor curve (sensor_curve.h); the defaults leave temperature alone.
+// The probe is fed from VDDA, so its counts already track the supply and
+// only the temperature term applies. A probe with its own reference (an
+// absolute voltage output) reads VDDA drift as level: build it with
+// LEVEL_COMP_ABSOLUTE_PROBE 1 to scale its counts by the VDDA ratio too.
+#ifndef LEVEL_COMP_ABSOLUTE_PROBE
+#define LEVEL_COMP_ABSOLUTE_PROBE 0
+#endif
+#ifndef LEVEL_COMP_K1
+#define LEVEL_COMP_K1           0.0     // per degC
+#endif
+#ifndef LEVEL_COMP_K2
+#define LEVEL_COMP_K2           0.0     // per degC^2
+#endif
+#define LEVEL_COMP_T0_C         25      // polynomial reference temperature
+#define LEVEL_COMP_AVG_SHIFT    3       // reference pairs averaged over ~8 (8 s at one a second)
+#define LEVEL_COMP_CAL_MV       3300    // VDDA of the factory VREFINT and TS measurements
+#define LEVEL_COMP_Q30(x)       ((int32_t)((x) * 1073741824.0))
+
+// Factory words from system memory (VREFINT_CAL_ADDR, TEMPSENSOR_CAL*_ADDR)
+typedef struct {
+    uint16_t vrefint;       // VREFINT counts at 3.3 V, 30 degC
+    uint16_t ts_30;         // temperature sensor counts at 30 degC
+    uint16_t ts_110;        // ... at 110 degC
+} level_comp_factory_t;
+
+typedef struct {
+    level_comp_factory_t fac;
+    uint8_t valid;          // factory words look sane: otherwise gain stays 1.0
+    uint8_t primed;         // at least one reference pair accepted
+    uint32_t vref_avg;      // VREFINT counts << LEVEL_COMP_AVG_SHIFT
+    uint32_t ts_avg;        // temperature sensor counts << LEVEL_COMP_AVG_SHIFT
+    int32_t temp_q8;        // die temperature, degC * 256
+    uint32_t vdda_mv;       // from the averaged VREFINT counts
+    uint32_t gain_q16;      // applied to every block
+    uint32_t refs, rejects; // reference pairs folded in / out of range
+} level_comp_t;
+
+void level_comp_init(level_comp_t *c, const level_comp_factory_t *fac);
+int level_comp_ref(level_comp_t *c, uint16_t vref, uint16_t ts);   // one VREFINT/TS pair; 0 if accepted
+uint16_t level_comp_apply(const level_comp_t *c, uint16_t raw);     // compensated 12-bit counts
+
+#endif // __LEVEL_COMP_H__
@@ -0,0 +1,32 @@
+#ifndef __MEDIAN_FILTER_H__
+#define __MEDIAN_FILTER_H__
+
+#include "arm_math.h"
+
+// Sliding-window median (odd window) in the style of the CMSIS FIR kernels.
+// The window is kept sorted incrementally: each sample costs two binary
+// searches plus one memmove of the run between the outgoing and incoming
+// values' positions, instead of a re-sort of the whole window.
+
+typedef struct {
+    uint16_t windowSize;    // odd, 1 .. MEDIAN_MAX_WINDOW
+    uint16_t head;          // oldest sample in the age ring
+    q15_t *pState;          // 2 * windowSize: age ring, then sorted copy
+} median_instance_q15;
+
+typedef struct {
+    uint16_t windowSize;
+    uint16_t head;
+    float32_t *pState;      // 2 * windowSize: age ring, then sorted copy
+} median_instance_f32;
+
+#define MEDIAN_MAX_WINDOW  255
+
+/* The window starts filled with zeros, like a FIR delay line. */
+arm_status median_init_q15(median_instance_q15 *S, uint16_t windowSize, q15_t *pState);
+arm_status median_init_f32(median_instance_f32 *S, uint16_t windowSize, float32_t *pState);
+
+void median_q15(median_instance_q15 *S, const q15_t *pSrc, q15_t *pDst, uint32_t blockSize);
+void median_f32(median_instance_f32 *S, const float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+#endif // __MEDIAN_FILTER_H__
@@ -0,0 +1,68 @@
+#ifndef __NN_RUNTIME_H__
+#define __NN_RUNTIME_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Minimal int8 inference runtime on CMSIS-NN. A model is a const table of
+// tensors and layers (generated offline, see Tools/train_flood_risk.py);
+// intermediate tensors and per-layer scratch buffers are packed into one
+// static arena by liveness when the model is loaded.
+#define NN_ARENA_BYTES   128     // shared by all intermediate tensors + scratch
+#define NN_MAX_TENSORS   8
+#define NN_MAX_LAYERS    8
+
+typedef enum {
+    NN_OP_FULLY_CONNECTED = 0,  // arm_fully_connected_s8
+    NN_OP_SOFTMAX               // arm_softmax_s8, one row
+} nn_op_t;
+
+typedef struct {
+    uint16_t size;              // elements (int8)
+} nn_tensor_t;
+
+typedef struct {
+    nn_op_t op;
+    uint8_t in;                 // tensor indices
+    uint8_t out;
+    const int8_t *weights;      // FC: [out][in], row major
+    const int32_t *bias;        // FC: [out]
+    int32_t input_offset;       // FC: -input zero point
+    int32_t output_offset;      // FC: output zero point
+    int32_t mult;               // FC: requantisation / softmax: input beta multiplier
+    int32_t shift;
+    int32_t act_min;            // FC: clamp (fused ReLU)
+    int32_t act_max;
+    int32_t diff_min;           // softmax only
+} nn_layer_t;
+
+typedef struct {
+    const nn_tensor_t *tensors;
+    uint8_t num_tensors;
+    const nn_layer_t *layers;
+    uint8_t num_layers;
+    uint8_t input;              // tensor read from the caller's buffer
+    uint8_t output;             // tensor written to the caller's buffer
+} nn_model_t;
+
+typedef struct {
+    uint16_t arena_used;        // peak arena bytes of the plan
+    uint32_t run_cycles;        // last nn_run()
+    uint32_t run_cycles_max;
+} nn_stats_t;
+
+// One instance per loaded model: the arena and the plan that packs it
+typedef struct {
+    int8_t arena[NN_ARENA_BYTES] __attribute__((aligned(4)));
+    uint16_t tensor_off[NN_MAX_TENSORS];
+    uint16_t scratch_off[NN_MAX_LAYERS];
+    uint16_t scratch_size[NN_MAX_LAYERS];
+    const nn_model_t *model;    // NULL if the model did not fit
+    nn_stats_t stats;
+} nn_instance_t;
+
+int nn_init(nn_instance_t *S, const nn_model_t *model);
+int nn_run(nn_instance_t *S, const int8_t *input, int8_t *output);
+void nn_get_stats(const nn_instance_t *S, nn_stats_t *stats);
+
+#endif // __NN_RUNTIME_H__
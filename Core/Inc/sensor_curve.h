@@ -0,0 +1,47 @@
+#ifndef __SENSOR_CURVE_H__
+#define __SENSOR_CURVE_H__
+
+#include <stdint.h>
+#include "arm_math.h"
+
+// Sensor linearization: raw ADC counts to "linear counts", the counts an
+// ideal straight-line sensor would give at the same level, before the
+// calibrated mm scale (calib.h). The curve is a const table generated by
+// Tools/fit_sensor_curve.py from bench points (sensor_curve_table.c); the
+// checked-in one is the straight line. SENSOR_CURVE_MODE picks the method:
+//   LINEAR  arm_linear_interp_q15 between 33 knots, 128 counts apart
+//   SPLINE  arm_spline_f32 (natural cubic) through the same knots; smoother
+//           between knots, may overshoot where the curve bends hard
+//   LUT     one q15 load per sample from a 4096-entry table (8 KB flash)
+// Knot and LUT values are q15 of the ADC full scale: linear counts * 8.
+#define SENSOR_CURVE_LINEAR  0
+#define SENSOR_CURVE_SPLINE  1
+#define SENSOR_CURVE_LUT     2
+#ifndef SENSOR_CURVE_MODE
+#define SENSOR_CURVE_MODE    SENSOR_CURVE_LINEAR
+#endif
+#define SENSOR_CURVE_SHIFT   7                                   // knot spacing 2^7 counts
+#define SENSOR_CURVE_KNOTS   ((4096 >> SENSOR_CURVE_SHIFT) + 1)  // 0 .. 4096
+#define SENSOR_CURVE_LSB     8.0f                                // q15 per linear count
+
+extern const q15_t sensor_curve_q15[SENSOR_CURVE_KNOTS];
+extern const float32_t sensor_curve_x_f32[SENSOR_CURVE_KNOTS];  // knot positions, counts
+extern const float32_t sensor_curve_y_f32[SENSOR_CURVE_KNOTS];  // linear counts at the knots
+#if SENSOR_CURVE_MODE == SENSOR_CURVE_LUT
+extern const q15_t sensor_curve_lut[4096];
+#endif
+
+typedef struct {
+#if SENSOR_CURVE_MODE == SENSOR_CURVE_SPLINE
+    arm_spline_instance_f32 spline;
+    float32_t coeffs[3 * (SENSOR_CURVE_KNOTS - 1)];
+#else
+    uint8_t unused;
+#endif
+} sensor_curve_instance_t;
+
+void sensor_curve_init(sensor_curve_instance_t *S);
+float32_t sensor_curve(sensor_curve_instance_t *S, uint16_t raw);      // 12-bit counts -> linear counts
+uint16_t sensor_curve_raw(sensor_curve_instance_t *S, float32_t lin);  // inverse: the counts a level reads as (host models)
+
+#endif // __SENSOR_CURVE_H__
@@ -0,0 +1,63 @@
+#ifndef __SENSOR_FAULT_H__
+#define __SENSOR_FAULT_H__
+
+#include <stdint.h>
+#include "slosh_filter.h"
+#include "arm_math.h"
+
+// Level sensor fault detection: per window a small feature vector is
+// classified with CMSIS-DSP Gaussian naive Bayes (model in sensor_fault_model.c,
+// generated offline by Tools/train_fault_model.py). A healthy sensor has
+// several model classes (moving, still, slosh); sensor_fault_class_state
+// maps each class to its state.
+#define SENSOR_FAULT_WIN        (SLOSH_FFT_LEN * SLOSH_ANALYSE_EVERY) // aligned with slosh analysis
+#define SENSOR_FAULT_NFEAT      4
+#define SENSOR_FAULT_NCLASS     5       // model classes
+#define SENSOR_CLAMP_HIGH_RAW   4000    // factory SENSOR_CLAMP_RAW (calib.h): the model was trained with it
+#define SENSOR_CLAMP_LOW_RAW    5
+#define SENSOR_FAULT_BUDGET_US  50      // inference budget per window
+#define SENSOR_FAULT_CONFIRM    2       // consecutive windows before a fault is latched
+
+typedef enum {
+    SENSOR_OK = 0,      // includes a frozen output: a steady level reads the same
+    SENSOR_OPEN,        // disconnected: floating input, large broadband noise
+    SENSOR_SHORTED      // shorted: pinned at the high clamp (a dry sensor at 0 is OK)
+} sensor_state_t;
+
+typedef struct {
+    float features[SENSOR_FAULT_NFEAT]; // log10 var, log10 |slope|, flatness, clamp ratio
+    uint8_t last_class;                 // model class of the last window
+    uint32_t infer_cycles;              // cycles spent in the last inference
+    uint32_t infer_cycles_max;          // worst case since boot
+    uint32_t budget_overruns;           // windows where the budget was exceeded
+} sensor_fault_stats_t;
+
+// One instance per level channel. Window accumulators: O(1) RAM, no sample
+// buffer is kept. Integer sums keep the variance exact (float would cancel
+// at mid-scale levels).
+typedef struct {
+    uint32_t win_n;
+    uint32_t win_sum;
+    uint64_t win_sum_sq;
+    uint32_t win_sum_ix;
+    int32_t win_clamp;                  // +1 per high clamp hit, -1 per low rail hit
+    sensor_state_t state;
+    sensor_state_t candidate;
+    uint8_t candidate_count;
+    sensor_fault_stats_t stats;
+    arm_gaussian_naive_bayes_instance_f32 nb;
+} sensor_fault_instance_t;
+
+void sensor_fault_init(sensor_fault_instance_t *S);
+void sensor_fault_push(sensor_fault_instance_t *S, const slosh_instance_t *slosh, uint16_t raw);
+sensor_state_t sensor_fault_get(const sensor_fault_instance_t *S);
+void sensor_fault_get_stats(const sensor_fault_instance_t *S, sensor_fault_stats_t *stats);
+
+// Model tables (sensor_fault_model.c)
+extern const float sensor_fault_theta[SENSOR_FAULT_NCLASS * SENSOR_FAULT_NFEAT];
+extern const float sensor_fault_sigma[SENSOR_FAULT_NCLASS * SENSOR_FAULT_NFEAT];
+extern const float sensor_fault_priors[SENSOR_FAULT_NCLASS];
+extern const float sensor_fault_epsilon;
+extern const sensor_state_t sensor_fault_class_state[SENSOR_FAULT_NCLASS];
+
+#endif // __SENSOR_FAULT_H__
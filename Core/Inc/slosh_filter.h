@@ -0,0 +1,44 @@
+#ifndef __SLOSH_FILTER_H__
+#define __SLOSH_FILTER_H__
+
+#include <stdint.h>
+#include "arm_math.h"
+
+// Spectral slosh stage: blocks of level samples are windowed and run through
+// arm_rfft_fast_f32, the dominant wave/slosh component is tracked and an
+// adaptive biquad notch removes it before smoothing/thresholding.
+#define SLOSH_FFT_LEN        128     // samples per analysis block (tables in dsp_tables.c)
+#define SLOSH_SAMPLE_HZ      10.0f   // level sample rate (water task runs every 100 ms)
+#define SLOSH_MIN_HZ         0.3f    // slosh band searched for a peak
+#define SLOSH_MAX_HZ         3.0f
+#define SLOSH_MIN_AMP_MM     0.5f    // peak amplitude needed to engage the notch
+#define SLOSH_NOTCH_Q        2.0f
+#define SLOSH_ANALYSE_EVERY  2       // run the FFT on every Nth block only (duty cycle)
+
+typedef struct {
+    float freq_hz;      // dominant oscillation frequency of the last analysed block
+    float amp_mm;       // its amplitude (mm, peak)
+    float flatness;     // spectral flatness of the block (1 = flat/white or silent)
+    uint8_t notch_on;   // 1 while the notch is filtering the slosh band
+} slosh_info_t;
+
+// One instance per level channel. Fixed RAM: one sample block (windowed in
+// place) and one spectrum buffer, 2 * SLOSH_FFT_LEN floats, plus the notch.
+typedef struct {
+    float32_t block[SLOSH_FFT_LEN];
+    float32_t spectrum[SLOSH_FFT_LEN];
+    uint16_t block_fill;
+    uint16_t block_count;
+    arm_rfft_fast_instance_f32 fft;
+    arm_biquad_cascade_df2T_instance_f32 notch;
+    float32_t notch_coeffs[5];
+    float32_t notch_state[2];
+    float last_input;
+    slosh_info_t info;
+} slosh_instance_t;
+
+void slosh_init(slosh_instance_t *S);
+float slosh_filter(slosh_instance_t *S, float level_mm);
+void slosh_get_info(const slosh_instance_t *S, slosh_info_t *info);
+
+#endif // __SLOSH_FILTER_H__
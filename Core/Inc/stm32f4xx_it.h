@@ -58,6 +58,7 @@ void TIM4_IRQHandler(void);
 void USART2_IRQHandler(void);
 void EXTI15_10_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void DMA1_Stream6_IRQHandler(void);
 
 /* USER CODE END EFP */
 
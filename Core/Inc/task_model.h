@@ -0,0 +1,89 @@
+#ifndef __TASK_MODEL_H__
+#define __TASK_MODEL_H__
+
+#include <stdint.h>
+#include "cmsis_os.h"
+
+// Fixed-priority task set. The safety (water) task runs highest and is
+// released by osDelayUntil on a fixed grid; the timer task and the deferred
+// work thread (LCD/HMI, IR commands) run below it and the trace dump is
+// background. These defines feed the thread attributes in
+// main.c, the startup response-time check in task_model.c and
+// Tools/sched_sim.py, so change them here only. WCETs are budgets to keep
+// measured worst cases (trace_recorder, DWT) under, not estimates. TASK_*_FPU
+// declares FPU use (fpu_ctx.h): only those tasks should stack FPU context.
+// Budgets hold at TASK_MODEL_REF_HZ; the check stretches all of them for a
+// slower core clock (clock_profile.h), I2C-bound time included, and credits
+// nothing for a faster one.
+#define TASK_MODEL_REF_HZ      84000000U
+#define TASK_WATER_PERIOD_MS   100
+#define TASK_WATER_WCET_US     3000     // ADC, median, slosh FFT, fault classifier, NN, state machine
+#define TASK_WATER_CS_US       0        // sole actuator owner (barrier_fsm.h): no shared lock
+#define TASK_WATER_PRIO        osPriorityNormal
+#define TASK_WATER_STACK       384      // words
+#define TASK_WATER_FPU         1        // float level pipeline
+
+// Software timers run in the kernel timer task; its callbacks only post
+// work, so it needs a small stack. Priority must match configTIMER_TASK_PRIORITY.
+#define TASK_TIMER_PERIOD_MS   1000     // shortest periodic timer (LCD refresh); boot-only LCD init steps aside
+#define TASK_TIMER_WCET_US     20       // all callbacks due in one tick
+#define TASK_TIMER_CS_US       0
+#define TASK_TIMER_PRIO        osPriorityBelowNormal1
+#define TASK_TIMER_FPU         0
+
+// Deferred work (work_queue.c): LCD refresh, IR and calibration commands.
+// Sporadic; the budget covers one of each queued together.
+#define WORK_LCD_PERIOD_MS     1000
+#define WORK_LCD_WCET_US       20000    // two 16-char lines, polled I2C at 100 kHz
+#define WORK_IR_WCET_US        200      // hold tracking, key lookup, event post
+#define WORK_CALIB_WCET_US     2000     // hex, CRCs, 16 flash words at 100 us worst case, reply queued (uart_tx.c)
+#define TASK_WORK_PERIOD_MS    50       // IR frames are at least this far apart
+#define TASK_WORK_WCET_US      22200    // WORK_LCD_WCET_US + WORK_IR_WCET_US + WORK_CALIB_WCET_US
+#define TASK_WORK_CS_US        10       // uart_tx lock: a reply line into the TX buffer; IR commands are queued
+#define TASK_WORK_PRIO         osPriorityBelowNormal
+#define TASK_WORK_STACK        192      // words; fmt.c and polled HAL I2C, no printf
+#define TASK_WORK_FPU          0        // integer level and status published by water
+
+// Flash sector erase (calib_store_reclaim() on the work thread): one bank, so
+// nothing runs for its length, interrupts included, and no clock buys it
+// back. It is posted only from a quiet water slot (calib_store_quiet()), so
+// the check charges it to the water task as blocking against
+// TASK_WATER_QUIET_MS instead of the period: slots missed then run back to
+// back after it. Below water the LCD refresh and IR handling are late by the
+// stall, and USART2 characters arriving during it are lost (calib.py retries).
+#define WORK_ERASE_STALL_US    2000000  // 128 KB sector, x32 parallelism: 2 s max
+#define TASK_WATER_QUIET_MS    2500     // longest gap between water slots at a quiet slot
+
+#define TASK_TRACE_PRIO        osPriorityLow   // background: no deadline, must stay lowest
+#define TASK_TRACE_STACK       256
+#define TASK_TRACE_CS_US       20       // uart_tx lock: one 517-byte event frame into the TX buffer
+#define TASK_TRACE_FPU         0
+
+// Interrupt load charged to every task: interarrival and WCET in us
+#define ISR_TICK_PERIOD_US     1000     // SysTick (kernel tick, trace hooks)
+#define ISR_TICK_WCET_US       5
+#define ISR_HALTICK_PERIOD_US  1000     // TIM9 HAL time base
+#define ISR_HALTICK_WCET_US    2
+#define ISR_IR_PERIOD_US       1120     // NEC: shortest falling-edge spacing
+#define ISR_IR_WCET_US         4        // one bit per edge (ir_nec.c); the last posts the frame
+#define ISR_UART_PERIOD_US     87       // USART2 at 115200: one character in; out is DMA, one interrupt per chunk
+#define ISR_UART_WCET_US       3        // a line end posts the command, a TX chunk end starts the next
+
+#define TASK_MODEL_ISR         0x100    // priority above every thread
+
+typedef struct {
+    const char *name;
+    uint32_t period_us;     // and implicit deadline; 0: background
+    uint32_t wcet_us;
+    uint32_t cs_us;         // longest hold of a mutex shared across priorities (inheritance)
+    uint32_t prio;          // osPriority_t, or TASK_MODEL_ISR
+    uint32_t quiet_us;      // deadline when a flash erase may block it (WORK_ERASE_STALL_US); 0: not charged
+} task_model_t;
+
+extern const task_model_t task_model[];
+extern const uint32_t task_model_count;
+extern uint32_t task_model_wcrt_us[];   // response-time bounds from the last check
+
+int task_model_check(uint32_t cpu_hz);  // tasks that can miss their deadline or exceed configMAX_PRIORITIES
+
+#endif // __TASK_MODEL_H__
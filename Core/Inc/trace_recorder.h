@@ -0,0 +1,122 @@
+#ifndef __TRACE_RECORDER_H__
+#define __TRACE_RECORDER_H__
+
+#include <stdint.h>
+
+// Scheduling trace: the FreeRTOS trace macros below write 8-byte, DWT
+// timestamped events into a RAM ring (trace_recorder.c). Included from
+// FreeRTOSConfig.h when configUSE_TRACE_RECORDER is 1, so keep this header
+// free of kernel includes. Decode captures with Tools/trace_decode.py.
+#define TRACE_RING_EVENTS    512     // power of two; 8 bytes each
+#define TRACE_MODE_SNAPSHOT  0       // record until triggered, then dump the ring
+#define TRACE_MODE_STREAM    1       // drain the ring over USART2 continuously
+#define TRACE_MODE           TRACE_MODE_SNAPSHOT
+#define TRACE_POST_TRIGGER   (TRACE_RING_EVENTS / 4)  // events kept after a trigger
+#define TRACE_MAX_TASKS      12      // task name table sent with each dump
+#define TRACE_TICKS          0       // 1: log every tick (1000 events/s)
+
+typedef struct {
+    uint32_t ts;        // DWT->CYCCNT
+    uint8_t  type;      // trace_type_t
+    uint8_t  obj;       // task number (uxTCBNumber) or object id
+    uint16_t arg;       // event specific, see trace_type_t
+} trace_event_t;
+
+typedef enum {
+    TRC_NONE = 0,
+    TRC_SWITCH_IN,      // obj task
+    TRC_READY,          // obj task made ready (woken)
+    TRC_DELAY,          // obj task, arg ticks
+    TRC_DELAY_UNTIL,    // obj task, arg low 16 bits of the wake tick
+    TRC_BLOCK_RECV,     // obj task, arg object id (queue, semaphore, mutex)
+    TRC_BLOCK_SEND,     // obj task, arg object id
+    TRC_BLOCK_NOTIFY,   // obj task, arg ticks
+    TRC_SEND,           // obj object, arg task (0xFF from an ISR)
+    TRC_RECV,           // obj object, arg task (0xFF from an ISR)
+    TRC_SEND_FAIL,      // obj object, arg task
+    TRC_RECV_FAIL,      // obj object, arg task
+    TRC_INHERIT,        // obj mutex holder task, arg inherited priority
+    TRC_DISINHERIT,     // obj task, arg restored priority
+    TRC_TASK_CREATE,    // obj task, arg priority
+    TRC_TASK_DELETE,    // obj task
+    TRC_OBJ_CREATE,     // obj object id, arg queue type (queueQUEUE_TYPE_*)
+    TRC_TICK,           // arg low 16 bits of the tick count
+    TRC_ISR_ENTER,      // obj IRQ number
+    TRC_ISR_EXIT,       // obj IRQ number
+    TRC_USER,           // obj code, arg value (trace_user)
+    TRC_TRIGGER,        // arg events still recorded after this one
+    TRC_CLOCK,          // obj core clock MHz before, arg after (clock_profile.c)
+} trace_type_t;
+
+#define TRACE_FROM_ISR       0xFF
+
+extern volatile uint8_t trace_current_task;
+extern volatile uint32_t trace_frames_dropped;  // not queued for USART2: dropped whole (events also count as lost)
+
+void trace_init(void);
+void trace_write(uint8_t type, uint8_t obj, uint16_t arg);
+uint8_t trace_object_id(void);
+void trace_trigger(void);
+void trace_user(uint8_t code, uint16_t value);
+void trace_task(void *argument);
+
+#define trace_isr_enter(irq)  trace_write(TRC_ISR_ENTER, (uint8_t)(irq), 0)
+#define trace_isr_exit(irq)   trace_write(TRC_ISR_EXIT, (uint8_t)(irq), 0)
+
+/* ---- kernel hooks (expanded inside tasks.c / queue.c) ---- */
+#define TRC_TCB(pxTCB)        ((uint8_t)(pxTCB)->uxTCBNumber)
+#define TRC_QUEUE(pxQueue)    ((uint8_t)(pxQueue)->uxQueueNumber)
+#define TRC_TICKS(x)          ((uint16_t)((x) > 0xFFFFU ? 0xFFFFU : (x)))
+
+#define traceTASK_SWITCHED_IN() do { \
+    trace_current_task = TRC_TCB(pxCurrentTCB); \
+    trace_write(TRC_SWITCH_IN, trace_current_task, 0); } while (0)
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB) \
+    trace_write(TRC_READY, TRC_TCB(pxTCB), 0)
+#define traceTASK_DELAY() \
+    trace_write(TRC_DELAY, trace_current_task, TRC_TICKS(xTicksToDelay))
+#define traceTASK_DELAY_UNTIL(xTimeToWake) \
+    trace_write(TRC_DELAY_UNTIL, trace_current_task, (uint16_t)(xTimeToWake))
+#define traceTASK_NOTIFY_TAKE_BLOCK() \
+    trace_write(TRC_BLOCK_NOTIFY, trace_current_task, TRC_TICKS(xTicksToWait))
+#define traceTASK_NOTIFY_WAIT_BLOCK() \
+    trace_write(TRC_BLOCK_NOTIFY, trace_current_task, TRC_TICKS(xTicksToWait))
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) \
+    trace_write(TRC_BLOCK_RECV, trace_current_task, TRC_QUEUE(pxQueue))
+#define traceBLOCKING_ON_QUEUE_PEEK(pxQueue) \
+    trace_write(TRC_BLOCK_RECV, trace_current_task, TRC_QUEUE(pxQueue))
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue) \
+    trace_write(TRC_BLOCK_SEND, trace_current_task, TRC_QUEUE(pxQueue))
+#define traceQUEUE_SEND(pxQueue) \
+    trace_write(TRC_SEND, TRC_QUEUE(pxQueue), trace_current_task)
+#define traceQUEUE_SEND_FAILED(pxQueue) \
+    trace_write(TRC_SEND_FAIL, TRC_QUEUE(pxQueue), trace_current_task)
+#define traceQUEUE_RECEIVE(pxQueue) \
+    trace_write(TRC_RECV, TRC_QUEUE(pxQueue), trace_current_task)
+#define traceQUEUE_RECEIVE_FAILED(pxQueue) \
+    trace_write(TRC_RECV_FAIL, TRC_QUEUE(pxQueue), trace_current_task)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue) \
+    trace_write(TRC_SEND, TRC_QUEUE(pxQueue), TRACE_FROM_ISR)
+#define traceQUEUE_SEND_FROM_ISR_FAILED(pxQueue) \
+    trace_write(TRC_SEND_FAIL, TRC_QUEUE(pxQueue), TRACE_FROM_ISR)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue) \
+    trace_write(TRC_RECV, TRC_QUEUE(pxQueue), TRACE_FROM_ISR)
+#define traceQUEUE_RECEIVE_FROM_ISR_FAILED(pxQueue) \
+    trace_write(TRC_RECV_FAIL, TRC_QUEUE(pxQueue), TRACE_FROM_ISR)
+#define traceTASK_PRIORITY_INHERIT(pxTCB, uxPriority) \
+    trace_write(TRC_INHERIT, TRC_TCB(pxTCB), (uint16_t)(uxPriority))
+#define traceTASK_PRIORITY_DISINHERIT(pxTCB, uxPriority) \
+    trace_write(TRC_DISINHERIT, TRC_TCB(pxTCB), (uint16_t)(uxPriority))
+#define traceTASK_CREATE(pxNewTCB) \
+    trace_write(TRC_TASK_CREATE, TRC_TCB(pxNewTCB), (uint16_t)(pxNewTCB)->uxPriority)
+#define traceTASK_DELETE(pxTCB) \
+    trace_write(TRC_TASK_DELETE, TRC_TCB(pxTCB), 0)
+#define traceQUEUE_CREATE(pxNewQueue) do { \
+    (pxNewQueue)->uxQueueNumber = trace_object_id(); \
+    trace_write(TRC_OBJ_CREATE, TRC_QUEUE(pxNewQueue), (pxNewQueue)->ucQueueType); } while (0)
+#if TRACE_TICKS
+#define traceTASK_INCREMENT_TICK(xTickCount) \
+    trace_write(TRC_TICK, 0, (uint16_t)(xTickCount))
+#endif
+
+#endif // __TRACE_RECORDER_H__
@@ -0,0 +1,37 @@
+#ifndef __UART_TX_H__
+#define __UART_TX_H__
+
+#include <stdint.h>
+
+// USART2 transmit has a single owner: nothing else calls HAL_UART_Transmit*()
+// on huart2. Senders append a whole frame or line to a stream buffer
+// (reserve, copy, commit under a mutex), so it is queued whole or not at all
+// and never interleaves with another sender's. DMA1 Stream6 drains the
+// buffer in place (peek, transfer, consume on TX complete), one chunk at a
+// time. Calibration replies, the boot report, the kernel benchmark and the
+// trace dump all go through here.
+#define UART_TX_BUF_BYTES   1024
+#define UART_TX_CHUNK       32      // bytes per DMA transfer: 2.8 ms at 115200, the longest uart_tx_pause() wait
+#define UART_TX_HEADROOM    256     // kept free of bulk data (trace) for replies and reports
+#define UART_TX_WAIT_MS     100     // replies and reports: longest wait for space
+
+typedef struct {
+    uint32_t frames;        // queued
+    uint32_t bytes;         // sent
+    uint32_t dropped;       // no space within the sender's timeout: dropped whole
+    uint32_t dma_errors;    // chunk lost on the wire
+    uint32_t depth_max;     // most bytes waiting at once
+} uart_tx_stats_t;
+
+extern uart_tx_stats_t uart_tx_stats;
+
+int uart_tx_init(void);                 // after osKernelInitialize, before the first sender; 0 on success
+int uart_tx_write(const void *data, uint32_t len, uint32_t timeout_ms);        // thread; 0 queued, -1 dropped
+int uart_tx_write_bulk(const void *data, uint32_t len, uint32_t timeout_ms);   // same, leaving UART_TX_HEADROOM free
+int uart_tx_pause(uint32_t timeout_ms); // let the chunk on the wire finish, start no other; 0 once the line is idle
+void uart_tx_resume(void);
+void uart_tx_done(void);                // HAL_UART_TxCpltCallback
+void uart_tx_error(void);               // HAL_UART_ErrorCallback with a DMA error
+void uart_tx_dma_irq(void);             // DMA1_Stream6_IRQHandler
+
+#endif // __UART_TX_H__
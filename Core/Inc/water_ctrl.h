@@ -0,0 +1,60 @@
+#ifndef __WATER_CTRL_H__
+#define __WATER_CTRL_H__
+
+#include <stdint.h>
+#include "median_filter.h"
+#include "slosh_filter.h"
+#include "sensor_fault.h"
+#include "flood_risk.h"
+#include "calib.h"
+#include "sensor_curve.h"
+
+// Level pipeline of one water slot, from raw ADC counts to the rain status
+// and the barrier level event: spike median, linearization and mm, slosh notch, fault
+// classifier, smoothing, thresholds and flood risk. It does not know where
+// the counts come from: the water task feeds it ADC1 (adc_scan.c), the replay
+// engine feeds it recorded traces in virtual time (Tools/replay). All state
+// is in water_ctrl_t, one per level channel; thresholds and sensor scale come
+// from the calib_t it points to (calib.h), read once per slot.
+#define USE_SPIKE_MEDIAN  1        // 1: sliding median on raw counts rejects splash spikes
+#define SPIKE_MEDIAN_LEN  5        // samples (odd); delays the level by (LEN-1)/2 samples
+#define USE_SLOSH_FILTER  1        // 1: notch out wave/slosh before smoothing
+#define USE_SENSOR_FAULT  1        // 1: classify sensor faults (uses the slosh spectrum)
+#define SENSOR_FAULT_FAILSAFE_RAISE 1  // 1: raise the barrier while the sensor is faulted
+#define USE_FLOOD_RISK    1        // 1: raise early when the risk model predicts a flood
+
+#if USE_SENSOR_FAULT && !USE_SLOSH_FILTER
+#error "USE_SENSOR_FAULT needs USE_SLOSH_FILTER (spectral flatness feature)"
+#endif
+
+typedef struct {
+    const calib_t *cal;     // swapped by the owner between slots (calib_store_active())
+    sensor_curve_instance_t curve;
+    float smooth_mm;
+#if USE_SPIKE_MEDIAN
+    median_instance_q15 spike_median;
+    q15_t spike_median_state[2 * SPIKE_MEDIAN_LEN];
+#endif
+#if USE_SLOSH_FILTER
+    slosh_instance_t slosh;
+#endif
+#if USE_SENSOR_FAULT
+    sensor_fault_instance_t fault;
+#endif
+#if USE_FLOOD_RISK
+    flood_risk_instance_t risk;
+#endif
+} water_ctrl_t;
+
+typedef struct {
+    float mm;               // smoothed level
+    uint8_t status;         // rain_status_t (indicator.h)
+    uint8_t level;          // BEV_LEVEL_* or BEV_SENSOR_FAULT (barrier_fsm.h)
+    uint8_t risk;           // P(flood) * 256, 0 without USE_FLOOD_RISK
+} water_slot_t;
+
+void water_ctrl_init(water_ctrl_t *w, const calib_t *cal);          // filters and models, before the first slot
+void water_ctrl_step(water_ctrl_t *w, uint16_t raw, water_slot_t *out);  // one sample, every TASK_WATER_PERIOD_MS
+float rain_raw_to_mm(water_ctrl_t *w, uint16_t raw);   // clamp, sensor curve, calibrated scale
+
+#endif // __WATER_CTRL_H__
@@ -0,0 +1,31 @@
+#ifndef __WORK_QUEUE_H__
+#define __WORK_QUEUE_H__
+
+#include <stdint.h>
+
+// Deferred work: one worker thread runs posted items in order. Timer
+// callbacks and ISRs only post; anything that blocks (polled I2C, UART)
+// runs here instead. Priority and stack come from
+// task_model.h (TASK_WORK_*).
+#define WORK_QUEUE_LEN   4
+
+typedef void (*work_fn_t)(uint32_t arg);
+
+typedef struct {
+    work_fn_t fn;
+    uint32_t arg;
+} work_item_t;
+
+typedef struct {
+    uint32_t posted;
+    uint32_t dropped;       // queue full: the item was not run
+    uint32_t depth_max;     // most items waiting at once
+} work_queue_stats_t;
+
+extern work_queue_stats_t work_queue_stats;
+
+int work_queue_init(void);                  // after osKernelInitialize; 0 on success
+int work_post(work_fn_t fn, uint32_t arg);  // task, timer callback or ISR, never blocks; 0 on success
+void *work_queue_thread(void);              // worker thread id (osThreadId_t)
+
+#endif // __WORK_QUEUE_H__
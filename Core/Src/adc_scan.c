@@ -0,0 +1,86 @@
+#include "adc_scan.h"
+#include "main.h"
+
+#define ADC_SCAN_START_US   10      // ADON stabilization (3 us) and temperature sensor start-up (10 us)
+
+extern ADC_HandleTypeDef hadc1;
+DMA_HandleTypeDef hdma_adc1;
+
+level_comp_t adc_comp;
+adc_scan_stats_t adc_scan_stats;
+
+static volatile uint16_t adc_buf[ADC_SCAN_RANKS];
+static uint8_t adc_ranks;           // ranks of the block in flight, 0 once folded
+static uint8_t adc_ref_count;
+
+/* Previous block done (it had 100 ms): reset the stream and start the next sequence */
+static void adc_scan_start(uint8_t ranks) {
+    HAL_DMA_Abort(&hdma_adc1);
+    MODIFY_REG(hadc1.Instance->SQR1, ADC_SQR1_L, (uint32_t)(ranks - 1) << ADC_SQR1_L_Pos);
+    __HAL_ADC_CLEAR_FLAG(&hadc1, ADC_FLAG_EOC | ADC_FLAG_OVR | ADC_FLAG_STRT);
+    // DDS = 0: requests stop after the last rank, toggling DMA re-arms them
+    CLEAR_BIT(hadc1.Instance->CR2, ADC_CR2_DMA);
+    SET_BIT(hadc1.Instance->CR2, ADC_CR2_DMA);
+    HAL_DMA_Start(&hdma_adc1, (uint32_t)&hadc1.Instance->DR, (uint32_t)adc_buf, ranks);
+    adc_ranks = ranks;
+    SET_BIT(hadc1.Instance->CR2, ADC_CR2_SWSTART);
+}
+
+static void adc_scan_fold(void) {
+    if (adc_ranks == ADC_SCAN_RANKS) {
+        if (__HAL_DMA_GET_COUNTER(&hdma_adc1) == 0) {
+            level_comp_ref(&adc_comp, adc_buf[1], adc_buf[2]);
+        } else {
+            adc_scan_stats.ref_late++;
+        }
+    }
+    adc_ranks = 0;
+}
+
+void adc_scan_init(void) {
+    level_comp_factory_t fac;
+
+    __HAL_RCC_DMA2_CLK_ENABLE();
+    hdma_adc1.Instance = DMA2_Stream0;
+    hdma_adc1.Init.Channel = DMA_CHANNEL_0;
+    hdma_adc1.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    hdma_adc1.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_adc1.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_adc1.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    hdma_adc1.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    hdma_adc1.Init.Mode = DMA_NORMAL;
+    hdma_adc1.Init.Priority = DMA_PRIORITY_HIGH;     // ahead of the indicator stream
+    hdma_adc1.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_adc1) != HAL_OK) {
+        Error_Handler();
+    }
+
+    fac.vrefint = *VREFINT_CAL_ADDR;
+    fac.ts_30 = *TEMPSENSOR_CAL1_ADDR;
+    fac.ts_110 = *TEMPSENSOR_CAL2_ADDR;
+    level_comp_init(&adc_comp, &fac);
+
+    __HAL_ADC_ENABLE(&hadc1);
+    for (volatile uint32_t n = ADC_SCAN_START_US * (SystemCoreClock / 1000000U); n != 0; n--) {}
+
+    // One reference pair before the first slot: the first level is already compensated
+    adc_scan_start(ADC_SCAN_RANKS);
+    while (__HAL_DMA_GET_COUNTER(&hdma_adc1) != 0) {}
+    adc_scan_fold();
+}
+
+uint16_t adc_scan_block(void) {
+    uint8_t ranks = 1;
+
+    adc_scan_fold();
+    if (++adc_ref_count >= ADC_SCAN_REF_EVERY) {
+        adc_ref_count = 0;
+        ranks = ADC_SCAN_RANKS;
+        adc_scan_stats.ref_blocks++;
+    }
+    adc_scan_start(ranks);
+    // Rank 1 only: the reference pair carries on behind the slot
+    while (__HAL_DMA_GET_COUNTER(&hdma_adc1) == ranks) {}
+    adc_scan_stats.blocks++;
+    return level_comp_apply(&adc_comp, adc_buf[0]);
+}
@@ -0,0 +1,129 @@
+#include "alarm_pattern.h"
+#include "main.h"
+
+TIM_HandleTypeDef htim1;
+DMA_HandleTypeDef hdma_tim1_up;
+
+static const pattern_step_t pattern_off[] = {
+    { PATTERN_SLOT_MS, 0 },
+};
+static const pattern_step_t pattern_warning[] = {
+    { 500, PATTERN_YELLOW },
+    { 500, 0 },
+};
+static const pattern_step_t pattern_flood[] = {
+    { 100, PATTERN_RED | PATTERN_BUZZER },
+    { 100, PATTERN_RED },
+};
+static const pattern_step_t pattern_manual[] = {
+    { 40,  PATTERN_RED | PATTERN_BUZZER },
+    { 60,  PATTERN_RED },
+    { 40,  PATTERN_RED | PATTERN_BUZZER },
+    { 1860, PATTERN_RED },
+};
+
+#define PATTERN(steps) { steps, sizeof(steps) / sizeof(steps[0]) }
+
+const pattern_t patterns[PATTERN_COUNT] = {
+    [PATTERN_OFF]     = PATTERN(pattern_off),
+    [PATTERN_WARNING] = PATTERN(pattern_warning),
+    [PATTERN_FLOOD]   = PATTERN(pattern_flood),
+    [PATTERN_MANUAL]  = PATTERN(pattern_manual),
+};
+
+// PATTERN_* bit -> GPIOC pin
+static const uint16_t pattern_pins[] = { GPIO_PIN_1, GPIO_PIN_2, GPIO_PIN_3, GPIO_PIN_0 };
+
+static uint32_t pattern_slots[PATTERN_MAX_SLOTS];
+static pattern_id_t pattern_now = PATTERN_COUNT;
+static uint8_t pattern_steady;
+uint32_t pattern_restarts;
+
+static uint32_t pattern_bsrr(uint8_t outputs) {
+    uint32_t bsrr = 0;
+
+    for (uint32_t i = 0; i < sizeof(pattern_pins) / sizeof(pattern_pins[0]); i++) {
+        bsrr |= (outputs & (1U << i)) ? pattern_pins[i] : ((uint32_t)pattern_pins[i] << 16);
+    }
+    return bsrr;
+}
+
+uint32_t pattern_expand(const pattern_t *p, uint8_t steady, uint32_t *slots, uint32_t max) {
+    uint32_t n = 0;
+
+    for (uint32_t s = 0; s < p->nsteps; s++) {
+        uint32_t count = (p->steps[s].ms + PATTERN_SLOT_MS / 2) / PATTERN_SLOT_MS;
+        uint32_t bsrr = pattern_bsrr(p->steps[s].outputs | steady);
+
+        if (count == 0) count = 1;
+        if (n + count > max) return 0;
+        while (count--) slots[n++] = bsrr;
+    }
+    return n;
+}
+
+void pattern_init(void) {
+    uint32_t clk = HAL_RCC_GetPCLK2Freq();
+
+    // APB2 timers run at twice PCLK2 when the APB2 prescaler is not 1
+    if ((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_CFGR_PPRE2_DIV1) clk *= 2;
+
+    __HAL_RCC_TIM1_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    htim1.Instance = TIM1;
+    htim1.Init.Prescaler = clk / 10000 - 1;            // 10 kHz
+    htim1.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim1.Init.Period = PATTERN_SLOT_MS * 10 - 1;
+    htim1.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim1.Init.RepetitionCounter = 0;
+    htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+    if (HAL_TIM_Base_Init(&htim1) != HAL_OK) {
+        Error_Handler();
+    }
+
+    hdma_tim1_up.Instance = DMA2_Stream5;
+    hdma_tim1_up.Init.Channel = DMA_CHANNEL_6;
+    hdma_tim1_up.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_tim1_up.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_tim1_up.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_tim1_up.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdma_tim1_up.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma_tim1_up.Init.Mode = DMA_CIRCULAR;
+    hdma_tim1_up.Init.Priority = DMA_PRIORITY_LOW;
+    hdma_tim1_up.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_tim1_up) != HAL_OK) {
+        Error_Handler();
+    }
+
+    // Every table must fit, so pattern_play() never has to fail
+    for (uint32_t i = 0; i < PATTERN_COUNT; i++) {
+        if (pattern_expand(&patterns[i], 0, pattern_slots, PATTERN_MAX_SLOTS) == 0) {
+            Error_Handler();
+        }
+    }
+
+    __HAL_TIM_ENABLE_DMA(&htim1, TIM_DMA_UPDATE);
+    __HAL_TIM_ENABLE(&htim1);
+    pattern_play(PATTERN_OFF, 0);
+}
+
+/* Stop the stream, rewrite the slots, restart at slot 0 with a full slot */
+void pattern_play(pattern_id_t id, uint8_t steady) {
+    uint32_t n;
+
+    if (id >= PATTERN_COUNT || (id == pattern_now && steady == pattern_steady)) return;
+
+    HAL_DMA_Abort(&hdma_tim1_up);
+    n = pattern_expand(&patterns[id], steady, pattern_slots, PATTERN_MAX_SLOTS);
+    HAL_DMA_Start(&hdma_tim1_up, (uint32_t)pattern_slots, (uint32_t)&GPIOC->BSRR, n);
+    // UG reloads the counter and issues the first request: slot 0 lands now
+    htim1.Instance->EGR = TIM_EGR_UG;
+    pattern_now = id;
+    pattern_steady = steady;
+    pattern_restarts++;
+}
+
+pattern_id_t pattern_current(void) {
+    return pattern_now;
+}
@@ -0,0 +1,115 @@
+#include "barrier_fsm.h"
+
+typedef enum {
+    ACT_NONE = 0,
+    ACT_RAISE,
+    ACT_LOWER,
+    ACT_MOTOR_OFF,
+    ACT_REPOWER,            // servo back on at the last commanded position
+} barrier_action_t;
+
+#define T(next, act)  { BARRIER_##next, ACT_##act }
+#define PASS          { BARRIER_STATES, ACT_NONE }     // parent decides, or ignored at the root
+
+const char *const barrier_state_text[BARRIER_STATES] = {
+    "NORMAL", "WARNING", "FLOOD", "MANUAL", "E-STOP", "AUTO"
+};
+
+// Rows: current state. Columns: barrier_event_t. The transition action runs
+// first, then the exit action of the old state and the entry action of the
+// new one; a transition to the same state runs its action only. Next state
+// AUTO picks the AUTO leaf for the last level and the barrier position.
+const barrier_transition_t barrier_table[BARRIER_STATES][BARRIER_EVENTS] = {
+    //                   LOW              MID               HIGH            FAULT           TOGGLE            UP                DOWN              STOP                  AUTO           ESTOP
+    [BARRIER_NORMAL]  = { T(NORMAL, NONE), T(WARNING, NONE), T(FLOOD, NONE), T(FLOOD, NONE), PASS,             PASS,             PASS,             PASS,                 PASS,          PASS },
+    [BARRIER_WARNING] = { T(NORMAL, NONE), T(WARNING, NONE), T(FLOOD, NONE), T(FLOOD, NONE), PASS,             PASS,             PASS,             PASS,                 PASS,          PASS },
+    [BARRIER_FLOOD]   = { T(NORMAL, NONE), T(FLOOD, NONE),   T(FLOOD, NONE), T(FLOOD, NONE), T(WARNING, NONE), PASS,             T(WARNING, NONE), PASS,                 PASS,          PASS },
+    [BARRIER_AUTO]    = { PASS,            PASS,             PASS,           PASS,           T(MANUAL, RAISE), T(MANUAL, RAISE), PASS,             PASS,                 PASS,          T(ESTOP, NONE) },
+    [BARRIER_MANUAL]  = { PASS,            PASS,             PASS,           PASS,           T(WARNING, NONE), T(MANUAL, RAISE), T(WARNING, NONE), T(MANUAL, MOTOR_OFF), T(AUTO, NONE), T(ESTOP, NONE) },
+    [BARRIER_ESTOP]   = { PASS,            PASS,             PASS,           PASS,           PASS,             PASS,             PASS,             PASS,                 T(AUTO, NONE), PASS },
+};
+
+static const uint8_t barrier_parent[BARRIER_STATES] = {
+    [BARRIER_NORMAL] = BARRIER_AUTO,
+    [BARRIER_WARNING] = BARRIER_AUTO,
+    [BARRIER_FLOOD] = BARRIER_AUTO,
+    [BARRIER_MANUAL] = BARRIER_MANUAL,
+    [BARRIER_ESTOP] = BARRIER_ESTOP,
+    [BARRIER_AUTO] = BARRIER_AUTO,
+};
+
+static const uint8_t barrier_entry[BARRIER_STATES] = {
+    [BARRIER_NORMAL] = ACT_LOWER,
+    [BARRIER_WARNING] = ACT_LOWER,
+    [BARRIER_FLOOD] = ACT_RAISE,
+    [BARRIER_ESTOP] = ACT_MOTOR_OFF,
+};
+
+static const uint8_t barrier_exit[BARRIER_STATES] = {
+    [BARRIER_ESTOP] = ACT_REPOWER,
+};
+
+// AUTO leaf by [level][barrier up]: between the thresholds the barrier stays put
+static const uint8_t barrier_auto_leaf[BEV_SENSOR_FAULT + 1][2] = {
+    [BEV_LEVEL_LOW]    = { BARRIER_NORMAL,  BARRIER_NORMAL },
+    [BEV_LEVEL_MID]    = { BARRIER_WARNING, BARRIER_FLOOD },
+    [BEV_LEVEL_HIGH]   = { BARRIER_FLOOD,   BARRIER_FLOOD },
+    [BEV_SENSOR_FAULT] = { BARRIER_FLOOD,   BARRIER_FLOOD },
+};
+
+static void barrier_act(barrier_fsm_t *f, uint8_t action) {
+    switch (action) {
+    case ACT_RAISE:
+        f->servo = SERVO_UP;
+        f->barrier_up = 1;
+        break;
+    case ACT_LOWER:
+        f->servo = SERVO_DOWN;
+        f->barrier_up = 0;
+        break;
+    case ACT_MOTOR_OFF:
+        f->servo = SERVO_OFF;
+        break;
+    case ACT_REPOWER:
+        f->servo = f->barrier_up ? SERVO_UP : SERVO_DOWN;
+        break;
+    default:
+        break;
+    }
+}
+
+void barrier_fsm_init(barrier_fsm_t *f) {
+    f->state = BARRIER_NORMAL;
+    f->level = BEV_LEVEL_LOW;
+    f->servo = SERVO_DOWN;
+    f->barrier_up = 0;
+}
+
+void barrier_fsm_dispatch(barrier_fsm_t *f, uint8_t event) {
+    const barrier_transition_t *t;
+    uint8_t next;
+
+    if (event >= BARRIER_EVENTS) return;
+    if (event <= BEV_SENSOR_FAULT) f->level = event;   // also while MANUAL/ESTOP ignore it
+
+    t = &barrier_table[f->state][event];
+    if (t->next == BARRIER_STATES) t = &barrier_table[barrier_parent[f->state]][event];
+    if (t->next == BARRIER_STATES) return;
+
+    barrier_act(f, t->action);
+    next = t->next == BARRIER_AUTO ? barrier_auto_leaf[f->level][f->barrier_up] : t->next;
+    if (next != f->state) {
+        barrier_act(f, barrier_exit[f->state]);
+        f->state = next;
+        barrier_act(f, barrier_entry[next]);
+    }
+}
+
+/* E-stop drives the otherwise unused "manual, barrier down" indicator rows */
+uint8_t barrier_fsm_manual(const barrier_fsm_t *f) {
+    return f->state == BARRIER_MANUAL || f->state == BARRIER_ESTOP;
+}
+
+uint8_t barrier_fsm_raised(const barrier_fsm_t *f) {
+    return f->state != BARRIER_ESTOP && f->barrier_up;
+}
@@ -0,0 +1,67 @@
+#include "boot_trace.h"
+#include "main.h"
+#include "fmt.h"
+#include "uart_tx.h"
+
+boot_trace_t boot_trace;
+
+static const char *const boot_mark_names[BOOT_MARKS] = {
+    "entry", "clocks", "safety io", "periph", "filters", "kernel", "decision", "lcd"
+};
+
+void boot_trace_start(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    boot_trace.reset_flags = RCC->CSR;
+    RCC->CSR |= RCC_CSR_RMVF;       // next boot reports its own cause
+    boot_mark(BOOT_ENTRY);
+}
+
+void boot_mark(boot_mark_t mark) {
+    if (boot_trace.seen & (1U << mark)) return;
+    boot_trace.cycles[mark] = DWT->CYCCNT;
+    boot_trace.hz[mark] = SystemCoreClock;
+    boot_trace.seen |= 1U << mark;
+}
+
+/* POR also sets BORRSTF and every reset sets PINRSTF: most specific first */
+static const char *boot_reset_cause(uint32_t csr) {
+    if (csr & RCC_CSR_LPWRRSTF) return "lowpower";
+    if (csr & RCC_CSR_WWDGRSTF) return "wwdg";
+    if (csr & RCC_CSR_IWDGRSTF) return "iwdg";
+    if (csr & RCC_CSR_SFTRSTF)  return "software";
+    if (csr & RCC_CSR_PORRSTF)  return "poweron";
+    if (csr & RCC_CSR_BORRSTF)  return "brownout";
+    if (csr & RCC_CSR_PINRSTF)  return "pin";
+    return "unknown";
+}
+
+void boot_trace_report(void) {
+    char line[192];         // worst case: every mark with an 8-digit time
+    char *p;
+    uint32_t prev = BOOT_ENTRY;
+    uint64_t us = 0;
+
+    // Each segment ran at the clock recorded at its start
+    for (uint32_t m = BOOT_ENTRY + 1; m < BOOT_MARKS; m++) {
+        if (!(boot_trace.seen & (1U << m))) continue;
+        us += (uint64_t)(boot_trace.cycles[m] - boot_trace.cycles[prev]) * 1000000U / boot_trace.hz[prev];
+        boot_trace.us[m] = (uint32_t)us;
+        prev = m;
+    }
+
+    p = fmt_lit(line, "boot: reset=");
+    p = fmt_str(p, boot_reset_cause(boot_trace.reset_flags), 0);
+    for (uint32_t m = BOOT_ENTRY + 1; m < BOOT_MARKS; m++) {
+        if (!(boot_trace.seen & (1U << m))) continue;
+        p = fmt_lit(p, ", ");
+        p = fmt_str(p, boot_mark_names[m], 0);
+        p = fmt_lit(p, " ");
+        p = fmt_fixed(p, (int32_t)(boot_trace.us[m] / 100U), 1, 0);
+        p = fmt_lit(p, " ms");
+    }
+    p = fmt_lit(p, "\r\n");
+    uart_tx_write(line, (uint32_t)(p - line), UART_TX_WAIT_MS);
+}
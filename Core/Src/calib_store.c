@@ -0,0 +1,332 @@
+#include "calib_store.h"
+#include "stm32f4xx_hal.h"
+#include "work_queue.h"
+#include "fmt.h"
+#include "uart_tx.h"
+#include "ir_nec.h"
+#include "cmsis_os.h"
+#include <string.h>
+
+extern ir_nec_rx_t ir_rx;
+
+calib_store_stats_t calib_store_stats;
+
+// Applied blocks: the one in force and the next. The water task is the
+// higher priority, so it never runs a slot while the work thread fills the
+// other block; it picks the new pointer up at its next slot.
+static calib_t calib_ram[2];
+static const calib_t *volatile calib_cur = &calib_factory;
+static calib_record_t calib_rec;            // record in force
+static uint8_t calib_slot;                  // slot the next record is appended to
+static uint16_t calib_next[CALIB_SLOTS];    // first erased record, CALIB_SLOT_RECORDS when full
+static volatile uint8_t calib_reclaim;      // CALIB_RECLAIM_*
+
+// Command lines: the RX ISR takes a buffer from the pool as a line starts
+// (lock-free, interrupts stay unmasked) and posts it whole; the work thread
+// frees it once parsed. The next line arrives while one is answered. The
+// buffers are a static array so the work item carries an index, not a pointer.
+static uint32_t calib_line_mem[CALIB_LINES * CALIB_LINE_MAX / 4];
+static osMemoryPoolId_t calib_lines;
+static char *calib_line;                    // being filled by the RX ISR, NULL between lines
+static uint8_t calib_line_len;
+static uint8_t calib_line_skip;             // too long or no buffer: dropped up to its end
+
+static const calib_record_t *calib_slot_record(uint8_t slot, uint32_t i) {
+    return (const calib_record_t *)(uintptr_t)(CALIB_FLASH_BASE + slot * CALIB_SLOT_BYTES + i * sizeof(calib_record_t));
+}
+
+static int calib_blank(const calib_record_t *r) {
+    const uint32_t *w = (const uint32_t *)r;
+
+    for (uint32_t i = 0; i < sizeof(*r) / 4; i++) {
+        if (w[i] != 0xFFFFFFFFU) return 0;
+    }
+    return 1;
+}
+
+/* Records are appended in order: the used part of a slot is a prefix */
+static uint16_t calib_slot_end(uint8_t slot) {
+    uint16_t lo = 0, hi = CALIB_SLOT_RECORDS;
+
+    while (lo < hi) {
+        uint16_t mid = (lo + hi) / 2;
+        if (calib_blank(calib_slot_record(slot, mid))) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+static void calib_flash_flush(void) {
+    // Reads of a record before it was programmed may sit in the ART data cache
+    __HAL_FLASH_DATA_CACHE_DISABLE();
+    __HAL_FLASH_DATA_CACHE_RESET();
+    __HAL_FLASH_DATA_CACHE_ENABLE();
+}
+
+/* Stalls the CPU for the whole erase, 1-2 s for a 128 KB sector: the F411
+   has one flash bank, so every fetch waits, interrupts and the water task
+   included. Work thread only, from calib_store_reclaim() at a quiet slot. */
+static int calib_erase(uint8_t slot) {
+    FLASH_EraseInitTypeDef erase = {0};
+    uint32_t bad_sector;
+    HAL_StatusTypeDef st;
+
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Sector = CALIB_SECTOR_FIRST + slot;
+    erase.NbSectors = 1;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+                           FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+    st = HAL_FLASHEx_Erase(&erase, &bad_sector);
+    HAL_FLASH_Lock();
+    if (st != HAL_OK) return -1;
+    calib_next[slot] = 0;
+    calib_store_stats.erases++;
+    return 0;
+}
+
+/* Word by word in order, CRC last: a reset part way leaves a record that fails its CRC */
+static int calib_program(const calib_record_t *dst, const calib_record_t *rec) {
+    const uint32_t *w = (const uint32_t *)rec;
+    uint32_t addr = (uint32_t)(uintptr_t)dst;
+    int rc = 0;
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+                           FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+    for (uint32_t i = 0; i < sizeof(*rec) / 4 && rc == 0; i++) {
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, addr + 4 * i, w[i]) != HAL_OK) rc = -1;
+    }
+    HAL_FLASH_Lock();
+    calib_flash_flush();
+    return rc;
+}
+
+/* The other slot only holds older records: due for erasing once the active one is half full */
+static int calib_reclaim_needed(void) {
+    return calib_next[calib_slot] > CALIB_SLOT_RECORDS / 2 && calib_next[calib_slot ^ 1] != 0;
+}
+
+int calib_store_init(void) {
+    const calib_record_t *best = NULL;
+
+    calib_slot = 0;
+    for (uint8_t slot = 0; slot < CALIB_SLOTS; slot++) {
+        calib_next[slot] = calib_slot_end(slot);
+        // The newest valid record of a slot is its last one that checks out
+        for (uint32_t i = calib_next[slot]; i-- > 0;) {
+            const calib_record_t *r = calib_slot_record(slot, i);
+            if (calib_check(r) == CALIB_OK) {
+                if (best == NULL || r->seq > best->seq) {
+                    best = r;
+                    calib_slot = slot;
+                }
+                break;
+            }
+            calib_store_stats.skipped++;
+        }
+    }
+    if (best != NULL) {
+        calib_rec = *best;
+    } else {
+        calib_defaults(&calib_rec);
+    }
+    calib_apply(&calib_ram[0], &calib_rec);
+    calib_cur = &calib_ram[0];
+
+    // No erase here: it would hold the first control decision off by a second or two
+    if (calib_reclaim_needed()) calib_reclaim = CALIB_RECLAIM_DUE;
+    return best != NULL ? 0 : 1;
+}
+
+int calib_store_reclaim(void) {
+    int rc = 0;
+
+    if (calib_reclaim_needed()) {
+        rc = calib_erase(calib_slot ^ 1);
+        if (rc != 0) calib_store_stats.errors++;    // due again at the next write
+    }
+    calib_reclaim = CALIB_RECLAIM_NONE;
+    return rc;
+}
+
+static void calib_reclaim_work(uint32_t arg) {
+    (void)arg;
+    (void)calib_store_reclaim();
+}
+
+void calib_store_quiet(void) {
+    if (calib_reclaim == CALIB_RECLAIM_DUE && work_post(calib_reclaim_work, 0) == 0) {
+        calib_reclaim = CALIB_RECLAIM_POSTED;
+    }
+}
+
+const calib_t *calib_store_active(void) {
+    return calib_cur;
+}
+
+const calib_record_t *calib_store_record(void) {
+    return &calib_rec;
+}
+
+calib_err_t calib_store_write(calib_record_t *rec) {
+    const calib_record_t *dst;
+    calib_t *next;
+    uint8_t slot = calib_slot;
+    calib_err_t err;
+
+    rec->seq = calib_rec.seq + 1;
+    // Unused remote entries and reserved bytes are stored as 0
+    for (uint8_t i = 0; i < CALIB_IR_REMOTES; i++) {
+        if (i >= rec->ir_remotes) memset(&rec->ir[i], 0, sizeof(rec->ir[i]));
+        rec->ir[i].reserved = 0;
+    }
+    calib_seal(rec);
+    err = calib_check(rec);
+    if (err == CALIB_OK && calib_next[slot] >= CALIB_SLOT_RECORDS) {
+        // Go on in the other slot only once it is erased: erasing here would
+        // stall the CPU outside a quiet slot, so refuse and leave it due
+        slot ^= 1;
+        if (calib_next[slot] != 0) {
+            if (calib_reclaim == CALIB_RECLAIM_NONE) calib_reclaim = CALIB_RECLAIM_DUE;
+            err = CALIB_ERR_FULL;
+        }
+    }
+    if (err == CALIB_OK) {
+        // Consumed even if programming fails: a half-written record is never reused
+        dst = calib_slot_record(slot, calib_next[slot]++);
+        if (calib_program(dst, rec) != 0 || memcmp(dst, rec, sizeof(*rec)) != 0) err = CALIB_ERR_FLASH;
+    }
+    if (err != CALIB_OK) {
+        calib_store_stats.errors++;
+        return err;
+    }
+    calib_slot = slot;
+    calib_rec = *rec;
+    next = calib_cur == &calib_ram[0] ? &calib_ram[1] : &calib_ram[0];
+    calib_apply(next, rec);
+    calib_cur = next;       // one aligned store: the water task sees the old block or the new one
+    calib_store_stats.writes++;
+    if (calib_reclaim == CALIB_RECLAIM_NONE && calib_reclaim_needed()) calib_reclaim = CALIB_RECLAIM_DUE;
+    return CALIB_OK;
+}
+
+static char *calib_hex(char *dst, const void *data, uint32_t len) {
+    static const char digits[] = "0123456789ABCDEF";
+    const uint8_t *p = data;
+
+    while (len--) {
+        *dst++ = digits[*p >> 4];
+        *dst++ = digits[*p++ & 0x0F];
+    }
+    return dst;
+}
+
+static int calib_unhex(void *data, uint32_t len, const char *s) {
+    uint8_t *p = data;
+
+    for (uint32_t i = 0; i < 2 * len; i++) {
+        char c = s[i];
+        uint8_t v;
+        if (c >= '0' && c <= '9') v = (uint8_t)(c - '0');
+        else if (c >= 'A' && c <= 'F') v = (uint8_t)(c - 'A' + 10);
+        else if (c >= 'a' && c <= 'f') v = (uint8_t)(c - 'a' + 10);
+        else return -1;
+        p[i / 2] = (uint8_t)((i & 1) ? (p[i / 2] << 4) | v : v);
+    }
+    return s[2 * len] == '\0' ? 0 : -1;
+}
+
+/* Work thread: one command line (arg: its buffer), one reply line */
+static void calib_command_work(uint32_t arg) {
+    char *line = (char *)calib_line_mem + arg * CALIB_LINE_MAX;
+    char reply[CALIB_LINE_MAX];
+    calib_record_t rec;
+    calib_err_t err = CALIB_OK;
+    char *p = reply;
+
+    switch (line[0]) {
+    case 'R':
+        p = fmt_lit(p, "C ");
+        p = calib_hex(p, &calib_rec, sizeof(calib_rec));
+        break;
+    case 'W':
+        if (line[1] != ' ' || calib_unhex(&rec, sizeof(rec), line + 2) != 0) {
+            err = CALIB_ERR_FORMAT;
+        } else {
+            err = calib_check(&rec);    // as sent: catches a garbled line
+        }
+        if (err == CALIB_OK) err = calib_store_write(&rec);
+        break;
+    case 'F':
+        // Factory thresholds and scale; learned remotes are not calibration and stay
+        calib_defaults(&rec);
+        rec.ir_remotes = calib_rec.ir_remotes;
+        memcpy(rec.ir, calib_rec.ir, sizeof(rec.ir));
+        err = calib_store_write(&rec);
+        break;
+    case 'K': {
+        // Last valid IR frame and the frame count: Tools/calib.py --learn waits for the count to move.
+        // The EXTI ISR writes both, so they are read as a pair with interrupts masked
+        uint32_t primask = __get_PRIMASK(), last, frames;
+
+        __disable_irq();
+        last = ir_rx.last;
+        frames = ir_rx.frames;
+        __set_PRIMASK(primask);
+        p = fmt_lit(p, "K ");
+        p = calib_hex(p, &last, sizeof(last));
+        p = calib_hex(p, &frames, sizeof(frames));
+        break;
+    }
+    default:
+        err = CALIB_ERR_FORMAT;
+        break;
+    }
+    osMemoryPoolFree(calib_lines, line);
+
+    if (p == reply) {
+        if (err == CALIB_OK) {
+            p = fmt_lit(p, "OK ");
+            p = fmt_uint(p, calib_rec.seq, 0);
+        } else {
+            p = fmt_lit(p, "ERR ");
+            p = fmt_str(p, calib_err_text[err], 0);
+        }
+    }
+    p = fmt_lit(p, "\r\n");
+    // Queued behind whatever is going out; a trace dump leaves room for it
+    uart_tx_write(reply, (uint32_t)(p - reply), UART_TX_WAIT_MS);
+}
+
+int calib_store_start(void) {
+    const osMemoryPoolAttr_t attr = { .name = "calib_lines", .mp_mem = calib_line_mem, .mp_size = sizeof(calib_line_mem) };
+
+    calib_lines = osMemoryPoolNew(CALIB_LINES, CALIB_LINE_MAX, &attr);
+    return calib_lines == NULL ? -1 : 0;
+}
+
+void calib_store_rx(uint8_t byte) {
+    if (byte == '\r' || byte == '\n') {
+        if (calib_line_len != 0 && !calib_line_skip) {
+            calib_line[calib_line_len] = '\0';
+            if (work_post(calib_command_work, (uint32_t)((calib_line - (char *)calib_line_mem) / CALIB_LINE_MAX)) == 0) {
+                calib_line = NULL;          // the work thread's now
+            } else {
+                calib_store_stats.lines_dropped++;     // buffer kept for the next line
+            }
+        }
+        calib_line_len = 0;
+        calib_line_skip = 0;
+    } else if (!calib_line_skip) {
+        if (calib_line == NULL && (calib_line = osMemoryPoolAlloc(calib_lines, 0)) == NULL) {
+            calib_store_stats.lines_dropped++;      // every buffer still queued or being answered
+            calib_line_skip = 1;
+        } else if (calib_line_len < CALIB_LINE_MAX - 1) {
+            calib_line[calib_line_len++] = (char)byte;
+        } else {
+            calib_line_skip = 1;
+        }
+    }
+}
@@ -0,0 +1,288 @@
+#include "clock_profile.h"
+#include "main.h"
+#include "cmsis_os.h"
+#include "indicator.h"
+#include "work_queue.h"
+#include "uart_tx.h"
+#if configUSE_TRACE_RECORDER
+#include "trace_recorder.h"
+#endif
+
+#define CLOCK_RCC_TIMEOUT_MS  5
+#define CLOCK_SERVO_GUARD_US  2000      // a switch must finish this far ahead of the next pulse
+
+extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim3;
+extern TIM_HandleTypeDef htim4;
+extern TIM_HandleTypeDef htim9;     // HAL time base (stm32f4xx_hal_timebase_tim.c)
+
+// HSI / 8 = 2 MHz into the VCO; VCO / P is the core clock
+const clock_profile_t clock_profiles[CLOCK_PROFILE_COUNT] = {
+    [CLOCK_LOW]  = { "low",   48000000U, 8,  96, 4, 4, 1, 1, 1, 3 },
+    [CLOCK_FULL] = { "full", 100000000U, 8, 200, 4, 9, 2, 1, 3, 1 },
+};
+
+clock_profile_stats_t clock_profile_stats;
+
+static clock_profile_id_t current = CLOCK_PROFILE_COUNT;   // HSI out of reset
+static volatile clock_profile_id_t target = CLOCK_BOOT;
+static clock_timing_t timing;
+static uint32_t entered_tick;
+static uint32_t hold;
+
+// Highest core clock per flash wait state at 2.7-3.6 V (RM0383 table 5)
+static const uint32_t flash_max_hz[] = { 30000000U, 64000000U, 90000000U, 100000000U };
+
+/* Prescaler for an exact count rate; non-zero if the rate cannot be hit */
+static int clock_psc(uint32_t clk, uint32_t hz, uint16_t *psc) {
+    *psc = (uint16_t)(clk / hz - 1U);
+    return clk % hz != 0 || clk / hz == 0 || clk / hz > 0x10000U;
+}
+
+int clock_timing(const clock_profile_t *p, clock_timing_t *t) {
+    uint32_t vco_in = HSI_VALUE / p->pllm;
+    uint32_t vco = vco_in * p->plln;
+    uint32_t baud;
+    int bad = 0;
+
+    if (vco_in < 1000000U || vco_in > 2000000U || vco < 100000000U || vco > 432000000U) bad++;
+    if (vco / p->pllp != p->sysclk_hz || vco % p->pllp != 0 || vco / p->pllq > 48000000U) bad++;
+    if (p->sysclk_hz > (p->vos == 3 ? 64000000U : 100000000U)) bad++;
+    // Exactly the wait states the clock needs: one more costs speed for nothing
+    if (p->flash_ws >= sizeof(flash_max_hz) / sizeof(flash_max_hz[0]) ||
+        p->sysclk_hz > flash_max_hz[p->flash_ws] ||
+        (p->flash_ws > 0 && p->sysclk_hz <= flash_max_hz[p->flash_ws - 1])) bad++;
+
+    t->pclk1_hz = p->sysclk_hz / p->apb1_div;
+    t->pclk2_hz = p->sysclk_hz / p->apb2_div;
+    if (t->pclk1_hz > CLOCK_APB1_MAX_HZ) bad++;
+    t->tim_apb1_hz = p->apb1_div == 1 ? t->pclk1_hz : 2U * t->pclk1_hz;
+    t->tim_apb2_hz = p->apb2_div == 1 ? t->pclk2_hz : 2U * t->pclk2_hz;
+
+    bad += clock_psc(t->tim_apb1_hz, CLOCK_SERVO_HZ, &t->tim3_psc);
+    bad += clock_psc(t->tim_apb1_hz, CLOCK_IR_HZ, &t->tim4_psc);
+    bad += clock_psc(t->tim_apb2_hz, CLOCK_PATTERN_HZ, &t->tim1_psc);
+    bad += clock_psc(t->tim_apb2_hz, CLOCK_HALTICK_HZ, &t->tim9_psc);
+
+    // 16x oversampling: BRR is PCLK1 / baud with 4 fraction bits
+    t->usart2_brr = (uint16_t)((t->pclk1_hz + CLOCK_UART_BAUD / 2U) / CLOCK_UART_BAUD);
+    baud = t->pclk1_hz / t->usart2_brr;
+    t->usart2_ppm = (uint32_t)((uint64_t)(baud > CLOCK_UART_BAUD ? baud - CLOCK_UART_BAUD : CLOCK_UART_BAUD - baud)
+                               * 1000000U / CLOCK_UART_BAUD);
+    if (t->usart2_ppm > CLOCK_UART_MAX_PPM) bad++;
+
+    // Standard mode: SCL high and low are CCR PCLK1 periods each, TRISE 1000 ns
+    t->i2c_freq = (uint8_t)(t->pclk1_hz / 1000000U);
+    t->i2c_ccr = (uint16_t)(t->pclk1_hz / (2U * CLOCK_I2C_HZ));
+    t->i2c_trise = (uint8_t)(t->i2c_freq + 1U);
+    if (t->pclk1_hz % 1000000U != 0 || t->i2c_freq < 2 || t->i2c_freq > 50) bad++;
+    if (t->pclk1_hz % (2U * CLOCK_I2C_HZ) != 0 || t->i2c_ccr < 4 || t->i2c_ccr > 0xFFF) bad++;
+
+    t->systick_load = p->sysclk_hz / configTICK_RATE_HZ - 1U;
+    if (p->sysclk_hz % configTICK_RATE_HZ != 0 || t->systick_load > 0xFFFFFFU) bad++;
+
+    t->adc_hz = t->pclk2_hz / 4U;
+    if (t->adc_hz > CLOCK_ADC_MAX_HZ) bad++;
+    return bad;
+}
+
+const clock_timing_t *clock_timing_now(void) {
+    return &timing;
+}
+
+clock_profile_id_t clock_profile_current(void) {
+    return current;
+}
+
+static uint32_t clock_hclk_div(uint8_t div) {
+    switch (div) {
+    case 2:  return RCC_HCLK_DIV2;
+    case 4:  return RCC_HCLK_DIV4;
+    case 8:  return RCC_HCLK_DIV8;
+    case 16: return RCC_HCLK_DIV16;
+    default: return RCC_HCLK_DIV1;
+    }
+}
+
+/* The HAL tick, kept counting while clock_profile_set() has interrupts
+   masked so the RCC timeouts in clock_rcc() still expire: a TIM9 update
+   that waits on the masked interrupt is taken here, and the handler then
+   finds its flag clear. Overrides the weak one in stm32f4xx_hal.c. */
+uint32_t HAL_GetTick(void) {
+    if (__get_PRIMASK() && __HAL_TIM_GET_IT_SOURCE(&htim9, TIM_IT_UPDATE) &&
+        __HAL_TIM_GET_FLAG(&htim9, TIM_FLAG_UPDATE)) {
+        __HAL_TIM_CLEAR_FLAG(&htim9, TIM_FLAG_UPDATE);
+        HAL_IncTick();
+    }
+    return uwTick;
+}
+
+/* Park on HSI, reprogram the PLL and the regulator scale, switch back.
+   HAL_RCC_ClockConfig() orders the flash latency change around the switch,
+   updates SystemCoreClock and re-inits the TIM9 HAL tick. */
+static int clock_rcc(const clock_profile_t *p) {
+    RCC_OscInitTypeDef osc = {0};
+    RCC_ClkInitTypeDef clk = {0};
+    uint32_t start;
+
+    clk.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+    clk.AHBCLKDivider = RCC_SYSCLK_DIV1;
+    if (__HAL_RCC_GET_SYSCLK_SOURCE() == RCC_SYSCLKSOURCE_STATUS_PLLCLK) {
+        clk.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+        clk.APB1CLKDivider = RCC_HCLK_DIV1;
+        clk.APB2CLKDivider = RCC_HCLK_DIV1;
+        if (HAL_RCC_ClockConfig(&clk, __HAL_FLASH_GET_LATENCY()) != HAL_OK) return -1;
+    }
+
+    // VOS only changes with the PLL off
+    osc.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+    osc.HSIState = RCC_HSI_ON;
+    osc.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
+    osc.PLL.PLLState = RCC_PLL_OFF;
+    if (HAL_RCC_OscConfig(&osc) != HAL_OK) return -1;
+    __HAL_RCC_PWR_CLK_ENABLE();
+    __HAL_PWR_VOLTAGESCALING_CONFIG(p->vos == 3 ? PWR_REGULATOR_VOLTAGE_SCALE3 : PWR_REGULATOR_VOLTAGE_SCALE1);
+
+    osc.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+    osc.PLL.PLLState = RCC_PLL_ON;
+    osc.PLL.PLLSource = RCC_PLLSOURCE_HSI;
+    osc.PLL.PLLM = p->pllm;
+    osc.PLL.PLLN = p->plln;
+    osc.PLL.PLLP = p->pllp;
+    osc.PLL.PLLQ = p->pllq;
+    if (HAL_RCC_OscConfig(&osc) != HAL_OK) return -1;
+
+    // The new scale is reached once the PLL runs
+    start = HAL_GetTick();
+    while (!(PWR->CSR & PWR_CSR_VOSRDY)) {
+        if (HAL_GetTick() - start > CLOCK_RCC_TIMEOUT_MS) return -1;
+    }
+
+    clk.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+    clk.APB1CLKDivider = clock_hclk_div(p->apb1_div);
+    clk.APB2CLKDivider = clock_hclk_div(p->apb2_div);
+    return HAL_RCC_ClockConfig(&clk, p->flash_ws) == HAL_OK ? 0 : -1;
+}
+
+/* Every SYSCLK-derived rate back to its nominal value. The update event
+   restarts the servo period at CNT = 0, so in PWM mode 1 both outputs go
+   high at once and a fresh pulse of the programmed width starts:
+   clock_profile_set() only switches between pulses, so the period cut short
+   was already low and no pulse is stretched or clipped. The pattern timer
+   picks its prescaler up at the next slot, an IR frame in flight is lost and
+   the next key press decodes again. */
+static void clock_retime(const clock_timing_t *t) {
+    htim3.Init.Prescaler = t->tim3_psc;
+    TIM3->PSC = t->tim3_psc;
+    TIM3->EGR = TIM_EGR_UG;
+    htim4.Init.Prescaler = t->tim4_psc;
+    TIM4->PSC = t->tim4_psc;
+    TIM4->EGR = TIM_EGR_UG;
+    htim1.Init.Prescaler = t->tim1_psc;
+    TIM1->PSC = t->tim1_psc;
+
+    USART2->BRR = t->usart2_brr;
+
+    // FREQ, CCR and TRISE are written with the peripheral disabled
+    I2C1->CR1 &= ~I2C_CR1_PE;
+    I2C1->CR2 = (I2C1->CR2 & ~I2C_CR2_FREQ) | t->i2c_freq;
+    I2C1->CCR = t->i2c_ccr;
+    I2C1->TRISE = t->i2c_trise;
+    I2C1->CR1 |= I2C_CR1_PE;
+
+    // Kernel tick: the tick in progress restarts, none is lost
+    SysTick->LOAD = t->systick_load;
+    SysTick->VAL = 0;
+}
+
+int clock_profile_boot(void) {
+    if (clock_timing(&clock_profiles[CLOCK_BOOT], &timing) != 0) return -1;
+    if (clock_rcc(&clock_profiles[CLOCK_BOOT]) != 0) return -1;
+    current = CLOCK_BOOT;
+    return 0;
+}
+
+/* Between servo pulses, with at least CLOCK_SERVO_GUARD_US to go */
+static int clock_servo_idle(void) {
+    uint32_t cnt = TIM3->CNT;
+    uint32_t pulse = TIM3->CCR1 > TIM3->CCR2 ? TIM3->CCR1 : TIM3->CCR2;
+
+    return cnt > pulse && cnt + CLOCK_SERVO_GUARD_US < TIM3->ARR;
+}
+
+int clock_profile_set(clock_profile_id_t id) {
+    clock_timing_t next;
+    clock_profile_id_t prev = current;
+    uint32_t now, primask, cycles;
+    int rc;
+
+    if (id >= CLOCK_PROFILE_COUNT || clock_timing(&clock_profiles[id], &next) != 0) return -1;
+    if (id == current) return 0;
+
+    // A byte still shifting out would go at the wrong baud rate: the line
+    // goes idle (or the wait times out) and stays so until the retime
+    (void)uart_tx_pause(CLOCK_RCC_TIMEOUT_MS);
+
+    for (;;) {
+        osKernelLock();
+        if (clock_servo_idle()) break;
+        osKernelUnlock();
+        clock_profile_stats.servo_waits++;
+        osDelay(1);
+    }
+    // From the park on HSI until the retime, the timers, USART2 and SysTick
+    // run on prescalers meant for another clock: no interrupt may see that.
+    // An edge or a received byte waits, pended, for the unmask.
+    primask = __get_PRIMASK();
+    __disable_irq();
+    cycles = DWT->CYCCNT;
+    rc = clock_rcc(&clock_profiles[id]);
+    if (rc != 0) {
+        // Back to the profile the peripherals are timed for
+        clock_profile_stats.failures++;
+        if (clock_rcc(&clock_profiles[prev]) != 0) Error_Handler();
+        id = prev;
+        next = timing;
+    }
+    clock_retime(&next);
+    cycles = DWT->CYCCNT - cycles;
+    __set_PRIMASK(primask);
+    timing = next;
+    current = id;
+    uart_tx_resume();
+    osKernelUnlock();
+
+#if configUSE_TRACE_RECORDER
+    trace_write(TRC_CLOCK, (uint8_t)(clock_profiles[prev].sysclk_hz / 1000000U),
+                (uint16_t)(clock_profiles[id].sysclk_hz / 1000000U));
+#endif
+    now = osKernelGetTickCount();
+    clock_profile_stats.ms[prev] += now - entered_tick;
+    entered_tick = now;
+    if (rc == 0) clock_profile_stats.switches++;
+    if (cycles > clock_profile_stats.masked_cycles) clock_profile_stats.masked_cycles = cycles;
+    return rc;
+}
+
+/* Full speed whenever the barrier may have to move or is being held */
+clock_profile_id_t clock_profile_for(uint8_t status, uint8_t barrier_up, uint8_t manual) {
+    return (status == RAIN_NORMAL && !barrier_up && !manual) ? CLOCK_LOW : CLOCK_FULL;
+}
+
+static void clock_profile_work(uint32_t arg) {
+    if (clock_profile_set((clock_profile_id_t)arg) != 0) {
+        target = current;       // the next request posts again
+    }
+}
+
+void clock_profile_request(clock_profile_id_t id) {
+    if (id == target) {
+        hold = 0;
+        return;
+    }
+    if (id < target && ++hold < CLOCK_LOW_HOLD_SLOTS) return;
+    if (work_post(clock_profile_work, id) == 0) {
+        target = id;
+        hold = 0;
+    }
+}
@@ -0,0 +1,67 @@
+#include "controller.h"
+
+void controller_init(controller_t *c, const calib_t *cal) {
+    water_ctrl_init(&c->water, cal);
+    barrier_fsm_init(&c->fsm);
+    indicator_init(&c->indicator);
+    c->slot.mm = 0.0f;
+    c->slot.status = RAIN_NORMAL;
+    c->slot.level = BEV_LEVEL_LOW;
+    c->slot.risk = 0;
+    c->indicator_out = NULL;
+    c->servo_out = 0xFF;    // MX_TIM3_Init leaves 1500 us: the first dispatch always writes
+    c->ir_frame = IR_NEC_REPEAT;
+    c->ir_last_ms = 0;
+}
+
+/* State machine, then servo and indicators: the outputs of one event */
+uint8_t controller_dispatch(controller_t *c, uint8_t event) {
+    uint8_t state = c->fsm.state;
+    uint8_t changed = 0;
+    const indicator_out_t *out;
+
+    barrier_fsm_dispatch(&c->fsm, event);
+    if (c->fsm.state != state) changed |= CTRL_STATE;
+    if (c->fsm.servo != c->servo_out) {
+        c->servo_out = c->fsm.servo;
+        changed |= CTRL_SERVO;
+    }
+    // Status LEDs and buzzer: one table lookup, played only on a change
+    out = indicator_update(&c->indicator, c->slot.status, barrier_fsm_raised(&c->fsm), barrier_fsm_manual(&c->fsm));
+    if (out != NULL) {
+        c->indicator_out = out;
+        changed |= CTRL_INDICATOR;
+    }
+    return changed;
+}
+
+uint8_t controller_slot(controller_t *c, uint16_t raw) {
+    uint8_t status = c->slot.status;
+
+    water_ctrl_step(&c->water, raw, &c->slot);
+    return controller_dispatch(c, c->slot.level) | (c->slot.status != status ? CTRL_STATUS : 0);
+}
+
+/* A press is one event however long the key is held; pressed again, it is another */
+uint8_t controller_ir_event(controller_t *c, uint32_t frame, uint32_t now_ms) {
+    uint8_t held = c->ir_frame != IR_NEC_REPEAT && now_ms - c->ir_last_ms <= IR_NEC_HOLD_GAP_MS;
+    ir_frame_t f;
+
+    if (frame == IR_NEC_REPEAT) {
+        // Keeps a press held; a repeat code whose frame was lost starts nothing
+        if (held) c->ir_last_ms = now_ms;
+        return CTRL_NO_EVENT;
+    }
+    if (held && frame == c->ir_frame) {
+        c->ir_last_ms = now_ms;     // remotes that resend the whole frame while held
+        return CTRL_NO_EVENT;
+    }
+    if (ir_nec_frame(frame, &f) != 0) {
+        c->ir_frame = IR_NEC_REPEAT;
+        return CTRL_NO_EVENT;
+    }
+    c->ir_frame = frame;
+    c->ir_last_ms = now_ms;
+    // Learned remotes come with the calibration block the water task last switched to
+    return ir_keymap_lookup(c->water.cal, &f);
+}
@@ -0,0 +1,114 @@
+/* Generated by Tools/gen_fft_tables.py from dsp_config.h (RFFT 128, CFFT -) -- do not edit. */
+#include "arm_math_types.h"
+#include "arm_common_tables.h"
+
+#if defined(ARM_TABLE_TWIDDLECOEF_F32_16) \
+ || defined(ARM_TABLE_TWIDDLECOEF_F32_32) \
+ || defined(ARM_TABLE_TWIDDLECOEF_F32_128) \
+ || defined(ARM_TABLE_TWIDDLECOEF_F32_256) \
+ || defined(ARM_TABLE_TWIDDLECOEF_F32_512) \
+ || defined(ARM_TABLE_TWIDDLECOEF_F32_1024) \
+ || defined(ARM_TABLE_TWIDDLECOEF_F32_2048) \
+ || defined(ARM_TABLE_TWIDDLECOEF_F32_4096) \
+ || defined(ARM_TABLE_BITREVIDX_FLT_16) \
+ || defined(ARM_TABLE_BITREVIDX_FLT_32) \
+ || defined(ARM_TABLE_BITREVIDX_FLT_128) \
+ || defined(ARM_TABLE_BITREVIDX_FLT_256) \
+ || defined(ARM_TABLE_BITREVIDX_FLT_512) \
+ || defined(ARM_TABLE_BITREVIDX_FLT_1024) \
+ || defined(ARM_TABLE_BITREVIDX_FLT_2048) \
+ || defined(ARM_TABLE_BITREVIDX_FLT_4096) \
+ || defined(ARM_TABLE_TWIDDLECOEF_RFFT_F32_32) \
+ || defined(ARM_TABLE_TWIDDLECOEF_RFFT_F32_64) \
+ || defined(ARM_TABLE_TWIDDLECOEF_RFFT_F32_256) \
+ || defined(ARM_TABLE_TWIDDLECOEF_RFFT_F32_512) \
+ || defined(ARM_TABLE_TWIDDLECOEF_RFFT_F32_1024) \
+ || defined(ARM_TABLE_TWIDDLECOEF_RFFT_F32_2048) \
+ || defined(ARM_TABLE_TWIDDLECOEF_RFFT_F32_4096)
+#error "dsp_config.h selects a table missing here: rerun Tools/gen_fft_tables.py"
+#endif
+
+#if defined(ARM_TABLE_TWIDDLECOEF_F32_64)
+const float32_t twiddleCoef_64[128] = {
+    1.000000000e+00f, 0.000000000e+00f, 9.951847267e-01f, 9.801714033e-02f,
+    9.807852804e-01f, 1.950903220e-01f, 9.569403357e-01f, 2.902846773e-01f,
+    9.238795325e-01f, 3.826834324e-01f, 8.819212643e-01f, 4.713967368e-01f,
+    8.314696123e-01f, 5.555702330e-01f, 7.730104534e-01f, 6.343932842e-01f,
+    7.071067812e-01f, 7.071067812e-01f, 6.343932842e-01f, 7.730104534e-01f,
+    5.555702330e-01f, 8.314696123e-01f, 4.713967368e-01f, 8.819212643e-01f,
+    3.826834324e-01f, 9.238795325e-01f, 2.902846773e-01f, 9.569403357e-01f,
+    1.950903220e-01f, 9.807852804e-01f, 9.801714033e-02f, 9.951847267e-01f,
+    0.000000000e+00f, 1.000000000e+00f, -9.801714033e-02f, 9.951847267e-01f,
+    -1.950903220e-01f, 9.807852804e-01f, -2.902846773e-01f, 9.569403357e-01f,
+    -3.826834324e-01f, 9.238795325e-01f, -4.713967368e-01f, 8.819212643e-01f,
+    -5.555702330e-01f, 8.314696123e-01f, -6.343932842e-01f, 7.730104534e-01f,
+    -7.071067812e-01f, 7.071067812e-01f, -7.730104534e-01f, 6.343932842e-01f,
+    -8.314696123e-01f, 5.555702330e-01f, -8.819212643e-01f, 4.713967368e-01f,
+    -9.238795325e-01f, 3.826834324e-01f, -9.569403357e-01f, 2.902846773e-01f,
+    -9.807852804e-01f, 1.950903220e-01f, -9.951847267e-01f, 9.801714033e-02f,
+    -1.000000000e+00f, 0.000000000e+00f, -9.951847267e-01f, -9.801714033e-02f,
+    -9.807852804e-01f, -1.950903220e-01f, -9.569403357e-01f, -2.902846773e-01f,
+    -9.238795325e-01f, -3.826834324e-01f, -8.819212643e-01f, -4.713967368e-01f,
+    -8.314696123e-01f, -5.555702330e-01f, -7.730104534e-01f, -6.343932842e-01f,
+    -7.071067812e-01f, -7.071067812e-01f, -6.343932842e-01f, -7.730104534e-01f,
+    -5.555702330e-01f, -8.314696123e-01f, -4.713967368e-01f, -8.819212643e-01f,
+    -3.826834324e-01f, -9.238795325e-01f, -2.902846773e-01f, -9.569403357e-01f,
+    -1.950903220e-01f, -9.807852804e-01f, -9.801714033e-02f, -9.951847267e-01f,
+    0.000000000e+00f, -1.000000000e+00f, 9.801714033e-02f, -9.951847267e-01f,
+    1.950903220e-01f, -9.807852804e-01f, 2.902846773e-01f, -9.569403357e-01f,
+    3.826834324e-01f, -9.238795325e-01f, 4.713967368e-01f, -8.819212643e-01f,
+    5.555702330e-01f, -8.314696123e-01f, 6.343932842e-01f, -7.730104534e-01f,
+    7.071067812e-01f, -7.071067812e-01f, 7.730104534e-01f, -6.343932842e-01f,
+    8.314696123e-01f, -5.555702330e-01f, 8.819212643e-01f, -4.713967368e-01f,
+    9.238795325e-01f, -3.826834324e-01f, 9.569403357e-01f, -2.902846773e-01f,
+    9.807852804e-01f, -1.950903220e-01f, 9.951847267e-01f, -9.801714033e-02f,
+};
+#endif
+
+#if defined(ARM_TABLE_BITREVIDX_FLT_64)
+const uint16_t armBitRevIndexTable64[56] = {
+    8, 64, 16, 128, 24, 192, 32, 256, 40, 320, 48, 384,
+    56, 448, 80, 136, 88, 200, 96, 264, 104, 328, 112, 392,
+    120, 456, 152, 208, 160, 272, 168, 336, 176, 400, 184, 464,
+    224, 280, 232, 344, 240, 408, 248, 472, 296, 352, 304, 416,
+    312, 480, 368, 424, 376, 488, 440, 496,
+};
+#endif
+
+#if defined(ARM_TABLE_TWIDDLECOEF_RFFT_F32_128)
+const float32_t twiddleCoef_rfft_128[128] = {
+    0.000000000e+00f, 1.000000000e+00f, 4.906767433e-02f, 9.987954562e-01f,
+    9.801714033e-02f, 9.951847267e-01f, 1.467304745e-01f, 9.891765100e-01f,
+    1.950903220e-01f, 9.807852804e-01f, 2.429801799e-01f, 9.700312532e-01f,
+    2.902846773e-01f, 9.569403357e-01f, 3.368898534e-01f, 9.415440652e-01f,
+    3.826834324e-01f, 9.238795325e-01f, 4.275550934e-01f, 9.039892931e-01f,
+    4.713967368e-01f, 8.819212643e-01f, 5.141027442e-01f, 8.577286100e-01f,
+    5.555702330e-01f, 8.314696123e-01f, 5.956993045e-01f, 8.032075315e-01f,
+    6.343932842e-01f, 7.730104534e-01f, 6.715589548e-01f, 7.409511254e-01f,
+    7.071067812e-01f, 7.071067812e-01f, 7.409511254e-01f, 6.715589548e-01f,
+    7.730104534e-01f, 6.343932842e-01f, 8.032075315e-01f, 5.956993045e-01f,
+    8.314696123e-01f, 5.555702330e-01f, 8.577286100e-01f, 5.141027442e-01f,
+    8.819212643e-01f, 4.713967368e-01f, 9.039892931e-01f, 4.275550934e-01f,
+    9.238795325e-01f, 3.826834324e-01f, 9.415440652e-01f, 3.368898534e-01f,
+    9.569403357e-01f, 2.902846773e-01f, 9.700312532e-01f, 2.429801799e-01f,
+    9.807852804e-01f, 1.950903220e-01f, 9.891765100e-01f, 1.467304745e-01f,
+    9.951847267e-01f, 9.801714033e-02f, 9.987954562e-01f, 4.906767433e-02f,
+    1.000000000e+00f, 0.000000000e+00f, 9.987954562e-01f, -4.906767433e-02f,
+    9.951847267e-01f, -9.801714033e-02f, 9.891765100e-01f, -1.467304745e-01f,
+    9.807852804e-01f, -1.950903220e-01f, 9.700312532e-01f, -2.429801799e-01f,
+    9.569403357e-01f, -2.902846773e-01f, 9.415440652e-01f, -3.368898534e-01f,
+    9.238795325e-01f, -3.826834324e-01f, 9.039892931e-01f, -4.275550934e-01f,
+    8.819212643e-01f, -4.713967368e-01f, 8.577286100e-01f, -5.141027442e-01f,
+    8.314696123e-01f, -5.555702330e-01f, 8.032075315e-01f, -5.956993045e-01f,
+    7.730104534e-01f, -6.343932842e-01f, 7.409511254e-01f, -6.715589548e-01f,
+    7.071067812e-01f, -7.071067812e-01f, 6.715589548e-01f, -7.409511254e-01f,
+    6.343932842e-01f, -7.730104534e-01f, 5.956993045e-01f, -8.032075315e-01f,
+    5.555702330e-01f, -8.314696123e-01f, 5.141027442e-01f, -8.577286100e-01f,
+    4.713967368e-01f, -8.819212643e-01f, 4.275550934e-01f, -9.039892931e-01f,
+    3.826834324e-01f, -9.238795325e-01f, 3.368898534e-01f, -9.415440652e-01f,
+    2.902846773e-01f, -9.569403357e-01f, 2.429801799e-01f, -9.700312532e-01f,
+    1.950903220e-01f, -9.807852804e-01f, 1.467304745e-01f, -9.891765100e-01f,
+    9.801714033e-02f, -9.951847267e-01f, 4.906767433e-02f, -9.987954562e-01f,
+};
+#endif
+
@@ -0,0 +1,71 @@
+#include "flood_risk.h"
+#include <math.h>
+
+#define SENSOR_MAX_MM  40.0f
+
+/* [-1, 1] -> int8 with scale 1/127, zero point 0 (model input quantisation) */
+static int8_t flood_risk_q(float x) {
+    if (x > 1.0f) x = 1.0f;
+    if (x < -1.0f) x = -1.0f;
+    return (int8_t)lroundf(x * 127.0f);
+}
+
+static void flood_risk_eval(flood_risk_instance_t *S) {
+    int8_t in[FLOOD_RISK_HIST + 2];
+    float lvl;
+
+    for (int i = 0; i < FLOOD_RISK_HIST; i++) {
+        lvl = S->hist[i] / SENSOR_MAX_MM;
+        if (lvl > 1.0f) lvl = 1.0f;
+        if (lvl < 0.0f) lvl = 0.0f;
+        in[i] = flood_risk_q(lvl * 2.0f - 1.0f);
+    }
+    in[FLOOD_RISK_HIST] = flood_risk_q((S->hist[FLOOD_RISK_HIST - 1] - S->hist[FLOOD_RISK_HIST - 3])
+                                       / 2.0f / FLOOD_RISK_RATE_FULL);
+    in[FLOOD_RISK_HIST + 1] = flood_risk_q((S->hist[FLOOD_RISK_HIST - 1] - S->hist[0])
+                                           / (FLOOD_RISK_HIST - 1.0f) / FLOOD_RISK_RATE_FULL);
+
+    if (nn_run(&S->nn, in, S->probs) != 0) return;
+
+    // Softmax output: scale 1/256, zero point -128
+    S->risk = (uint8_t)(S->probs[FLOOD_RISK_FLOOD] + 128);
+    S->risk_class = FLOOD_RISK_SAFE;
+    if (S->probs[FLOOD_RISK_RISING] > S->probs[S->risk_class]) S->risk_class = FLOOD_RISK_RISING;
+    if (S->probs[FLOOD_RISK_FLOOD] > S->probs[S->risk_class]) S->risk_class = FLOOD_RISK_FLOOD;
+}
+
+int flood_risk_init(flood_risk_instance_t *S) {
+    S->hist_fill = 0;
+    S->decim_sum = 0.0f;
+    S->decim_n = 0;
+    S->risk = 0;
+    S->risk_class = FLOOD_RISK_SAFE;
+    S->ready = (nn_init(&S->nn, &flood_risk_model) == 0);
+    return S->ready ? 0 : -1;
+}
+
+/* Feed one level sample (10 Hz); the network runs once per history step */
+void flood_risk_push(flood_risk_instance_t *S, float level_mm) {
+    S->decim_sum += level_mm;
+    if (++S->decim_n < FLOOD_RISK_DECIM) return;
+
+    level_mm = S->decim_sum / FLOOD_RISK_DECIM;
+    S->decim_sum = 0.0f;
+    S->decim_n = 0;
+
+    if (S->hist_fill < FLOOD_RISK_HIST) {
+        S->hist[S->hist_fill++] = level_mm;
+    } else {
+        for (int i = 1; i < FLOOD_RISK_HIST; i++) S->hist[i - 1] = S->hist[i];
+        S->hist[FLOOD_RISK_HIST - 1] = level_mm;
+    }
+    if (S->ready && S->hist_fill == FLOOD_RISK_HIST) flood_risk_eval(S);
+}
+
+uint8_t flood_risk_get(const flood_risk_instance_t *S) {
+    return S->risk;
+}
+
+flood_risk_class_t flood_risk_class(const flood_risk_instance_t *S) {
+    return S->risk_class;
+}
@@ -0,0 +1,58 @@
+/* Generated by Tools/train_flood_risk.py (synthetic, 6000 samples, seed 7) -- do not edit. */
+#include "flood_risk.h"
+
+static const int8_t fc0_weights[120] = {
+    -50, -20, -35, 17, -33, -58, -23, -51, -26, -36, 33, 48,
+    9, 12, 1, 33, 19, 13, -19, -16, -25, 7, 13, 14,
+    4, 8, -29, -4, -20, -17, -5, 2, 24, -12, 0, 65,
+    57, 52, 39, 83, 0, -19, 1, 6, -5, -19, -13, -23,
+    -65, -79, 1, -12, -16, 5, -24, -11, -14, -24, -27, -22,
+    -7, -17, 20, 20, 15, 0, -7, -5, -28, -29, -28, -16,
+    -21, -34, 14, 26, 26, 26, 44, 62, 12, -14, 24, -1,
+    8, 40, 15, 48, -3, 56, -24, -24, -18, -23, 9, 13,
+    57, -4, 40, 127, -25, -32, 0, -16, 3, 14, -14, 22,
+    64, 31, 20, -8, 3, 5, 8, 14, 46, -12, -49, 38,
+};
+static const int32_t fc0_bias[12] = {
+    -2978, -12468, 2292, -2430, 4688, -890, 1792, -733,
+    -3006, -1345, -4688, 7818,
+};
+
+static const int8_t fc1_weights[96] = {
+    25, -16, 12, -55, 50, 43, 29, -10, -62, -28, -61, -32,
+    -13, 27, -27, -18, 56, -1, 29, 15, 23, 16, -24, -35,
+    -61, 127, -31, 66, -52, 37, -40, 35, 22, 75, -38, -3,
+    47, 9, 38, -29, 69, 11, -18, -28, 37, -22, -13, -97,
+    -114, 20, 29, -109, 41, -47, 15, -47, -67, -23, -49, 19,
+    -39, -16, 29, 5, -22, -16, -40, -27, -35, -49, -18, 15,
+    14, 95, -13, 54, -15, 30, 27, 43, 32, 49, 47, 61,
+    -117, 25, 29, -26, -8, -37, 6, 23, -7, 55, 31, 88,
+};
+static const int32_t fc1_bias[8] = {
+    3572, 1329, -4990, 1004, 2176, -977, -3188, 2803,
+};
+
+static const int8_t fc2_weights[24] = {
+    56, 14, 10, 81, -51, 22, -82, -127, 17, 0, -36, 2,
+    62, 12, -5, 42, -100, -28, 72, -37, -57, -37, 61, 67,
+};
+static const int32_t fc2_bias[3] = {
+    -1763, 4688, -2925,
+};
+
+static const nn_tensor_t tensors[] = {
+    { 10 }, { 12 }, { 8 }, { 3 }, { 3 },
+};
+
+static const nn_layer_t layers[] = {
+    { NN_OP_FULLY_CONNECTED, 0, 1, fc0_weights, fc0_bias, 0, -128, 1088520076, -6, -128, 127, 0 },
+    { NN_OP_FULLY_CONNECTED, 1, 2, fc1_weights, fc1_bias, 128, -128, 1942462969, -7, -128, 127, 0 },
+    { NN_OP_FULLY_CONNECTED, 2, 3, fc2_weights, fc2_bias, 128, 0, 1936368256, -8, -128, 127, 0 },
+    { NN_OP_SOFTMAX, 3, 4, NULL, NULL, 0, 0, 1924256235, 23, 0, 0, -248 },
+};
+
+const nn_model_t flood_risk_model = {
+    tensors, sizeof(tensors) / sizeof(tensors[0]),
+    layers, sizeof(layers) / sizeof(layers[0]),
+    0, 4,
+};
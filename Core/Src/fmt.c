@@ -0,0 +1,71 @@
+#include "fmt.h"
+
+#define FMT_DIGITS_MAX  10      // 4294967295
+
+/* Digits of v, least significant first; returns the count */
+static uint32_t fmt_digits(char *rev, uint32_t v) {
+    uint32_t n = 0;
+
+    do {
+        rev[n++] = (char)('0' + v % 10U);
+        v /= 10U;
+    } while (v != 0);
+    return n;
+}
+
+/* Sign, digits with a point before the last `frac` of them, right aligned */
+static char *fmt_number(char *dst, uint32_t mag, uint8_t neg, uint8_t frac, uint8_t width) {
+    char rev[FMT_DIGITS_MAX + 1];
+    uint32_t n = fmt_digits(rev, mag);
+    uint32_t len;
+
+    while (n <= frac) rev[n++] = '0';           // at least one digit before the point
+    len = n + (frac ? 1U : 0U) + neg;
+    if (width == 0) {
+        width = (uint8_t)len;
+    } else if (len > width) {
+        for (uint32_t i = 0; i < width; i++) dst[i] = FMT_OVERFLOW;
+        return dst + width;
+    }
+
+    for (uint32_t i = len; i < width; i++) *dst++ = ' ';
+    if (neg) *dst++ = '-';
+    while (n > 0) {
+        if (frac && n == frac) *dst++ = '.';
+        *dst++ = rev[--n];
+    }
+    return dst;
+}
+
+char *fmt_uint(char *dst, uint32_t v, uint8_t width) {
+    return fmt_number(dst, v, 0, 0, width);
+}
+
+char *fmt_int(char *dst, int32_t v, uint8_t width) {
+    return fmt_fixed(dst, v, 0, width);
+}
+
+char *fmt_fixed(char *dst, int32_t v, uint8_t frac_digits, uint8_t width) {
+    // Magnitude in unsigned arithmetic: INT32_MIN has no positive counterpart
+    uint32_t mag = v < 0 ? 0U - (uint32_t)v : (uint32_t)v;
+
+    if (frac_digits > FMT_DIGITS_MAX - 1) frac_digits = FMT_DIGITS_MAX - 1;
+    return fmt_number(dst, mag, v < 0, frac_digits, width);
+}
+
+char *fmt_str(char *dst, const char *s, uint8_t width) {
+    uint32_t i = 0;
+
+    if (width == 0) {
+        while (*s) *dst++ = *s++;
+        return dst;
+    }
+    for (; i < width && s[i]; i++) dst[i] = s[i];
+    for (; i < width; i++) dst[i] = ' ';
+    return dst + width;
+}
+
+char *fmt_copy(char *dst, const char *s, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) dst[i] = s[i];
+    return dst + n;
+}
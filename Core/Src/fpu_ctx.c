@@ -0,0 +1,40 @@
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if configUSE_FPU_CTX_STATS
+#include "fpu_ctx.h"
+
+fpu_ctx_stats_t fpu_ctx;
+
+/* The task tag points at the task's entry, so the switch hook needs no lookup */
+void fpu_ctx_declare(void *task, uint8_t uses_fpu) {
+    fpu_ctx_task_t *entry;
+
+    if (task == NULL || fpu_ctx.ntasks >= FPU_CTX_MAX_TASKS) return;
+    entry = &fpu_ctx.tasks[fpu_ctx.ntasks++];
+    entry->task = task;
+    entry->uses_fpu = uses_fpu;
+    vTaskSetApplicationTaskTag((TaskHandle_t)task, (TaskHookFunction_t)entry);
+}
+
+/* Runs inside vTaskSwitchContext, scheduler locked by BASEPRI */
+void fpu_ctx_switched_out(void *task, void *tag, const uint32_t *top_of_stack) {
+    fpu_ctx_task_t *entry = (fpu_ctx_task_t *)tag;
+    uint8_t fpu = (top_of_stack[FPU_CTX_EXC_RETURN_SLOT] & FPU_CTX_EXC_RETURN_BASIC) == 0;
+
+    fpu_ctx.switches++;
+    fpu_ctx.fpu_saves += fpu;
+    if (entry == NULL) return;      // undeclared (idle, kernel tasks)
+
+    entry->switches++;
+    entry->fpu_saves += fpu;
+    if (fpu && !entry->uses_fpu) {
+        fpu_ctx.violations++;
+        fpu_ctx.last_violator = task;
+#if FPU_CTX_ASSERT
+        configASSERT(0);
+#endif
+    }
+}
+
+#endif // configUSE_FPU_CTX_STATS
@@ -0,0 +1,48 @@
+#include "indicator.h"
+
+#define OUT(steady, pattern)  { (steady), (pattern) }
+
+// Green only for a safe level with automatic control; with the barrier up
+// the flood (automatic) or manual (IR override) pattern wins over the level.
+// Manual mode without the barrier up does not occur (lowering ends it), so
+// those rows are the emergency stop: servo off, flood alarm kept on.
+const indicator_out_t indicator_table[INDICATOR_STATES] = {
+    [INDICATOR_STATE(RAIN_NORMAL,     0, 0)] = OUT(PATTERN_GREEN, PATTERN_OFF),
+    [INDICATOR_STATE(RAIN_WARNING,    0, 0)] = OUT(0,             PATTERN_WARNING),
+    [INDICATOR_STATE(RAIN_FLOOD,      0, 0)] = OUT(0,             PATTERN_OFF),
+    [INDICATOR_STATE(RAIN_SENSOR_ERR, 0, 0)] = OUT(0,             PATTERN_OFF),
+    [INDICATOR_STATE(RAIN_NORMAL,     1, 0)] = OUT(PATTERN_GREEN, PATTERN_FLOOD),
+    [INDICATOR_STATE(RAIN_WARNING,    1, 0)] = OUT(0,             PATTERN_FLOOD),
+    [INDICATOR_STATE(RAIN_FLOOD,      1, 0)] = OUT(0,             PATTERN_FLOOD),
+    [INDICATOR_STATE(RAIN_SENSOR_ERR, 1, 0)] = OUT(0,             PATTERN_FLOOD),
+    [INDICATOR_STATE(RAIN_NORMAL,     0, 1)] = OUT(0,             PATTERN_FLOOD),
+    [INDICATOR_STATE(RAIN_WARNING,    0, 1)] = OUT(0,             PATTERN_FLOOD),
+    [INDICATOR_STATE(RAIN_FLOOD,      0, 1)] = OUT(0,             PATTERN_FLOOD),
+    [INDICATOR_STATE(RAIN_SENSOR_ERR, 0, 1)] = OUT(0,             PATTERN_FLOOD),
+    [INDICATOR_STATE(RAIN_NORMAL,     1, 1)] = OUT(0,             PATTERN_MANUAL),
+    [INDICATOR_STATE(RAIN_WARNING,    1, 1)] = OUT(0,             PATTERN_MANUAL),
+    [INDICATOR_STATE(RAIN_FLOOD,      1, 1)] = OUT(0,             PATTERN_MANUAL),
+    [INDICATOR_STATE(RAIN_SENSOR_ERR, 1, 1)] = OUT(0,             PATTERN_MANUAL),
+};
+
+void indicator_init(indicator_t *ind) {
+    ind->last = 0xFF;
+    ind->stats.updates = 0;
+    ind->stats.writes = 0;
+}
+
+const indicator_out_t *indicator_update(indicator_t *ind, uint8_t status, uint8_t barrier_up, uint8_t manual) {
+    uint8_t state = INDICATOR_STATE(status, barrier_up, manual);
+    const indicator_out_t *out = &indicator_table[state];
+
+    ind->stats.updates++;
+    if (ind->last != 0xFF &&
+        indicator_table[ind->last].steady == out->steady &&
+        indicator_table[ind->last].pattern == out->pattern) {
+        ind->last = state;
+        return NULL;
+    }
+    ind->last = state;
+    ind->stats.writes++;
+    return out;
+}
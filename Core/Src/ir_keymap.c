@@ -0,0 +1,27 @@
+#include "ir_keymap.h"
+#include "barrier_fsm.h"
+
+uint8_t ir_keymap_lookup(const calib_t *cal, const ir_frame_t *f) {
+    uint32_t key = (uint32_t)f->address << 8 | f->command;
+    uint8_t i;
+
+    // Learned remotes first: a site may re-teach the built-in address
+    for (i = 0; i < cal->ir_remotes; i++) {
+        const calib_ir_remote_t *r = &cal->ir[i];
+        if (r->address != f->address) continue;
+        for (uint8_t k = 0; k < CALIB_IR_KEYS; k++) {
+            if (r->command[k] == f->command) return BEV_IR_UP + k;
+        }
+        return BEV_IR_TOGGLE;
+    }
+
+    i = ir_hash_slot[(key * ir_hash_seed) >> (32 - IR_HASH_BITS)];
+    if (i != 0 && ir_keys[i - 1].address == f->address && ir_keys[i - 1].command == f->command) {
+        return ir_keys[i - 1].event;
+    }
+    // Misses only: is it the built-in remote at all
+    for (i = 0; i < ir_key_count; i++) {
+        if (ir_keys[i].address == f->address) return BEV_IR_TOGGLE;
+    }
+    return BARRIER_EVENTS;
+}
@@ -0,0 +1,18 @@
+/* Generated by Tools/gen_ir_keymap.py -- do not edit. */
+#include "ir_keymap.h"
+#include "barrier_fsm.h"
+
+const ir_key_t ir_keys[] = {
+    { 0xFF00, 0x47, BEV_IR_UP     },   // CH+
+    { 0xFF00, 0x45, BEV_IR_DOWN   },   // CH-
+    { 0xFF00, 0x46, BEV_IR_STOP   },   // CH
+    { 0xFF00, 0x43, BEV_IR_AUTO   },   // play/pause
+    { 0xFF00, 0x09, BEV_IR_ESTOP  },   // EQ
+};
+const uint8_t ir_key_count = sizeof(ir_keys) / sizeof(ir_keys[0]);
+
+const uint32_t ir_hash_seed = 0x9E3779B1U;
+// Slot -> key index + 1, 0 for an empty slot
+const uint8_t ir_hash_slot[1 << IR_HASH_BITS] = {
+    0, 1, 0, 0, 0, 0, 0, 3, 0, 4, 0, 0, 5, 2, 0, 0,
+};
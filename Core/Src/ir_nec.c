@@ -0,0 +1,50 @@
+#include "ir_nec.h"
+
+#define IR_NEC_IDLE     0xFF
+
+void ir_nec_init(ir_nec_rx_t *rx) {
+    rx->word = 0;
+    rx->bits = IR_NEC_IDLE;
+    rx->frames = 0;
+    rx->last = IR_NEC_REPEAT;
+    rx->errors = 0;
+}
+
+ir_nec_result_t ir_nec_edge(ir_nec_rx_t *rx, uint32_t us) {
+    // A leader or a repeat restarts the receiver wherever it was: a frame cut short is dropped
+    if (us >= IR_NEC_LEADER_MIN_US && us <= IR_NEC_LEADER_MAX_US) {
+        rx->word = 0;
+        rx->bits = 0;
+        return IR_NEC_NONE;
+    }
+    if (us >= IR_NEC_REPEAT_MIN_US && us < IR_NEC_LEADER_MIN_US) {
+        rx->bits = IR_NEC_IDLE;
+        return IR_NEC_HOLD;
+    }
+    if (rx->bits == IR_NEC_IDLE) return IR_NEC_NONE;    // gap between frames
+
+    if (us >= IR_NEC_ONE_MIN_US && us <= IR_NEC_ONE_MAX_US) {
+        rx->word |= 1UL << rx->bits;
+    } else if (us < IR_NEC_ZERO_MIN_US || us > IR_NEC_ZERO_MAX_US) {
+        rx->bits = IR_NEC_IDLE;
+        rx->errors++;
+        return IR_NEC_NONE;
+    }
+    if (++rx->bits < 32) return IR_NEC_NONE;
+
+    rx->bits = IR_NEC_IDLE;
+    if ((((rx->word >> 16) ^ (rx->word >> 24)) & 0xFF) != 0xFF) {
+        rx->errors++;
+        return IR_NEC_NONE;
+    }
+    rx->last = rx->word;
+    rx->frames++;
+    return IR_NEC_FRAME;
+}
+
+int ir_nec_frame(uint32_t word, ir_frame_t *f) {
+    if ((((word >> 16) ^ (word >> 24)) & 0xFF) != 0xFF) return -1;
+    f->address = (uint16_t)word;
+    f->command = (uint8_t)(word >> 16);
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "kernel_bench.h"
+#include "FreeRTOS.h"
+#include "cmsis_os.h"
+#include "stm32f4xx_hal.h"
+#include "fpu_ctx.h"
+#include "fmt.h"
+#include "uart_tx.h"
+
+#define KBENCH_FLAG_TASK  0x1U
+#define KBENCH_FLAG_ISR   0x2U
+#define KBENCH_FLAG_FPU   0x4U
+
+kernel_bench_t kernel_bench;
+
+static osThreadId_t waiter;
+static osThreadId_t waiter_fpu;
+static volatile uint32_t stamp;
+
+static const osThreadAttr_t waiter_attributes = {
+  .name = "kb_wait",
+  .priority = (osPriority_t) osPriorityNormal1,
+  .stack_size = 128 * 4
+};
+static const osThreadAttr_t waiter_fpu_attributes = {
+  .name = "kb_wait_fpu",
+  .priority = (osPriority_t) osPriorityNormal1,
+  .stack_size = 128 * 4
+};
+static const osThreadAttr_t driver_attributes = {
+  .name = "kb_drive",
+  .priority = (osPriority_t) osPriorityNormal,
+  .stack_size = 256 * 4
+};
+
+static void kbench_add(kbench_stat_t *s, uint32_t cycles) {
+    if (s->n == 0 || cycles < s->min) s->min = cycles;
+    if (cycles > s->max) s->max = cycles;
+    s->sum += cycles;
+    s->n++;
+}
+
+void EXTI0_IRQHandler(void) {
+    osThreadFlagsSet(waiter, KBENCH_FLAG_ISR);
+}
+
+static void kbench_waiter(void *argument) {
+    for (;;) {
+        uint32_t flags = osThreadFlagsWait(KBENCH_FLAG_TASK | KBENCH_FLAG_ISR, osFlagsWaitAny, osWaitForever);
+        uint32_t now = DWT->CYCCNT;
+
+        kbench_add((flags & KBENCH_FLAG_ISR) ? &kernel_bench.isr_to_task : &kernel_bench.task_switch,
+                   now - stamp);
+    }
+}
+
+/* "min/avg/max" of one statistic */
+static char *kbench_fmt(char *p, const kbench_stat_t *s) {
+    p = fmt_uint(p, s->min, 0);
+    p = fmt_lit(p, "/");
+    p = fmt_uint(p, s->n ? s->sum / s->n : 0, 0);
+    p = fmt_lit(p, "/");
+    return fmt_uint(p, s->max, 0);
+}
+
+/* Keeps live FPU state across every block, like the water task */
+static void kbench_waiter_fpu(void *argument) {
+    volatile float acc = 1.0f;
+
+    for (;;) {
+        osThreadFlagsWait(KBENCH_FLAG_FPU, osFlagsWaitAny, osWaitForever);
+        kbench_add(&kernel_bench.task_switch_fpu, DWT->CYCCNT - stamp);
+        acc = acc * 1.0001f + 0.5f;
+    }
+}
+
+static void kbench_driver(void *argument) {
+    char line[192];
+    char *p;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    HAL_NVIC_SetPriority(EXTI0_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(EXTI0_IRQn);
+
+    for (int i = 0; i < KBENCH_ROUNDS; i++) {
+        // The waiter preempts inside each call; control is back here once it blocks again
+        stamp = DWT->CYCCNT;
+        osThreadFlagsSet(waiter, KBENCH_FLAG_TASK);
+
+        stamp = DWT->CYCCNT;
+        NVIC_SetPendingIRQ(EXTI0_IRQn);
+        __DSB();
+        __ISB();
+
+        stamp = DWT->CYCCNT;
+        osThreadFlagsSet(waiter_fpu, KBENCH_FLAG_FPU);
+
+        if ((i & 63) == 0) osDelay(1);  // spread the rounds over tick phases
+    }
+    HAL_NVIC_DisableIRQ(EXTI0_IRQn);
+    kernel_bench.done = 1;
+
+    // 2 + 2 digit settings, 9 counters of at most 10 digits: fits the line
+    p = fmt_lit(line, "kbench lean=");
+    p = fmt_uint(p, configKERNEL_LEAN, 0);
+    p = fmt_lit(p, " prios=");
+    p = fmt_uint(p, configMAX_PRIORITIES, 0);
+    p = fmt_lit(p, ": switch ");
+    p = kbench_fmt(p, &kernel_bench.task_switch);
+    p = fmt_lit(p, " cyc, fpu switch ");
+    p = kbench_fmt(p, &kernel_bench.task_switch_fpu);
+    p = fmt_lit(p, " cyc, isr->task ");
+    p = kbench_fmt(p, &kernel_bench.isr_to_task);
+    p = fmt_lit(p, " cyc (min/avg/max)\r\n");
+    uart_tx_write(line, (uint32_t)(p - line), UART_TX_WAIT_MS);
+
+    for (;;) {
+        osDelay(osWaitForever);
+    }
+}
+
+void kernel_bench_start(void) {
+    osThreadId_t driver;
+
+    waiter = osThreadNew(kbench_waiter, NULL, &waiter_attributes);
+    waiter_fpu = osThreadNew(kbench_waiter_fpu, NULL, &waiter_fpu_attributes);
+    driver = osThreadNew(kbench_driver, NULL, &driver_attributes);
+#if configUSE_FPU_CTX_STATS
+    fpu_ctx_declare(waiter, 0);
+    fpu_ctx_declare(waiter_fpu, 1);
+    fpu_ctx_declare(driver, 0);
+#else
+    (void)driver;
+#endif
+}
@@ -14,21 +14,51 @@ void lcd_send_internal(uint8_t data, uint8_t flags);
 void lcd_send_cmd(uint8_t cmd);
 void lcd_send_byte(uint8_t data);
 
-void lcd_init(void) {
-    HAL_Delay(100);
-    for (int i = 0; i < 3; i++) {
-        lcd_send_raw_cmd(0x30);
-        HAL_Delay(i == 0 ? 5 : 1);
+/* HD44780 4-bit init as a table, so it can run without blocking: the wait
+   after each command is left to the caller (lcd_init_step) */
+#define LCD_POWERUP_MS  100     // datasheet: >40 ms after Vcc reaches 2.7 V
+#define LCD_OP_WAIT     0
+#define LCD_OP_RAW      1       // high nibble only (still in 8-bit mode)
+#define LCD_OP_CMD      2
+
+typedef struct {
+    uint8_t op;
+    uint8_t value;
+    uint8_t wait_ms;
+} lcd_init_op_t;
+
+static const lcd_init_op_t lcd_init_seq[] = {
+    { LCD_OP_WAIT, 0x00, LCD_POWERUP_MS },
+    { LCD_OP_RAW,  0x30, 5 },
+    { LCD_OP_RAW,  0x30, 1 },
+    { LCD_OP_RAW,  0x30, 1 },
+    { LCD_OP_RAW,  0x20, 1 },   // 4-bit mode
+    { LCD_OP_CMD,  0x28, 0 },   // Function set: 4-bit, 2-line, 5x8 dots
+    { LCD_OP_CMD,  0x08, 0 },   // Display off
+    { LCD_OP_CMD,  0x01, 2 },   // Clear display
+    { LCD_OP_CMD,  0x06, 0 },   // Entry mode set: increment, no shift
+    { LCD_OP_CMD,  0x0C, 0 },   // Display on, cursor off, blink off
+};
+static uint8_t lcd_init_pos;
+
+uint32_t lcd_init_step(void) {
+    while (lcd_init_pos < sizeof(lcd_init_seq) / sizeof(lcd_init_seq[0])) {
+        const lcd_init_op_t *op = &lcd_init_seq[lcd_init_pos++];
+
+        if (op->op == LCD_OP_RAW) lcd_send_raw_cmd(op->value);
+        else if (op->op == LCD_OP_CMD) lcd_send_cmd(op->value);
+        if (op->wait_ms) return op->wait_ms;
     }
-    lcd_send_raw_cmd(0x20); // 4-bit mode
-    HAL_Delay(1);
+    return 0;
+}
 
-    lcd_send_cmd(0x28); // Function set: 4-bit, 2-line, 5x8 dots
-    lcd_send_cmd(0x08); // Display off
-    lcd_send_cmd(0x01); // Clear display
-    HAL_Delay(2);
-    lcd_send_cmd(0x06); // Entry mode set: increment, no shift
-    lcd_send_cmd(0x0C); // Display on, cursor off, blink off
+void lcd_init(void) {
+    uint32_t wait;
+
+    lcd_init_pos = 0;
+    while ((wait = lcd_init_step()) != 0) {
+        HAL_Delay(wait);
+    }
 }
 
 void lcd_send_cmd(uint8_t cmd) {
@@ -0,0 +1,88 @@
+#include "level_comp.h"
+
+#define LEVEL_COMP_MV_MIN   1700    // VDDA operating range of the part
+#define LEVEL_COMP_MV_MAX   3600
+#define LEVEL_COMP_T_MIN_C  (-40)
+#define LEVEL_COMP_T_MAX_C  125
+#define LEVEL_COMP_GAIN_MAX 0x1FFFFU    // just under 2.0: raw * gain stays in 32 bits
+
+void level_comp_init(level_comp_t *c, const level_comp_factory_t *fac) {
+    c->fac = *fac;
+    // Blank or foreign system memory: VREFINT is ~1500 counts, the sensor ~940 at 30 degC and ~250 more at 110
+    c->valid = fac->vrefint > 1300 && fac->vrefint < 1700 && fac->ts_30 > 700 && fac->ts_30 < 1200 &&
+               fac->ts_110 > fac->ts_30 + 100 && fac->ts_110 < fac->ts_30 + 400;
+    c->primed = 0;
+    c->vref_avg = (uint32_t)fac->vrefint << LEVEL_COMP_AVG_SHIFT;
+    c->ts_avg = (uint32_t)fac->ts_30 << LEVEL_COMP_AVG_SHIFT;
+    c->temp_q8 = LEVEL_COMP_T0_C * 256;
+    c->vdda_mv = LEVEL_COMP_CAL_MV;
+    c->gain_q16 = 1U << 16;
+    c->refs = 0;
+    c->rejects = 0;
+}
+
+/* VDDA now / VDDA at calibration, Q16, from VREFINT counts << LEVEL_COMP_AVG_SHIFT
+   (VREFINT is fixed, so its counts fall as VDDA rises) */
+static uint32_t level_comp_ratio_q16(const level_comp_t *c, uint32_t vref) {
+    return ((uint32_t)c->fac.vrefint << (16 + LEVEL_COMP_AVG_SHIFT)) / vref;
+}
+
+/* Die temperature, degC * 256, from sensor counts taken at the given VDDA ratio */
+static int32_t level_comp_temp_q8(const level_comp_t *c, uint32_t ts, uint32_t ratio_q16) {
+    int32_t at_cal = (int32_t)(((uint64_t)ts * ratio_q16) >> 16);     // counts at 3.3 V, << LEVEL_COMP_AVG_SHIFT
+    int32_t span = (int32_t)(c->fac.ts_110 - c->fac.ts_30) << LEVEL_COMP_AVG_SHIFT;
+
+    return 30 * 256 + (at_cal - ((int32_t)c->fac.ts_30 << LEVEL_COMP_AVG_SHIFT)) * (80 * 256) / span;
+}
+
+int level_comp_ref(level_comp_t *c, uint16_t vref, uint16_t ts) {
+    uint32_t ratio;
+    int32_t temp, dt;
+    int64_t poly;
+
+    if (!c->valid || vref == 0) {
+        c->rejects++;
+        return -1;
+    }
+    // The pair on its own first: one disturbed conversion must not reach the average
+    ratio = level_comp_ratio_q16(c, (uint32_t)vref << LEVEL_COMP_AVG_SHIFT);
+    temp = level_comp_temp_q8(c, (uint32_t)ts << LEVEL_COMP_AVG_SHIFT, ratio);
+    if (ratio < ((uint32_t)LEVEL_COMP_MV_MIN << 16) / LEVEL_COMP_CAL_MV ||
+        ratio > ((uint32_t)LEVEL_COMP_MV_MAX << 16) / LEVEL_COMP_CAL_MV ||
+        temp < LEVEL_COMP_T_MIN_C * 256 || temp > LEVEL_COMP_T_MAX_C * 256) {
+        c->rejects++;
+        return -1;
+    }
+
+    if (!c->primed) {
+        c->vref_avg = (uint32_t)vref << LEVEL_COMP_AVG_SHIFT;
+        c->ts_avg = (uint32_t)ts << LEVEL_COMP_AVG_SHIFT;
+        c->primed = 1;
+    } else {
+        c->vref_avg += (int32_t)(((uint32_t)vref << LEVEL_COMP_AVG_SHIFT) - c->vref_avg) >> LEVEL_COMP_AVG_SHIFT;
+        c->ts_avg += (int32_t)(((uint32_t)ts << LEVEL_COMP_AVG_SHIFT) - c->ts_avg) >> LEVEL_COMP_AVG_SHIFT;
+    }
+    ratio = level_comp_ratio_q16(c, c->vref_avg);
+    c->temp_q8 = level_comp_temp_q8(c, c->ts_avg, ratio);
+    c->vdda_mv = (LEVEL_COMP_CAL_MV * ratio + 0x8000U) >> 16;
+
+    // Horner in Q30 with dT in Q8
+    dt = c->temp_q8 - LEVEL_COMP_T0_C * 256;
+    poly = ((int64_t)LEVEL_COMP_Q30(LEVEL_COMP_K2) * dt) >> 8;
+    poly = ((poly + LEVEL_COMP_Q30(LEVEL_COMP_K1)) * dt) >> 8;
+    poly += 1 << 30;
+#if LEVEL_COMP_ABSOLUTE_PROBE
+    poly = (poly * ratio) >> 30;    // counts as if VDDA were still 3.3 V
+#else
+    poly >>= 14;
+#endif
+    c->gain_q16 = poly < 0 ? 0 : poly > LEVEL_COMP_GAIN_MAX ? LEVEL_COMP_GAIN_MAX : (uint32_t)poly;
+    c->refs++;
+    return 0;
+}
+
+uint16_t level_comp_apply(const level_comp_t *c, uint16_t raw) {
+    uint32_t v = (raw * c->gain_q16 + 0x8000U) >> 16;
+
+    return v > 4095 ? 4095 : (uint16_t)v;
+}
@@ -12,15 +12,28 @@
 
 /* USER CODE BEGIN Includes */
 #include "i2c-lcd.h"
-#include <stdio.h>
+#include "controller.h"
+#include "calib_store.h"
+#include "adc_scan.h"
+#include "trace_recorder.h"
+#include "fpu_ctx.h"
+#include "task_model.h"
+#include "kernel_bench.h"
+#include "work_queue.h"
+#include "indicator.h"
+#include "fmt.h"
+#include "boot_trace.h"
+#include "clock_profile.h"
+#include "uart_tx.h"
 #include <string.h>
 /* USER CODE END Includes */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-#define NORMAL_RAIN_MM    15.0f    // 보통 비(mm)
-#define WARNING_RAIN_MM   34.0f    // 폭우 경고(mm)
-#define SENSOR_MAX_MM     40.0f    // 빨간 수위센서 측정 최대 높이(mm)
+// Pipeline switches: water_ctrl.h; thresholds: calib.h (factory) and calib_store.c (flash)
+#define TRACE_LATE_SLOT_MS 120     // a water slot later than this freezes the scheduling trace
+#define USE_KERNEL_BENCH  0        // 1: boot into the kernel latency benchmark instead of the application
+#define BARRIER_QUEUE_LEN 8        // IR commands waiting for the water task
 #define IR_PIN GPIO_PIN_8
 #define IR_PORT GPIOA
 /* USER CODE END PD */
@@ -32,22 +45,52 @@ TIM_HandleTypeDef htim3;
 UART_HandleTypeDef huart2;
 TIM_HandleTypeDef htim4;
 /* FreeRTOS thread handles */
-osThreadId_t lcdTaskHandle;
 osThreadId_t servoTaskHandle;
+osThreadId_t traceTaskHandle;
+osTimerId_t lcdTimerHandle;
+osTimerId_t lcdBootTimerHandle;
 
 /* USER CODE BEGIN PV */
+// Priorities and stacks come from task_model.h (checked at startup)
+const osThreadAttr_t waterTask_attributes = {
+  .name = "water",
+  .priority = (osPriority_t) TASK_WATER_PRIO,
+  .stack_size = TASK_WATER_STACK * 4
+};
+// LCD refresh: the timer callback posts, the work thread drives I2C
+const osTimerAttr_t lcdTimer_attributes = {
+  .name = "lcd"
+};
+// HD44780 init steps, re-armed with each step's wait
+const osTimerAttr_t lcdBootTimer_attributes = {
+  .name = "lcd_boot"
+};
+#if configUSE_TRACE_RECORDER
+const osThreadAttr_t traceTask_attributes = {
+  .name = "trace",
+  .priority = (osPriority_t) TASK_TRACE_PRIO,
+  .stack_size = TASK_TRACE_STACK * 4
+};
+#endif
+// Servo and PC0-PC3 belong to the water task; IR commands reach it as events
+osMessageQueueId_t barrierEventsHandle;
+const osMessageQueueAttr_t barrierEvents_attributes = {
+  .name = "barrier"
+};
+controller_t ctrl;     // level pipeline, barrier state machine, indicator and IR state
+volatile uint8_t barrier_state = BARRIER_NORMAL;   // published for the LCD
+uint32_t barrier_events_dropped;
 float rain_mm = 0.0f;
-float smooth_rain_mm = 0.0f;
-char line1[17];
-char line2[17];
+// Published by the water task so the LCD refresh stays integer-only (no FPU frame)
+static const char *const rain_status_text[] = { "NORMAL", "WARNING", "!!FLOOD!!", "SENSOR ERR" };
+volatile int16_t rain_mm_int = 0;
+volatile uint8_t rain_status = RAIN_NORMAL;
+char line1[LCD_COLS + 1];  // LCD shadow lines, always fully written
+char line2[LCD_COLS + 1];
 int flood_counter = 0;
-volatile uint8_t barrier_up = 0;    // 1 if barrier is raised, 0 if lowered
-volatile uint8_t manual_mode = 0;   // 1 if IR manual override is active, 0 if in automatic mode
-volatile uint8_t ir_ready = 0;
-volatile uint32_t ir_timings[100];
-volatile uint8_t ir_index = 0;
+ir_nec_rx_t ir_rx;          // NEC receiver, EXTI context; calib_store.c reports its last frame
 volatile uint32_t last_edge_time = 0;
-volatile uint32_t last_ir_code = 0;
+uint8_t uart_rx_byte;      // USART2 commands (calib_store.c), one byte per interrupt
 /* USER CODE END PV */
 
 /* Function prototypes -------------------------------------------------------*/
@@ -58,209 +101,234 @@ static void MX_I2C1_Init(void);
 static void MX_TIM3_Init(void);
 static void MX_TIM4_Init(void);
 static void MX_USART2_UART_Init(void);
-void StartLcdTask(void *argument);
 void StartWaterTask(void *argument);
-void StartIrTask(void *argument);
-uint32_t decode_nec_signal(void);
+void lcd_refresh_timer(void *argument);
+void lcd_refresh_work(uint32_t arg);
+void lcd_boot_timer(void *argument);
+void lcd_boot_work(uint32_t arg);
+void ir_command_work(uint32_t arg);
+void set_servo_pulse(uint32_t us);
 void set_servo_angle(uint8_t angle);
-float read_rain_mm(void);
-float read_smoothed_rain_mm(void);
+void barrier_apply(uint8_t changed);
 void lcd_display_rain(const char* status);
 /* USER CODE BEGIN 0 */
-uint32_t decode_nec_signal()
-{
-    // NEC protocol requires ~68 timing edges (including leader and spaces)
-       if (ir_index < 68 || ir_index > 100) {
-           return 0xFFFFFFFF;
-       }
-       uint32_t data = 0;
-       for (int i = 0; i < 32; i++) {
-           uint32_t t = ir_timings[17 + i];
-           // Logical 1: typically ~1.6-2.4 ms high pulse
-           if (t > 1400) {
-               data |= (1UL << (31 - i));
-           }
-           // Logical 0: typically ~0.5 ms high pulse
-           else if (t > 200 && t <= 1400) {
-               // bit remains 0 (do nothing)
-           }
-           // Timing out of range: error
-           else {
-               return 0xFFFFFFFF;
-           }
-       }
-       return data;
-}
 /* 서보 각도 제어 */
 
-void set_servo_angle(uint8_t angle) {
-    uint32_t pulse = ((angle * 2000) / 180) + 500; // Map 0-180° to 500-2500us pulse
-    __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_1, pulse);
-    __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_2, pulse);
+void set_servo_pulse(uint32_t us) {
+    __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_1, us);
+    __HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_2, us);
 }
 
-/* 센서 값 읽고 mm 변환 */
-
-float read_rain_mm() {
-    HAL_ADC_Start(&hadc1);
-    HAL_ADC_PollForConversion(&hadc1, HAL_MAX_DELAY);
-    uint16_t raw = HAL_ADC_GetValue(&hadc1);
-    if (raw > 4000) raw = 4000;  // clamp to max expected ADC value
-    return (raw / 4095.0f) * SENSOR_MAX_MM;
-}
-float read_smoothed_rain_mm() {
-    float current = read_rain_mm();
-    // 80% previous value + 20% new value for smoothing
-    smooth_rain_mm = (smooth_rain_mm * 0.8f) + (current * 0.2f);
-    return smooth_rain_mm;
+void set_servo_angle(uint8_t angle) {
+    set_servo_pulse(((angle * 2000) / 180) + 500); // Map 0-180° to 500-2500us pulse
 }
+
 /* LCD에 강수량 표시 (정수 버전) */
 void lcd_display_rain(const char* status) {
-    int rain_int = (int)rain_mm; // truncate to integer mm
-    sprintf(line1, "Rain: %3d mm", rain_int);
-    sprintf(line2, "Status: %s", status);
+    char *p;
+
+    // "Rain: nnn mm    " / "Status: xxxxxxxx": fixed fields, padded to the
+    // full width so a shorter value overwrites the previous one
+    FMT_FITS(line1, 6 + 3 + 3);
+    p = fmt_lit(line1, "Rain: ");
+    p = fmt_int(p, rain_mm_int, 3);     // truncated to integer mm by the water task
+    p = fmt_lit(p, " mm");
+    fmt_str(p, "", (uint8_t)(line1 + LCD_COLS - p));
+    line1[LCD_COLS] = '\0';
+
+    FMT_FITS(line2, 8 + 8);
+    p = fmt_lit(line2, "Status: ");
+    fmt_str(p, status, LCD_COLS - 8);   // "SENSOR ERR" is cut to the 16th column
+    line2[LCD_COLS] = '\0';
     lcd_put_cur(0, 0);
     lcd_send_string(line1);
     lcd_put_cur(1, 0);
     lcd_send_string(line2);
 }
 
-/* LCD Task */
-void StartLcdTask(void *argument) {
-  /* USER CODE BEGIN StartLcdTask */
-  for (;;) {
-    rain_mm = read_smoothed_rain_mm();
-    if (rain_mm < NORMAL_RAIN_MM) {
-        lcd_display_rain("NORMAL");
-    } else if (rain_mm < WARNING_RAIN_MM) {
-        lcd_display_rain("WARNING");
-    } else {
-        lcd_display_rain("!!FLOOD!!");
-    }
-    osDelay(1000);
+/* LCD refresh: timer task context, must not block */
+void lcd_refresh_timer(void *argument) {
+  work_post(lcd_refresh_work, 0);
+}
+
+void lcd_refresh_work(uint32_t arg) {
+  // Level and status are sampled and classified by the water task; an
+  // override outranks the level on the status line
+  uint8_t state = barrier_state;
+  if (state == BARRIER_MANUAL || state == BARRIER_ESTOP) {
+    lcd_display_rain(barrier_state_text[state]);
+  } else {
+    lcd_display_rain(rain_status_text[rain_status]);
+  }
+}
+
+/* Display init in the background: the control loop never waits for it */
+void lcd_boot_timer(void *argument) {
+  // Queue full (a calibration burst): try again next tick, or the display never comes up
+  if (work_post(lcd_boot_work, 0) != 0) {
+    osTimerStart(lcdBootTimerHandle, 1);
   }
-  /* USER CODE END StartLcdTask */
+}
+
+void lcd_boot_work(uint32_t arg) {
+  uint32_t wait = lcd_init_step();
+
+  if (wait != 0) {
+    // A one-shot can fire up to a tick early: one extra tick keeps the minimum
+    osTimerStart(lcdBootTimerHandle, wait + 1);
+    return;
+  }
+  boot_mark(BOOT_LCD_READY);
+  lcd_refresh_work(0);
+  osTimerStart(lcdTimerHandle, WORK_LCD_PERIOD_MS);
+  boot_trace_report();
 }
 
 /* Servo Task */
 void StartWaterTask(void *argument) {
   /* USER CODE BEGIN StartWaterTask */
+  uint32_t next = osKernelGetTickCount();
+#if configUSE_TRACE_RECORDER
+  uint32_t last_slot = osKernelGetTickCount();
+#endif
   for (;;) {
-    rain_mm = read_smoothed_rain_mm();
-
-    if (!manual_mode) {
-      // Automatic control active only when not in manual override
-      if (rain_mm >= WARNING_RAIN_MM) {
-        // Heavy rain: raise barrier if not already up
-        if (!barrier_up) {
-          set_servo_angle(90);           // raise barrier
-          barrier_up = 1;
-          // Activate flood indicators
-          HAL_GPIO_WritePin(GPIOC, GPIO_PIN_2, GPIO_PIN_SET);   // Red LED ON
-          HAL_GPIO_WritePin(GPIOC, GPIO_PIN_3, GPIO_PIN_SET);   // Buzzer ON
-        }
-      } else if (rain_mm < NORMAL_RAIN_MM) {
-        // Light rain/normal: lower barrier if it was up
-        if (barrier_up) {
-          set_servo_angle(0);            // lower barrier
-          barrier_up = 0;
-          // Deactivate flood indicators
-          HAL_GPIO_WritePin(GPIOC, GPIO_PIN_2, GPIO_PIN_RESET); // Red LED OFF
-          HAL_GPIO_WritePin(GPIOC, GPIO_PIN_3, GPIO_PIN_RESET); // Buzzer OFF
-        }
+    // IR commands between slots are dispatched as they arrive
+    uint32_t wait = next - osKernelGetTickCount();
+    uint8_t event;
+    if ((int32_t)wait > 0) {
+      if (osMessageQueueGet(barrierEventsHandle, &event, NULL, wait) == osOK) {
+        barrier_apply(controller_dispatch(&ctrl, event));
       }
-      // (If rain is in between NORMAL_RAIN_MM and WARNING_RAIN_MM, barrier state remains as is.)
+      continue;
     }
+#if configUSE_TRACE_RECORDER
+    // Late control slot: keep the scheduling history that led to it
+    uint32_t slot = osKernelGetTickCount();
+    if (slot - last_slot > TRACE_LATE_SLOT_MS) trace_trigger();
+    last_slot = slot;
+#endif
+    // The controller only sees counts (supply and temperature compensated: adc_scan.c):
+    // Tools/replay and Tools/fleet run the same code.
+    // A calibration update over USART2 takes effect here, at a slot boundary
+    ctrl.water.cal = calib_store_active();
+    uint8_t changed = controller_slot(&ctrl, adc_scan_block());
+    rain_mm = ctrl.slot.mm;
+    rain_mm_int = (int16_t)ctrl.slot.mm;
+    rain_status = ctrl.slot.status;
+    barrier_apply(changed);
+    // Full clock while the barrier may move; the switch runs on the work thread
+    clock_profile_id_t profile = clock_profile_for(rain_status, barrier_fsm_raised(&ctrl.fsm), barrier_fsm_manual(&ctrl.fsm));
+    clock_profile_request(profile);
+    boot_mark(BOOT_FIRST_DECISION);
+    // Nothing to move: the work thread may stall the CPU for a calibration erase
+    if (profile == CLOCK_LOW) calib_store_quiet();
+
+    // Fixed release grid: a slow iteration does not shift the next slot
+    next += TASK_WATER_PERIOD_MS;
+  }
+  /* USER CODE END StartWaterTask */
+}
 
-    // Status LEDs for rain level (Green/Yellow).
-    // If in manual mode with barrier up, override status LEDs to off (red LED indicates manual override/heavy state).
-    if (manual_mode && barrier_up) {
-      HAL_GPIO_WritePin(GPIOC, GPIO_PIN_0, GPIO_PIN_RESET); // Green OFF
-      HAL_GPIO_WritePin(GPIOC, GPIO_PIN_1, GPIO_PIN_RESET); // Yellow OFF
+/* The only actuator writer: servo and indicators as the controller changed them */
+void barrier_apply(uint8_t changed) {
+  if (changed & CTRL_SERVO) {
+    if (ctrl.fsm.servo == SERVO_OFF) {
+      set_servo_pulse(0);                // no pulses: the servo stops driving
     } else {
-      if (rain_mm < NORMAL_RAIN_MM) {
-        HAL_GPIO_WritePin(GPIOC, GPIO_PIN_0, GPIO_PIN_SET);    // Green ON (safe)
-        HAL_GPIO_WritePin(GPIOC, GPIO_PIN_1, GPIO_PIN_RESET);  // Yellow OFF
-      } else if (rain_mm < WARNING_RAIN_MM) {
-        HAL_GPIO_WritePin(GPIOC, GPIO_PIN_0, GPIO_PIN_RESET);  // Green OFF
-        HAL_GPIO_WritePin(GPIOC, GPIO_PIN_1, GPIO_PIN_SET);    // Yellow ON (warning)
-      } else {
-        HAL_GPIO_WritePin(GPIOC, GPIO_PIN_0, GPIO_PIN_RESET);  // Green OFF
-        HAL_GPIO_WritePin(GPIOC, GPIO_PIN_1, GPIO_PIN_RESET);  // Yellow OFF (flood, red is handled above)
-      }
+      set_servo_angle(ctrl.fsm.servo == SERVO_UP ? 90 : 0);
     }
-
-    osDelay(100);  // small delay for loop
   }
-  /* USER CODE END StartWaterTask */
+  if (changed & CTRL_INDICATOR) {
+    pattern_play((pattern_id_t)ctrl.indicator_out->pattern, ctrl.indicator_out->steady);
+  }
+  barrier_state = ctrl.fsm.state;
 }
 
-void StartIrTask(void *argument) {
-  /* USER CODE BEGIN StartIrTask */
-  for (;;) {
-    if (ir_ready) {
-      // An IR code has been captured by the interrupt
-      ir_ready = 0;
-      uint32_t code = decode_nec_signal();
-      ir_index = 0;
-      if (code != 0xFFFFFFFF && code != last_ir_code) {
-        // New valid IR code received (filter out repeats)
-        last_ir_code = code;
-        if (!manual_mode) {
-          manual_mode = 1;  // enter manual mode on first IR command
-        }
-        // Toggle barrier state on IR command
-        if (!barrier_up) {
-          // Barrier is currently down -> raise it via remote
-          set_servo_angle(90);
-          barrier_up = 1;
-          // Turn off green/yellow, turn on red LED and buzzer for manual raise
-          HAL_GPIO_WritePin(GPIOC, GPIO_PIN_0, GPIO_PIN_RESET); // Green OFF
-          HAL_GPIO_WritePin(GPIOC, GPIO_PIN_1, GPIO_PIN_RESET); // Yellow OFF
-          HAL_GPIO_WritePin(GPIOC, GPIO_PIN_2, GPIO_PIN_SET);   // Red ON
-          HAL_GPIO_WritePin(GPIOC, GPIO_PIN_3, GPIO_PIN_SET);   // Buzzer ON
-        } else {
-          // Barrier is currently up -> lower it via remote
-          set_servo_angle(0);
-          barrier_up = 0;
-          // Turn off red LED and buzzer for manual lower
-          HAL_GPIO_WritePin(GPIOC, GPIO_PIN_2, GPIO_PIN_RESET); // Red OFF
-          HAL_GPIO_WritePin(GPIOC, GPIO_PIN_3, GPIO_PIN_RESET); // Buzzer OFF
-        }
-        // If barrier has been lowered by remote, exit manual mode (return to automatic)
-        if (barrier_up == 0) {
-          manual_mode = 0;
-        }
-      }
+/* Posted by the IR EXTI callback with a frame word, or IR_NEC_REPEAT for a repeat code */
+void ir_command_work(uint32_t arg) {
+  // Key mapping (ir_keymap.c) and hold tracking (controller.c); the water task dispatches
+  uint8_t event = controller_ir_event(&ctrl, arg, osKernelGetTickCount());
+  if (event != CTRL_NO_EVENT) {
+    if (osMessageQueuePut(barrierEventsHandle, &event, 0, 0) != osOK) {
+      barrier_events_dropped++;
     }
-    osDelay(50);  // short polling delay
   }
-  /* USER CODE END StartIrTask */
 }
 /* USER CODE END 0 */
 
 /* Main function */
 int main(void) {
+    boot_trace_start();
     HAL_Init();
     SystemClock_Config();
+    boot_mark(BOOT_CLOCKS);
 
+    // Safety path first: level sensor, barrier servo, indicators
+    ir_nec_init(&ir_rx);    // before MX_GPIO_Init enables the IR edge interrupt
     MX_GPIO_Init();
     MX_ADC1_Init();
-    MX_I2C1_Init();
+    adc_scan_init();
     MX_TIM3_Init();
-    MX_TIM4_Init();
-    MX_USART2_UART_Init();
-
-    HAL_TIM_Base_Start(&htim4);
-
-    lcd_init();
     HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_1);
     HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_2);
+    pattern_init();     // indicators off until the first control slot
+    boot_mark(BOOT_SAFETY_IO);
 
+    MX_I2C1_Init();
+    MX_TIM4_Init();
+    MX_USART2_UART_Init();
+    HAL_TIM_Base_Start(&htim4);
+    boot_mark(BOOT_PERIPHERALS);
+    calib_store_init();     // reads only: a stale slot is erased after boot, at a quiet slot
+    controller_init(&ctrl, calib_store_active());
+    boot_mark(BOOT_FILTERS);
+    // No lcd_init() here: its ~115 ms of waits run as timer steps after the
+    // scheduler starts, behind the first control decision
+
+#if configUSE_TRACE_RECORDER
+    trace_init();       // before the kernel creates its first object
+#endif
+    for (uint32_t i = 0; i < CLOCK_PROFILE_COUNT; i++) {
+        if (task_model_check(clock_profiles[i].sysclk_hz) != 0) {
+            Error_Handler();    // declared WCETs/priorities cannot meet the periods at this clock
+        }
+    }
     osKernelInitialize();
-    lcdTaskHandle   = osThreadNew(StartLcdTask, NULL, NULL);  // LCD task
-    servoTaskHandle = osThreadNew(StartWaterTask, NULL, NULL); // 센서(자동) task
-    osThreadNew(StartIrTask, NULL, NULL); // IR(수동) task 따로 등록
+    if (uart_tx_init() != 0) {
+        Error_Handler();    // every USART2 sender queues through uart_tx.c
+    }
+#if USE_KERNEL_BENCH
+    kernel_bench_start();
+#else
+    barrierEventsHandle = osMessageQueueNew(BARRIER_QUEUE_LEN, sizeof(uint8_t), &barrierEvents_attributes);
+    if (barrierEventsHandle == NULL) {
+        Error_Handler();
+    }
+    servoTaskHandle = osThreadNew(StartWaterTask, NULL, &waterTask_attributes); // 센서(자동) task
+    if (work_queue_init() != 0) {
+        Error_Handler();    // LCD refresh, IR(수동) and calibration commands run on the work thread
+    }
+    if (calib_store_start() != 0) {
+        Error_Handler();    // no buffers for USART2 command lines
+    }
+    HAL_UART_Receive_IT(&huart2, &uart_rx_byte, 1);
+    // The refresh timer is started by lcd_boot_work() once the display is up
+    lcdTimerHandle = osTimerNew(lcd_refresh_timer, osTimerPeriodic, NULL, &lcdTimer_attributes);
+    lcdBootTimerHandle = osTimerNew(lcd_boot_timer, osTimerOnce, NULL, &lcdBootTimer_attributes);
+    if (lcdTimerHandle == NULL || lcdBootTimerHandle == NULL || work_post(lcd_boot_work, 0) != 0) {
+        Error_Handler();
+    }
+#endif
+#if configUSE_TRACE_RECORDER
+    traceTaskHandle = osThreadNew(trace_task, NULL, &traceTask_attributes);
+#endif
+#if configUSE_FPU_CTX_STATS
+    // Only tasks declared with FPU use should ever stack FPU context
+    fpu_ctx_declare(servoTaskHandle, TASK_WATER_FPU);
+    fpu_ctx_declare(work_queue_thread(), TASK_WORK_FPU);
+    fpu_ctx_declare(traceTaskHandle, TASK_TRACE_FPU);
+#endif
+    boot_mark(BOOT_KERNEL_START);
     osKernelStart();
 
     while (1) {}
@@ -275,41 +343,10 @@ int main(void) {
   */
 void SystemClock_Config(void)
 {
-  RCC_OscInitTypeDef RCC_OscInitStruct = {0};
-  RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
-
-  /** Configure the main internal regulator output voltage
-  */
-  __HAL_RCC_PWR_CLK_ENABLE();
-  __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE1);
-
-  /** Initializes the RCC Oscillators according to the specified parameters
-  * in the RCC_OscInitTypeDef structure.
-  */
-  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;
-  RCC_OscInitStruct.HSIState = RCC_HSI_ON;
-  RCC_OscInitStruct.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
-  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
-  RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSI;
-  RCC_OscInitStruct.PLL.PLLM = 16;
-  RCC_OscInitStruct.PLL.PLLN = 336;
-  RCC_OscInitStruct.PLL.PLLP = RCC_PLLP_DIV4;
-  RCC_OscInitStruct.PLL.PLLQ = 4;
-  if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
-  {
-    Error_Handler();
-  }
-
-  /** Initializes the CPU, AHB and APB buses clocks
+  /** PLL, regulator scale, flash latency and bus dividers of the boot
+  * profile (clock_profile.c); the water task steps down once NORMAL settles
   */
-  RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK
-                              |RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2;
-  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
-  RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
-  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV2;
-  RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
-
-  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_2) != HAL_OK)
+  if (clock_profile_boot() != 0)
   {
     Error_Handler();
   }
@@ -338,15 +375,15 @@ static void MX_ADC1_Init(void)
   hadc1.Instance = ADC1;
   hadc1.Init.ClockPrescaler = ADC_CLOCK_SYNC_PCLK_DIV4;
   hadc1.Init.Resolution = ADC_RESOLUTION_12B;
-  hadc1.Init.ScanConvMode = DISABLE;
+  hadc1.Init.ScanConvMode = ENABLE;
   hadc1.Init.ContinuousConvMode = DISABLE;
   hadc1.Init.DiscontinuousConvMode = DISABLE;
   hadc1.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
   hadc1.Init.ExternalTrigConv = ADC_SOFTWARE_START;
   hadc1.Init.DataAlign = ADC_DATAALIGN_RIGHT;
-  hadc1.Init.NbrOfConversion = 1;
+  hadc1.Init.NbrOfConversion = ADC_SCAN_RANKS;     // adc_scan.c shortens it to the level on most blocks
   hadc1.Init.DMAContinuousRequests = DISABLE;
-  hadc1.Init.EOCSelection = ADC_EOC_SINGLE_CONV;
+  hadc1.Init.EOCSelection = ADC_EOC_SEQ_CONV;
   if (HAL_ADC_Init(&hadc1) != HAL_OK)
   {
     Error_Handler();
@@ -362,7 +399,20 @@ static void MX_ADC1_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN ADC1_Init 2 */
-
+  // Internal channels want at least 10 us of sampling: 480 cycles is 19 us at 25 MHz
+  sConfig.Channel = ADC_CHANNEL_VREFINT;
+  sConfig.Rank = 2;
+  sConfig.SamplingTime = ADC_SAMPLETIME_480CYCLES;
+  if (HAL_ADC_ConfigChannel(&hadc1, &sConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sConfig.Channel = ADC_CHANNEL_TEMPSENSOR;
+  sConfig.Rank = 3;
+  if (HAL_ADC_ConfigChannel(&hadc1, &sConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
   /* USER CODE END ADC1_Init 2 */
 
 }
@@ -420,7 +470,7 @@ static void MX_TIM3_Init(void)
 
   /* USER CODE END TIM3_Init 1 */
   htim3.Instance = TIM3;
-  htim3.Init.Prescaler = 83;
+  htim3.Init.Prescaler = clock_timing_now()->tim3_psc;     // 1 MHz: pulse in us
   htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
   htim3.Init.Period = 20000;
   htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
@@ -459,7 +509,7 @@ static void MX_TIM4_Init(void)
     __HAL_RCC_TIM4_CLK_ENABLE();
 
     htim4.Instance = TIM4;
-    htim4.Init.Prescaler = 83;
+    htim4.Init.Prescaler = clock_timing_now()->tim4_psc;   // 1 MHz: NEC timings in us
     htim4.Init.CounterMode = TIM_COUNTERMODE_UP;
     htim4.Init.Period = 0xFFFF;
     htim4.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
@@ -569,17 +619,41 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
     uint32_t duration = (now >= last_edge_time) ? (now - last_edge_time)
                                                : (0xFFFF - last_edge_time + now);
     last_edge_time = now;
-    if (ir_index < 100) {
-      ir_timings[ir_index++] = duration;
-    }
-    // If a full IR code (≈68 edges) is captured, signal readiness to decode
-    if (ir_index >= 68) {
-      ir_ready = 1;
+    // The frame travels as the work argument: the receiver is free for the next one at once
+    ir_nec_result_t r = ir_nec_edge(&ir_rx, duration);
+    if (r != IR_NEC_NONE) {
+      (void)work_post(ir_command_work, r == IR_NEC_FRAME ? ir_rx.word : IR_NEC_REPEAT);     // queue full: dropped
     }
   }
   /* USER CODE END HAL_GPIO_EXTI_Callback */
 }
 
+/* USART2 RX: command bytes to calib_store.c, which posts whole lines */
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
+  if (huart == &huart2) {
+    calib_store_rx(uart_rx_byte);
+    HAL_UART_Receive_IT(&huart2, &uart_rx_byte, 1);
+  }
+}
+
+/* USART2 TX: the DMA chunk is out, uart_tx.c starts the next */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+  if (huart == &huart2) {
+    uart_tx_done();
+  }
+}
+
+/* Overrun or noise aborts the reception: start over on the next byte.
+   A DMA error has stopped the transmit instead */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+  if (huart == &huart2) {
+    if (huart->ErrorCode & HAL_UART_ERROR_DMA) {
+      uart_tx_error();
+    }
+    HAL_UART_Receive_IT(&huart2, &uart_rx_byte, 1);
+  }
+}
+
 /* USER CODE END 4 */
 
 /* USER CODE BEGIN Header_StartDefaultTask */
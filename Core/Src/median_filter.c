@@ -0,0 +1,88 @@
+#include "median_filter.h"
+#include <string.h>
+
+/* First index in sorted[0..n) holding a value >= v */
+#define MEDIAN_LOWER_BOUND(sorted, n, v, idx)      \
+    do {                                            \
+        uint32_t lo_ = 0, hi_ = (n);                \
+        while (lo_ < hi_) {                         \
+            uint32_t mid_ = (lo_ + hi_) >> 1;       \
+            if ((sorted)[mid_] < (v)) lo_ = mid_ + 1; \
+            else hi_ = mid_;                        \
+        }                                           \
+        (idx) = lo_;                                \
+    } while (0)
+
+/* Replace `out` by `in` in the sorted window: the run between the two
+ * positions moves by one slot in a single memmove. */
+#define MEDIAN_REPLACE(sorted, n, out, in)                                          \
+    do {                                                                            \
+        uint32_t i_, j_;                                                            \
+        MEDIAN_LOWER_BOUND(sorted, n, out, i_);                                     \
+        MEDIAN_LOWER_BOUND(sorted, n, in, j_);                                      \
+        if (j_ > i_) {                                                              \
+            memmove(&(sorted)[i_], &(sorted)[i_ + 1], (j_ - i_ - 1) * sizeof((sorted)[0])); \
+            (sorted)[j_ - 1] = (in);                                                \
+        } else {                                                                    \
+            memmove(&(sorted)[j_ + 1], &(sorted)[j_], (i_ - j_) * sizeof((sorted)[0]));     \
+            (sorted)[j_] = (in);                                                    \
+        }                                                                           \
+    } while (0)
+
+arm_status median_init_q15(median_instance_q15 *S, uint16_t windowSize, q15_t *pState) {
+    if (windowSize == 0 || windowSize > MEDIAN_MAX_WINDOW || (windowSize & 1U) == 0) {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    S->windowSize = windowSize;
+    S->head = 0;
+    S->pState = pState;
+    memset(pState, 0, 2U * windowSize * sizeof(q15_t));
+    return ARM_MATH_SUCCESS;
+}
+
+arm_status median_init_f32(median_instance_f32 *S, uint16_t windowSize, float32_t *pState) {
+    if (windowSize == 0 || windowSize > MEDIAN_MAX_WINDOW || (windowSize & 1U) == 0) {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    S->windowSize = windowSize;
+    S->head = 0;
+    S->pState = pState;
+    memset(pState, 0, 2U * windowSize * sizeof(float32_t));
+    return ARM_MATH_SUCCESS;
+}
+
+void median_q15(median_instance_q15 *S, const q15_t *pSrc, q15_t *pDst, uint32_t blockSize) {
+    const uint32_t n = S->windowSize;
+    q15_t *ring = S->pState;
+    q15_t *sorted = S->pState + n;
+    uint32_t head = S->head;
+
+    while (blockSize-- > 0U) {
+        q15_t in = *pSrc++;
+        q15_t out = ring[head];
+
+        ring[head] = in;
+        if (++head == n) head = 0;
+        if (in != out) MEDIAN_REPLACE(sorted, n, out, in);
+        *pDst++ = sorted[n >> 1];
+    }
+    S->head = (uint16_t)head;
+}
+
+void median_f32(median_instance_f32 *S, const float32_t *pSrc, float32_t *pDst, uint32_t blockSize) {
+    const uint32_t n = S->windowSize;
+    float32_t *ring = S->pState;
+    float32_t *sorted = S->pState + n;
+    uint32_t head = S->head;
+
+    while (blockSize-- > 0U) {
+        float32_t in = *pSrc++;
+        float32_t out = ring[head];
+
+        ring[head] = in;
+        if (++head == n) head = 0;
+        if (in != out) MEDIAN_REPLACE(sorted, n, out, in);
+        *pDst++ = sorted[n >> 1];
+    }
+    S->head = (uint16_t)head;
+}
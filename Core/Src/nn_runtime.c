@@ -0,0 +1,145 @@
+#include "nn_runtime.h"
+#include "stm32f4xx_hal.h"
+#include "arm_nnfunctions.h"
+#include <string.h>
+
+#define NN_ALIGN(x)   (((x) + 3U) & ~3U)
+#define NN_NONE       0xFFFFU
+
+typedef struct {
+    uint16_t size;
+    uint8_t first;      // first layer that needs the buffer
+    uint8_t last;       // last layer that needs it
+    uint16_t *off;      // where the planned offset goes
+} nn_buf_t;
+
+/* Scratch bytes a layer needs, as reported by CMSIS-NN for this build */
+static uint16_t nn_scratch_bytes(const nn_instance_t *S, const nn_layer_t *l) {
+    if (l->op == NN_OP_FULLY_CONNECTED) {
+        cmsis_nn_dims filter = { S->model->tensors[l->in].size, 1, 1, S->model->tensors[l->out].size };
+        return (uint16_t)arm_fully_connected_s8_get_buffer_size(&filter);
+    }
+    return 0;
+}
+
+/* Greedy by size: each buffer goes to the lowest offset not overlapping any
+ * already placed buffer whose lifetime intersects its own. */
+static int nn_plan(nn_instance_t *S) {
+    nn_buf_t bufs[NN_MAX_TENSORS + NN_MAX_LAYERS];
+    uint8_t n = 0;
+    uint16_t peak = 0;
+
+    for (uint8_t t = 0; t < S->model->num_tensors; t++) {
+        S->tensor_off[t] = NN_NONE;
+        if (t == S->model->input || t == S->model->output) continue;   // caller's buffers
+        bufs[n].size = NN_ALIGN(S->model->tensors[t].size);
+        bufs[n].first = 0xFF;
+        bufs[n].last = 0;
+        bufs[n].off = &S->tensor_off[t];
+        for (uint8_t i = 0; i < S->model->num_layers; i++) {
+            const nn_layer_t *l = &S->model->layers[i];
+            if (l->out == t && i < bufs[n].first) bufs[n].first = i;
+            if (l->in == t || l->out == t) bufs[n].last = i;
+        }
+        if (bufs[n].first == 0xFF) return -1;  // never produced
+        n++;
+    }
+    for (uint8_t i = 0; i < S->model->num_layers; i++) {
+        S->scratch_size[i] = nn_scratch_bytes(S, &S->model->layers[i]);
+        S->scratch_off[i] = NN_NONE;
+        if (S->scratch_size[i] == 0) continue;
+        bufs[n].size = NN_ALIGN(S->scratch_size[i]);
+        bufs[n].first = bufs[n].last = i;
+        bufs[n].off = &S->scratch_off[i];
+        n++;
+    }
+
+    // Largest first (insertion sort, n is tiny)
+    for (uint8_t i = 1; i < n; i++) {
+        nn_buf_t b = bufs[i];
+        int8_t j = i - 1;
+        while (j >= 0 && bufs[j].size < b.size) { bufs[j + 1] = bufs[j]; j--; }
+        bufs[j + 1] = b;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        uint16_t off = 0;
+        uint8_t moved = 1;
+        while (moved) {
+            moved = 0;
+            for (uint8_t j = 0; j < i; j++) {
+                if (bufs[j].last < bufs[i].first || bufs[i].last < bufs[j].first) continue;
+                if (off < *bufs[j].off + bufs[j].size && *bufs[j].off < off + bufs[i].size) {
+                    off = *bufs[j].off + bufs[j].size;
+                    moved = 1;
+                }
+            }
+        }
+        *bufs[i].off = off;
+        if (off + bufs[i].size > peak) peak = off + bufs[i].size;
+    }
+
+    S->stats.arena_used = peak;
+    return peak <= NN_ARENA_BYTES ? 0 : -1;
+}
+
+/* Load a model and plan its arena; -1 if it does not fit the build limits */
+int nn_init(nn_instance_t *S, const nn_model_t *m) {
+    S->model = m;
+    memset(&S->stats, 0, sizeof(S->stats));
+    if (m->num_tensors > NN_MAX_TENSORS || m->num_layers > NN_MAX_LAYERS) {
+        S->model = NULL;
+        return -1;
+    }
+    if (nn_plan(S) != 0) {
+        S->model = NULL;
+        return -1;
+    }
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    return 0;
+}
+
+static int8_t *nn_tensor(nn_instance_t *S, uint8_t t, const int8_t *input, int8_t *output) {
+    if (t == S->model->input) return (int8_t *)input;
+    if (t == S->model->output) return output;
+    return &S->arena[S->tensor_off[t]];
+}
+
+/* Run the loaded model: input/output sizes are those of the model's tensors */
+int nn_run(nn_instance_t *S, const int8_t *input, int8_t *output) {
+    uint32_t start = DWT->CYCCNT;
+
+    if (S->model == NULL) return -1;
+
+    for (uint8_t i = 0; i < S->model->num_layers; i++) {
+        const nn_layer_t *l = &S->model->layers[i];
+        const int8_t *in = nn_tensor(S, l->in, input, output);
+        int8_t *out = nn_tensor(S, l->out, input, output);
+        int32_t in_size = S->model->tensors[l->in].size;
+        int32_t out_size = S->model->tensors[l->out].size;
+
+        if (l->op == NN_OP_FULLY_CONNECTED) {
+            cmsis_nn_context ctx = { S->scratch_size[i] ? &S->arena[S->scratch_off[i]] : NULL, S->scratch_size[i] };
+            cmsis_nn_fc_params fc = { l->input_offset, 0, l->output_offset, { l->act_min, l->act_max } };
+            cmsis_nn_per_tensor_quant_params q = { l->mult, l->shift };
+            cmsis_nn_dims in_dims = { 1, 1, 1, in_size };
+            cmsis_nn_dims filter_dims = { in_size, 1, 1, out_size };
+            cmsis_nn_dims bias_dims = { 1, 1, 1, out_size };
+            cmsis_nn_dims out_dims = { 1, 1, 1, out_size };
+
+            arm_fully_connected_s8(&ctx, &fc, &q, &in_dims, in, &filter_dims, l->weights,
+                                   &bias_dims, l->bias, &out_dims, out);
+        } else {
+            arm_softmax_s8(in, 1, in_size, l->mult, l->shift, l->diff_min, out);
+        }
+    }
+
+    S->stats.run_cycles = DWT->CYCCNT - start;
+    if (S->stats.run_cycles > S->stats.run_cycles_max) S->stats.run_cycles_max = S->stats.run_cycles;
+    return 0;
+}
+
+void nn_get_stats(const nn_instance_t *S, nn_stats_t *out) {
+    *out = S->stats;
+}
@@ -0,0 +1,43 @@
+#include "sensor_curve.h"
+
+void sensor_curve_init(sensor_curve_instance_t *S) {
+#if SENSOR_CURVE_MODE == SENSOR_CURVE_SPLINE
+    float32_t temp[2 * SENSOR_CURVE_KNOTS - 1];
+
+    arm_spline_init_f32(&S->spline, ARM_SPLINE_NATURAL, sensor_curve_x_f32, sensor_curve_y_f32,
+                        SENSOR_CURVE_KNOTS, S->coeffs, temp);
+#else
+    (void)S;
+#endif
+}
+
+float32_t sensor_curve(sensor_curve_instance_t *S, uint16_t raw) {
+#if SENSOR_CURVE_MODE == SENSOR_CURVE_LUT
+    (void)S;
+    return sensor_curve_lut[raw & 0x0FFF] * (1.0f / SENSOR_CURVE_LSB);
+#elif SENSOR_CURVE_MODE == SENSOR_CURVE_SPLINE
+    float32_t x = raw;
+    float32_t y;
+
+    arm_spline_f32(&S->spline, &x, &y, 1);
+    return y;
+#else
+    // 12.20 fixed point: knot index in the top 12 bits, 20 bits of fraction
+    (void)S;
+    return arm_linear_interp_q15(sensor_curve_q15, (q31_t)raw << (20 - SENSOR_CURVE_SHIFT),
+                                 SENSOR_CURVE_KNOTS) * (1.0f / SENSOR_CURVE_LSB);
+#endif
+}
+
+/* Nearest count by bisection: the curve is non-decreasing */
+uint16_t sensor_curve_raw(sensor_curve_instance_t *S, float32_t lin) {
+    uint16_t lo = 0, hi = 4095;
+
+    while (lo < hi) {
+        uint16_t mid = (lo + hi) / 2;
+        if (sensor_curve(S, mid) < lin) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo > 0 && lin - sensor_curve(S, lo - 1) < sensor_curve(S, lo) - lin) lo--;
+    return lo;
+}
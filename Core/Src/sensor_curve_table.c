@@ -0,0 +1,284 @@
+/* Generated by Tools/fit_sensor_curve.py (straight line) -- do not edit. */
+#include "sensor_curve.h"
+
+// Linear counts * 8 at raw = i << SENSOR_CURVE_SHIFT
+const q15_t sensor_curve_q15[SENSOR_CURVE_KNOTS] = {
+         0,   1024,   2048,   3072,   4096,   5120,   6144,   7168,   8192,   9216,  10240,
+     11264,  12288,  13312,  14336,  15360,  16384,  17408,  18432,  19456,  20480,  21504,
+     22528,  23552,  24576,  25600,  26624,  27648,  28672,  29696,  30720,  31744,  32767,
+};
+
+const float32_t sensor_curve_x_f32[SENSOR_CURVE_KNOTS] = {
+    0.0f, 128.0f, 256.0f, 384.0f, 512.0f, 640.0f, 768.0f, 896.0f, 1024.0f, 1152.0f, 1280.0f,
+    1408.0f, 1536.0f, 1664.0f, 1792.0f, 1920.0f, 2048.0f, 2176.0f, 2304.0f, 2432.0f, 2560.0f, 2688.0f,
+    2816.0f, 2944.0f, 3072.0f, 3200.0f, 3328.0f, 3456.0f, 3584.0f, 3712.0f, 3840.0f, 3968.0f, 4096.0f,
+};
+
+const float32_t sensor_curve_y_f32[SENSOR_CURVE_KNOTS] = {
+    0.0000f, 128.0000f, 256.0000f, 384.0000f, 512.0000f, 640.0000f, 768.0000f, 896.0000f,
+    1024.0000f, 1152.0000f, 1280.0000f, 1408.0000f, 1536.0000f, 1664.0000f, 1792.0000f, 1920.0000f,
+    2048.0000f, 2176.0000f, 2304.0000f, 2432.0000f, 2560.0000f, 2688.0000f, 2816.0000f, 2944.0000f,
+    3072.0000f, 3200.0000f, 3328.0000f, 3456.0000f, 3584.0000f, 3712.0000f, 3840.0000f, 3968.0000f,
+    4095.8750f,
+};
+
+#if SENSOR_CURVE_MODE == SENSOR_CURVE_LUT
+const q15_t sensor_curve_lut[4096] = {
+         0,      8,     16,     24,     32,     40,     48,     56,     64,     72,     80,     88,     96,    104,    112,    120,
+       128,    136,    144,    152,    160,    168,    176,    184,    192,    200,    208,    216,    224,    232,    240,    248,
+       256,    264,    272,    280,    288,    296,    304,    312,    320,    328,    336,    344,    352,    360,    368,    376,
+       384,    392,    400,    408,    416,    424,    432,    440,    448,    456,    464,    472,    480,    488,    496,    504,
+       512,    520,    528,    536,    544,    552,    560,    568,    576,    584,    592,    600,    608,    616,    624,    632,
+       640,    648,    656,    664,    672,    680,    688,    696,    704,    712,    720,    728,    736,    744,    752,    760,
+       768,    776,    784,    792,    800,    808,    816,    824,    832,    840,    848,    856,    864,    872,    880,    888,
+       896,    904,    912,    920,    928,    936,    944,    952,    960,    968,    976,    984,    992,   1000,   1008,   1016,
+      1024,   1032,   1040,   1048,   1056,   1064,   1072,   1080,   1088,   1096,   1104,   1112,   1120,   1128,   1136,   1144,
+      1152,   1160,   1168,   1176,   1184,   1192,   1200,   1208,   1216,   1224,   1232,   1240,   1248,   1256,   1264,   1272,
+      1280,   1288,   1296,   1304,   1312,   1320,   1328,   1336,   1344,   1352,   1360,   1368,   1376,   1384,   1392,   1400,
+      1408,   1416,   1424,   1432,   1440,   1448,   1456,   1464,   1472,   1480,   1488,   1496,   1504,   1512,   1520,   1528,
+      1536,   1544,   1552,   1560,   1568,   1576,   1584,   1592,   1600,   1608,   1616,   1624,   1632,   1640,   1648,   1656,
+      1664,   1672,   1680,   1688,   1696,   1704,   1712,   1720,   1728,   1736,   1744,   1752,   1760,   1768,   1776,   1784,
+      1792,   1800,   1808,   1816,   1824,   1832,   1840,   1848,   1856,   1864,   1872,   1880,   1888,   1896,   1904,   1912,
+      1920,   1928,   1936,   1944,   1952,   1960,   1968,   1976,   1984,   1992,   2000,   2008,   2016,   2024,   2032,   2040,
+      2048,   2056,   2064,   2072,   2080,   2088,   2096,   2104,   2112,   2120,   2128,   2136,   2144,   2152,   2160,   2168,
+      2176,   2184,   2192,   2200,   2208,   2216,   2224,   2232,   2240,   2248,   2256,   2264,   2272,   2280,   2288,   2296,
+      2304,   2312,   2320,   2328,   2336,   2344,   2352,   2360,   2368,   2376,   2384,   2392,   2400,   2408,   2416,   2424,
+      2432,   2440,   2448,   2456,   2464,   2472,   2480,   2488,   2496,   2504,   2512,   2520,   2528,   2536,   2544,   2552,
+      2560,   2568,   2576,   2584,   2592,   2600,   2608,   2616,   2624,   2632,   2640,   2648,   2656,   2664,   2672,   2680,
+      2688,   2696,   2704,   2712,   2720,   2728,   2736,   2744,   2752,   2760,   2768,   2776,   2784,   2792,   2800,   2808,
+      2816,   2824,   2832,   2840,   2848,   2856,   2864,   2872,   2880,   2888,   2896,   2904,   2912,   2920,   2928,   2936,
+      2944,   2952,   2960,   2968,   2976,   2984,   2992,   3000,   3008,   3016,   3024,   3032,   3040,   3048,   3056,   3064,
+      3072,   3080,   3088,   3096,   3104,   3112,   3120,   3128,   3136,   3144,   3152,   3160,   3168,   3176,   3184,   3192,
+      3200,   3208,   3216,   3224,   3232,   3240,   3248,   3256,   3264,   3272,   3280,   3288,   3296,   3304,   3312,   3320,
+      3328,   3336,   3344,   3352,   3360,   3368,   3376,   3384,   3392,   3400,   3408,   3416,   3424,   3432,   3440,   3448,
+      3456,   3464,   3472,   3480,   3488,   3496,   3504,   3512,   3520,   3528,   3536,   3544,   3552,   3560,   3568,   3576,
+      3584,   3592,   3600,   3608,   3616,   3624,   3632,   3640,   3648,   3656,   3664,   3672,   3680,   3688,   3696,   3704,
+      3712,   3720,   3728,   3736,   3744,   3752,   3760,   3768,   3776,   3784,   3792,   3800,   3808,   3816,   3824,   3832,
+      3840,   3848,   3856,   3864,   3872,   3880,   3888,   3896,   3904,   3912,   3920,   3928,   3936,   3944,   3952,   3960,
+      3968,   3976,   3984,   3992,   4000,   4008,   4016,   4024,   4032,   4040,   4048,   4056,   4064,   4072,   4080,   4088,
+      4096,   4104,   4112,   4120,   4128,   4136,   4144,   4152,   4160,   4168,   4176,   4184,   4192,   4200,   4208,   4216,
+      4224,   4232,   4240,   4248,   4256,   4264,   4272,   4280,   4288,   4296,   4304,   4312,   4320,   4328,   4336,   4344,
+      4352,   4360,   4368,   4376,   4384,   4392,   4400,   4408,   4416,   4424,   4432,   4440,   4448,   4456,   4464,   4472,
+      4480,   4488,   4496,   4504,   4512,   4520,   4528,   4536,   4544,   4552,   4560,   4568,   4576,   4584,   4592,   4600,
+      4608,   4616,   4624,   4632,   4640,   4648,   4656,   4664,   4672,   4680,   4688,   4696,   4704,   4712,   4720,   4728,
+      4736,   4744,   4752,   4760,   4768,   4776,   4784,   4792,   4800,   4808,   4816,   4824,   4832,   4840,   4848,   4856,
+      4864,   4872,   4880,   4888,   4896,   4904,   4912,   4920,   4928,   4936,   4944,   4952,   4960,   4968,   4976,   4984,
+      4992,   5000,   5008,   5016,   5024,   5032,   5040,   5048,   5056,   5064,   5072,   5080,   5088,   5096,   5104,   5112,
+      5120,   5128,   5136,   5144,   5152,   5160,   5168,   5176,   5184,   5192,   5200,   5208,   5216,   5224,   5232,   5240,
+      5248,   5256,   5264,   5272,   5280,   5288,   5296,   5304,   5312,   5320,   5328,   5336,   5344,   5352,   5360,   5368,
+      5376,   5384,   5392,   5400,   5408,   5416,   5424,   5432,   5440,   5448,   5456,   5464,   5472,   5480,   5488,   5496,
+      5504,   5512,   5520,   5528,   5536,   5544,   5552,   5560,   5568,   5576,   5584,   5592,   5600,   5608,   5616,   5624,
+      5632,   5640,   5648,   5656,   5664,   5672,   5680,   5688,   5696,   5704,   5712,   5720,   5728,   5736,   5744,   5752,
+      5760,   5768,   5776,   5784,   5792,   5800,   5808,   5816,   5824,   5832,   5840,   5848,   5856,   5864,   5872,   5880,
+      5888,   5896,   5904,   5912,   5920,   5928,   5936,   5944,   5952,   5960,   5968,   5976,   5984,   5992,   6000,   6008,
+      6016,   6024,   6032,   6040,   6048,   6056,   6064,   6072,   6080,   6088,   6096,   6104,   6112,   6120,   6128,   6136,
+      6144,   6152,   6160,   6168,   6176,   6184,   6192,   6200,   6208,   6216,   6224,   6232,   6240,   6248,   6256,   6264,
+      6272,   6280,   6288,   6296,   6304,   6312,   6320,   6328,   6336,   6344,   6352,   6360,   6368,   6376,   6384,   6392,
+      6400,   6408,   6416,   6424,   6432,   6440,   6448,   6456,   6464,   6472,   6480,   6488,   6496,   6504,   6512,   6520,
+      6528,   6536,   6544,   6552,   6560,   6568,   6576,   6584,   6592,   6600,   6608,   6616,   6624,   6632,   6640,   6648,
+      6656,   6664,   6672,   6680,   6688,   6696,   6704,   6712,   6720,   6728,   6736,   6744,   6752,   6760,   6768,   6776,
+      6784,   6792,   6800,   6808,   6816,   6824,   6832,   6840,   6848,   6856,   6864,   6872,   6880,   6888,   6896,   6904,
+      6912,   6920,   6928,   6936,   6944,   6952,   6960,   6968,   6976,   6984,   6992,   7000,   7008,   7016,   7024,   7032,
+      7040,   7048,   7056,   7064,   7072,   7080,   7088,   7096,   7104,   7112,   7120,   7128,   7136,   7144,   7152,   7160,
+      7168,   7176,   7184,   7192,   7200,   7208,   7216,   7224,   7232,   7240,   7248,   7256,   7264,   7272,   7280,   7288,
+      7296,   7304,   7312,   7320,   7328,   7336,   7344,   7352,   7360,   7368,   7376,   7384,   7392,   7400,   7408,   7416,
+      7424,   7432,   7440,   7448,   7456,   7464,   7472,   7480,   7488,   7496,   7504,   7512,   7520,   7528,   7536,   7544,
+      7552,   7560,   7568,   7576,   7584,   7592,   7600,   7608,   7616,   7624,   7632,   7640,   7648,   7656,   7664,   7672,
+      7680,   7688,   7696,   7704,   7712,   7720,   7728,   7736,   7744,   7752,   7760,   7768,   7776,   7784,   7792,   7800,
+      7808,   7816,   7824,   7832,   7840,   7848,   7856,   7864,   7872,   7880,   7888,   7896,   7904,   7912,   7920,   7928,
+      7936,   7944,   7952,   7960,   7968,   7976,   7984,   7992,   8000,   8008,   8016,   8024,   8032,   8040,   8048,   8056,
+      8064,   8072,   8080,   8088,   8096,   8104,   8112,   8120,   8128,   8136,   8144,   8152,   8160,   8168,   8176,   8184,
+      8192,   8200,   8208,   8216,   8224,   8232,   8240,   8248,   8256,   8264,   8272,   8280,   8288,   8296,   8304,   8312,
+      8320,   8328,   8336,   8344,   8352,   8360,   8368,   8376,   8384,   8392,   8400,   8408,   8416,   8424,   8432,   8440,
+      8448,   8456,   8464,   8472,   8480,   8488,   8496,   8504,   8512,   8520,   8528,   8536,   8544,   8552,   8560,   8568,
+      8576,   8584,   8592,   8600,   8608,   8616,   8624,   8632,   8640,   8648,   8656,   8664,   8672,   8680,   8688,   8696,
+      8704,   8712,   8720,   8728,   8736,   8744,   8752,   8760,   8768,   8776,   8784,   8792,   8800,   8808,   8816,   8824,
+      8832,   8840,   8848,   8856,   8864,   8872,   8880,   8888,   8896,   8904,   8912,   8920,   8928,   8936,   8944,   8952,
+      8960,   8968,   8976,   8984,   8992,   9000,   9008,   9016,   9024,   9032,   9040,   9048,   9056,   9064,   9072,   9080,
+      9088,   9096,   9104,   9112,   9120,   9128,   9136,   9144,   9152,   9160,   9168,   9176,   9184,   9192,   9200,   9208,
+      9216,   9224,   9232,   9240,   9248,   9256,   9264,   9272,   9280,   9288,   9296,   9304,   9312,   9320,   9328,   9336,
+      9344,   9352,   9360,   9368,   9376,   9384,   9392,   9400,   9408,   9416,   9424,   9432,   9440,   9448,   9456,   9464,
+      9472,   9480,   9488,   9496,   9504,   9512,   9520,   9528,   9536,   9544,   9552,   9560,   9568,   9576,   9584,   9592,
+      9600,   9608,   9616,   9624,   9632,   9640,   9648,   9656,   9664,   9672,   9680,   9688,   9696,   9704,   9712,   9720,
+      9728,   9736,   9744,   9752,   9760,   9768,   9776,   9784,   9792,   9800,   9808,   9816,   9824,   9832,   9840,   9848,
+      9856,   9864,   9872,   9880,   9888,   9896,   9904,   9912,   9920,   9928,   9936,   9944,   9952,   9960,   9968,   9976,
+      9984,   9992,  10000,  10008,  10016,  10024,  10032,  10040,  10048,  10056,  10064,  10072,  10080,  10088,  10096,  10104,
+     10112,  10120,  10128,  10136,  10144,  10152,  10160,  10168,  10176,  10184,  10192,  10200,  10208,  10216,  10224,  10232,
+     10240,  10248,  10256,  10264,  10272,  10280,  10288,  10296,  10304,  10312,  10320,  10328,  10336,  10344,  10352,  10360,
+     10368,  10376,  10384,  10392,  10400,  10408,  10416,  10424,  10432,  10440,  10448,  10456,  10464,  10472,  10480,  10488,
+     10496,  10504,  10512,  10520,  10528,  10536,  10544,  10552,  10560,  10568,  10576,  10584,  10592,  10600,  10608,  10616,
+     10624,  10632,  10640,  10648,  10656,  10664,  10672,  10680,  10688,  10696,  10704,  10712,  10720,  10728,  10736,  10744,
+     10752,  10760,  10768,  10776,  10784,  10792,  10800,  10808,  10816,  10824,  10832,  10840,  10848,  10856,  10864,  10872,
+     10880,  10888,  10896,  10904,  10912,  10920,  10928,  10936,  10944,  10952,  10960,  10968,  10976,  10984,  10992,  11000,
+     11008,  11016,  11024,  11032,  11040,  11048,  11056,  11064,  11072,  11080,  11088,  11096,  11104,  11112,  11120,  11128,
+     11136,  11144,  11152,  11160,  11168,  11176,  11184,  11192,  11200,  11208,  11216,  11224,  11232,  11240,  11248,  11256,
+     11264,  11272,  11280,  11288,  11296,  11304,  11312,  11320,  11328,  11336,  11344,  11352,  11360,  11368,  11376,  11384,
+     11392,  11400,  11408,  11416,  11424,  11432,  11440,  11448,  11456,  11464,  11472,  11480,  11488,  11496,  11504,  11512,
+     11520,  11528,  11536,  11544,  11552,  11560,  11568,  11576,  11584,  11592,  11600,  11608,  11616,  11624,  11632,  11640,
+     11648,  11656,  11664,  11672,  11680,  11688,  11696,  11704,  11712,  11720,  11728,  11736,  11744,  11752,  11760,  11768,
+     11776,  11784,  11792,  11800,  11808,  11816,  11824,  11832,  11840,  11848,  11856,  11864,  11872,  11880,  11888,  11896,
+     11904,  11912,  11920,  11928,  11936,  11944,  11952,  11960,  11968,  11976,  11984,  11992,  12000,  12008,  12016,  12024,
+     12032,  12040,  12048,  12056,  12064,  12072,  12080,  12088,  12096,  12104,  12112,  12120,  12128,  12136,  12144,  12152,
+     12160,  12168,  12176,  12184,  12192,  12200,  12208,  12216,  12224,  12232,  12240,  12248,  12256,  12264,  12272,  12280,
+     12288,  12296,  12304,  12312,  12320,  12328,  12336,  12344,  12352,  12360,  12368,  12376,  12384,  12392,  12400,  12408,
+     12416,  12424,  12432,  12440,  12448,  12456,  12464,  12472,  12480,  12488,  12496,  12504,  12512,  12520,  12528,  12536,
+     12544,  12552,  12560,  12568,  12576,  12584,  12592,  12600,  12608,  12616,  12624,  12632,  12640,  12648,  12656,  12664,
+     12672,  12680,  12688,  12696,  12704,  12712,  12720,  12728,  12736,  12744,  12752,  12760,  12768,  12776,  12784,  12792,
+     12800,  12808,  12816,  12824,  12832,  12840,  12848,  12856,  12864,  12872,  12880,  12888,  12896,  12904,  12912,  12920,
+     12928,  12936,  12944,  12952,  12960,  12968,  12976,  12984,  12992,  13000,  13008,  13016,  13024,  13032,  13040,  13048,
+     13056,  13064,  13072,  13080,  13088,  13096,  13104,  13112,  13120,  13128,  13136,  13144,  13152,  13160,  13168,  13176,
+     13184,  13192,  13200,  13208,  13216,  13224,  13232,  13240,  13248,  13256,  13264,  13272,  13280,  13288,  13296,  13304,
+     13312,  13320,  13328,  13336,  13344,  13352,  13360,  13368,  13376,  13384,  13392,  13400,  13408,  13416,  13424,  13432,
+     13440,  13448,  13456,  13464,  13472,  13480,  13488,  13496,  13504,  13512,  13520,  13528,  13536,  13544,  13552,  13560,
+     13568,  13576,  13584,  13592,  13600,  13608,  13616,  13624,  13632,  13640,  13648,  13656,  13664,  13672,  13680,  13688,
+     13696,  13704,  13712,  13720,  13728,  13736,  13744,  13752,  13760,  13768,  13776,  13784,  13792,  13800,  13808,  13816,
+     13824,  13832,  13840,  13848,  13856,  13864,  13872,  13880,  13888,  13896,  13904,  13912,  13920,  13928,  13936,  13944,
+     13952,  13960,  13968,  13976,  13984,  13992,  14000,  14008,  14016,  14024,  14032,  14040,  14048,  14056,  14064,  14072,
+     14080,  14088,  14096,  14104,  14112,  14120,  14128,  14136,  14144,  14152,  14160,  14168,  14176,  14184,  14192,  14200,
+     14208,  14216,  14224,  14232,  14240,  14248,  14256,  14264,  14272,  14280,  14288,  14296,  14304,  14312,  14320,  14328,
+     14336,  14344,  14352,  14360,  14368,  14376,  14384,  14392,  14400,  14408,  14416,  14424,  14432,  14440,  14448,  14456,
+     14464,  14472,  14480,  14488,  14496,  14504,  14512,  14520,  14528,  14536,  14544,  14552,  14560,  14568,  14576,  14584,
+     14592,  14600,  14608,  14616,  14624,  14632,  14640,  14648,  14656,  14664,  14672,  14680,  14688,  14696,  14704,  14712,
+     14720,  14728,  14736,  14744,  14752,  14760,  14768,  14776,  14784,  14792,  14800,  14808,  14816,  14824,  14832,  14840,
+     14848,  14856,  14864,  14872,  14880,  14888,  14896,  14904,  14912,  14920,  14928,  14936,  14944,  14952,  14960,  14968,
+     14976,  14984,  14992,  15000,  15008,  15016,  15024,  15032,  15040,  15048,  15056,  15064,  15072,  15080,  15088,  15096,
+     15104,  15112,  15120,  15128,  15136,  15144,  15152,  15160,  15168,  15176,  15184,  15192,  15200,  15208,  15216,  15224,
+     15232,  15240,  15248,  15256,  15264,  15272,  15280,  15288,  15296,  15304,  15312,  15320,  15328,  15336,  15344,  15352,
+     15360,  15368,  15376,  15384,  15392,  15400,  15408,  15416,  15424,  15432,  15440,  15448,  15456,  15464,  15472,  15480,
+     15488,  15496,  15504,  15512,  15520,  15528,  15536,  15544,  15552,  15560,  15568,  15576,  15584,  15592,  15600,  15608,
+     15616,  15624,  15632,  15640,  15648,  15656,  15664,  15672,  15680,  15688,  15696,  15704,  15712,  15720,  15728,  15736,
+     15744,  15752,  15760,  15768,  15776,  15784,  15792,  15800,  15808,  15816,  15824,  15832,  15840,  15848,  15856,  15864,
+     15872,  15880,  15888,  15896,  15904,  15912,  15920,  15928,  15936,  15944,  15952,  15960,  15968,  15976,  15984,  15992,
+     16000,  16008,  16016,  16024,  16032,  16040,  16048,  16056,  16064,  16072,  16080,  16088,  16096,  16104,  16112,  16120,
+     16128,  16136,  16144,  16152,  16160,  16168,  16176,  16184,  16192,  16200,  16208,  16216,  16224,  16232,  16240,  16248,
+     16256,  16264,  16272,  16280,  16288,  16296,  16304,  16312,  16320,  16328,  16336,  16344,  16352,  16360,  16368,  16376,
+     16384,  16392,  16400,  16408,  16416,  16424,  16432,  16440,  16448,  16456,  16464,  16472,  16480,  16488,  16496,  16504,
+     16512,  16520,  16528,  16536,  16544,  16552,  16560,  16568,  16576,  16584,  16592,  16600,  16608,  16616,  16624,  16632,
+     16640,  16648,  16656,  16664,  16672,  16680,  16688,  16696,  16704,  16712,  16720,  16728,  16736,  16744,  16752,  16760,
+     16768,  16776,  16784,  16792,  16800,  16808,  16816,  16824,  16832,  16840,  16848,  16856,  16864,  16872,  16880,  16888,
+     16896,  16904,  16912,  16920,  16928,  16936,  16944,  16952,  16960,  16968,  16976,  16984,  16992,  17000,  17008,  17016,
+     17024,  17032,  17040,  17048,  17056,  17064,  17072,  17080,  17088,  17096,  17104,  17112,  17120,  17128,  17136,  17144,
+     17152,  17160,  17168,  17176,  17184,  17192,  17200,  17208,  17216,  17224,  17232,  17240,  17248,  17256,  17264,  17272,
+     17280,  17288,  17296,  17304,  17312,  17320,  17328,  17336,  17344,  17352,  17360,  17368,  17376,  17384,  17392,  17400,
+     17408,  17416,  17424,  17432,  17440,  17448,  17456,  17464,  17472,  17480,  17488,  17496,  17504,  17512,  17520,  17528,
+     17536,  17544,  17552,  17560,  17568,  17576,  17584,  17592,  17600,  17608,  17616,  17624,  17632,  17640,  17648,  17656,
+     17664,  17672,  17680,  17688,  17696,  17704,  17712,  17720,  17728,  17736,  17744,  17752,  17760,  17768,  17776,  17784,
+     17792,  17800,  17808,  17816,  17824,  17832,  17840,  17848,  17856,  17864,  17872,  17880,  17888,  17896,  17904,  17912,
+     17920,  17928,  17936,  17944,  17952,  17960,  17968,  17976,  17984,  17992,  18000,  18008,  18016,  18024,  18032,  18040,
+     18048,  18056,  18064,  18072,  18080,  18088,  18096,  18104,  18112,  18120,  18128,  18136,  18144,  18152,  18160,  18168,
+     18176,  18184,  18192,  18200,  18208,  18216,  18224,  18232,  18240,  18248,  18256,  18264,  18272,  18280,  18288,  18296,
+     18304,  18312,  18320,  18328,  18336,  18344,  18352,  18360,  18368,  18376,  18384,  18392,  18400,  18408,  18416,  18424,
+     18432,  18440,  18448,  18456,  18464,  18472,  18480,  18488,  18496,  18504,  18512,  18520,  18528,  18536,  18544,  18552,
+     18560,  18568,  18576,  18584,  18592,  18600,  18608,  18616,  18624,  18632,  18640,  18648,  18656,  18664,  18672,  18680,
+     18688,  18696,  18704,  18712,  18720,  18728,  18736,  18744,  18752,  18760,  18768,  18776,  18784,  18792,  18800,  18808,
+     18816,  18824,  18832,  18840,  18848,  18856,  18864,  18872,  18880,  18888,  18896,  18904,  18912,  18920,  18928,  18936,
+     18944,  18952,  18960,  18968,  18976,  18984,  18992,  19000,  19008,  19016,  19024,  19032,  19040,  19048,  19056,  19064,
+     19072,  19080,  19088,  19096,  19104,  19112,  19120,  19128,  19136,  19144,  19152,  19160,  19168,  19176,  19184,  19192,
+     19200,  19208,  19216,  19224,  19232,  19240,  19248,  19256,  19264,  19272,  19280,  19288,  19296,  19304,  19312,  19320,
+     19328,  19336,  19344,  19352,  19360,  19368,  19376,  19384,  19392,  19400,  19408,  19416,  19424,  19432,  19440,  19448,
+     19456,  19464,  19472,  19480,  19488,  19496,  19504,  19512,  19520,  19528,  19536,  19544,  19552,  19560,  19568,  19576,
+     19584,  19592,  19600,  19608,  19616,  19624,  19632,  19640,  19648,  19656,  19664,  19672,  19680,  19688,  19696,  19704,
+     19712,  19720,  19728,  19736,  19744,  19752,  19760,  19768,  19776,  19784,  19792,  19800,  19808,  19816,  19824,  19832,
+     19840,  19848,  19856,  19864,  19872,  19880,  19888,  19896,  19904,  19912,  19920,  19928,  19936,  19944,  19952,  19960,
+     19968,  19976,  19984,  19992,  20000,  20008,  20016,  20024,  20032,  20040,  20048,  20056,  20064,  20072,  20080,  20088,
+     20096,  20104,  20112,  20120,  20128,  20136,  20144,  20152,  20160,  20168,  20176,  20184,  20192,  20200,  20208,  20216,
+     20224,  20232,  20240,  20248,  20256,  20264,  20272,  20280,  20288,  20296,  20304,  20312,  20320,  20328,  20336,  20344,
+     20352,  20360,  20368,  20376,  20384,  20392,  20400,  20408,  20416,  20424,  20432,  20440,  20448,  20456,  20464,  20472,
+     20480,  20488,  20496,  20504,  20512,  20520,  20528,  20536,  20544,  20552,  20560,  20568,  20576,  20584,  20592,  20600,
+     20608,  20616,  20624,  20632,  20640,  20648,  20656,  20664,  20672,  20680,  20688,  20696,  20704,  20712,  20720,  20728,
+     20736,  20744,  20752,  20760,  20768,  20776,  20784,  20792,  20800,  20808,  20816,  20824,  20832,  20840,  20848,  20856,
+     20864,  20872,  20880,  20888,  20896,  20904,  20912,  20920,  20928,  20936,  20944,  20952,  20960,  20968,  20976,  20984,
+     20992,  21000,  21008,  21016,  21024,  21032,  21040,  21048,  21056,  21064,  21072,  21080,  21088,  21096,  21104,  21112,
+     21120,  21128,  21136,  21144,  21152,  21160,  21168,  21176,  21184,  21192,  21200,  21208,  21216,  21224,  21232,  21240,
+     21248,  21256,  21264,  21272,  21280,  21288,  21296,  21304,  21312,  21320,  21328,  21336,  21344,  21352,  21360,  21368,
+     21376,  21384,  21392,  21400,  21408,  21416,  21424,  21432,  21440,  21448,  21456,  21464,  21472,  21480,  21488,  21496,
+     21504,  21512,  21520,  21528,  21536,  21544,  21552,  21560,  21568,  21576,  21584,  21592,  21600,  21608,  21616,  21624,
+     21632,  21640,  21648,  21656,  21664,  21672,  21680,  21688,  21696,  21704,  21712,  21720,  21728,  21736,  21744,  21752,
+     21760,  21768,  21776,  21784,  21792,  21800,  21808,  21816,  21824,  21832,  21840,  21848,  21856,  21864,  21872,  21880,
+     21888,  21896,  21904,  21912,  21920,  21928,  21936,  21944,  21952,  21960,  21968,  21976,  21984,  21992,  22000,  22008,
+     22016,  22024,  22032,  22040,  22048,  22056,  22064,  22072,  22080,  22088,  22096,  22104,  22112,  22120,  22128,  22136,
+     22144,  22152,  22160,  22168,  22176,  22184,  22192,  22200,  22208,  22216,  22224,  22232,  22240,  22248,  22256,  22264,
+     22272,  22280,  22288,  22296,  22304,  22312,  22320,  22328,  22336,  22344,  22352,  22360,  22368,  22376,  22384,  22392,
+     22400,  22408,  22416,  22424,  22432,  22440,  22448,  22456,  22464,  22472,  22480,  22488,  22496,  22504,  22512,  22520,
+     22528,  22536,  22544,  22552,  22560,  22568,  22576,  22584,  22592,  22600,  22608,  22616,  22624,  22632,  22640,  22648,
+     22656,  22664,  22672,  22680,  22688,  22696,  22704,  22712,  22720,  22728,  22736,  22744,  22752,  22760,  22768,  22776,
+     22784,  22792,  22800,  22808,  22816,  22824,  22832,  22840,  22848,  22856,  22864,  22872,  22880,  22888,  22896,  22904,
+     22912,  22920,  22928,  22936,  22944,  22952,  22960,  22968,  22976,  22984,  22992,  23000,  23008,  23016,  23024,  23032,
+     23040,  23048,  23056,  23064,  23072,  23080,  23088,  23096,  23104,  23112,  23120,  23128,  23136,  23144,  23152,  23160,
+     23168,  23176,  23184,  23192,  23200,  23208,  23216,  23224,  23232,  23240,  23248,  23256,  23264,  23272,  23280,  23288,
+     23296,  23304,  23312,  23320,  23328,  23336,  23344,  23352,  23360,  23368,  23376,  23384,  23392,  23400,  23408,  23416,
+     23424,  23432,  23440,  23448,  23456,  23464,  23472,  23480,  23488,  23496,  23504,  23512,  23520,  23528,  23536,  23544,
+     23552,  23560,  23568,  23576,  23584,  23592,  23600,  23608,  23616,  23624,  23632,  23640,  23648,  23656,  23664,  23672,
+     23680,  23688,  23696,  23704,  23712,  23720,  23728,  23736,  23744,  23752,  23760,  23768,  23776,  23784,  23792,  23800,
+     23808,  23816,  23824,  23832,  23840,  23848,  23856,  23864,  23872,  23880,  23888,  23896,  23904,  23912,  23920,  23928,
+     23936,  23944,  23952,  23960,  23968,  23976,  23984,  23992,  24000,  24008,  24016,  24024,  24032,  24040,  24048,  24056,
+     24064,  24072,  24080,  24088,  24096,  24104,  24112,  24120,  24128,  24136,  24144,  24152,  24160,  24168,  24176,  24184,
+     24192,  24200,  24208,  24216,  24224,  24232,  24240,  24248,  24256,  24264,  24272,  24280,  24288,  24296,  24304,  24312,
+     24320,  24328,  24336,  24344,  24352,  24360,  24368,  24376,  24384,  24392,  24400,  24408,  24416,  24424,  24432,  24440,
+     24448,  24456,  24464,  24472,  24480,  24488,  24496,  24504,  24512,  24520,  24528,  24536,  24544,  24552,  24560,  24568,
+     24576,  24584,  24592,  24600,  24608,  24616,  24624,  24632,  24640,  24648,  24656,  24664,  24672,  24680,  24688,  24696,
+     24704,  24712,  24720,  24728,  24736,  24744,  24752,  24760,  24768,  24776,  24784,  24792,  24800,  24808,  24816,  24824,
+     24832,  24840,  24848,  24856,  24864,  24872,  24880,  24888,  24896,  24904,  24912,  24920,  24928,  24936,  24944,  24952,
+     24960,  24968,  24976,  24984,  24992,  25000,  25008,  25016,  25024,  25032,  25040,  25048,  25056,  25064,  25072,  25080,
+     25088,  25096,  25104,  25112,  25120,  25128,  25136,  25144,  25152,  25160,  25168,  25176,  25184,  25192,  25200,  25208,
+     25216,  25224,  25232,  25240,  25248,  25256,  25264,  25272,  25280,  25288,  25296,  25304,  25312,  25320,  25328,  25336,
+     25344,  25352,  25360,  25368,  25376,  25384,  25392,  25400,  25408,  25416,  25424,  25432,  25440,  25448,  25456,  25464,
+     25472,  25480,  25488,  25496,  25504,  25512,  25520,  25528,  25536,  25544,  25552,  25560,  25568,  25576,  25584,  25592,
+     25600,  25608,  25616,  25624,  25632,  25640,  25648,  25656,  25664,  25672,  25680,  25688,  25696,  25704,  25712,  25720,
+     25728,  25736,  25744,  25752,  25760,  25768,  25776,  25784,  25792,  25800,  25808,  25816,  25824,  25832,  25840,  25848,
+     25856,  25864,  25872,  25880,  25888,  25896,  25904,  25912,  25920,  25928,  25936,  25944,  25952,  25960,  25968,  25976,
+     25984,  25992,  26000,  26008,  26016,  26024,  26032,  26040,  26048,  26056,  26064,  26072,  26080,  26088,  26096,  26104,
+     26112,  26120,  26128,  26136,  26144,  26152,  26160,  26168,  26176,  26184,  26192,  26200,  26208,  26216,  26224,  26232,
+     26240,  26248,  26256,  26264,  26272,  26280,  26288,  26296,  26304,  26312,  26320,  26328,  26336,  26344,  26352,  26360,
+     26368,  26376,  26384,  26392,  26400,  26408,  26416,  26424,  26432,  26440,  26448,  26456,  26464,  26472,  26480,  26488,
+     26496,  26504,  26512,  26520,  26528,  26536,  26544,  26552,  26560,  26568,  26576,  26584,  26592,  26600,  26608,  26616,
+     26624,  26632,  26640,  26648,  26656,  26664,  26672,  26680,  26688,  26696,  26704,  26712,  26720,  26728,  26736,  26744,
+     26752,  26760,  26768,  26776,  26784,  26792,  26800,  26808,  26816,  26824,  26832,  26840,  26848,  26856,  26864,  26872,
+     26880,  26888,  26896,  26904,  26912,  26920,  26928,  26936,  26944,  26952,  26960,  26968,  26976,  26984,  26992,  27000,
+     27008,  27016,  27024,  27032,  27040,  27048,  27056,  27064,  27072,  27080,  27088,  27096,  27104,  27112,  27120,  27128,
+     27136,  27144,  27152,  27160,  27168,  27176,  27184,  27192,  27200,  27208,  27216,  27224,  27232,  27240,  27248,  27256,
+     27264,  27272,  27280,  27288,  27296,  27304,  27312,  27320,  27328,  27336,  27344,  27352,  27360,  27368,  27376,  27384,
+     27392,  27400,  27408,  27416,  27424,  27432,  27440,  27448,  27456,  27464,  27472,  27480,  27488,  27496,  27504,  27512,
+     27520,  27528,  27536,  27544,  27552,  27560,  27568,  27576,  27584,  27592,  27600,  27608,  27616,  27624,  27632,  27640,
+     27648,  27656,  27664,  27672,  27680,  27688,  27696,  27704,  27712,  27720,  27728,  27736,  27744,  27752,  27760,  27768,
+     27776,  27784,  27792,  27800,  27808,  27816,  27824,  27832,  27840,  27848,  27856,  27864,  27872,  27880,  27888,  27896,
+     27904,  27912,  27920,  27928,  27936,  27944,  27952,  27960,  27968,  27976,  27984,  27992,  28000,  28008,  28016,  28024,
+     28032,  28040,  28048,  28056,  28064,  28072,  28080,  28088,  28096,  28104,  28112,  28120,  28128,  28136,  28144,  28152,
+     28160,  28168,  28176,  28184,  28192,  28200,  28208,  28216,  28224,  28232,  28240,  28248,  28256,  28264,  28272,  28280,
+     28288,  28296,  28304,  28312,  28320,  28328,  28336,  28344,  28352,  28360,  28368,  28376,  28384,  28392,  28400,  28408,
+     28416,  28424,  28432,  28440,  28448,  28456,  28464,  28472,  28480,  28488,  28496,  28504,  28512,  28520,  28528,  28536,
+     28544,  28552,  28560,  28568,  28576,  28584,  28592,  28600,  28608,  28616,  28624,  28632,  28640,  28648,  28656,  28664,
+     28672,  28680,  28688,  28696,  28704,  28712,  28720,  28728,  28736,  28744,  28752,  28760,  28768,  28776,  28784,  28792,
+     28800,  28808,  28816,  28824,  28832,  28840,  28848,  28856,  28864,  28872,  28880,  28888,  28896,  28904,  28912,  28920,
+     28928,  28936,  28944,  28952,  28960,  28968,  28976,  28984,  28992,  29000,  29008,  29016,  29024,  29032,  29040,  29048,
+     29056,  29064,  29072,  29080,  29088,  29096,  29104,  29112,  29120,  29128,  29136,  29144,  29152,  29160,  29168,  29176,
+     29184,  29192,  29200,  29208,  29216,  29224,  29232,  29240,  29248,  29256,  29264,  29272,  29280,  29288,  29296,  29304,
+     29312,  29320,  29328,  29336,  29344,  29352,  29360,  29368,  29376,  29384,  29392,  29400,  29408,  29416,  29424,  29432,
+     29440,  29448,  29456,  29464,  29472,  29480,  29488,  29496,  29504,  29512,  29520,  29528,  29536,  29544,  29552,  29560,
+     29568,  29576,  29584,  29592,  29600,  29608,  29616,  29624,  29632,  29640,  29648,  29656,  29664,  29672,  29680,  29688,
+     29696,  29704,  29712,  29720,  29728,  29736,  29744,  29752,  29760,  29768,  29776,  29784,  29792,  29800,  29808,  29816,
+     29824,  29832,  29840,  29848,  29856,  29864,  29872,  29880,  29888,  29896,  29904,  29912,  29920,  29928,  29936,  29944,
+     29952,  29960,  29968,  29976,  29984,  29992,  30000,  30008,  30016,  30024,  30032,  30040,  30048,  30056,  30064,  30072,
+     30080,  30088,  30096,  30104,  30112,  30120,  30128,  30136,  30144,  30152,  30160,  30168,  30176,  30184,  30192,  30200,
+     30208,  30216,  30224,  30232,  30240,  30248,  30256,  30264,  30272,  30280,  30288,  30296,  30304,  30312,  30320,  30328,
+     30336,  30344,  30352,  30360,  30368,  30376,  30384,  30392,  30400,  30408,  30416,  30424,  30432,  30440,  30448,  30456,
+     30464,  30472,  30480,  30488,  30496,  30504,  30512,  30520,  30528,  30536,  30544,  30552,  30560,  30568,  30576,  30584,
+     30592,  30600,  30608,  30616,  30624,  30632,  30640,  30648,  30656,  30664,  30672,  30680,  30688,  30696,  30704,  30712,
+     30720,  30728,  30736,  30744,  30752,  30760,  30768,  30776,  30784,  30792,  30800,  30808,  30816,  30824,  30832,  30840,
+     30848,  30856,  30864,  30872,  30880,  30888,  30896,  30904,  30912,  30920,  30928,  30936,  30944,  30952,  30960,  30968,
+     30976,  30984,  30992,  31000,  31008,  31016,  31024,  31032,  31040,  31048,  31056,  31064,  31072,  31080,  31088,  31096,
+     31104,  31112,  31120,  31128,  31136,  31144,  31152,  31160,  31168,  31176,  31184,  31192,  31200,  31208,  31216,  31224,
+     31232,  31240,  31248,  31256,  31264,  31272,  31280,  31288,  31296,  31304,  31312,  31320,  31328,  31336,  31344,  31352,
+     31360,  31368,  31376,  31384,  31392,  31400,  31408,  31416,  31424,  31432,  31440,  31448,  31456,  31464,  31472,  31480,
+     31488,  31496,  31504,  31512,  31520,  31528,  31536,  31544,  31552,  31560,  31568,  31576,  31584,  31592,  31600,  31608,
+     31616,  31624,  31632,  31640,  31648,  31656,  31664,  31672,  31680,  31688,  31696,  31704,  31712,  31720,  31728,  31736,
+     31744,  31752,  31760,  31768,  31776,  31784,  31792,  31800,  31808,  31816,  31824,  31832,  31840,  31848,  31856,  31864,
+     31872,  31880,  31888,  31896,  31904,  31912,  31920,  31928,  31936,  31944,  31952,  31960,  31968,  31976,  31984,  31992,
+     32000,  32008,  32016,  32024,  32032,  32040,  32048,  32056,  32064,  32072,  32080,  32088,  32096,  32104,  32112,  32120,
+     32128,  32136,  32144,  32152,  32160,  32168,  32176,  32184,  32192,  32200,  32208,  32216,  32224,  32232,  32240,  32248,
+     32256,  32264,  32272,  32280,  32288,  32296,  32304,  32312,  32320,  32328,  32336,  32344,  32352,  32360,  32368,  32376,
+     32384,  32392,  32400,  32408,  32416,  32424,  32432,  32440,  32448,  32456,  32464,  32472,  32480,  32488,  32496,  32504,
+     32512,  32520,  32528,  32536,  32544,  32552,  32560,  32568,  32576,  32584,  32592,  32600,  32608,  32616,  32624,  32632,
+     32640,  32648,  32656,  32664,  32672,  32680,  32688,  32696,  32704,  32712,  32720,  32728,  32736,  32744,  32752,  32760,
+};
+#endif
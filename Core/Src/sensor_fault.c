@@ -0,0 +1,97 @@
+#include "sensor_fault.h"
+#include "stm32f4xx_hal.h"
+#include "arm_math.h"
+#include <math.h>
+#include <string.h>
+
+static void sensor_fault_features(const sensor_fault_instance_t *S, const slosh_instance_t *slosh, float *f) {
+    const int64_t n = SENSOR_FAULT_WIN;
+    const int64_t sum_i = n * (n - 1) / 2;
+    const int64_t sum_ii = (n - 1) * n * (2 * n - 1) / 6;
+    float var;
+    float slope;
+
+    // n^2 * variance and the least-squares slope numerator, both exact
+    var = (float)(n * (int64_t)S->win_sum_sq - (int64_t)S->win_sum * S->win_sum) / (float)(n * n);
+    slope = (float)(n * (int64_t)S->win_sum_ix - sum_i * (int64_t)S->win_sum)
+          / (float)(n * sum_ii - sum_i * sum_i);
+    slope *= SLOSH_SAMPLE_HZ;   // counts per second
+
+    f[0] = log10f(var + 1.0f);
+    f[1] = log10f(fabsf(slope) + 1.0f);
+    f[2] = slosh->info.flatness;  // the slosh stage analysed the last block of this window
+    f[3] = (float)S->win_clamp / n;
+}
+
+static void sensor_fault_classify(sensor_fault_instance_t *S, const slosh_instance_t *slosh) {
+    float32_t prob[SENSOR_FAULT_NCLASS];
+    float32_t scratch[SENSOR_FAULT_NCLASS];
+    uint32_t start = DWT->CYCCNT;
+    uint32_t budget = (SystemCoreClock / 1000000U) * SENSOR_FAULT_BUDGET_US;
+    uint32_t cls;
+
+    sensor_fault_features(S, slosh, S->stats.features);
+    cls = arm_gaussian_naive_bayes_predict_f32(&S->nb, S->stats.features, prob, scratch);
+
+    S->stats.infer_cycles = DWT->CYCCNT - start;
+    if (S->stats.infer_cycles > S->stats.infer_cycles_max) S->stats.infer_cycles_max = S->stats.infer_cycles;
+    if (S->stats.infer_cycles > budget) S->stats.budget_overruns++;
+    S->stats.last_class = (uint8_t)cls;
+
+    // Require the same verdict on consecutive windows before changing state
+    if (sensor_fault_class_state[cls] == S->candidate) {
+        if (S->candidate_count < SENSOR_FAULT_CONFIRM) S->candidate_count++;
+    } else {
+        S->candidate = sensor_fault_class_state[cls];
+        S->candidate_count = 1;
+    }
+    if (S->candidate_count >= SENSOR_FAULT_CONFIRM) {
+        S->state = S->candidate;
+    }
+}
+
+void sensor_fault_init(sensor_fault_instance_t *S) {
+    S->win_n = 0;
+    S->win_sum = S->win_sum_ix = 0;
+    S->win_sum_sq = 0;
+    S->win_clamp = 0;
+    S->state = S->candidate = SENSOR_OK;
+    S->candidate_count = 0;
+    memset(&S->stats, 0, sizeof(S->stats));
+
+    S->nb.vectorDimension = SENSOR_FAULT_NFEAT;
+    S->nb.numberOfClasses = SENSOR_FAULT_NCLASS;
+    S->nb.theta = sensor_fault_theta;
+    S->nb.sigma = sensor_fault_sigma;
+    S->nb.classPriors = sensor_fault_priors;
+    S->nb.epsilon = sensor_fault_epsilon;
+
+    // Cycle counter for the inference budget
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/* Feed one raw ADC sample, in step with slosh_filter() on the same channel */
+void sensor_fault_push(sensor_fault_instance_t *S, const slosh_instance_t *slosh, uint16_t raw) {
+    S->win_sum += raw;
+    S->win_sum_sq += (uint32_t)raw * raw;
+    S->win_sum_ix += S->win_n * raw;
+    if (raw >= SENSOR_CLAMP_HIGH_RAW) S->win_clamp++;
+    else if (raw <= SENSOR_CLAMP_LOW_RAW) S->win_clamp--;
+
+    if (++S->win_n == SENSOR_FAULT_WIN) {
+        sensor_fault_classify(S, slosh);
+        S->win_n = 0;
+        S->win_sum = S->win_sum_ix = 0;
+        S->win_sum_sq = 0;
+        S->win_clamp = 0;
+    }
+}
+
+sensor_state_t sensor_fault_get(const sensor_fault_instance_t *S) {
+    return S->state;
+}
+
+void sensor_fault_get_stats(const sensor_fault_instance_t *S, sensor_fault_stats_t *out) {
+    *out = S->stats;
+}
@@ -0,0 +1,29 @@
+/* Generated by Tools/train_fault_model.py (synthetic, 300 windows/class, seed 1) -- do not edit. */
+#include "sensor_fault.h"
+
+// Per class (ok, still, slosh, open, shorted): mean of log10 var, log10 |slope|, flatness, clamp ratio
+const float sensor_fault_theta[SENSOR_FAULT_NCLASS * SENSOR_FAULT_NFEAT] = {
+    3.65816051e+00f, 8.35367958e-01f, 1.62593924e-01f, -8.85416667e-04f,
+    1.19748180e-01f, 1.42536331e-03f, 6.32471866e-01f, -5.06341146e-01f,
+    4.47872350e+00f, 3.62908485e-01f, 4.50030654e-02f, -1.47526042e-02f,
+    5.27320405e+00f, 5.22247102e-01f, 2.99812659e-01f, -3.48828125e-02f,
+    1.84191679e+00f, 2.40265895e-02f, 1.00000000e+00f, 1.00000000e+00f,
+};
+
+const float sensor_fault_sigma[SENSOR_FAULT_NCLASS * SENSOR_FAULT_NFEAT] = {
+    1.96846328e-01f, 9.09806342e-02f, 1.19678370e-02f, 1.84864638e-04f,
+    1.66042553e-02f, 3.35859893e-06f, 1.04439905e-01f, 2.49636660e-01f,
+    1.34078371e-01f, 3.15938770e-02f, 2.30759000e-03f, 4.59462670e-03f,
+    1.31249355e-01f, 7.74755619e-02f, 6.94742984e-03f, 5.70767873e-03f,
+    4.58778908e-03f, 2.70894400e-04f, 9.98402083e-31f, 0.00000000e+00f,
+};
+
+const float sensor_fault_priors[SENSOR_FAULT_NCLASS] = {
+    2.00000000e-01f, 2.00000000e-01f, 2.00000000e-01f, 2.00000000e-01f, 2.00000000e-01f
+};
+
+const float sensor_fault_epsilon = 2.49636660e-10f;
+
+const sensor_state_t sensor_fault_class_state[SENSOR_FAULT_NCLASS] = {
+    SENSOR_OK, SENSOR_OK, SENSOR_OK, SENSOR_OPEN, SENSOR_SHORTED
+};
@@ -0,0 +1,120 @@
+#include "slosh_filter.h"
+#include "arm_math.h"
+#include <math.h>
+#include <string.h>
+
+#if !DSP_RFFT_F32(SLOSH_FFT_LEN)
+#error "declare the SLOSH_FFT_LEN real FFT in dsp_config.h"
+#endif
+
+/* Design a unity-DC-gain notch at freq_hz (CMSIS coefficient order b0 b1 b2 a1 a2) */
+static void slosh_set_notch(slosh_instance_t *S, float freq_hz, uint8_t preload) {
+    float w0 = 2.0f * PI * freq_hz / SLOSH_SAMPLE_HZ;
+    float alpha = sinf(w0) / (2.0f * SLOSH_NOTCH_Q);
+    float cw = cosf(w0);
+    float a0 = 1.0f + alpha;
+
+    S->notch_coeffs[0] = 1.0f / a0;
+    S->notch_coeffs[1] = -2.0f * cw / a0;
+    S->notch_coeffs[2] = 1.0f / a0;
+    S->notch_coeffs[3] = 2.0f * cw / a0;
+    S->notch_coeffs[4] = -(1.0f - alpha) / a0;
+
+    // Preload the steady state for the current level so switching the notch
+    // in does not inject a step transient into the control path.
+    if (!preload) return;
+    S->notch_state[1] = (S->notch_coeffs[2] + S->notch_coeffs[4]) * S->last_input;
+    S->notch_state[0] = (S->notch_coeffs[1] + S->notch_coeffs[3]) * S->last_input + S->notch_state[1];
+}
+
+/* Geometric / arithmetic mean of the power spectrum, DC and Nyquist excluded */
+static float slosh_flatness(const slosh_instance_t *S) {
+    const float eps = 1e-9f;
+    float log_sum = 0.0f;
+    float sum = 0.0f;
+
+    for (int k = 1; k < SLOSH_FFT_LEN / 2; k++) {
+        float p = S->spectrum[k] * S->spectrum[k];
+        log_sum += logf(p + eps);
+        sum += p;
+    }
+    return expf(log_sum / (SLOSH_FFT_LEN / 2 - 1)) / (sum / (SLOSH_FFT_LEN / 2 - 1) + eps);
+}
+
+static void slosh_analyse(slosh_instance_t *S) {
+    float32_t mean;
+    float32_t peak;
+    uint32_t peak_bin;
+    uint32_t lo = (uint32_t)(SLOSH_MIN_HZ * SLOSH_FFT_LEN / SLOSH_SAMPLE_HZ);
+    uint32_t hi = (uint32_t)(SLOSH_MAX_HZ * SLOSH_FFT_LEN / SLOSH_SAMPLE_HZ);
+
+    if (lo < 1) lo = 1;
+    if (hi > SLOSH_FFT_LEN / 2 - 1) hi = SLOSH_FFT_LEN / 2 - 1;
+
+    // Remove the level itself, then apply a Hann window in place
+    arm_mean_f32(S->block, SLOSH_FFT_LEN, &mean);
+    for (int i = 0; i < SLOSH_FFT_LEN; i++) {
+        float w = 0.5f - 0.5f * cosf(2.0f * PI * i / (SLOSH_FFT_LEN - 1));
+        S->block[i] = (S->block[i] - mean) * w;
+    }
+
+    arm_rfft_fast_f32(&S->fft, S->block, S->spectrum, 0);
+    // Packed real spectrum -> magnitudes, in place (bin 0 holds DC/Nyquist)
+    arm_cmplx_mag_f32(S->spectrum, S->spectrum, SLOSH_FFT_LEN / 2);
+    arm_max_f32(&S->spectrum[lo], hi - lo + 1, &peak, &peak_bin);
+    S->info.flatness = slosh_flatness(S);
+    peak_bin += lo;
+
+    // The wave sits between bins: a notch on the bin centre leaves up to
+    // half a bin (0.04 Hz) of it. For a Hann window the larger neighbour
+    // over the peak is (1 + d) / (2 - d) at an offset of d bins.
+    float left = S->spectrum[peak_bin - 1];
+    float right = S->spectrum[peak_bin + 1];
+    float d = right > left ? (2.0f * right - peak) / (peak + right) : -(2.0f * left - peak) / (peak + left);
+    if (peak <= 0.0f) d = 0.0f;
+
+    // Hann coherent gain is 0.5: amplitude = 4 * |X| / N, less the scalloping loss off the bin centre
+    S->info.amp_mm = 4.0f * peak / SLOSH_FFT_LEN;
+    if (d != 0.0f) S->info.amp_mm *= PI * d * (1.0f - d * d) / sinf(PI * d);
+    S->info.freq_hz = ((float)peak_bin + d) * SLOSH_SAMPLE_HZ / SLOSH_FFT_LEN;
+
+    if (S->info.amp_mm >= SLOSH_MIN_AMP_MM) {
+        slosh_set_notch(S, S->info.freq_hz, !S->info.notch_on);
+        S->info.notch_on = 1;
+    } else {
+        S->info.notch_on = 0;
+    }
+}
+
+void slosh_init(slosh_instance_t *S) {
+    memset(&S->info, 0, sizeof(S->info));
+    S->block_fill = 0;
+    S->block_count = 0;
+    S->last_input = 0.0f;
+    arm_rfft_fast_init_f32(&S->fft, SLOSH_FFT_LEN);
+    arm_biquad_cascade_df2T_init_f32(&S->notch, 1, S->notch_coeffs, S->notch_state);
+}
+
+/* Feed one level sample; returns the sample with the slosh band removed */
+float slosh_filter(slosh_instance_t *S, float level_mm) {
+    float32_t out = level_mm;
+
+    S->last_input = level_mm;
+    if (S->info.notch_on) {
+        arm_biquad_cascade_df2T_f32(&S->notch, &S->last_input, &out, 1);
+    }
+
+    S->block[S->block_fill++] = level_mm;
+    if (S->block_fill == SLOSH_FFT_LEN) {
+        S->block_fill = 0;
+        if (++S->block_count >= SLOSH_ANALYSE_EVERY) {
+            S->block_count = 0;
+            slosh_analyse(S);
+        }
+    }
+    return out;
+}
+
+void slosh_get_info(const slosh_instance_t *S, slosh_info_t *out) {
+    *out = S->info;
+}
@@ -22,6 +22,7 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "uart_tx.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -233,4 +234,12 @@ void EXTI15_10_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles DMA1 stream6 global interrupt (USART2 TX, uart_tx.c).
+  */
+void DMA1_Stream6_IRQHandler(void)
+{
+  uart_tx_dma_irq();
+}
+
 /* USER CODE END 1 */
@@ -0,0 +1,103 @@
+#include "task_model.h"
+#include "FreeRTOS.h"
+
+const task_model_t task_model[] = {
+    { "isr_tick",    ISR_TICK_PERIOD_US,    ISR_TICK_WCET_US,    0, TASK_MODEL_ISR },
+    { "isr_haltick", ISR_HALTICK_PERIOD_US, ISR_HALTICK_WCET_US, 0, TASK_MODEL_ISR },
+    { "isr_ir",      ISR_IR_PERIOD_US,      ISR_IR_WCET_US,      0, TASK_MODEL_ISR },
+    { "isr_uart",    ISR_UART_PERIOD_US,    ISR_UART_WCET_US,    0, TASK_MODEL_ISR },
+    { "water", TASK_WATER_PERIOD_MS * 1000U, TASK_WATER_WCET_US, TASK_WATER_CS_US, TASK_WATER_PRIO,
+      TASK_WATER_QUIET_MS * 1000U },
+    { "timer", TASK_TIMER_PERIOD_MS * 1000U, TASK_TIMER_WCET_US, TASK_TIMER_CS_US, TASK_TIMER_PRIO },
+    { "work",  TASK_WORK_PERIOD_MS * 1000U,  TASK_WORK_WCET_US,  TASK_WORK_CS_US,  TASK_WORK_PRIO },
+    { "trace", 0, 0, TASK_TRACE_CS_US, TASK_TRACE_PRIO },
+};
+
+const uint32_t task_model_count = sizeof(task_model) / sizeof(task_model[0]);
+uint32_t task_model_wcrt_us[sizeof(task_model) / sizeof(task_model[0])];
+
+/* Budget at cpu_hz, rounded up; never shorter than at TASK_MODEL_REF_HZ */
+static uint32_t task_model_scale(uint32_t us, uint32_t cpu_hz) {
+    if (cpu_hz >= TASK_MODEL_REF_HZ) return us;
+    return (uint32_t)(((uint64_t)us * TASK_MODEL_REF_HZ + cpu_hz - 1) / cpu_hz);
+}
+
+/* Worst-case blocking of a task at prio under priority inheritance: one
+   shared mutex, so at most one lower-priority hold, and only if some user
+   of the mutex runs at or above prio (direct or push-through blocking). */
+static uint32_t task_model_blocking(uint32_t prio, uint32_t cpu_hz) {
+    uint32_t ceiling = 0;
+    uint32_t b = 0;
+
+    for (uint32_t j = 0; j < task_model_count; j++) {
+        if (task_model[j].cs_us && task_model[j].prio > ceiling) ceiling = task_model[j].prio;
+    }
+    if (ceiling < prio) return 0;
+    for (uint32_t j = 0; j < task_model_count; j++) {
+        if (task_model[j].prio < prio && task_model[j].cs_us > b) b = task_model[j].cs_us;
+    }
+    return task_model_scale(b, cpu_hz);
+}
+
+/* Response-time analysis of task i: R = C + sum over higher/equal priority
+   of ceil(R / T) * C, iterated to a fixed point or past the deadline. */
+static uint32_t task_model_rta(uint32_t i, uint32_t c, uint32_t deadline_us, uint32_t cpu_hz) {
+    const task_model_t *t = &task_model[i];
+    uint32_t r = c, prev;
+
+    do {
+        prev = r;
+        r = c;
+        for (uint32_t j = 0; j < task_model_count; j++) {
+            const task_model_t *h = &task_model[j];
+            if (j == i || h->period_us == 0 || h->prio < t->prio) continue;
+            r += ((prev + h->period_us - 1) / h->period_us) * task_model_scale(h->wcet_us, cpu_hz);
+        }
+    } while (r != prev && r <= deadline_us);
+    return r;
+}
+
+/* C includes the blocking B; at a quiet slot the flash erase stall replaces
+   it (one lower-priority hold at a time), unscaled: it is flash time. */
+int task_model_check(uint32_t cpu_hz) {
+    int misses = 0;
+
+#if (configUSE_TIMERS == 1)
+    if (TASK_TIMER_PRIO != configTIMER_TASK_PRIORITY) {
+        misses++;           // the model would analyse the timer task at the wrong level
+    }
+#endif
+
+    for (uint32_t i = 0; i < task_model_count; i++) {
+        const task_model_t *t = &task_model[i];
+        uint32_t b, c, r;
+
+        if (t->prio != TASK_MODEL_ISR && t->prio >= configMAX_PRIORITIES) {
+            misses++;       // the kernel would assert in xTaskCreate
+        }
+
+        if (t->period_us == 0) {
+            // Background work preempts nothing only while it is the lowest priority
+            for (uint32_t j = 0; j < task_model_count; j++) {
+                if (task_model[j].period_us && task_model[j].prio <= t->prio) {
+                    misses++;
+                    break;
+                }
+            }
+            task_model_wcrt_us[i] = 0;
+            continue;
+        }
+
+        b = task_model_blocking(t->prio, cpu_hz);
+        c = task_model_scale(t->wcet_us, cpu_hz);
+        r = task_model_rta(i, c + b, t->period_us, cpu_hz);
+        task_model_wcrt_us[i] = r;
+        if (r > t->period_us) misses++;
+
+        if (t->quiet_us) {
+            if (b < WORK_ERASE_STALL_US) b = WORK_ERASE_STALL_US;
+            if (task_model_rta(i, c + b, t->quiet_us, cpu_hz) > t->quiet_us) misses++;
+        }
+    }
+    return misses;
+}
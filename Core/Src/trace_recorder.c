@@ -0,0 +1,220 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "cmsis_os.h"
+#include "stm32f4xx_hal.h"
+#include "uart_tx.h"
+#include <string.h>
+
+#if configUSE_TRACE_RECORDER
+#include "trace_recorder.h"
+
+#if (TRACE_RING_EVENTS & (TRACE_RING_EVENTS - 1)) != 0
+#error "TRACE_RING_EVENTS must be a power of two"
+#endif
+
+// Capture framing on USART2 (uart_tx.c), little endian, each frame queued whole or not at all:
+//   0xA5 0x5A, type, len (u16), payload[len]
+// HEADER: cpu_hz u32, tick_hz u32, ring_events u16, cycles_per_event u16, lost u32,
+//         heap_free u32, heap_min_free u32
+// TASK:   task number u8, priority u8, name
+// EVENTS: trace_event_t[len / 8], oldest first
+// END:    empty, closes a snapshot
+#define TRACE_SYNC0          0xA5
+#define TRACE_SYNC1          0x5A
+#define TRACE_PKT_HEADER     1
+#define TRACE_PKT_TASK       2
+#define TRACE_PKT_EVENTS     3
+#define TRACE_PKT_END        4
+#define TRACE_PKT_MAX_EVENTS 64
+#define TRACE_FRAME_HDR      5
+#define TRACE_FRAME_MAX      (TRACE_FRAME_HDR + TRACE_PKT_MAX_EVENTS * sizeof(trace_event_t))
+#define TRACE_STREAM_HEADER_MS 5000   // re-send header/task table for late attach
+
+volatile uint8_t trace_current_task;
+volatile uint32_t trace_frames_dropped;
+
+static trace_event_t ring[TRACE_RING_EVENTS];
+static volatile uint32_t head;        // events written since the last reset
+static volatile uint32_t tail;        // stream mode: next event to send
+static volatile uint32_t lost;        // events dropped (stream overflow)
+static volatile uint32_t stop_at;     // head value that freezes the ring
+static volatile uint8_t armed;
+static volatile uint8_t frozen;
+static uint8_t object_count;
+static uint16_t cycles_per_event;
+static TaskStatus_t task_status[TRACE_MAX_TASKS];
+static uint8_t frame[TRACE_FRAME_MAX];
+
+/* Fixed cost: PRIMASK save, one slot store, index update. Called from the
+   kernel with the scheduler or interrupts already masked and from any ISR. */
+void trace_write(uint8_t type, uint8_t obj, uint16_t arg) {
+    uint32_t primask = __get_PRIMASK();
+    trace_event_t *e;
+
+    __disable_irq();
+    if (!frozen) {
+#if TRACE_MODE == TRACE_MODE_STREAM
+        if (head - tail >= TRACE_RING_EVENTS) {
+            lost++;
+            __set_PRIMASK(primask);
+            return;
+        }
+#endif
+        e = &ring[head & (TRACE_RING_EVENTS - 1)];
+        e->ts = DWT->CYCCNT;
+        e->type = type;
+        e->obj = obj;
+        e->arg = arg;
+        head++;
+        if (armed && head == stop_at) frozen = 1;
+    }
+    __set_PRIMASK(primask);
+}
+
+uint8_t trace_object_id(void) {
+    return ++object_count;
+}
+
+/* Keep TRACE_POST_TRIGGER more events, then freeze the ring for trace_task */
+void trace_trigger(void) {
+    uint32_t primask = __get_PRIMASK();
+    uint8_t fire;
+
+    __disable_irq();
+    fire = !armed && !frozen;
+    if (fire) {
+        armed = 1;
+        stop_at = head + 1 + TRACE_POST_TRIGGER;
+    }
+    __set_PRIMASK(primask);
+    if (fire) trace_write(TRC_TRIGGER, 0, TRACE_POST_TRIGGER);
+}
+
+void trace_user(uint8_t code, uint16_t value) {
+    trace_write(TRC_USER, code, value);
+}
+
+void trace_init(void) {
+    uint32_t start;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Measure the per-event cost once; reported in every header
+    start = DWT->CYCCNT;
+    for (int i = 0; i < 16; i++) {
+        trace_write(TRC_NONE, 0, 0);
+    }
+    cycles_per_event = (uint16_t)((DWT->CYCCNT - start) / 16);
+
+    head = tail = lost = 0;
+    armed = frozen = 0;
+}
+
+/* One write per frame: a frame that cannot be queued is dropped whole, so
+   the decoder never reads the next frame's bytes as payload. Bulk: command
+   replies keep their headroom in the TX buffer while a dump waits for space. */
+static int trace_send(uint8_t type, const void *p1, uint16_t n1, const void *p2, uint16_t n2) {
+    uint16_t len = n1 + n2;
+
+    frame[0] = TRACE_SYNC0;
+    frame[1] = TRACE_SYNC1;
+    frame[2] = type;
+    frame[3] = (uint8_t)len;
+    frame[4] = (uint8_t)(len >> 8);
+    if (n1) memcpy(&frame[TRACE_FRAME_HDR], p1, n1);
+    if (n2) memcpy(&frame[TRACE_FRAME_HDR + n1], p2, n2);
+    if (uart_tx_write_bulk(frame, TRACE_FRAME_HDR + len, osWaitForever) != 0) {
+        trace_frames_dropped++;
+        return -1;
+    }
+    return 0;
+}
+
+static void trace_send_header(void) {
+    uint8_t h[24];
+    uint32_t cpu = SystemCoreClock;
+    uint32_t tick = configTICK_RATE_HZ;
+    uint16_t n = TRACE_RING_EVENTS;
+    uint32_t l = lost;
+    uint32_t heap = xPortGetFreeHeapSize();
+    uint32_t heap_min = xPortGetMinimumEverFreeHeapSize();
+    UBaseType_t count;
+
+    memcpy(&h[0], &cpu, 4);
+    memcpy(&h[4], &tick, 4);
+    memcpy(&h[8], &n, 2);
+    memcpy(&h[10], &cycles_per_event, 2);
+    memcpy(&h[12], &l, 4);
+    memcpy(&h[16], &heap, 4);
+    memcpy(&h[20], &heap_min, 4);
+    trace_send(TRACE_PKT_HEADER, h, sizeof(h), NULL, 0);
+
+    count = uxTaskGetSystemState(task_status, TRACE_MAX_TASKS, NULL);
+    for (UBaseType_t i = 0; i < count; i++) {
+        uint8_t t[2] = { (uint8_t)task_status[i].xTaskNumber, (uint8_t)task_status[i].uxBasePriority };
+        trace_send(TRACE_PKT_TASK, t, 2, task_status[i].pcTaskName,
+                   (uint16_t)strnlen(task_status[i].pcTaskName, configMAX_TASK_NAME_LEN));
+    }
+}
+
+/* Send events [from, to) of the ring, split at the wrap point */
+static void trace_send_events(uint32_t from, uint32_t to) {
+    while (from != to) {
+        uint32_t idx = from & (TRACE_RING_EVENTS - 1);
+        uint32_t n = to - from;
+
+        if (n > TRACE_RING_EVENTS - idx) n = TRACE_RING_EVENTS - idx;
+        if (n > TRACE_PKT_MAX_EVENTS) n = TRACE_PKT_MAX_EVENTS;
+        if (trace_send(TRACE_PKT_EVENTS, &ring[idx], (uint16_t)(n * sizeof(trace_event_t)), NULL, 0) != 0) {
+            // Reported in the next header; trace_write() counts into it from ISRs too
+            uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+            lost += n;
+            __set_PRIMASK(primask);
+        }
+        from += n;
+#if TRACE_MODE == TRACE_MODE_STREAM
+        tail = from;    // slots are only reused once sent
+#endif
+    }
+}
+
+/* Lowest priority task: dumps the frozen ring (snapshot) or drains it (stream) */
+void trace_task(void *argument) {
+#if TRACE_MODE == TRACE_MODE_SNAPSHOT
+    for (;;) {
+        if (frozen) {
+            uint32_t end = head;
+            uint32_t begin = end > TRACE_RING_EVENTS ? end - TRACE_RING_EVENTS : 0;
+
+            trace_send_header();
+            trace_send_events(begin, end);
+            trace_send(TRACE_PKT_END, NULL, 0, NULL, 0);
+
+            __disable_irq();
+            head = 0;
+            armed = 0;
+            frozen = 0;
+            __enable_irq();
+        }
+        osDelay(50);
+    }
+#else
+    uint32_t last_header = osKernelGetTickCount() - TRACE_STREAM_HEADER_MS;
+
+    for (;;) {
+        if (osKernelGetTickCount() - last_header >= TRACE_STREAM_HEADER_MS) {
+            last_header = osKernelGetTickCount();
+            trace_send_header();
+        }
+        if (head != tail) {
+            trace_send_events(tail, head);
+        } else {
+            osDelay(10);
+        }
+    }
+#endif
+}
+
+#endif // configUSE_TRACE_RECORDER
@@ -0,0 +1,150 @@
+#include "uart_tx.h"
+#include "FreeRTOS.h"
+#include "stream_buffer.h"
+#include "cmsis_os.h"
+#include "main.h"
+#include <string.h>
+
+extern UART_HandleTypeDef huart2;
+static DMA_HandleTypeDef hdma_usart2_tx;
+
+uart_tx_stats_t uart_tx_stats;
+
+static StaticStreamBuffer_t uart_tx_sb;
+static uint8_t uart_tx_storage[UART_TX_BUF_BYTES + 1];     // a stream buffer keeps one byte spare
+static StreamBufferHandle_t uart_tx_buf;
+static osMutexId_t uart_tx_lock;            // the stream buffer's single writer
+static volatile uint16_t uart_tx_chunk;     // bytes on the wire, 0 when idle
+static volatile uint8_t uart_tx_held;
+
+static const osMutexAttr_t uart_tx_lock_attributes = {
+  .name = "uart_tx",
+  .attr_bits = osMutexPrioInherit
+};
+
+/* Next chunk from the buffer in place; interrupts masked or in the TX-complete ISR */
+static void uart_tx_kick(void) {
+    StreamBufferSpan_t span;
+    uint16_t n;
+
+    if (uart_tx_chunk != 0 || uart_tx_held) return;
+    if (xStreamBufferPeekFromISR(uart_tx_buf, &span) == 0) return;
+    n = span.xFirstLength > UART_TX_CHUNK ? UART_TX_CHUNK : (uint16_t)span.xFirstLength;
+    uart_tx_chunk = n;
+    if (HAL_UART_Transmit_DMA(&huart2, span.pucFirst, n) != HAL_OK) {
+        uart_tx_chunk = 0;      // only while the UART is being reset; the next write retries
+    }
+}
+
+int uart_tx_init(void) {
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    hdma_usart2_tx.Instance = DMA1_Stream6;
+    hdma_usart2_tx.Init.Channel = DMA_CHANNEL_4;
+    hdma_usart2_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_usart2_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_usart2_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_usart2_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_usart2_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_usart2_tx.Init.Mode = DMA_NORMAL;
+    hdma_usart2_tx.Init.Priority = DMA_PRIORITY_LOW;
+    hdma_usart2_tx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_usart2_tx) != HAL_OK) return -1;
+    __HAL_LINKDMA(&huart2, hdmatx, hdma_usart2_tx);
+    // Same level as USART2: the completion path calls the stream buffer FromISR API
+    HAL_NVIC_SetPriority(DMA1_Stream6_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+
+    uart_tx_buf = xStreamBufferCreateStatic(UART_TX_BUF_BYTES, 1, uart_tx_storage, &uart_tx_sb);
+    uart_tx_lock = osMutexNew(&uart_tx_lock_attributes);
+    return (uart_tx_buf == NULL || uart_tx_lock == NULL) ? -1 : 0;
+}
+
+/* Whole or nothing: the space check, the copy and the commit are one step
+   under the lock, and waiting for space happens outside it */
+static int uart_tx_put(const void *data, uint32_t len, uint32_t keep, uint32_t timeout_ms) {
+    StreamBufferSpan_t span;
+    uint32_t start = osKernelGetTickCount();
+    uint32_t depth;
+
+    if (len == 0) return 0;
+    for (;;) {
+        if (len + keep <= UART_TX_BUF_BYTES) {
+            osMutexAcquire(uart_tx_lock, osWaitForever);
+            if (xStreamBufferSpacesAvailable(uart_tx_buf) >= len + keep) {
+                xStreamBufferReserve(uart_tx_buf, len, &span, 0);
+                memcpy(span.pucFirst, data, span.xFirstLength);
+                if (span.xSecondLength) memcpy(span.pucSecond, (const uint8_t *)data + span.xFirstLength, span.xSecondLength);
+                vStreamBufferCommit(uart_tx_buf, len);
+                uart_tx_stats.frames++;
+                depth = xStreamBufferBytesAvailable(uart_tx_buf);
+                if (depth > uart_tx_stats.depth_max) uart_tx_stats.depth_max = depth;
+                osMutexRelease(uart_tx_lock);
+
+                taskENTER_CRITICAL();
+                uart_tx_kick();
+                taskEXIT_CRITICAL();
+                return 0;
+            }
+            osMutexRelease(uart_tx_lock);
+        }
+        // A chunk drains in a few ms: polling keeps the writers independent of each other
+        if (len + keep > UART_TX_BUF_BYTES || osKernelGetTickCount() - start >= timeout_ms) {
+            uart_tx_stats.dropped++;
+            return -1;
+        }
+        osDelay(1);
+    }
+}
+
+int uart_tx_write(const void *data, uint32_t len, uint32_t timeout_ms) {
+    return uart_tx_put(data, len, 0, timeout_ms);
+}
+
+int uart_tx_write_bulk(const void *data, uint32_t len, uint32_t timeout_ms) {
+    return uart_tx_put(data, len, UART_TX_HEADROOM, timeout_ms);
+}
+
+/* Clock switch: a byte shifting out while the baud rate changes is garbled */
+int uart_tx_pause(uint32_t timeout_ms) {
+    uint32_t start = HAL_GetTick();
+
+    uart_tx_held = 1;
+    while (uart_tx_chunk != 0 || !(USART2->SR & USART_SR_TC)) {
+        if (HAL_GetTick() - start >= timeout_ms) return -1;
+    }
+    return 0;
+}
+
+void uart_tx_resume(void) {
+    taskENTER_CRITICAL();
+    uart_tx_held = 0;
+    uart_tx_kick();
+    taskEXIT_CRITICAL();
+}
+
+/* The chunk on the wire is finished (sent) or abandoned: release it, start the next */
+static void uart_tx_retire(uint8_t sent) {
+    BaseType_t woken = pdFALSE;
+
+    if (uart_tx_chunk != 0) {
+        vStreamBufferConsumeFromISR(uart_tx_buf, uart_tx_chunk, &woken);
+        if (sent) uart_tx_stats.bytes += uart_tx_chunk;
+        uart_tx_chunk = 0;
+    }
+    uart_tx_kick();
+    portYIELD_FROM_ISR(woken);
+}
+
+void uart_tx_done(void) {
+    uart_tx_retire(1);
+}
+
+/* The HAL has stopped the transfer: the chunk is lost, the stream goes on */
+void uart_tx_error(void) {
+    uart_tx_stats.dma_errors++;
+    uart_tx_retire(0);
+}
+
+void uart_tx_dma_irq(void) {
+    HAL_DMA_IRQHandler(&hdma_usart2_tx);
+}
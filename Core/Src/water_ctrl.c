@@ -0,0 +1,90 @@
+#include "water_ctrl.h"
+#include "indicator.h"
+#include "barrier_fsm.h"
+
+void water_ctrl_init(water_ctrl_t *w, const calib_t *cal) {
+    w->cal = cal;
+    sensor_curve_init(&w->curve);
+    w->smooth_mm = 0.0f;
+#if USE_SPIKE_MEDIAN
+    median_init_q15(&w->spike_median, SPIKE_MEDIAN_LEN, w->spike_median_state);
+#endif
+#if USE_SLOSH_FILTER
+    slosh_init(&w->slosh);
+#endif
+#if USE_SENSOR_FAULT
+    sensor_fault_init(&w->fault);
+#endif
+#if USE_FLOOD_RISK
+    flood_risk_init(&w->risk);  // on failure the risk stays 0 and only the thresholds act
+#endif
+}
+
+/* 센서 값 mm 변환 */
+float rain_raw_to_mm(water_ctrl_t *w, uint16_t raw) {
+    if (raw > w->cal->raw_clamp) raw = w->cal->raw_clamp;  // clamp to max expected ADC value
+    return sensor_curve(&w->curve, raw) * w->cal->mm_per_count;
+}
+
+static float smoothed_rain_mm(water_ctrl_t *w, uint16_t raw) {
+    uint16_t level_raw = raw;
+#if USE_SPIKE_MEDIAN
+    // 12-bit counts fit q15 as they are
+    q15_t q = (q15_t)raw;
+    median_q15(&w->spike_median, &q, &q, 1);
+    level_raw = (uint16_t)q;
+#endif
+    float current = rain_raw_to_mm(w, level_raw);
+#if USE_SLOSH_FILTER
+    // Spectral stage needs a uniform sample clock: one sample per slot
+    current = slosh_filter(&w->slosh, current);
+#endif
+#if USE_SENSOR_FAULT
+    // The classifier sees the unfiltered counts, after slosh_filter() so its
+    // window closes right after the matching spectral analysis
+    sensor_fault_push(&w->fault, &w->slosh, raw);
+#endif
+    // 80% previous value + 20% new value for smoothing
+    w->smooth_mm = (w->smooth_mm * 0.8f) + (current * 0.2f);
+    return w->smooth_mm;
+}
+
+void water_ctrl_step(water_ctrl_t *w, uint16_t raw, water_slot_t *out) {
+    const calib_t *cal = w->cal;
+    float mm = smoothed_rain_mm(w, raw);
+    uint8_t status = RAIN_FLOOD;
+    uint8_t risk = 0;
+
+#if USE_SENSOR_FAULT
+    if (sensor_fault_get(&w->fault) != SENSOR_OK) {
+        status = RAIN_SENSOR_ERR;
+    } else
+#endif
+    if (mm < cal->normal_mm) {
+        status = RAIN_NORMAL;
+    } else if (mm < cal->warning_mm) {
+        status = RAIN_WARNING;
+    }
+#if USE_FLOOD_RISK
+    flood_risk_push(&w->risk, mm);
+    risk = flood_risk_get(&w->risk);
+#endif
+
+    uint8_t level = BEV_LEVEL_MID;     // between the thresholds: the barrier stays as it is
+#if USE_SENSOR_FAULT && SENSOR_FAULT_FAILSAFE_RAISE
+    // An open or shorted sensor cannot be trusted: fail safe with the barrier up
+    if (sensor_fault_get(&w->fault) != SENSOR_OK) {
+        level = BEV_SENSOR_FAULT;
+    } else
+#endif
+    if (mm >= cal->warning_mm || risk >= cal->risk_raise) {
+        level = BEV_LEVEL_HIGH;         // heavy rain, or a flood predicted
+    } else if (mm < cal->normal_mm) {
+        level = BEV_LEVEL_LOW;
+    }
+
+    out->mm = mm;
+    out->status = status;
+    out->level = level;
+    out->risk = risk;
+}
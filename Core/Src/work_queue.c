@@ -0,0 +1,50 @@
+#include "work_queue.h"
+#include "task_model.h"
+#include "cmsis_os.h"
+
+work_queue_stats_t work_queue_stats;
+
+static osMessageQueueId_t work_queue;
+static osThreadId_t work_thread;
+
+static const osThreadAttr_t work_attributes = {
+  .name = "work",
+  .priority = (osPriority_t) TASK_WORK_PRIO,
+  .stack_size = TASK_WORK_STACK * 4
+};
+
+static void work_task(void *argument) {
+    work_item_t item;
+
+    for (;;) {
+        if (osMessageQueueGet(work_queue, &item, NULL, osWaitForever) == osOK) {
+            item.fn(item.arg);
+        }
+    }
+}
+
+int work_queue_init(void) {
+    work_queue = osMessageQueueNew(WORK_QUEUE_LEN, sizeof(work_item_t), NULL);
+    if (work_queue == NULL) return -1;
+    work_thread = osThreadNew(work_task, NULL, &work_attributes);
+    return work_thread == NULL ? -1 : 0;
+}
+
+/* osMessageQueuePut picks the FromISR call itself; timeout 0 never blocks */
+int work_post(work_fn_t fn, uint32_t arg) {
+    work_item_t item = { fn, arg };
+    uint32_t depth;
+
+    if (osMessageQueuePut(work_queue, &item, 0, 0) != osOK) {
+        work_queue_stats.dropped++;
+        return -1;
+    }
+    work_queue_stats.posted++;
+    depth = osMessageQueueGetCount(work_queue);
+    if (depth > work_queue_stats.depth_max) work_queue_stats.depth_max = depth;
+    return 0;
+}
+
+void *work_queue_thread(void) {
+    return work_thread;
+}
@@ -465,7 +465,7 @@ osThreadId_t osThreadNew (osThreadFunc_t func, void *argument, const osThreadAtt
         prio = (UBaseType_t)attr->priority;
       }
 
-      if ((prio < osPriorityIdle) || (prio > osPriorityISR) || ((attr->attr_bits & osThreadJoinable) == osThreadJoinable)) {
+      if ((prio < osPriorityIdle) || (prio > OS2_PRIORITY_MAX) || ((attr->attr_bits & osThreadJoinable) == osThreadJoinable)) {
         return (NULL);
       }
 
@@ -572,7 +572,7 @@ osStatus_t osThreadSetPriority (osThreadId_t thread_id, osPriority_t priority) {
   if (IS_IRQ()) {
     stat = osErrorISR;
   }
-  else if ((hTask == NULL) || (priority < osPriorityIdle) || (priority > osPriorityISR)) {
+  else if ((hTask == NULL) || (priority < osPriorityIdle) || (priority > OS2_PRIORITY_MAX)) {
     stat = osErrorParameter;
   }
   else {
@@ -1944,10 +1944,12 @@ osStatus_t osMessageQueueDelete (osMessageQueueId_t mq_id) {
 /*---------------------------------------------------------------------------*/
 #ifdef FREERTOS_MPOOL_H_
 
-/* Static memory pool functions */
-static void  FreeBlock   (MemPool_t *mp, void *block);
-static void *AllocBlock  (MemPool_t *mp);
-static void *CreateBlock (MemPool_t *mp);
+/*
+  Blocks are taken from and returned to a lock-free free list (freertos_mpool.h),
+  so osMemoryPoolAlloc (timeout 0) and osMemoryPoolFree never mask interrupts.
+  The semaphore is only used to wake threads waiting for a block and is given
+  by osMemoryPoolFree while such threads exist.
+*/
 
 osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, const osMemoryPoolAttr_t *attr) {
   MemPool_t *mp;
@@ -1958,11 +1960,15 @@ osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, con
   if (IS_IRQ()) {
     mp = NULL;
   }
-  else if ((block_count == 0U) || (block_size == 0U)) {
+  else if ((block_count == 0U) || (block_size == 0U) || (block_count > MPOOL_MAX_BLOCKS)) {
     mp = NULL;
   }
   else {
     mp = NULL;
+    /* A free block holds the free list link */
+    if (block_size < sizeof(MemPoolBlock_t)) {
+      block_size = sizeof(MemPoolBlock_t);
+    }
     sz = MEMPOOL_ARR_SIZE (block_count, block_size);
 
     name = NULL;
@@ -2013,11 +2019,11 @@ osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, con
     }
 
     if (mp != NULL) {
-      /* Create a semaphore (max count == initial count == block_count) */
+      /* Create a semaphore (max count == block_count, initially empty) */
       #if (configSUPPORT_STATIC_ALLOCATION == 1)
-        mp->sem = xSemaphoreCreateCountingStatic (block_count, block_count, &mp->mem_sem);
+        mp->sem = xSemaphoreCreateCountingStatic (block_count, 0U, &mp->mem_sem);
       #elif (configSUPPORT_DYNAMIC_ALLOCATION == 1)
-        mp->sem = xSemaphoreCreateCounting (block_count, block_count);
+        mp->sem = xSemaphoreCreateCounting (block_count, 0U);
       #else
         mp->sem == NULL;
       #endif
@@ -2034,12 +2040,14 @@ osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, con
 
     if ((mp != NULL) && (mp->mem_arr != NULL)) {
       /* Memory pool can be created */
-      mp->head    = NULL;
       mp->mem_sz  = sz;
       mp->name    = name;
       mp->bl_sz   = block_size;
       mp->bl_cnt  = block_count;
-      mp->n       = 0U;
+      mp->bl_step = MEMPOOL_BL_STEP (block_size);
+
+      /* All blocks start on the free list */
+      MemPoolInitList (mp);
 
       /* Set heap allocated memory flags */
       mp->status = MPOOL_STATUS;
@@ -2086,7 +2094,8 @@ const char *osMemoryPoolGetName (osMemoryPoolId_t mp_id) {
 void *osMemoryPoolAlloc (osMemoryPoolId_t mp_id, uint32_t timeout) {
   MemPool_t *mp;
   void *block;
-  uint32_t isrm;
+  TimeOut_t tout;
+  TickType_t ticks;
 
   if (mp_id == NULL) {
     /* Invalid input parameters */
@@ -2097,42 +2106,43 @@ void *osMemoryPoolAlloc (osMemoryPoolId_t mp_id, uint32_t timeout) {
 
     mp = (MemPool_t *)mp_id;
 
-    if ((mp->status & MPOOL_STATUS) == MPOOL_STATUS) {
-      if (IS_IRQ()) {
-        if (timeout == 0U) {
-          if (xSemaphoreTakeFromISR (mp->sem, NULL) == pdTRUE) {
-            if ((mp->status & MPOOL_STATUS) == MPOOL_STATUS) {
-              isrm  = taskENTER_CRITICAL_FROM_ISR();
+    if ((mp->status & MPOOL_STATUS) != MPOOL_STATUS) {
+      /* Invalid object status */
+      block = NULL;
+    }
+    else if (IS_IRQ() && (timeout != 0U)) {
+      /* Interrupts cannot wait for a block */
+      block = NULL;
+    }
+    else {
+      /* Get a block from the free-list */
+      block = MemPoolPop (mp);
 
-              /* Get a block from the free-list */
-              block = AllocBlock(mp);
+      if ((block == NULL) && (timeout != 0U)) {
+        /* Register as waiter first, then retry: a block freed before the
+           registration is found by the retry, one freed after it gives
+           the semaphore */
+        vTaskSetTimeOutState (&tout);
+        ticks = (TickType_t)timeout;
 
-              if (block == NULL) {
-                /* List of free blocks is empty, 'create' new block */
-                block = CreateBlock(mp);
-              }
+        MemPoolAtomicAdd (&mp->waiters, 1U);
 
-              taskEXIT_CRITICAL_FROM_ISR(isrm);
-            }
+        while ((block = MemPoolPop (mp)) == NULL) {
+          if ((mp->status & MPOOL_STATUS) != MPOOL_STATUS) {
+            /* Pool deleted while waiting */
+            break;
+          }
+          if (xTaskCheckForTimeOut (&tout, &ticks) != pdFALSE) {
+            break;
           }
+          (void)xSemaphoreTake (mp->sem, ticks);
         }
-      }
-      else {
-        if (xSemaphoreTake (mp->sem, (TickType_t)timeout) == pdTRUE) {
-          if ((mp->status & MPOOL_STATUS) == MPOOL_STATUS) {
-            taskENTER_CRITICAL();
-
-            /* Get a block from the free-list */
-            block = AllocBlock(mp);
 
-            if (block == NULL) {
-              /* List of free blocks is empty, 'create' new block */
-              block = CreateBlock(mp);
-            }
+        MemPoolAtomicAdd (&mp->waiters, (uint32_t)-1);
+      }
 
-            taskEXIT_CRITICAL();
-          }
-        }
+      if (block != NULL) {
+        MemPoolAtomicAdd (&mp->used, 1U);
       }
     }
   }
@@ -2143,7 +2153,6 @@ void *osMemoryPoolAlloc (osMemoryPoolId_t mp_id, uint32_t timeout) {
 osStatus_t osMemoryPoolFree (osMemoryPoolId_t mp_id, void *block) {
   MemPool_t *mp;
   osStatus_t stat;
-  uint32_t isrm;
   BaseType_t yield;
 
   if ((mp_id == NULL) || (block == NULL)) {
@@ -2161,39 +2170,29 @@ osStatus_t osMemoryPoolFree (osMemoryPoolId_t mp_id, void *block) {
       /* Block pointer outside of memory array area */
       stat = osErrorParameter;
     }
+    else if ((((uint8_t *)block - mp->mem_arr) % mp->bl_step) != 0U) {
+      /* Block pointer not at the start of a block */
+      stat = osErrorParameter;
+    }
+    else if (MemPoolAtomicDecNZ (&mp->used) == 0U) {
+      /* All blocks are already free */
+      stat = osErrorResource;
+    }
     else {
       stat = osOK;
 
-      if (IS_IRQ()) {
-        if (uxSemaphoreGetCountFromISR (mp->sem) == mp->bl_cnt) {
-          stat = osErrorResource;
-        }
-        else {
-          isrm = taskENTER_CRITICAL_FROM_ISR();
-
-          /* Add block to the list of free blocks */
-          FreeBlock(mp, block);
-
-          taskEXIT_CRITICAL_FROM_ISR(isrm);
+      /* Add block to the list of free blocks */
+      MemPoolPush (mp, block);
 
+      if (mp->waiters != 0U) {
+        /* Wake-up a thread waiting for a block */
+        if (IS_IRQ()) {
           yield = pdFALSE;
-          xSemaphoreGiveFromISR (mp->sem, &yield);
+          (void)xSemaphoreGiveFromISR (mp->sem, &yield);
           portYIELD_FROM_ISR (yield);
         }
-      }
-      else {
-        if (uxSemaphoreGetCount (mp->sem) == mp->bl_cnt) {
-          stat = osErrorResource;
-        }
         else {
-          taskENTER_CRITICAL();
-
-          /* Add block to the list of free blocks */
-          FreeBlock(mp, block);
-
-          taskEXIT_CRITICAL();
-
-          xSemaphoreGive (mp->sem);
+          (void)xSemaphoreGive (mp->sem);
         }
       }
     }
@@ -2266,13 +2265,7 @@ uint32_t osMemoryPoolGetCount (osMemoryPoolId_t mp_id) {
       n = 0U;
     }
     else {
-      if (IS_IRQ()) {
-        n = uxSemaphoreGetCountFromISR (mp->sem);
-      } else {
-        n = uxSemaphoreGetCount        (mp->sem);
-      }
-
-      n = mp->bl_cnt - n;
+      n = mp->used;
     }
   }
 
@@ -2296,11 +2289,7 @@ uint32_t osMemoryPoolGetSpace (osMemoryPoolId_t mp_id) {
       n = 0U;
     }
     else {
-      if (IS_IRQ()) {
-        n = uxSemaphoreGetCountFromISR (mp->sem);
-      } else {
-        n = uxSemaphoreGetCount        (mp->sem);
-      }
+      n = mp->bl_cnt - mp->used;
     }
   }
 
@@ -2330,7 +2319,7 @@ osStatus_t osMemoryPoolDelete (osMemoryPoolId_t mp_id) {
     /* Wake-up tasks waiting for pool semaphore */
     while (xSemaphoreGive (mp->sem) == pdTRUE);
 
-    mp->head    = NULL;
+    mp->head    = 0U;
     mp->bl_sz   = 0U;
     mp->bl_cnt  = 0U;
 
@@ -2351,52 +2340,6 @@ osStatus_t osMemoryPoolDelete (osMemoryPoolId_t mp_id) {
   return (stat);
 }
 
-/*
-  Create new block given according to the current block index.
-*/
-static void *CreateBlock (MemPool_t *mp) {
-  MemPoolBlock_t *p = NULL;
-
-  if (mp->n < mp->bl_cnt) {
-    /* Unallocated blocks exist, set pointer to new block */
-    p = (void *)(mp->mem_arr + (mp->bl_sz * mp->n));
-
-    /* Increment block index */
-    mp->n += 1U;
-  }
-
-  return (p);
-}
-
-/*
-  Allocate a block by reading the list of free blocks.
-*/
-static void *AllocBlock (MemPool_t *mp) {
-  MemPoolBlock_t *p = NULL;
-
-  if (mp->head != NULL) {
-    /* List of free block exists, get head block */
-    p = mp->head;
-
-    /* Head block is now next on the list */
-    mp->head = p->next;
-  }
-
-  return (p);
-}
-
-/*
-  Free block by putting it to the list of free blocks.
-*/
-static void FreeBlock (MemPool_t *mp, void *block) {
-  MemPoolBlock_t *p = block;
-
-  /* Store current head into block memory space */
-  p->next = mp->head;
-
-  /* Store current block as new head */
-  mp->head = p;
-}
 #endif /* FREERTOS_MPOOL_H_ */
 /*---------------------------------------------------------------------------*/
 
@@ -2466,6 +2409,7 @@ __WEAK void vApplicationGetIdleTaskMemory (StaticTask_t **ppxIdleTaskTCBBuffer,
   *pulIdleTaskStackSize   = (uint32_t)configMINIMAL_STACK_SIZE;
 }
 
+#if (configUSE_TIMERS == 1)
 /*
   vApplicationGetTimerTaskMemory gets called when configSUPPORT_STATIC_ALLOCATION
   equals to 1 and is required for static memory allocation support.
@@ -2479,4 +2423,5 @@ __WEAK void vApplicationGetTimerTaskMemory (StaticTask_t **ppxTimerTaskTCBBuffer
   *ppxTimerTaskStackBuffer = &Timer_Stack[0];
   *pulTimerTaskStackSize   = (uint32_t)configTIMER_TASK_STACK_DEPTH;
 }
+#endif /* (configUSE_TIMERS == 1) */
 #endif
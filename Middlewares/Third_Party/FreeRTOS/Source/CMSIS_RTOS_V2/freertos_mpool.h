@@ -27,24 +27,53 @@
 #include "FreeRTOS.h"
 #include "semphr.h"
 
+/* The free list is a lock-free stack so blocks can be allocated and freed from
+   any interrupt without masking interrupts. Cortex-M3/M4/M33 use LDREX/STREX,
+   other targets (host builds) use C11 atomics. */
+#if ((defined(__ARM_ARCH_7M__)      && (__ARM_ARCH_7M__      == 1)) || \
+     (defined(__ARM_ARCH_7EM__)     && (__ARM_ARCH_7EM__     == 1)) || \
+     (defined(__ARM_ARCH_8M_MAIN__) && (__ARM_ARCH_8M_MAIN__ == 1)))
+  #include "cmsis_compiler.h"
+  #define MPOOL_EXCLUSIVE_ACCESS  1
+#else
+  #include <stdatomic.h>
+  #define MPOOL_EXCLUSIVE_ACCESS  0
+#endif
+
 /* Memory Pool implementation definitions */
 #define MPOOL_STATUS              0x5EED0000U
 
+/* Free list head: index + 1 of the first free block in the low half (0 when the
+   list is empty) and a tag in the high half that changes on every update, so a
+   stale head cannot be swapped back in after the same block returned to the
+   top of the list (ABA). */
+#define MPOOL_HEAD_IDX_MSK        0x0000FFFFU
+#define MPOOL_HEAD_TAG_INC        0x00010000U
+#define MPOOL_MAX_BLOCKS          0xFFFFU
+
+#if (MPOOL_EXCLUSIVE_ACCESS == 1)
+typedef volatile uint32_t MemPoolAtomic_t;
+#else
+typedef _Atomic uint32_t  MemPoolAtomic_t;
+#endif
+
 /* Memory Block header */
 typedef struct {
-  void *next;                   /* Pointer to next block  */
+  uint32_t next;                /* Index + 1 of next free block, 0 = none */
 } MemPoolBlock_t;
 
 /* Memory Pool control block */
 typedef struct MemPoolDef_t {
-  MemPoolBlock_t    *head;      /* Pointer to head block   */
-  SemaphoreHandle_t  sem;       /* Pool semaphore handle   */
+  MemPoolAtomic_t    head;      /* Tagged free list head   */
+  MemPoolAtomic_t    used;      /* Number of used blocks   */
+  MemPoolAtomic_t    waiters;   /* Threads waiting a block */
+  SemaphoreHandle_t  sem;       /* Given on free to waiters*/
   uint8_t           *mem_arr;   /* Pool memory array       */
   uint32_t           mem_sz;    /* Pool memory array size  */
   const char        *name;      /* Pointer to name string  */
   uint32_t           bl_sz;     /* Size of a single block  */
   uint32_t           bl_cnt;    /* Number of blocks        */
-  uint32_t           n;         /* Block allocation index  */
+  uint32_t           bl_step;   /* Block to block distance */
   volatile uint32_t  status;    /* Object status flags     */
 #if (configSUPPORT_STATIC_ALLOCATION == 1)
   StaticSemaphore_t  mem_sem;   /* Semaphore object memory */
@@ -57,7 +86,134 @@ typedef struct MemPoolDef_t {
 /* Define memory pool control block size */
 #define MEMPOOL_CB_SIZE         (sizeof(StaticMemPool_t))
 
+/* Distance between blocks: block size rounded up to keep blocks 4-byte aligned */
+#define MEMPOOL_BL_STEP(bl_size) ((((bl_size) + (4 - 1)) / 4) * 4)
+
 /* Define size of the byte array required to create count of blocks of given size */
-#define MEMPOOL_ARR_SIZE(bl_count, bl_size) (((((bl_size) + (4 - 1)) / 4) * 4)*(bl_count))
+#define MEMPOOL_ARR_SIZE(bl_count, bl_size) (MEMPOOL_BL_STEP(bl_size)*(bl_count))
+
+/*
+  Atomically add val to *var and return the new value.
+*/
+static inline uint32_t MemPoolAtomicAdd (MemPoolAtomic_t *var, uint32_t val) {
+#if (MPOOL_EXCLUSIVE_ACCESS == 1)
+  uint32_t n;
+
+  do {
+    n = __LDREXW(var) + val;
+  } while (__STREXW(n, var) != 0U);
+
+  return (n);
+#else
+  return (atomic_fetch_add(var, val) + val);
+#endif
+}
+
+/*
+  Atomically decrement *var unless it is already zero, return the old value.
+*/
+static inline uint32_t MemPoolAtomicDecNZ (MemPoolAtomic_t *var) {
+#if (MPOOL_EXCLUSIVE_ACCESS == 1)
+  uint32_t n;
+
+  do {
+    n = __LDREXW(var);
+    if (n == 0U) {
+      __CLREX();
+      break;
+    }
+  } while (__STREXW(n - 1U, var) != 0U);
+
+  return (n);
+#else
+  uint32_t n = atomic_load(var);
+
+  while ((n != 0U) && !atomic_compare_exchange_weak(var, &n, n - 1U));
+
+  return (n);
+#endif
+}
+
+/*
+  Link every block of the pool into the free list (pool not yet in use).
+*/
+static inline void MemPoolInitList (MemPool_t *mp) {
+  MemPoolBlock_t *p;
+  uint32_t i;
+
+  for (i = 0U; i < mp->bl_cnt; i++) {
+    p = (MemPoolBlock_t *)(void *)(mp->mem_arr + (mp->bl_step * i));
+    p->next = (i + 2U <= mp->bl_cnt) ? (i + 2U) : 0U;
+  }
+
+  mp->head = 1U;
+  mp->used = 0U;
+  mp->waiters = 0U;
+}
+
+/*
+  Take the first block off the free list, NULL if the list is empty.
+*/
+static inline void *MemPoolPop (MemPool_t *mp) {
+  volatile MemPoolBlock_t *p;
+  uint32_t head, idx;
+
+#if (MPOOL_EXCLUSIVE_ACCESS == 1)
+  do {
+    head = __LDREXW(&mp->head);
+    idx  = head & MPOOL_HEAD_IDX_MSK;
+
+    if (idx == 0U) {
+      __CLREX();
+      return (NULL);
+    }
+    /* Any access to the head from an interrupt, or an exception taken between
+       LDREX and STREX, makes the STREX fail and the pop start over */
+    p = (MemPoolBlock_t *)(void *)(mp->mem_arr + (mp->bl_step * (idx - 1U)));
+  } while (__STREXW(((head + MPOOL_HEAD_TAG_INC) & ~MPOOL_HEAD_IDX_MSK) | p->next, &mp->head) != 0U);
+#else
+  head = atomic_load(&mp->head);
+
+  do {
+    idx = head & MPOOL_HEAD_IDX_MSK;
+
+    if (idx == 0U) {
+      return (NULL);
+    }
+    /* p->next may be stale if p was taken meanwhile; the tag then differs
+       and the exchange fails */
+    p = (MemPoolBlock_t *)(void *)(mp->mem_arr + (mp->bl_step * (idx - 1U)));
+  } while (!atomic_compare_exchange_weak(&mp->head, &head,
+                                         ((head + MPOOL_HEAD_TAG_INC) & ~MPOOL_HEAD_IDX_MSK) | p->next));
+#endif
+
+  return ((void *)p);
+}
+
+/*
+  Put a block back at the top of the free list.
+*/
+static inline void MemPoolPush (MemPool_t *mp, void *block) {
+  volatile MemPoolBlock_t *p = block;
+  uint32_t head, idx;
+
+  idx = (uint32_t)((uint8_t *)block - mp->mem_arr) / mp->bl_step + 1U;
+
+#if (MPOOL_EXCLUSIVE_ACCESS == 1)
+  do {
+    head = __LDREXW(&mp->head);
+    p->next = head & MPOOL_HEAD_IDX_MSK;
+    /* The link must be in memory before the block becomes visible */
+    __COMPILER_BARRIER();
+  } while (__STREXW(((head + MPOOL_HEAD_TAG_INC) & ~MPOOL_HEAD_IDX_MSK) | idx, &mp->head) != 0U);
+#else
+  head = atomic_load(&mp->head);
+
+  do {
+    p->next = head & MPOOL_HEAD_IDX_MSK;
+  } while (!atomic_compare_exchange_weak(&mp->head, &head,
+                                         ((head + MPOOL_HEAD_TAG_INC) & ~MPOOL_HEAD_IDX_MSK) | idx));
+#endif
+}
 
 #endif /* FREERTOS_MPOOL_H_ */
@@ -84,6 +84,22 @@
 #define configUSE_OS2_MUTEX                   configUSE_MUTEXES
 #endif
 
+/*
+  Option to run on fewer than the 56 CMSIS-RTOS2 priorities, for instance to
+  use configUSE_PORT_OPTIMISED_TASK_SELECTION (at most 32 priorities).
+  osThreadNew and osThreadSetPriority then reject priorities at or above
+  configMAX_PRIORITIES instead of passing them to the kernel.
+*/
+#ifndef configUSE_OS2_REDUCED_PRIORITIES
+#define configUSE_OS2_REDUCED_PRIORITIES      0
+#endif
+
+#if (configUSE_OS2_REDUCED_PRIORITIES == 1)
+  #define OS2_PRIORITY_MAX                    (configMAX_PRIORITIES - 1)
+#else
+  #define OS2_PRIORITY_MAX                    osPriorityISR
+#endif
+
 
 /*
   CMSIS-RTOS2 FreeRTOS configuration check (FreeRTOSConfig.h).
@@ -290,19 +306,19 @@
   #error "Definition configUSE_16_BIT_TICKS must be zero to implement CMSIS-RTOS2 API."
 #endif
 
-#if (configMAX_PRIORITIES != 56)
+#if (configMAX_PRIORITIES != 56) && (configUSE_OS2_REDUCED_PRIORITIES == 0)
   /*
     CMSIS-RTOS2 defines 56 different priorities (see osPriority_t) and portable CMSIS-RTOS2
     implementation should implement the same number of priorities.
-    Set #define configMAX_PRIORITIES 56 to fix this error.
+    Set #define configMAX_PRIORITIES 56 (or configUSE_OS2_REDUCED_PRIORITIES 1) to fix this error.
   */
   #error "Definition configMAX_PRIORITIES must equal 56 to implement Thread Management API."
 #endif
-#if (configUSE_PORT_OPTIMISED_TASK_SELECTION != 0)
+#if (configUSE_PORT_OPTIMISED_TASK_SELECTION != 0) && (configUSE_OS2_REDUCED_PRIORITIES == 0)
   /*
     CMSIS-RTOS2 requires handling of 56 different priorities (see osPriority_t) while FreeRTOS port
     optimised selection for Cortex core only handles 32 different priorities.
-    Set #define configUSE_PORT_OPTIMISED_TASK_SELECTION 0 to fix this error.
+    Set #define configUSE_PORT_OPTIMISED_TASK_SELECTION 0 (or configUSE_OS2_REDUCED_PRIORITIES 1) to fix this error.
   */
   #error "Definition configUSE_PORT_OPTIMISED_TASK_SELECTION must be zero to implement Thread Management API."
 #endif
@@ -157,6 +157,13 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) PRIVILEG
  */
 void vPortGetHeapStats( HeapStats_t *pxHeapStats );
 
+/*
+ * Returns how fragmented the free heap is, in percent: 0 while the free memory
+ * is one block, approaching 100 as the largest free block becomes a small part
+ * of the total.  Only provided by heap_tlsf.c.
+ */
+size_t xPortGetHeapFragmentation( void ) PRIVILEGED_FUNCTION;
+
 /*
  * Map to the memory management routines required for the port.
  */
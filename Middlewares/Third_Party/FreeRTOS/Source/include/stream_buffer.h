@@ -68,6 +68,20 @@ extern "C" {
 struct StreamBufferDef_t;
 typedef struct StreamBufferDef_t * StreamBufferHandle_t;
 
+/**
+ * Describes a region of a stream buffer's storage area returned by the
+ * zero-copy functions xStreamBufferReserve() and xStreamBufferPeek().  The
+ * region is contiguous in the ring, so it is split in two where it wraps past
+ * the end of the storage area; xSecondLength is 0 when it does not wrap.
+ */
+typedef struct xSTREAM_BUFFER_SPAN
+{
+	uint8_t *pucFirst;		/* Start of the first part. */
+	size_t xFirstLength;	/* Bytes in the first part. */
+	uint8_t *pucSecond;		/* Start of the part that wrapped to the start of the buffer. */
+	size_t xSecondLength;	/* Bytes in the second part, 0 if the region does not wrap. */
+} StreamBufferSpan_t;
+
 
 /**
  * message_buffer.h
@@ -833,6 +847,198 @@ BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuf
  */
 BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuffer, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+                             size_t xDataLengthBytes,
+                             StreamBufferSpan_t *pxSpan,
+                             TickType_t xTicksToWait );
+</pre>
+ *
+ * Zero-copy alternative to xStreamBufferSend().  Instead of copying data into
+ * the stream buffer, the writer is given the free region of the storage area
+ * directly, fills it (for example by starting a DMA transfer into it), then
+ * publishes the bytes with xStreamBufferCommit().  Nothing is visible to the
+ * reader until it is committed.
+ *
+ * Blocking follows xStreamBufferSend(): the calling task waits up to
+ * xTicksToWait for xDataLengthBytes of space, after which as much space as is
+ * free (up to xDataLengthBytes) is reserved.  Stream buffers only - message
+ * buffers cannot be used with this function.  As with xStreamBufferSend()
+ * there must be only one writer, and a reservation must be committed (with 0
+ * bytes if it is abandoned) before the next one is made.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to write into.
+ *
+ * @param xDataLengthBytes The number of bytes the writer wants to write.
+ *
+ * @param pxSpan Set to the reserved region, split in two at the wrap point.
+ *
+ * @param xTicksToWait The maximum time to wait for xDataLengthBytes of space.
+ *
+ * @return The number of bytes reserved, which is pxSpan->xFirstLength +
+ * pxSpan->xSecondLength and may be less than xDataLengthBytes (including 0)
+ * if the block time expired.
+ *
+ * \defgroup xStreamBufferReserve xStreamBufferReserve
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+							 size_t xDataLengthBytes,
+							 StreamBufferSpan_t *pxSpan,
+							 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReserveFromISR( StreamBufferHandle_t xStreamBuffer,
+                                    size_t xDataLengthBytes,
+                                    StreamBufferSpan_t *pxSpan );
+</pre>
+ *
+ * Interrupt safe version of xStreamBufferReserve(), which never blocks.
+ *
+ * \defgroup xStreamBufferReserveFromISR xStreamBufferReserveFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReserveFromISR( StreamBufferHandle_t xStreamBuffer,
+									size_t xDataLengthBytes,
+									StreamBufferSpan_t *pxSpan ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+void vStreamBufferCommit( StreamBufferHandle_t xStreamBuffer, size_t xBytesWritten );
+</pre>
+ *
+ * Publishes the first xBytesWritten bytes of the region last returned by
+ * xStreamBufferReserve().  If the stream buffer then holds at least its
+ * trigger level, a task blocked reading (or peeking) is unblocked, exactly as
+ * if the bytes had been sent with xStreamBufferSend().
+ *
+ * @param xStreamBuffer The handle of the stream buffer written to.
+ *
+ * @param xBytesWritten The number of bytes written into the reserved region,
+ * from the start of pxSpan->pucFirst.  Must not exceed the number reserved.
+ *
+ * \defgroup vStreamBufferCommit vStreamBufferCommit
+ * \ingroup StreamBufferManagement
+ */
+void vStreamBufferCommit( StreamBufferHandle_t xStreamBuffer, size_t xBytesWritten ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+void vStreamBufferCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                 size_t xBytesWritten,
+                                 BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Interrupt safe version of vStreamBufferCommit().  *pxHigherPriorityTaskWoken
+ * is set to pdTRUE if the commit unblocked a task with a priority above the
+ * running task, in which case a context switch should be requested before the
+ * interrupt exits.
+ *
+ * \defgroup vStreamBufferCommitFromISR vStreamBufferCommitFromISR
+ * \ingroup StreamBufferManagement
+ */
+void vStreamBufferCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+								 size_t xBytesWritten,
+								 BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferPeek( StreamBufferHandle_t xStreamBuffer,
+                          StreamBufferSpan_t *pxSpan,
+                          TickType_t xTicksToWait );
+</pre>
+ *
+ * Zero-copy alternative to xStreamBufferReceive().  Returns the region of the
+ * storage area holding the unread bytes without copying or removing them; the
+ * reader processes them in place (for example by starting a DMA transfer out
+ * of the region) and then releases them with vStreamBufferConsume().
+ *
+ * Blocking follows xStreamBufferReceive(): if the stream buffer is empty the
+ * calling task waits up to xTicksToWait, and is woken when a writer takes the
+ * buffer to its trigger level.  Stream buffers only, and only one reader.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to read from.
+ *
+ * @param pxSpan Set to the readable region, split in two at the wrap point.
+ *
+ * @param xTicksToWait The maximum time to wait for data if the stream buffer
+ * is empty.
+ *
+ * @return The number of bytes readable, which is pxSpan->xFirstLength +
+ * pxSpan->xSecondLength.
+ *
+ * \defgroup xStreamBufferPeek xStreamBufferPeek
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferPeek( StreamBufferHandle_t xStreamBuffer,
+						  StreamBufferSpan_t *pxSpan,
+						  TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferPeekFromISR( StreamBufferHandle_t xStreamBuffer, StreamBufferSpan_t *pxSpan );
+</pre>
+ *
+ * Interrupt safe version of xStreamBufferPeek(), which never blocks.
+ *
+ * \defgroup xStreamBufferPeekFromISR xStreamBufferPeekFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferPeekFromISR( StreamBufferHandle_t xStreamBuffer, StreamBufferSpan_t *pxSpan ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+void vStreamBufferConsume( StreamBufferHandle_t xStreamBuffer, size_t xBytesRead );
+</pre>
+ *
+ * Removes the first xBytesRead bytes returned by xStreamBufferPeek() from the
+ * stream buffer, and unblocks a task waiting to write, as
+ * xStreamBufferReceive() would.
+ *
+ * @param xStreamBuffer The handle of the stream buffer read from.
+ *
+ * @param xBytesRead The number of bytes to release.  Must not exceed the
+ * number of bytes in the stream buffer.
+ *
+ * \defgroup vStreamBufferConsume vStreamBufferConsume
+ * \ingroup StreamBufferManagement
+ */
+void vStreamBufferConsume( StreamBufferHandle_t xStreamBuffer, size_t xBytesRead ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+void vStreamBufferConsumeFromISR( StreamBufferHandle_t xStreamBuffer,
+                                  size_t xBytesRead,
+                                  BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Interrupt safe version of vStreamBufferConsume().
+ *
+ * \defgroup vStreamBufferConsumeFromISR vStreamBufferConsumeFromISR
+ * \ingroup StreamBufferManagement
+ */
+void vStreamBufferConsumeFromISR( StreamBufferHandle_t xStreamBuffer,
+								  size_t xBytesRead,
+								  BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /* Functions below here are not part of the public API. */
 StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes,
 												 size_t xTriggerLevelBytes,
@@ -0,0 +1,715 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * An implementation of pvPortMalloc() and vPortFree() with constant execution
+ * time, using a two level segregated fit (TLSF) scheme.
+ *
+ * Free blocks are kept in size classes.  The first level splits sizes by power
+ * of two, the second level splits each power of two range into
+ * heapSL_INDEX_COUNT linear steps.  A bitmap per level records which classes
+ * hold at least one block, so finding a block that fits, and adding or removing
+ * one, is a couple of count-leading-zeros instructions regardless of how many
+ * blocks the heap has been split into.  Adjacent free blocks are merged as soon
+ * as they are freed, as heap_4.c does, but through a pointer to the physically
+ * previous block instead of an address ordered walk of the free list.
+ *
+ * Requests are rounded up to the next class boundary before the search, so a
+ * block taken from the class found always fits without searching inside the
+ * class.  The cost is a little internal fragmentation for large requests (at
+ * most 1/heapSL_INDEX_COUNT of the request).
+ *
+ * The heap is a single array, configured exactly as for heap_4.c.  Blocks must
+ * be smaller than 2 ^ configTLSF_FL_INDEX_MAX bytes, so configTOTAL_HEAP_SIZE
+ * must not be larger than that.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c and heap_4.c for alternative
+ * implementations, and the memory management pages of http://www.FreeRTOS.org
+ * for more information.
+ */
+#include <stdlib.h>
+#include <stddef.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+/* Blocks of up to 2 ^ configTLSF_FL_INDEX_MAX bytes can be managed.  Each
+extra first level index costs heapSL_INDEX_COUNT pointers of RAM. */
+#ifndef configTLSF_FL_INDEX_MAX
+	#define configTLSF_FL_INDEX_MAX		14
+#endif
+
+/* Number of second level classes per power of two, as a power of two. */
+#define heapSL_INDEX_COUNT_LOG2		4
+#define heapSL_INDEX_COUNT			( 1UL << heapSL_INDEX_COUNT_LOG2 )
+
+/* Blocks smaller than heapSMALL_BLOCK_SIZE all live in first level class 0,
+split into heapSL_INDEX_COUNT classes of 8 bytes each. */
+#define heapALIGN_SIZE_LOG2			3
+#define heapFL_INDEX_SHIFT			( heapSL_INDEX_COUNT_LOG2 + heapALIGN_SIZE_LOG2 )
+#define heapFL_INDEX_COUNT			( configTLSF_FL_INDEX_MAX - heapFL_INDEX_SHIFT + 1 )
+#define heapSMALL_BLOCK_SIZE		( ( size_t ) 1 << heapFL_INDEX_SHIFT )
+#define heapMAX_BLOCK_SIZE			( ( size_t ) 1 << configTLSF_FL_INDEX_MAX )
+
+#if( portBYTE_ALIGNMENT < 8 )
+	#error heap_tlsf.c requires portBYTE_ALIGNMENT of at least 8
+#endif
+
+#if( ( configTLSF_FL_INDEX_MAX <= heapFL_INDEX_SHIFT ) || ( configTLSF_FL_INDEX_MAX > 30 ) )
+	#error configTLSF_FL_INDEX_MAX is out of range
+#endif
+
+/* Bit 0 of xBlockSize is set while the block is on a free list.  Block sizes
+are multiples of portBYTE_ALIGNMENT so the bit is otherwise unused. */
+#define heapBLOCK_FREE_BIT			( ( size_t ) 1 )
+
+#if defined( __ICCARM__ )
+	#include <intrinsics.h>
+	#define heapCLZ( ulValue )		( ( UBaseType_t ) __CLZ( ulValue ) )
+#else
+	#define heapCLZ( ulValue )		( ( UBaseType_t ) __builtin_clz( ulValue ) )
+#endif
+
+/* Index of the most / least significant set bit of a non-zero value. */
+#define heapFLS( ulValue )			( ( UBaseType_t ) 31 - heapCLZ( ( uint32_t ) ( ulValue ) ) )
+#define heapFFS( ulValue )			heapFLS( ( ulValue ) & ( ~( ulValue ) + 1UL ) )
+
+/* Allocate the memory for the heap. */
+#if( configAPPLICATION_ALLOCATED_HEAP == 1 )
+	/* The application writer has already defined the array used for the RTOS
+	heap - probably so it can be placed in a special segment or address. */
+	extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+	static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* Every block, free or allocated, starts with the physical neighbour link and
+the size.  The free list links overlay the start of the user area, so they only
+exist while the block is free. */
+typedef struct A_TLSF_BLOCK
+{
+	struct A_TLSF_BLOCK *pxPrevPhysBlock;	/*<< The block immediately below this one in memory, NULL for the first block. */
+	size_t xBlockSize;						/*<< The size of the block including its header, plus heapBLOCK_FREE_BIT while free. */
+	struct A_TLSF_BLOCK *pxNextFreeBlock;	/*<< The next free block in the same size class. */
+	struct A_TLSF_BLOCK *pxPrevFreeBlock;	/*<< The previous free block in the same size class. */
+} TLSFBlock_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Map a block size onto its first and second level class indexes.
+ */
+static void prvMappingInsert( size_t xSize, UBaseType_t *puxFL, UBaseType_t *puxSL );
+
+/*
+ * Round xSize up to the next class boundary, so any block in the class it
+ * then maps to is large enough, and return the class indexes.
+ */
+static void prvMappingSearch( size_t xSize, UBaseType_t *puxFL, UBaseType_t *puxSL );
+
+/*
+ * Return the first block of the smallest non-empty class at or above the class
+ * passed in, updating the indexes to that class, or NULL if there is none.
+ */
+static TLSFBlock_t *prvFindSuitableBlock( UBaseType_t *puxFL, UBaseType_t *puxSL );
+
+/*
+ * Add a block to, or take a block off, the free list of its size class.
+ */
+static void prvInsertFreeBlock( TLSFBlock_t *pxBlock );
+static void prvRemoveFreeBlock( TLSFBlock_t *pxBlock );
+
+/*
+ * Size of the largest free block.  The largest block is in the highest
+ * non-empty class, so only that one list is walked.
+ */
+static size_t prvLargestFreeBlock( void );
+
+/*
+ * Called automatically to setup the required heap structures the first time
+ * pvPortMalloc() is called.
+ */
+static void prvHeapInit( void );
+
+/*-----------------------------------------------------------*/
+
+/* The size of the header placed at the beginning of each allocated memory
+block must by correctly byte aligned. */
+static const size_t xHeapStructSize	= ( offsetof( TLSFBlock_t, pxNextFreeBlock ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* A free block must be able to hold the free list links. */
+static const size_t xMinimumBlockSize = ( sizeof( TLSFBlock_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* Class bitmaps and free list heads. */
+static uint32_t ulFLBitmap = 0;
+static uint32_t ulSLBitmap[ heapFL_INDEX_COUNT ];
+static TLSFBlock_t *pxFreeLists[ heapFL_INDEX_COUNT ][ heapSL_INDEX_COUNT ];
+
+/* The first block in the heap, and a zero sized, permanently allocated block
+at the end that stops merging running off the top of the heap. */
+static TLSFBlock_t *pxFirst = NULL, *pxEnd = NULL;
+
+/* Keeps track of the number of calls to allocate and free memory as well as the
+number of free bytes remaining. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfSuccessfulAllocations = 0;
+static size_t xNumberOfSuccessfulFrees = 0;
+
+/*-----------------------------------------------------------*/
+
+#define prvBlockSize( pxBlock )			( ( pxBlock )->xBlockSize & ~heapBLOCK_FREE_BIT )
+#define prvBlockIsFree( pxBlock )		( ( ( pxBlock )->xBlockSize & heapBLOCK_FREE_BIT ) != 0 )
+#define prvNextPhysBlock( pxBlock )		( ( TLSFBlock_t * ) ( ( ( uint8_t * ) ( pxBlock ) ) + prvBlockSize( pxBlock ) ) )
+
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+TLSFBlock_t *pxBlock, *pxNewBlockLink;
+UBaseType_t uxFL, uxSL;
+size_t xBlockSize;
+void *pvReturn = NULL;
+
+	vTaskSuspendAll();
+	{
+		/* If this is the first call to malloc then the heap will require
+		initialisation to setup the free lists. */
+		if( pxEnd == NULL )
+		{
+			prvHeapInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Requests that could not fit in the largest block are rejected here,
+		which also keeps the size arithmetic below from overflowing. */
+		if( ( xWantedSize > 0 ) && ( xWantedSize < ( heapMAX_BLOCK_SIZE - xHeapStructSize - portBYTE_ALIGNMENT ) ) )
+		{
+			/* The wanted size is increased so it can contain the header in
+			addition to the requested amount of bytes, and rounded so that
+			blocks are always aligned to the required number of bytes. */
+			xWantedSize += xHeapStructSize;
+			xWantedSize = ( xWantedSize + ( ( size_t ) portBYTE_ALIGNMENT_MASK ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+			if( xWantedSize < xMinimumBlockSize )
+			{
+				xWantedSize = xMinimumBlockSize;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( xWantedSize <= xFreeBytesRemaining )
+			{
+				prvMappingSearch( xWantedSize, &uxFL, &uxSL );
+				pxBlock = prvFindSuitableBlock( &uxFL, &uxSL );
+
+				if( pxBlock != NULL )
+				{
+					prvRemoveFreeBlock( pxBlock );
+					xBlockSize = prvBlockSize( pxBlock );
+					configASSERT( xBlockSize >= xWantedSize );
+
+					/* If the block is larger than required it can be split into
+					two.  The remainder cannot have a free neighbour above it, as
+					free blocks are always merged, so it goes straight back on a
+					free list. */
+					if( ( xBlockSize - xWantedSize ) >= xMinimumBlockSize )
+					{
+						pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+						configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+						pxNewBlockLink->xBlockSize = xBlockSize - xWantedSize;
+						pxNewBlockLink->pxPrevPhysBlock = pxBlock;
+						prvNextPhysBlock( pxNewBlockLink )->pxPrevPhysBlock = pxNewBlockLink;
+						prvInsertFreeBlock( pxNewBlockLink );
+						xBlockSize = xWantedSize;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* The block is being returned - it is allocated and owned by
+					the application. */
+					pxBlock->xBlockSize = xBlockSize;
+					xFreeBytesRemaining -= xBlockSize;
+
+					if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+					{
+						xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* Return the memory space pointed to - jumping over the
+					header at its start. */
+					pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+					xNumberOfSuccessfulAllocations++;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceMALLOC( pvReturn, xWantedSize );
+	}
+	( void ) xTaskResumeAll();
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+uint8_t *puc = ( uint8_t * ) pv;
+TLSFBlock_t *pxBlock, *pxNeighbour;
+
+	if( pv != NULL )
+	{
+		/* The memory being freed will have a header immediately before it. */
+		puc -= xHeapStructSize;
+
+		/* This casting is to keep the compiler from issuing warnings. */
+		pxBlock = ( void * ) puc;
+
+		/* Check the block is actually allocated, and lies within the heap. */
+		configASSERT( ( pxBlock >= pxFirst ) && ( pxBlock < pxEnd ) );
+		configASSERT( !prvBlockIsFree( pxBlock ) );
+		configASSERT( prvNextPhysBlock( pxBlock )->pxPrevPhysBlock == pxBlock );
+
+		if( !prvBlockIsFree( pxBlock ) )
+		{
+			vTaskSuspendAll();
+			{
+				xFreeBytesRemaining += pxBlock->xBlockSize;
+				traceFREE( pv, pxBlock->xBlockSize );
+
+				/* Merge with the block below if it is free. */
+				pxNeighbour = pxBlock->pxPrevPhysBlock;
+				if( ( pxNeighbour != NULL ) && prvBlockIsFree( pxNeighbour ) )
+				{
+					prvRemoveFreeBlock( pxNeighbour );
+					pxNeighbour->xBlockSize = prvBlockSize( pxNeighbour ) + pxBlock->xBlockSize;
+					pxBlock = pxNeighbour;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Merge with the block above if it is free.  pxEnd is never
+				free so this cannot run off the top of the heap. */
+				pxNeighbour = prvNextPhysBlock( pxBlock );
+				if( prvBlockIsFree( pxNeighbour ) )
+				{
+					prvRemoveFreeBlock( pxNeighbour );
+					pxBlock->xBlockSize += prvBlockSize( pxNeighbour );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				prvNextPhysBlock( pxBlock )->pxPrevPhysBlock = pxBlock;
+				prvInsertFreeBlock( pxBlock );
+				xNumberOfSuccessfulFrees++;
+			}
+			( void ) xTaskResumeAll();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetHeapFragmentation( void )
+{
+size_t xLargest, xFree;
+
+	vTaskSuspendAll();
+	{
+		xLargest = prvLargestFreeBlock();
+		xFree = xFreeBytesRemaining;
+	}
+	( void ) xTaskResumeAll();
+
+	/* 0 while all the free memory is one block, rising towards 100 as it is
+	split into pieces that are each a small part of the total. */
+	if( xFree == 0 )
+	{
+		return 0;
+	}
+
+	return 100U - ( ( xLargest * 100U ) / xFree );
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+	/* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+static void prvMappingInsert( size_t xSize, UBaseType_t *puxFL, UBaseType_t *puxSL )
+{
+UBaseType_t uxFL, uxSL;
+
+	if( xSize < heapSMALL_BLOCK_SIZE )
+	{
+		/* Small blocks are split linearly in 8 byte steps. */
+		uxFL = 0;
+		uxSL = ( UBaseType_t ) ( xSize >> heapALIGN_SIZE_LOG2 );
+	}
+	else
+	{
+		/* The top bit picks the power of two, the next heapSL_INDEX_COUNT_LOG2
+		bits pick the step within it. */
+		uxFL = heapFLS( xSize );
+		uxSL = ( UBaseType_t ) ( xSize >> ( uxFL - heapSL_INDEX_COUNT_LOG2 ) ) ^ heapSL_INDEX_COUNT;
+		uxFL -= ( heapFL_INDEX_SHIFT - 1 );
+	}
+
+	*puxFL = uxFL;
+	*puxSL = uxSL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMappingSearch( size_t xSize, UBaseType_t *puxFL, UBaseType_t *puxSL )
+{
+	if( xSize >= heapSMALL_BLOCK_SIZE )
+	{
+		xSize += ( ( size_t ) 1 << ( heapFLS( xSize ) - heapSL_INDEX_COUNT_LOG2 ) ) - 1;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	prvMappingInsert( xSize, puxFL, puxSL );
+}
+/*-----------------------------------------------------------*/
+
+static TLSFBlock_t *prvFindSuitableBlock( UBaseType_t *puxFL, UBaseType_t *puxSL )
+{
+UBaseType_t uxFL = *puxFL;
+uint32_t ulSLMap, ulFLMap;
+
+	/* A request rounded past the largest class cannot be met. */
+	if( uxFL >= heapFL_INDEX_COUNT )
+	{
+		return NULL;
+	}
+
+	/* First look for a class in this power of two at or above the one asked
+	for, then for the smallest non-empty class in any larger power of two. */
+	ulSLMap = ulSLBitmap[ uxFL ] & ( 0xffffffffUL << *puxSL );
+
+	if( ulSLMap == 0 )
+	{
+		ulFLMap = ulFLBitmap & ( 0xffffffffUL << ( uxFL + 1 ) );
+
+		if( ulFLMap == 0 )
+		{
+			return NULL;
+		}
+
+		uxFL = heapFFS( ulFLMap );
+		ulSLMap = ulSLBitmap[ uxFL ];
+		configASSERT( ulSLMap != 0 );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	*puxFL = uxFL;
+	*puxSL = heapFFS( ulSLMap );
+
+	return pxFreeLists[ uxFL ][ *puxSL ];
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( TLSFBlock_t *pxBlock )
+{
+UBaseType_t uxFL, uxSL;
+TLSFBlock_t *pxHead;
+
+	prvMappingInsert( prvBlockSize( pxBlock ), &uxFL, &uxSL );
+	configASSERT( uxFL < heapFL_INDEX_COUNT );
+
+	pxHead = pxFreeLists[ uxFL ][ uxSL ];
+	pxBlock->pxNextFreeBlock = pxHead;
+	pxBlock->pxPrevFreeBlock = NULL;
+
+	if( pxHead != NULL )
+	{
+		pxHead->pxPrevFreeBlock = pxBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxFreeLists[ uxFL ][ uxSL ] = pxBlock;
+	pxBlock->xBlockSize |= heapBLOCK_FREE_BIT;
+
+	ulFLBitmap |= ( 1UL << uxFL );
+	ulSLBitmap[ uxFL ] |= ( 1UL << uxSL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( TLSFBlock_t *pxBlock )
+{
+UBaseType_t uxFL, uxSL;
+
+	prvMappingInsert( prvBlockSize( pxBlock ), &uxFL, &uxSL );
+
+	if( pxBlock->pxNextFreeBlock != NULL )
+	{
+		pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock->pxPrevFreeBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxBlock->pxPrevFreeBlock != NULL )
+	{
+		pxBlock->pxPrevFreeBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+	}
+	else
+	{
+		/* The block was the head of its class.  Clear the bitmap bits if the
+		class, and then possibly the whole power of two, is now empty. */
+		configASSERT( pxFreeLists[ uxFL ][ uxSL ] == pxBlock );
+		pxFreeLists[ uxFL ][ uxSL ] = pxBlock->pxNextFreeBlock;
+
+		if( pxBlock->pxNextFreeBlock == NULL )
+		{
+			ulSLBitmap[ uxFL ] &= ~( 1UL << uxSL );
+
+			if( ulSLBitmap[ uxFL ] == 0 )
+			{
+				ulFLBitmap &= ~( 1UL << uxFL );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	pxBlock->xBlockSize &= ~heapBLOCK_FREE_BIT;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvLargestFreeBlock( void )
+{
+TLSFBlock_t *pxBlock;
+UBaseType_t uxFL;
+size_t xMaxSize = 0;
+
+	if( ulFLBitmap != 0 )
+	{
+		uxFL = heapFLS( ulFLBitmap );
+
+		for( pxBlock = pxFreeLists[ uxFL ][ heapFLS( ulSLBitmap[ uxFL ] ) ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFreeBlock )
+		{
+			if( prvBlockSize( pxBlock ) > xMaxSize )
+			{
+				xMaxSize = prvBlockSize( pxBlock );
+			}
+		}
+	}
+
+	return xMaxSize;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void )
+{
+uint8_t *pucAlignedHeap;
+size_t uxAddress;
+size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
+
+	/* Ensure the heap starts on a correctly aligned boundary. */
+	uxAddress = ( size_t ) ucHeap;
+
+	if( ( uxAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+	{
+		uxAddress += ( portBYTE_ALIGNMENT - 1 );
+		uxAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+		xTotalHeapSize -= uxAddress - ( size_t ) ucHeap;
+	}
+
+	pucAlignedHeap = ( uint8_t * ) uxAddress;
+
+	/* A heap larger than the largest block the size classes describe needs a
+	bigger configTLSF_FL_INDEX_MAX.  Without it the excess is left unused. */
+	configASSERT( xTotalHeapSize <= heapMAX_BLOCK_SIZE );
+
+	if( xTotalHeapSize > heapMAX_BLOCK_SIZE )
+	{
+		xTotalHeapSize = heapMAX_BLOCK_SIZE;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* pxEnd marks the end of the heap.  It has no size and is never free, so
+	the block below it never tries to merge upwards. */
+	uxAddress = ( ( size_t ) pucAlignedHeap ) + xTotalHeapSize;
+	uxAddress -= xHeapStructSize;
+	uxAddress &= ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+	pxEnd = ( void * ) uxAddress;
+
+	/* To start with there is a single free block that is sized to take up the
+	entire heap space, minus the space taken by pxEnd. */
+	pxFirst = ( void * ) pucAlignedHeap;
+	pxFirst->pxPrevPhysBlock = NULL;
+	pxFirst->xBlockSize = uxAddress - ( size_t ) pxFirst;
+
+	pxEnd->pxPrevPhysBlock = pxFirst;
+	pxEnd->xBlockSize = 0;
+
+	prvInsertFreeBlock( pxFirst );
+
+	/* Only one block exists - and it covers the entire usable heap space. */
+	xMinimumEverFreeBytesRemaining = prvBlockSize( pxFirst );
+	xFreeBytesRemaining = prvBlockSize( pxFirst );
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+TLSFBlock_t *pxBlock;
+size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+	vTaskSuspendAll();
+	{
+		/* pxFirst will be NULL if the heap has not been initialised.  The heap
+		is initialised automatically when the first allocation is made.  The
+		walk is in address order over every block, free or not, so unlike the
+		allocator itself it is not constant time. */
+		if( pxFirst != NULL )
+		{
+			for( pxBlock = pxFirst; pxBlock != pxEnd; pxBlock = prvNextPhysBlock( pxBlock ) )
+			{
+				if( prvBlockIsFree( pxBlock ) )
+				{
+					xBlocks++;
+
+					if( prvBlockSize( pxBlock ) > xMaxSize )
+					{
+						xMaxSize = prvBlockSize( pxBlock );
+					}
+
+					if( prvBlockSize( pxBlock ) < xMinSize )
+					{
+						xMinSize = prvBlockSize( pxBlock );
+					}
+				}
+			}
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+	pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+	pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+	taskENTER_CRITICAL();
+	{
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+	}
+	taskEXIT_CRITICAL();
+}
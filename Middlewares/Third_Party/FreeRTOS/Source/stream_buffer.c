@@ -202,6 +202,15 @@ static size_t prvReadBytesFromBuffer( StreamBuffer_t *pxStreamBuffer,
 									  size_t xMaxCount,
 									  size_t xBytesAvailable ) PRIVILEGED_FUNCTION;
 
+/*
+ * Fills *pxSpan with the xCount bytes of the ring starting at index xStart,
+ * split in two where they wrap.  Used by the zero-copy reserve/peek functions.
+ */
+static void prvGetSpan( const StreamBuffer_t * const pxStreamBuffer,
+						size_t xStart,
+						size_t xCount,
+						StreamBufferSpan_t * const pxSpan ) PRIVILEGED_FUNCTION;
+
 /*
  * Called by both pxStreamBufferCreate() and pxStreamBufferCreateStatic() to
  * initialise the members of the newly created stream buffer structure.
@@ -1085,6 +1094,332 @@ UBaseType_t uxSavedInterruptStatus;
 }
 /*-----------------------------------------------------------*/
 
+size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+							 size_t xDataLengthBytes,
+							 StreamBufferSpan_t *pxSpan,
+							 TickType_t xTicksToWait )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xSpace = 0;
+TimeOut_t xTimeOut;
+
+	configASSERT( pxSpan );
+	configASSERT( pxStreamBuffer );
+
+	/* The length prefix of a message buffer cannot be written in place. */
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+	if( xTicksToWait != ( TickType_t ) 0 )
+	{
+		vTaskSetTimeOutState( &xTimeOut );
+
+		do
+		{
+			/* Same wait as xStreamBufferSend(): for the whole request. */
+			taskENTER_CRITICAL();
+			{
+				xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+				if( xSpace < xDataLengthBytes )
+				{
+					( void ) xTaskNotifyStateClear( NULL );
+
+					configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+					pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+				}
+				else
+				{
+					taskEXIT_CRITICAL();
+					break;
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
+			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToSend = NULL;
+
+		} while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xSpace == ( size_t ) 0 )
+	{
+		xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* Only the writer moves xHead, so the region cannot change under it. */
+	xSpace = configMIN( xSpace, xDataLengthBytes );
+	prvGetSpan( pxStreamBuffer, pxStreamBuffer->xHead, xSpace, pxSpan );
+
+	return xSpace;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReserveFromISR( StreamBufferHandle_t xStreamBuffer,
+									size_t xDataLengthBytes,
+									StreamBufferSpan_t *pxSpan )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xSpace;
+
+	configASSERT( pxSpan );
+	configASSERT( pxStreamBuffer );
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+	xSpace = configMIN( xStreamBufferSpacesAvailable( pxStreamBuffer ), xDataLengthBytes );
+	prvGetSpan( pxStreamBuffer, pxStreamBuffer->xHead, xSpace, pxSpan );
+
+	return xSpace;
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferCommit( StreamBufferHandle_t xStreamBuffer, size_t xBytesWritten )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xNextHead;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( xBytesWritten <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+
+	if( xBytesWritten > ( size_t ) 0 )
+	{
+		xNextHead = pxStreamBuffer->xHead + xBytesWritten;
+		if( xNextHead >= pxStreamBuffer->xLength )
+		{
+			xNextHead -= pxStreamBuffer->xLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Publishing the new head is what makes the data visible. */
+		pxStreamBuffer->xHead = xNextHead;
+		traceSTREAM_BUFFER_SEND( xStreamBuffer, xBytesWritten );
+
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		{
+			sbSEND_COMPLETED( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+								 size_t xBytesWritten,
+								 BaseType_t *pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xNextHead;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( xBytesWritten <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+
+	if( xBytesWritten > ( size_t ) 0 )
+	{
+		xNextHead = pxStreamBuffer->xHead + xBytesWritten;
+		if( xNextHead >= pxStreamBuffer->xLength )
+		{
+			xNextHead -= pxStreamBuffer->xLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxStreamBuffer->xHead = xNextHead;
+
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		{
+			sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xBytesWritten );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferPeek( StreamBufferHandle_t xStreamBuffer,
+						  StreamBufferSpan_t *pxSpan,
+						  TickType_t xTicksToWait )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xBytesAvailable;
+
+	configASSERT( pxSpan );
+	configASSERT( pxStreamBuffer );
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+	if( xTicksToWait != ( TickType_t ) 0 )
+	{
+		/* Same wait as xStreamBufferReceive(): the writer wakes this task
+		once the trigger level is reached. */
+		taskENTER_CRITICAL();
+		{
+			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+			if( xBytesAvailable == ( size_t ) 0 )
+			{
+				( void ) xTaskNotifyStateClear( NULL );
+
+				configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+				pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xBytesAvailable == ( size_t ) 0 )
+		{
+			traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer );
+			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToReceive = NULL;
+
+			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+	}
+
+	/* Only the reader moves xTail, so the region cannot change under it. */
+	prvGetSpan( pxStreamBuffer, pxStreamBuffer->xTail, xBytesAvailable, pxSpan );
+
+	return xBytesAvailable;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferPeekFromISR( StreamBufferHandle_t xStreamBuffer, StreamBufferSpan_t *pxSpan )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xBytesAvailable;
+
+	configASSERT( pxSpan );
+	configASSERT( pxStreamBuffer );
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+	xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+	prvGetSpan( pxStreamBuffer, pxStreamBuffer->xTail, xBytesAvailable, pxSpan );
+
+	return xBytesAvailable;
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferConsume( StreamBufferHandle_t xStreamBuffer, size_t xBytesRead )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xNextTail;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( xBytesRead <= prvBytesInBuffer( pxStreamBuffer ) );
+
+	if( xBytesRead > ( size_t ) 0 )
+	{
+		xNextTail = pxStreamBuffer->xTail + xBytesRead;
+		if( xNextTail >= pxStreamBuffer->xLength )
+		{
+			xNextTail -= pxStreamBuffer->xLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxStreamBuffer->xTail = xNextTail;
+		traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xBytesRead );
+		sbRECEIVE_COMPLETED( pxStreamBuffer );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferConsumeFromISR( StreamBufferHandle_t xStreamBuffer,
+								  size_t xBytesRead,
+								  BaseType_t *pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xNextTail;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( xBytesRead <= prvBytesInBuffer( pxStreamBuffer ) );
+
+	if( xBytesRead > ( size_t ) 0 )
+	{
+		xNextTail = pxStreamBuffer->xTail + xBytesRead;
+		if( xNextTail >= pxStreamBuffer->xLength )
+		{
+			xNextTail -= pxStreamBuffer->xLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxStreamBuffer->xTail = xNextTail;
+		sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xBytesRead );
+}
+/*-----------------------------------------------------------*/
+
+static void prvGetSpan( const StreamBuffer_t * const pxStreamBuffer,
+						size_t xStart,
+						size_t xCount,
+						StreamBufferSpan_t * const pxSpan )
+{
+size_t xFirstLength;
+
+	configASSERT( xCount <= pxStreamBuffer->xLength );
+
+	xFirstLength = configMIN( pxStreamBuffer->xLength - xStart, xCount );
+
+	pxSpan->pucFirst = &( pxStreamBuffer->pucBuffer[ xStart ] );
+	pxSpan->xFirstLength = xFirstLength;
+	pxSpan->pucSecond = pxStreamBuffer->pucBuffer;
+	pxSpan->xSecondLength = xCount - xFirstLength;
+}
+/*-----------------------------------------------------------*/
+
 static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount )
 {
 size_t xNextHead, xFirstLength;
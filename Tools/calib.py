@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""Read and update the site calibration stored in flash (Core/Src/calib_store.c).
+
+Talks to the running firmware over USART2 (115200 8N1, the ST-Link virtual
+COM port); sampling and the barrier keep running, and an update is in force
+from the next water slot.
+
+    python3 Tools/calib.py /dev/ttyACM0                       # show the block in force
+    python3 Tools/calib.py /dev/ttyACM0 --warning 30 --normal 12
+    python3 Tools/calib.py /dev/ttyACM0 --sensor-max 42.5 --clamp 3980
+    python3 Tools/calib.py /dev/ttyACM0 --factory             # back to the calib.h values
+    python3 Tools/calib.py /dev/ttyACM0 --learn               # teach another remote
+    python3 Tools/calib.py /dev/ttyACM0 --forget 1            # drop learned remote 1
+
+Options left out keep their current value. The firmware checks the record's
+CRC and ranges (0 < normal < warning <= sensor max), stores it as the next
+sequence number in the A/B flash slots and answers with that number.
+
+--learn asks for the five barrier keys in turn (up, down, stop, auto,
+e-stop) on the new remote and reads each frame back from the firmware; keys
+of a remote it does not know yet move nothing. Up to 4 remotes are kept
+(CALIB_IR_REMOTES); --learn N re-teaches remote N. --factory keeps them.
+"""
+
+import argparse
+import struct
+import sys
+import time
+import zlib
+
+# calib_record_t in Core/Inc/calib.h
+MAGIC = 0x424C4143
+VERSION = 1
+REMOTES = 4                 # CALIB_IR_REMOTES
+IR_KEYS = ["up", "down", "stop", "auto", "e-stop"]     # CALIB_IR_KEYS, BEV_IR_UP order
+RECORD = struct.Struct("<IHHIfffHBB" + "H5sB" * REMOTES + "I")
+FIELDS = ["magic", "version", "size", "seq", "normal_mm", "warning_mm", "sensor_max_mm",
+          "raw_clamp", "risk_raise", "ir_remotes"]
+
+
+def unpack(raw):
+    v = RECORD.unpack(raw)
+    rec = dict(zip(FIELDS, v[:len(FIELDS)]))
+    ir = v[len(FIELDS):-1]
+    rec["remotes"] = [(ir[3 * i], list(ir[3 * i + 1])) for i in range(min(rec["ir_remotes"], REMOTES))]
+    rec["crc_ok"] = v[-1] == zlib.crc32(raw[:RECORD.size - 4])
+    return rec
+
+
+def pack(rec):
+    ir = []
+    for i in range(REMOTES):
+        address, commands = rec["remotes"][i] if i < len(rec["remotes"]) else (0, [0] * len(IR_KEYS))
+        ir += [address, bytes(commands), 0]
+    body = RECORD.pack(MAGIC, VERSION, RECORD.size, rec["seq"], rec["normal_mm"], rec["warning_mm"],
+                       rec["sensor_max_mm"], rec["raw_clamp"], rec["risk_raise"], len(rec["remotes"]), *ir, 0)
+    return body[:-4] + struct.pack("<I", zlib.crc32(body[:-4]))
+
+
+def command(port, line):
+    """Send one command line, return the reply line (trace dump bytes are skipped)"""
+    port.reset_input_buffer()
+    port.write(line.encode() + b"\n")
+    for _ in range(20):
+        reply = port.readline().decode(errors="replace").strip()
+        for prefix in ("C ", "K ", "OK ", "ERR "):
+            if prefix in reply:
+                return reply[reply.index(prefix):]
+    raise SystemExit("no reply to %r" % line[:1])
+
+
+def show(rec):
+    print("seq %d%s: normal %.2f mm, warning %.2f mm, sensor max %.2f mm, clamp %d counts, early raise at P=%d/256"
+          % (rec["seq"], " (factory)" if rec["seq"] == 0 else "", rec["normal_mm"], rec["warning_mm"],
+             rec["sensor_max_mm"], rec["raw_clamp"], rec["risk_raise"]))
+    for i, (address, commands) in enumerate(rec["remotes"]):
+        print("remote %d: address 0x%04X, %s" % (i, address,
+              ", ".join("%s 0x%02X" % (k, c) for k, c in zip(IR_KEYS, commands))))
+
+
+def last_frame(port):
+    """(frame word, frame count) of the last valid IR frame the firmware received"""
+    reply = command(port, "K")
+    if not reply.startswith("K "):
+        raise SystemExit(reply)
+    return struct.unpack("<II", bytes.fromhex(reply[2:]))
+
+
+def learn(port):
+    """Frames for the barrier keys of one remote: (address, [command per key])"""
+    address, commands = None, []
+    _, count = last_frame(port)
+    for key in IR_KEYS:
+        print("press %s on the new remote" % key.upper(), flush=True)
+        deadline = time.monotonic() + 30.0
+        while True:
+            if time.monotonic() > deadline:
+                raise SystemExit("no frame in 30 s")
+            time.sleep(0.2)
+            word, n = last_frame(port)
+            if n == count:
+                continue
+            count = n
+            a, c = word & 0xFFFF, (word >> 16) & 0xFF
+            if address is not None and a != address:
+                print("  address 0x%04X is another remote, try again" % a)
+            elif c in commands:
+                print("  already taken by %s, try another key" % IR_KEYS[commands.index(c)])
+            else:
+                break
+        address = a
+        commands.append(c)
+        print("  address 0x%04X command 0x%02X" % (a, c))
+    return address, commands
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("port")
+    ap.add_argument("--normal", type=float, help="NORMAL below this level (mm)")
+    ap.add_argument("--warning", type=float, help="barrier up at this level (mm)")
+    ap.add_argument("--sensor-max", type=float, help="level at full scale, 4095 counts (mm)")
+    ap.add_argument("--clamp", type=int, help="raw counts clamp")
+    ap.add_argument("--risk", type=int, help="P(flood) * 256 that raises early")
+    ap.add_argument("--factory", action="store_true", help="store the factory values")
+    ap.add_argument("--learn", type=int, nargs="?", const=-1, metavar="N", help="teach a remote (or re-teach remote N)")
+    ap.add_argument("--forget", type=int, metavar="N", help="drop learned remote N")
+    args = ap.parse_args()
+
+    import serial   # pyserial
+    with serial.Serial(args.port, 115200, timeout=1.0) as port:
+        reply = command(port, "R")
+        if not reply.startswith("C "):
+            raise SystemExit(reply)
+        rec = unpack(bytes.fromhex(reply[2:]))
+        if not rec["crc_ok"]:
+            raise SystemExit("garbled read-back, try again")
+        changes = {"normal_mm": args.normal, "warning_mm": args.warning, "sensor_max_mm": args.sensor_max,
+                   "raw_clamp": args.clamp, "risk_raise": args.risk}
+        remotes = rec["remotes"]
+        if args.forget is not None:
+            if not 0 <= args.forget < len(remotes):
+                raise SystemExit("no remote %d (%d learned)" % (args.forget, len(remotes)))
+            del remotes[args.forget]
+        elif args.learn is not None:
+            if args.learn >= len(remotes) or (args.learn < 0 and len(remotes) == REMOTES):
+                raise SystemExit("no remote %d (%d learned, at most %d)" % (args.learn, len(remotes), REMOTES))
+            remote = learn(port)
+            if any(r[0] == remote[0] for i, r in enumerate(remotes) if i != args.learn):
+                raise SystemExit("address 0x%04X is learned already" % remote[0])
+            if args.learn < 0:
+                remotes.append(remote)
+            else:
+                remotes[args.learn] = remote
+        elif not args.factory and all(v is None for v in changes.values()):
+            show(rec)
+            return
+        if args.factory:
+            reply = command(port, "F")
+        else:
+            rec.update({k: v for k, v in changes.items() if v is not None})
+            reply = command(port, "W " + pack(rec).hex().upper())
+        if not reply.startswith("OK "):
+            sys.exit(reply)
+        rec = unpack(bytes.fromhex(command(port, "R")[2:]))
+        show(rec)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Fit the level sensor linearization curve and export it for Core/Src/sensor_curve.c.
+
+Bench calibration: fill the tank to known levels, log the ADC counts at
+each, and fit the curve from those points:
+
+    python3 Tools/fit_sensor_curve.py points.csv > Core/Src/sensor_curve_table.c
+    python3 Tools/fit_sensor_curve.py > Core/Src/sensor_curve_table.c      # straight line
+
+A CSV row is "raw,mm" (header and '#' lines skipped; repeated readings at one
+level are averaged).  Levels become linear counts with --sensor-max, which
+must match the calibration block's sensor_max_mm (calib.h).  The points are
+made non-decreasing (pool-adjacent-violators), joined piecewise linearly and
+extended past the end points with the end slopes; the knots and the
+4096-entry LUT are sampled from that.  Fit error at the points per
+SENSOR_CURVE_MODE is printed to stderr.
+"""
+
+import argparse
+import csv
+import sys
+
+SHIFT = 7                       # SENSOR_CURVE_SHIFT
+KNOTS = (4096 >> SHIFT) + 1     # SENSOR_CURVE_KNOTS
+LSB = 8                         # q15 per linear count
+SENSOR_MAX_MM = 40.0
+
+
+def read_points(path):
+    levels = {}
+    with open(path) as f:
+        for row in csv.reader(line for line in f if not line.startswith("#")):
+            try:
+                raw, mm = int(row[0]), float(row[1])
+            except (ValueError, IndexError):
+                continue        # header
+            levels.setdefault(mm, []).append(raw)
+    return sorted((sum(r) / len(r), mm) for mm, r in levels.items())
+
+
+def monotone(points):
+    """Pool-adjacent-violators on y (and merge equal counts): the curve must not fall as counts rise"""
+    blocks = []
+    for x, y in points:
+        blocks.append([x, y, 1])
+        while len(blocks) > 1 and (blocks[-2][1] > blocks[-1][1] or blocks[-2][0] >= blocks[-1][0]):
+            x2, y2, n2 = blocks.pop()
+            x1, y1, n1 = blocks[-1]
+            blocks[-1] = [(x1 * n1 + x2 * n2) / (n1 + n2), (y1 * n1 + y2 * n2) / (n1 + n2), n1 + n2]
+    return [(x, y) for x, y, _ in blocks]
+
+
+def piecewise(points):
+    def f(x):
+        if len(points) == 1:
+            return points[0][1]
+        i = 1
+        while i < len(points) - 1 and x > points[i][0]:
+            i += 1
+        (x0, y0), (x1, y1) = points[i - 1], points[i]
+        return y0 + (y1 - y0) * (x - x0) / (x1 - x0)
+    return f
+
+
+def q15(v):
+    return max(0, min(32767, int(round(v * LSB))))
+
+
+def linear_interp_q15(table, raw):
+    """arm_linear_interp_q15 with x = raw << (20 - SHIFT)"""
+    x = raw << (20 - SHIFT)
+    i, fract = x >> 20, x & 0xFFFFF
+    if i >= len(table) - 1:
+        return table[-1]
+    return (table[i] * (0xFFFFF - fract) + table[i + 1] * fract) >> 20
+
+
+def natural_spline(xs, ys):
+    """Same coefficients as arm_spline_init_f32(ARM_SPLINE_NATURAL)"""
+    n = len(xs)
+    h = [xs[i + 1] - xs[i] for i in range(n - 1)]
+    alpha = [0.0] * n
+    for i in range(1, n - 1):
+        alpha[i] = 3 / h[i] * (ys[i + 1] - ys[i]) - 3 / h[i - 1] * (ys[i] - ys[i - 1])
+    l, mu, z = [1.0] * n, [0.0] * n, [0.0] * n
+    for i in range(1, n - 1):
+        l[i] = 2 * (xs[i + 1] - xs[i - 1]) - h[i - 1] * mu[i - 1]
+        mu[i] = h[i] / l[i]
+        z[i] = (alpha[i] - h[i - 1] * z[i - 1]) / l[i]
+    c = [0.0] * n
+    for i in range(n - 2, -1, -1):
+        c[i] = z[i] - mu[i] * c[i + 1]
+
+    def f(x):
+        i = min(max(int(x) >> SHIFT, 0), n - 2)
+        b = (ys[i + 1] - ys[i]) / h[i] - h[i] * (c[i + 1] + 2 * c[i]) / 3
+        d = (c[i + 1] - c[i]) / (3 * h[i])
+        t = x - xs[i]
+        return ys[i] + b * t + c[i] * t * t + d * t * t * t
+    return f
+
+
+def curve(fit):
+    """Knot x/y, q15 knots, q15 LUT and the spline the firmware builds, for a fit in linear counts."""
+    f = piecewise(fit)
+
+    def lin(x):
+        return min(max(f(x), 0.0), 32767.0 / LSB)
+
+    xs = [float(i << SHIFT) for i in range(KNOTS)]
+    ys = [lin(x) for x in xs]
+    return xs, ys, [q15(y) for y in ys], [q15(lin(r)) for r in range(4096)], natural_spline(xs, ys)
+
+
+def c_array(decl, values, fmt, per_line):
+    lines = [decl + " = {"]
+    for i in range(0, len(values), per_line):
+        lines.append("    " + " ".join(fmt % v + "," for v in values[i:i + per_line]))
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("points", nargs="?", help="raw,mm calibration points (default: straight line)")
+    ap.add_argument("--sensor-max", type=float, default=SENSOR_MAX_MM, help="mm at 4095 counts (calib.h)")
+    args = ap.parse_args()
+
+    scale = 4095.0 / args.sensor_max
+    if args.points:
+        pts = read_points(args.points)
+        if len(pts) < 2:
+            sys.exit("need at least two distinct levels")
+        fit = monotone([(raw, mm * scale) for raw, mm in pts])
+        source = "%s, %d levels, sensor max %g mm" % (args.points, len(pts), args.sensor_max)
+    else:
+        pts = [(0, 0.0), (4095, args.sensor_max)]
+        fit = [(0.0, 0.0), (4095.0, 4095.0)]
+        source = "straight line"
+    xs, ys, knots, lut, spline = curve(fit)
+
+    for name, conv in (("linear", lambda r: linear_interp_q15(knots, r) / LSB),
+                       ("spline", lambda r: spline(r)),
+                       ("lut", lambda r: lut[r] / LSB)):
+        errs = [abs(conv(min(int(round(raw)), 4095)) - mm * scale) / scale for raw, mm in pts]
+        print("%-6s max %.3f mm, mean %.3f mm at %d points" % (name, max(errs), sum(errs) / len(errs), len(pts)),
+              file=sys.stderr)
+
+    print("/* Generated by Tools/fit_sensor_curve.py (%s) -- do not edit. */" % source)
+    print('#include "sensor_curve.h"\n')
+    print("// Linear counts * %d at raw = i << SENSOR_CURVE_SHIFT" % LSB)
+    print(c_array("const q15_t sensor_curve_q15[SENSOR_CURVE_KNOTS]", knots, "%6d", 11))
+    print()
+    print(c_array("const float32_t sensor_curve_x_f32[SENSOR_CURVE_KNOTS]", xs, "%.1ff", 11))
+    print()
+    print(c_array("const float32_t sensor_curve_y_f32[SENSOR_CURVE_KNOTS]", ys, "%.4ff", 8))
+    print()
+    print("#if SENSOR_CURVE_MODE == SENSOR_CURVE_LUT")
+    print(c_array("const q15_t sensor_curve_lut[4096]", lut, "%6d", 16))
+    print("#endif")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,387 @@
+// Fleet simulator: thousands of barrier controllers (controller.c, one
+// controller_t per unit, unchanged) in one host process under one synthetic
+// storm, for gateway capacity planning. Units sit on a square grid over the
+// district; a few rain cells drift across it, so neighbouring units see
+// correlated rainfall. Each unit turns rain into a channel level (a leaky
+// bucket with its own gain and drainage), adds sensor noise and splash
+// spikes, and feeds the counts to its controller every REPLAY_SLOT_MS of
+// virtual time. A small fraction of units get a stuck or open sensor part
+// way through (only the open ones are flagged: a stuck sensor reads as a
+// steady level), and operators press remote keys at random.
+//
+// Units are stepped in batches by a pool of threads: a worker claims the
+// next batch and runs it through the whole storm, so a batch stays in its
+// cache. Every unit has its own random stream, so the result does not depend
+// on the thread count or the batch size. Nothing is allocated per unit: the
+// unit array is one allocation at start-up. Built and run by Tools/fleet.py.
+//
+//     fleet [-n units] [-hours h] [-threads t] [-batch b] [-seed s]
+//           [-cells k] [-faults f] [-ir per_unit_hour] [-heartbeat s] [-o series.csv]
+//
+// Telemetry model: one message per servo, barrier state or rain status
+// change, plus a heartbeat per unit. Alerts: a barrier raised by the level
+// (FLOOD) and a sensor fault (SENSOR ERR).
+#include "controller.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef REPLAY_SLOT_MS
+#define REPLAY_SLOT_MS      100     // TASK_WATER_PERIOD_MS; fleet.py passes it from task_model.h
+#endif
+#define FLEET_MAX_CELLS     16
+#define FLEET_DISTRICT_KM   12.0f
+#define FLEET_DRAIN_S       900.0f  // channel drainage time constant: 60 mm/h settles at 15 mm x gain
+#define FLEET_NOISE_MM      0.3f
+#define FLEET_SPIKE_P       0.002f  // splash spike probability per sample
+
+typedef struct {
+    float x0_km, y0_km;     // centre at onset
+    float vx, vy;           // km/s
+    float radius_km;
+    float peak_mm_h;
+    float onset_s, length_s;
+} rain_cell_t;
+
+enum { FAULT_NONE = 0, FAULT_STUCK, FAULT_OPEN };
+
+typedef struct {
+    controller_t ctrl;
+    float x_km, y_km;
+    float level_mm;         // channel level the sensor sees
+    float gain;             // catchment: level per unit rain
+    float rain_mm_s;        // field value for the current second
+    uint32_t rng;
+    uint8_t fault;
+    uint16_t stuck_raw;
+    uint32_t fault_at_s;
+    uint32_t next_ir_s;
+    uint32_t heartbeat_phase_s;
+} unit_t;
+
+typedef struct {
+    uint64_t state, servo, status;
+    uint64_t raises, raises_auto, faults;
+    uint64_t ir, ir_ignored;
+    uint64_t messages, alerts;
+    uint32_t *sec_messages, *sec_alerts, *sec_up;   // per virtual second
+} fleet_stats_t;
+
+static struct {
+    uint32_t units, batch, threads, seconds, cells, heartbeat_s;
+    float faults, ir_per_hour;
+    uint32_t seed;
+    const char *series;
+} cfg = { 1024, 64, 0, 3600, 6, 60, 0.005f, 0.2f, 1, NULL };
+
+static rain_cell_t cells[FLEET_MAX_CELLS];
+static unit_t *units;
+static atomic_uint next_batch;
+static fleet_stats_t *thread_stats;
+static uint16_t sensor_raw[32768];  // inverse sensor curve (sensor_curve.h) in q15 steps, shared by all units
+
+static uint32_t rng_next(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *s = x;
+}
+
+static float rng_uniform(uint32_t *s) {
+    return (rng_next(s) >> 8) * (1.0f / 16777216.0f);
+}
+
+/* Irwin-Hall: good enough for sensor noise, no libm in the inner loop */
+static float rng_normal(uint32_t *s) {
+    return (rng_uniform(s) + rng_uniform(s) + rng_uniform(s) + rng_uniform(s) - 2.0f) * 1.7320508f;
+}
+
+static uint32_t rng_seed(uint32_t seed, uint32_t i) {
+    uint32_t s = seed * 0x9E3779B9U ^ (i + 1) * 0x85EBCA6BU;
+    return s ? s : 1;
+}
+
+static void storm_init(void) {
+    uint32_t s = rng_seed(cfg.seed, 0xFFFFFFFFU);
+    float wind_dir = rng_uniform(&s) * 6.2831853f;
+    float wind_km_s = (20.0f + 30.0f * rng_uniform(&s)) / 3600.0f;
+
+    // Cells share the wind and start upwind, so the storm sweeps the district
+    for (uint32_t k = 0; k < cfg.cells; k++) {
+        rain_cell_t *c = &cells[k];
+        float jitter = (rng_uniform(&s) - 0.5f) * 0.6f;
+        c->vx = wind_km_s * cosf(wind_dir + jitter);
+        c->vy = wind_km_s * sinf(wind_dir + jitter);
+        c->radius_km = 2.0f + 4.0f * rng_uniform(&s);
+        c->peak_mm_h = 20.0f + 70.0f * rng_uniform(&s);
+        c->onset_s = cfg.seconds * 0.6f * rng_uniform(&s);
+        c->length_s = 1800.0f + 3600.0f * rng_uniform(&s);
+        c->x0_km = FLEET_DISTRICT_KM * rng_uniform(&s) - c->vx * c->length_s * 0.5f;
+        c->y0_km = FLEET_DISTRICT_KM * rng_uniform(&s) - c->vy * c->length_s * 0.5f;
+    }
+}
+
+/* Rain rate at a point: Gaussian cells under a sin^2 life-cycle envelope */
+static float storm_rain_mm_s(float x, float y, float t) {
+    float r = 0.5f;     // district-wide drizzle, mm/h
+    for (uint32_t k = 0; k < cfg.cells; k++) {
+        const rain_cell_t *c = &cells[k];
+        float age = t - c->onset_s;
+        if (age <= 0.0f || age >= c->length_s) continue;
+        float dx = x - (c->x0_km + c->vx * age);
+        float dy = y - (c->y0_km + c->vy * age);
+        float env = sinf(3.1415927f * age / c->length_s);
+        r += c->peak_mm_h * env * env * expf(-(dx * dx + dy * dy) / (2.0f * c->radius_km * c->radius_km));
+    }
+    return r / 3600.0f;
+}
+
+static void unit_init(unit_t *u, uint32_t i) {
+    uint32_t side = (uint32_t)ceilf(sqrtf((float)cfg.units));
+
+    controller_init(&u->ctrl, &calib_factory);
+    controller_dispatch(&u->ctrl, BEV_LEVEL_LOW);   // boot outputs: units are already running at t = 0
+    u->rng = rng_seed(cfg.seed, i);
+    u->x_km = FLEET_DISTRICT_KM * ((i % side) + 0.5f) / side;
+    u->y_km = FLEET_DISTRICT_KM * ((i / side) + 0.5f) / side;
+    u->level_mm = 2.0f + 2.0f * rng_uniform(&u->rng);
+    u->gain = 1.5f + 2.0f * rng_uniform(&u->rng);
+    u->rain_mm_s = 0.0f;
+    u->fault = FAULT_NONE;
+    if (rng_uniform(&u->rng) < cfg.faults) {
+        u->fault = rng_uniform(&u->rng) < 0.5f ? FAULT_STUCK : FAULT_OPEN;
+        u->fault_at_s = (uint32_t)(cfg.seconds * rng_uniform(&u->rng));
+        u->stuck_raw = (uint16_t)(400 + rng_next(&u->rng) % 2000);
+    }
+    u->next_ir_s = cfg.ir_per_hour > 0.0f
+                 ? (uint32_t)(-logf(1.0f - rng_uniform(&u->rng)) * 3600.0f / cfg.ir_per_hour) : UINT32_MAX;
+    u->heartbeat_phase_s = rng_next(&u->rng) % cfg.heartbeat_s;
+}
+
+static void sensor_init(void) {
+    sensor_curve_instance_t curve;
+
+    sensor_curve_init(&curve);
+    for (uint16_t i = 0; i < 32768; i++) sensor_raw[i] = sensor_curve_raw(&curve, i / SENSOR_CURVE_LSB);
+}
+
+/* Sensor counts for the current level, with noise, spikes and injected faults */
+static uint16_t unit_sample(unit_t *u, uint32_t sec) {
+    float mm, lin;
+
+    if (u->fault != FAULT_NONE && sec >= u->fault_at_s) {
+        if (u->fault == FAULT_STUCK) return u->stuck_raw;
+        return (uint16_t)(rng_next(&u->rng) % 4096);   // floating input
+    }
+    mm = u->level_mm + FLEET_NOISE_MM * rng_normal(&u->rng);
+    if (rng_uniform(&u->rng) < FLEET_SPIKE_P) mm += 10.0f * rng_uniform(&u->rng);
+    lin = mm / calib_factory.mm_per_count * SENSOR_CURVE_LSB + 0.5f;
+    return sensor_raw[lin < 0.0f ? 0 : lin > 32767.0f ? 32767 : (uint16_t)lin];
+}
+
+static void unit_outputs(fleet_stats_t *st, const unit_t *u, uint32_t sec, uint8_t up, uint8_t changed) {
+    uint32_t msgs = 0, alerts = 0;
+
+    if (changed & CTRL_STATE) { st->state++; msgs++; }
+    if (changed & CTRL_SERVO) { st->servo++; msgs++; }
+    if (changed & CTRL_STATUS) {
+        st->status++;
+        msgs++;
+        if (u->ctrl.slot.status == RAIN_SENSOR_ERR) { st->faults++; alerts++; }
+    }
+    if (u->ctrl.fsm.barrier_up && !up) {
+        st->raises++;
+        if (u->ctrl.fsm.state == BARRIER_FLOOD) { st->raises_auto++; alerts++; }
+    }
+    st->messages += msgs;
+    st->alerts += alerts;
+    st->sec_messages[sec] += msgs;
+    st->sec_alerts[sec] += alerts;
+}
+
+static void batch_run(fleet_stats_t *st, unit_t *b, uint32_t n) {
+    const uint32_t slots_per_s = 1000 / REPLAY_SLOT_MS;
+    const float dt = REPLAY_SLOT_MS / 1000.0f;
+
+    for (uint32_t sec = 0; sec < cfg.seconds; sec++) {
+        for (uint32_t i = 0; i < n; i++) {
+            unit_t *u = &b[i];
+            u->rain_mm_s = storm_rain_mm_s(u->x_km, u->y_km, (float)sec);
+            if ((sec + u->heartbeat_phase_s) % cfg.heartbeat_s == 0) {
+                st->messages++;
+                st->sec_messages[sec]++;
+            }
+            if (sec >= u->next_ir_s) {
+                // A key of the built-in remote: one of the mapped ones, or any other (toggle)
+                uint32_t k = rng_next(&u->rng) % (ir_key_count + 1);
+                uint32_t frame = k < ir_key_count ? ir_nec_word(ir_keys[k].address, ir_keys[k].command)
+                                                  : ir_nec_word(ir_keys[0].address, (uint8_t)rng_next(&u->rng));
+                uint8_t ev = controller_ir_event(&u->ctrl, frame, sec * 1000U);
+                uint8_t up = u->ctrl.fsm.barrier_up;
+                st->ir++;
+                if (ev == CTRL_NO_EVENT) st->ir_ignored++;
+                else unit_outputs(st, u, sec, up, controller_dispatch(&u->ctrl, ev));
+                u->next_ir_s = sec + 1 + (uint32_t)(-logf(1.0f - rng_uniform(&u->rng)) * 3600.0f / cfg.ir_per_hour);
+            }
+            for (uint32_t s = 0; s < slots_per_s; s++) {
+                uint8_t up = u->ctrl.fsm.barrier_up;
+                u->level_mm += dt * (u->gain * u->rain_mm_s - u->level_mm / FLEET_DRAIN_S);
+                unit_outputs(st, u, sec, up, controller_slot(&u->ctrl, unit_sample(u, sec)));
+            }
+            st->sec_up[sec] += u->ctrl.fsm.barrier_up;
+        }
+    }
+}
+
+static void *worker(void *arg) {
+    fleet_stats_t *st = arg;
+    uint32_t nbatch = (cfg.units + cfg.batch - 1) / cfg.batch;
+
+    for (;;) {
+        uint32_t b = atomic_fetch_add(&next_batch, 1);
+        if (b >= nbatch) break;
+        uint32_t first = b * cfg.batch;
+        uint32_t n = cfg.units - first < cfg.batch ? cfg.units - first : cfg.batch;
+        batch_run(st, &units[first], n);
+    }
+    return NULL;
+}
+
+static const char *hms(uint32_t s) {
+    static char buf[16];
+    snprintf(buf, sizeof(buf), "%02u:%02u:%02u", s / 3600, s / 60 % 60, s % 60);
+    return buf;
+}
+
+static int parse_args(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (v == NULL) return -1;
+        if (strcmp(a, "-n") == 0) cfg.units = (uint32_t)atoi(v);
+        else if (strcmp(a, "-hours") == 0) cfg.seconds = (uint32_t)(atof(v) * 3600.0);
+        else if (strcmp(a, "-threads") == 0) cfg.threads = (uint32_t)atoi(v);
+        else if (strcmp(a, "-batch") == 0) cfg.batch = (uint32_t)atoi(v);
+        else if (strcmp(a, "-seed") == 0) cfg.seed = (uint32_t)atoi(v);
+        else if (strcmp(a, "-cells") == 0) cfg.cells = (uint32_t)atoi(v);
+        else if (strcmp(a, "-faults") == 0) cfg.faults = (float)atof(v);
+        else if (strcmp(a, "-ir") == 0) cfg.ir_per_hour = (float)atof(v);
+        else if (strcmp(a, "-heartbeat") == 0) cfg.heartbeat_s = (uint32_t)atoi(v);
+        else if (strcmp(a, "-o") == 0) cfg.series = v;
+        else return -1;
+        i++;
+    }
+    if (cfg.units == 0 || cfg.batch == 0 || cfg.seconds == 0 || cfg.heartbeat_s == 0 ||
+        cfg.cells > FLEET_MAX_CELLS || 1000 % REPLAY_SLOT_MS != 0) return -1;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    struct timespec w0, w1;
+    pthread_t *threads;
+    fleet_stats_t tot = { 0 };
+    uint32_t peak_msg_s = 0, peak_alert_s = 0, peak_up_s = 0, peak_alert_min_s = 0;
+    uint64_t alert_min = 0, peak_alert_min = 0;
+
+    if (parse_args(argc, argv) != 0) {
+        fprintf(stderr, "usage: %s [-n units] [-hours h] [-threads t] [-batch b] [-seed s] [-cells k]"
+                        " [-faults f] [-ir per_unit_hour] [-heartbeat s] [-o series.csv]\n", argv[0]);
+        return 2;
+    }
+    if (cfg.threads == 0) cfg.threads = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+
+    // The only allocations: units, then per-thread counters
+    units = aligned_alloc(64, ((sizeof(unit_t) * cfg.units + 63) / 64) * 64);
+    thread_stats = calloc(cfg.threads, sizeof(fleet_stats_t));
+    threads = calloc(cfg.threads, sizeof(pthread_t));
+    if (units == NULL || thread_stats == NULL || threads == NULL) return 2;
+    for (uint32_t t = 0; t < cfg.threads; t++) {
+        thread_stats[t].sec_messages = calloc(cfg.seconds, sizeof(uint32_t));
+        thread_stats[t].sec_alerts = calloc(cfg.seconds, sizeof(uint32_t));
+        thread_stats[t].sec_up = calloc(cfg.seconds, sizeof(uint32_t));
+        if (!thread_stats[t].sec_messages || !thread_stats[t].sec_alerts || !thread_stats[t].sec_up) return 2;
+    }
+
+    storm_init();
+    sensor_init();
+    for (uint32_t i = 0; i < cfg.units; i++) unit_init(&units[i], i);
+
+    clock_gettime(CLOCK_MONOTONIC, &w0);
+    for (uint32_t t = 0; t < cfg.threads; t++) pthread_create(&threads[t], NULL, worker, &thread_stats[t]);
+    for (uint32_t t = 0; t < cfg.threads; t++) pthread_join(threads[t], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &w1);
+
+    // Merge: counters add up, series add per second
+    tot.sec_messages = thread_stats[0].sec_messages;
+    tot.sec_alerts = thread_stats[0].sec_alerts;
+    tot.sec_up = thread_stats[0].sec_up;
+    for (uint32_t t = 0; t < cfg.threads; t++) {
+        const fleet_stats_t *st = &thread_stats[t];
+        tot.state += st->state;
+        tot.servo += st->servo;
+        tot.status += st->status;
+        tot.raises += st->raises;
+        tot.raises_auto += st->raises_auto;
+        tot.faults += st->faults;
+        tot.ir += st->ir;
+        tot.ir_ignored += st->ir_ignored;
+        tot.messages += st->messages;
+        tot.alerts += st->alerts;
+        if (t == 0) continue;
+        for (uint32_t s = 0; s < cfg.seconds; s++) {
+            tot.sec_messages[s] += st->sec_messages[s];
+            tot.sec_alerts[s] += st->sec_alerts[s];
+            tot.sec_up[s] += st->sec_up[s];
+        }
+    }
+    for (uint32_t s = 0; s < cfg.seconds; s++) {
+        if (tot.sec_messages[s] > tot.sec_messages[peak_msg_s]) peak_msg_s = s;
+        if (tot.sec_alerts[s] > tot.sec_alerts[peak_alert_s]) peak_alert_s = s;
+        if (tot.sec_up[s] > tot.sec_up[peak_up_s]) peak_up_s = s;
+        alert_min += tot.sec_alerts[s];
+        if (s >= 60) alert_min -= tot.sec_alerts[s - 60];
+        if (alert_min > peak_alert_min) {
+            peak_alert_min = alert_min;
+            peak_alert_min_s = s;
+        }
+    }
+
+    double wall = (double)(w1.tv_sec - w0.tv_sec) + (double)(w1.tv_nsec - w0.tv_nsec) * 1e-9;
+    double steps = (double)cfg.units * cfg.seconds * (1000 / REPLAY_SLOT_MS);
+    printf("fleet: %u units, %.2f h storm (%u cells), %u threads, batch %u, seed %u\n",
+           cfg.units, cfg.seconds / 3600.0, cfg.cells, cfg.threads, cfg.batch, cfg.seed);
+    printf("steps: %.0f in %.2f s = %.2f M steps/s (%.2f M/s per thread), %.0f x real time per unit\n",
+           steps, wall, steps / wall * 1e-6, steps / wall * 1e-6 / cfg.threads, steps / wall / cfg.units * REPLAY_SLOT_MS / 1000.0);
+    printf("controller: %zu bytes per unit (unit %zu), %.1f MB total\n",
+           sizeof(controller_t), sizeof(unit_t), sizeof(unit_t) * (double)cfg.units / 1048576.0);
+    printf("events: %llu state, %llu servo, %llu status; %llu raises (%llu by level), %llu sensor faults,"
+           " %llu IR frames (%llu ignored)\n",
+           (unsigned long long)tot.state, (unsigned long long)tot.servo, (unsigned long long)tot.status,
+           (unsigned long long)tot.raises, (unsigned long long)tot.raises_auto, (unsigned long long)tot.faults,
+           (unsigned long long)tot.ir, (unsigned long long)tot.ir_ignored);
+    printf("telemetry: %llu messages (heartbeat %u s), mean %.1f msg/s, peak %u msg/s at %s\n",
+           (unsigned long long)tot.messages, cfg.heartbeat_s, (double)tot.messages / cfg.seconds,
+           tot.sec_messages[peak_msg_s], hms(peak_msg_s));
+    printf("alerts: %llu, peak %u in one second at %s,", (unsigned long long)tot.alerts,
+           tot.sec_alerts[peak_alert_s], hms(peak_alert_s));
+    printf(" peak %llu in one minute ending %s\n", (unsigned long long)peak_alert_min, hms(peak_alert_min_s));
+    printf("barriers up: peak %u units (%.1f %%) at %s\n", tot.sec_up[peak_up_s],
+           100.0 * tot.sec_up[peak_up_s] / cfg.units, hms(peak_up_s));
+
+    if (cfg.series != NULL) {
+        FILE *f = fopen(cfg.series, "w");
+        if (f == NULL) return 2;
+        fprintf(f, "t_s,messages,alerts,units_up\n");
+        for (uint32_t s = 0; s < cfg.seconds; s++) {
+            fprintf(f, "%u,%u,%u,%u\n", s, tot.sec_messages[s], tot.sec_alerts[s], tot.sec_up[s]);
+        }
+        fclose(f);
+    }
+    return 0;
+}
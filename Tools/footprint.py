@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+"""Flash/RAM footprint per component from the GNU ld map file.
+
+Only sections kept after --gc-sections are counted (the "Discarded input
+sections" list is skipped).  Flash is .text + .rodata + .data (its load
+image), RAM is .data + .bss; the heap array (ucHeap) is reported apart
+from the kernel since its size is configTOTAL_HEAP_SIZE.
+
+    python3 Tools/footprint.py "STM32CubeIDE/Debug/new mini project.map"
+    python3 Tools/footprint.py lean.map --compare full.map      # delta per component
+    python3 Tools/footprint.py lean.map --objects kernel        # per object file
+
+Build once with configKERNEL_LEAN 1 and once with 0 to compare the kernel
+profiles; the Debug build prints the summary after linking (makefile.targets).
+"""
+
+import argparse
+import re
+
+GROUPS = [
+    ("kernel", r"FreeRTOS/(?!.*heap_)|cmsis_os|FreeRTOS/portable/GCC"),
+    ("heap", r"heap_\w+\.o"),
+    ("dsp/nn", r"CMSIS/(DSP|NN)|arm_"),
+    ("hal", r"STM32F4xx_HAL_Driver|stm32f4xx_hal"),
+    ("app", r"Application/User|Core/"),
+    ("libc", r"libc|libm|libgcc|libnosys|crt"),
+]
+
+SECTION = re.compile(r"^ (\.[\w.$-]+|COMMON)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*))?$")
+CONT = re.compile(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$")
+
+
+def kind(section):
+    if section.startswith((".text", ".isr_vector", ".ARM", ".glue", ".vfp11", ".init", ".fini")):
+        return "text"
+    if section.startswith(".rodata"):
+        return "rodata"
+    if section.startswith(".data"):
+        return "data"
+    if section.startswith((".bss", "COMMON")):
+        return "bss"
+    return None
+
+
+def group_of(obj):
+    for name, pattern in GROUPS:
+        if re.search(pattern, obj):
+            return name
+    return "other"
+
+
+def parse(path):
+    """{object: {text, rodata, data, bss}} plus the heap symbol size"""
+    objects = {}
+    heap = 0
+    in_map = False
+    pending = None
+    for line in open(path, errors="replace"):
+        if not in_map:
+            in_map = line.startswith("Linker script and memory map")
+            continue
+        m = SECTION.match(line.rstrip("\n"))
+        if m and m.group(2) is None:
+            pending = m.group(1)    # long section name, numbers on the next line
+            continue
+        if m:
+            section, addr, size, obj = m.group(1), m.group(2), int(m.group(3), 16), m.group(4)
+        elif pending:
+            c = CONT.match(line.rstrip("\n"))
+            pending, section = None, pending
+            if not c:
+                continue
+            addr, size, obj = c.group(1), int(c.group(2), 16), c.group(3)
+        else:
+            continue
+        k = kind(section)
+        if not k or size == 0 or int(addr, 16) == 0:
+            continue
+        if "ucHeap" in section:
+            heap += size
+            continue
+        entry = objects.setdefault(obj.strip(), dict(text=0, rodata=0, data=0, bss=0))
+        entry[k] += size
+    return objects, heap
+
+
+def totals(objects):
+    out = {}
+    for obj, s in objects.items():
+        g = out.setdefault(group_of(obj), [0, 0])
+        g[0] += s["text"] + s["rodata"] + s["data"]
+        g[1] += s["data"] + s["bss"]
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("map")
+    ap.add_argument("--compare", metavar="MAP")
+    ap.add_argument("--objects", metavar="GROUP", help="list object files of one group")
+    args = ap.parse_args()
+
+    objects, heap = parse(args.map)
+    cur = totals(objects)
+    ref, ref_heap = None, 0
+    if args.compare:
+        ref_objects, ref_heap = parse(args.compare)
+        ref = totals(ref_objects)
+
+    names = [g for g, _ in GROUPS] + ["other"]
+    print("%-8s %8s %8s%s" % ("", "flash", "ram", "   delta flash  delta ram" if ref else ""))
+    for g in names:
+        f, r = cur.get(g, [0, 0])
+        line = "%-8s %8d %8d" % (g, f, r)
+        if ref:
+            rf, rr = ref.get(g, [0, 0])
+            line += "   %+11d %+10d" % (f - rf, r - rr)
+        if f or r or (ref and ref.get(g)):
+            print(line)
+    tf = sum(v[0] for v in cur.values())
+    tr = sum(v[1] for v in cur.values()) + heap
+    line = "%-8s %8d %8d" % ("total", tf, tr)
+    if ref:
+        line += "   %+11d %+10d" % (tf - sum(v[0] for v in ref.values()),
+                                   tr - sum(v[1] for v in ref.values()) - ref_heap)
+    print(line)
+    print("(RAM total includes the %d-byte kernel heap)" % heap)
+
+    if args.objects:
+        print()
+        for obj, s in sorted(objects.items(), key=lambda kv: -sum(kv[1].values())):
+            if group_of(obj) == args.objects:
+                print("%6d %6d %6d %6d  %s" % (s["text"], s["rodata"], s["data"], s["bss"], obj))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""Generate the CMSIS-DSP FFT tables used by the firmware.
+
+The vendored CMSIS-DSP tree ships without arm_common_tables.c, so the
+twiddle and bit-reversal tables needed by arm_rfft_fast_f32/arm_cfft_f32
+are generated here, only for the transforms declared in Core/Inc/dsp_config.h.
+The output keeps the CMSIS table names and ARM_TABLE_* guards, so the
+library sources link against it unchanged.
+
+    python3 Tools/gen_fft_tables.py > Core/Src/dsp_tables.c
+    python3 Tools/gen_fft_tables.py --report     # flash used vs. full set
+"""
+
+import argparse
+import math
+import os
+import re
+import sys
+
+CONFIG = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Core", "Inc", "dsp_config.h")
+CFFT_SIZES = [16, 32, 64, 128, 256, 512, 1024, 2048, 4096]
+RFFT_SIZES = [32, 64, 128, 256, 512, 1024, 2048, 4096]
+TABLE_LENGTH = {16: 20, 32: 48, 64: 56, 128: 208, 256: 440, 512: 448,
+                1024: 1800, 2048: 3808, 4096: 4032}
+
+
+def is_pow8(n):
+    while n % 8 == 0:
+        n //= 8
+    return n == 1
+
+
+def rev8(j, m):
+    digits = 0
+    while 8 ** digits < m:
+        digits += 1
+    r = 0
+    for _ in range(digits):
+        r = r * 8 + j % 8
+        j //= 8
+    return r
+
+
+def bin_at(j, n):
+    """Frequency bin left at position j by arm_cfft_f32 before reordering."""
+    if is_pow8(n):
+        return rev8(j, n)
+    for split in (2, 4):
+        m = n // split
+        if is_pow8(m):
+            return split * rev8(j % m, m) + j // m
+    raise ValueError("unsupported CFFT length %d" % n)
+
+
+def bitrev_table(n):
+    order = [bin_at(j, n) for j in range(n)]
+    swaps = []
+    for k in range(n):
+        while order[k] != k:
+            other = order[k]
+            swaps += [k * 8, other * 8]
+            order[k], order[other] = order[other], order[k]
+    if len(swaps) > TABLE_LENGTH[n]:
+        raise ValueError("bit reversal table for %d does not fit" % n)
+    # Pad with no-op swaps so the length matches arm_common_tables.h.
+    swaps += [0] * (TABLE_LENGTH[n] - len(swaps))
+    return swaps
+
+
+def cfft_twiddle(n):
+    out = []
+    for i in range(n):
+        out += [math.cos(2 * math.pi * i / n), math.sin(2 * math.pi * i / n)]
+    return out
+
+
+def rfft_twiddle(n):
+    out = []
+    for i in range(n // 2):
+        out += [math.sin(2 * math.pi * i / n), math.cos(2 * math.pi * i / n)]
+    return out
+
+
+def emit(ctype, name, guard, values, fmt, per_line):
+    print("#if defined(%s)" % guard)
+    print("const %s %s[%d] = {" % (ctype, name, len(values)))
+    for i in range(0, len(values), per_line):
+        chunk = values[i:i + per_line]
+        print("    " + ", ".join(fmt(v) for v in chunk) + ",")
+    print("};")
+    print("#endif")
+    print()
+
+
+def read_config(path):
+    """-> (rfft sizes, cfft sizes) declared with 1 in dsp_config.h"""
+    rfft, cfft = set(), set()
+    for m in re.finditer(r"^#define\s+DSP_(R|C)FFT_F32_(\d+)\s+(\d+)", open(path).read(), re.M):
+        if int(m.group(3)):
+            (rfft if m.group(1) == "R" else cfft).add(int(m.group(2)))
+    for n in rfft:
+        if n not in RFFT_SIZES:
+            raise SystemExit("unsupported RFFT length %d" % n)
+    for n in cfft:
+        if n not in CFFT_SIZES:
+            raise SystemExit("unsupported CFFT length %d" % n)
+    return sorted(rfft), sorted(cfft)
+
+
+def tables(rfft, cfft):
+    """-> [(ctype, name, guard, values, fmt, per_line)] for the selection"""
+    def flt(v):
+        return "%.9ef" % (0.0 if abs(v) < 1e-12 else v)
+
+    out = []
+    for n in sorted(set(cfft) | {r // 2 for r in rfft}):
+        out.append(("float32_t", "twiddleCoef_%d" % n, "ARM_TABLE_TWIDDLECOEF_F32_%d" % n,
+                    cfft_twiddle(n), flt, 4))
+        out.append(("uint16_t", "armBitRevIndexTable%d" % n, "ARM_TABLE_BITREVIDX_FLT_%d" % n,
+                    bitrev_table(n), str, 12))
+    for n in rfft:
+        out.append(("float32_t", "twiddleCoef_rfft_%d" % n, "ARM_TABLE_TWIDDLECOEF_RFFT_F32_%d" % n,
+                    rfft_twiddle(n), flt, 4))
+    return out
+
+
+def table_bytes(ctype, values):
+    return len(values) * (4 if ctype == "float32_t" else 2)
+
+
+def full_set_bytes():
+    """f32 FFT tables of the complete CMSIS-DSP table set"""
+    return (sum(2 * n * 4 for n in CFFT_SIZES)
+            + sum(TABLE_LENGTH[n] * 2 for n in CFFT_SIZES)
+            + sum(n * 4 for n in RFFT_SIZES))
+
+
+def report(rfft, cfft):
+    used = 0
+    print("declared: RFFT %s, CFFT %s" % (" ".join(map(str, rfft)) or "-", " ".join(map(str, cfft)) or "-"))
+    for ctype, name, _, values, _, _ in tables(rfft, cfft):
+        size = table_bytes(ctype, values)
+        used += size
+        print("  %-28s %6d bytes" % (name, size))
+    full = full_set_bytes()
+    print("selected tables: %d bytes" % used)
+    print("full f32 set:    %d bytes" % full)
+    print("flash saved:     %d bytes" % (full - used))
+
+
+def main(argv):
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--config", default=CONFIG)
+    ap.add_argument("--report", action="store_true")
+    args = ap.parse_args(argv)
+    rfft, cfft = read_config(args.config)
+    if args.report:
+        report(rfft, cfft)
+        return
+
+    selected = tables(rfft, cfft)
+    print("/* Generated by Tools/gen_fft_tables.py from dsp_config.h (RFFT %s, CFFT %s)"
+          " -- do not edit. */" % (" ".join(map(str, rfft)) or "-", " ".join(map(str, cfft)) or "-"))
+    print('#include "arm_math_types.h"')
+    print('#include "arm_common_tables.h"')
+    print()
+
+    # Catch a dsp_config.h edited without regenerating this file
+    have = {t[2] for t in selected}
+    missing = ["ARM_TABLE_TWIDDLECOEF_F32_%d" % n for n in CFFT_SIZES] \
+        + ["ARM_TABLE_BITREVIDX_FLT_%d" % n for n in CFFT_SIZES] \
+        + ["ARM_TABLE_TWIDDLECOEF_RFFT_F32_%d" % n for n in RFFT_SIZES]
+    missing = [g for g in missing if g not in have]
+    if missing:
+        print("#if " + " \\\n || ".join("defined(%s)" % g for g in missing))
+        print('#error "dsp_config.h selects a table missing here: rerun Tools/gen_fft_tables.py"')
+        print("#endif")
+        print()
+
+    for t in selected:
+        emit(*t)
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""Generate the built-in IR key table for Core/Src/ir_keymap.c.
+
+The keys of the remote shipped with the barrier are listed below as
+(address, command, event). The table is a perfect hash: key = address << 8 |
+command, slot = (key * seed mod 2^32) >> (32 - IR_HASH_BITS), with the
+seed searched here so no two keys share a slot. The firmware then maps a
+frame with one multiply and one compare (ir_keymap_lookup()).
+
+    python3 Tools/gen_ir_keymap.py > Core/Src/ir_keymap_table.c
+
+Addresses are the two address bytes as received (ir_nec.h): 0xFF00 is
+standard NEC address 0x00. Learned remotes are not in this table; they are
+stored with the site calibration (Tools/calib.py --learn).
+"""
+
+import os
+import re
+import sys
+
+# 21-key NEC "car MP3" remote, address 0x00
+KEYS = [
+    (0xFF00, 0x47, "BEV_IR_UP", "CH+"),
+    (0xFF00, 0x45, "BEV_IR_DOWN", "CH-"),
+    (0xFF00, 0x46, "BEV_IR_STOP", "CH"),
+    (0xFF00, 0x43, "BEV_IR_AUTO", "play/pause"),
+    (0xFF00, 0x09, "BEV_IR_ESTOP", "EQ"),
+]
+SEED_START = 0x9E3779B1     # golden ratio; odd seeds from here
+
+
+def hash_bits():
+    text = open(os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Core", "Inc", "ir_keymap.h")).read()
+    return int(re.search(r"#define\s+IR_HASH_BITS\s+(\d+)", text).group(1))
+
+
+def slot(key, seed, bits):
+    return ((key * seed) & 0xFFFFFFFF) >> (32 - bits)
+
+
+def find_seed(keys, bits):
+    for seed in range(SEED_START, SEED_START + 2 * 1000000, 2):
+        if len({slot(k, seed, bits) for k in keys}) == len(keys):
+            return seed
+    sys.exit("no perfect hash for %d keys in %d slots: raise IR_HASH_BITS" % (len(keys), 1 << bits))
+
+
+def main():
+    bits = hash_bits()
+    keys = [a << 8 | c for a, c, _, _ in KEYS]
+    if len(set(keys)) != len(keys):
+        sys.exit("duplicate key")
+    seed = find_seed(keys, bits)
+    slots = [0] * (1 << bits)
+    for i, k in enumerate(keys):
+        slots[slot(k, seed, bits)] = i + 1
+
+    print("/* Generated by Tools/gen_ir_keymap.py -- do not edit. */")
+    print('#include "ir_keymap.h"')
+    print('#include "barrier_fsm.h"\n')
+    print("const ir_key_t ir_keys[] = {")
+    for a, c, ev, name in KEYS:
+        print("    { 0x%04X, 0x%02X, %-13s },   // %s" % (a, c, ev, name))
+    print("};")
+    print("const uint8_t ir_key_count = sizeof(ir_keys) / sizeof(ir_keys[0]);\n")
+    print("const uint32_t ir_hash_seed = 0x%08XU;" % seed)
+    print("// Slot -> key index + 1, 0 for an empty slot")
+    print("const uint8_t ir_hash_slot[1 << IR_HASH_BITS] = {")
+    print("    " + " ".join("%d," % s for s in slots))
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""Generate the synthetic level traces in Tools/replay/traces/.
+
+    python3 Tools/gen_replay_traces.py              # rewrites Tools/replay/traces/*.csv
+
+The traces are checked in: Tools/host_test.py replays them and compares
+each timeline with Tools/replay/expected/, and the replay figures quoted
+for the controller come from them. Regenerate only to change a scenario,
+then refresh the expected output (host_test.py --update replay).
+
+  storm_major    one hour: dry 10 min, rise to 38 mm over 20 min, hold 10 min, recede
+  storm_minor    the same storm peaking at 25 mm, under the raise threshold
+  storm_slosh    storm_major with 3 mm of 1.2 Hz slosh on top
+  drizzle        the same storm peaking at 10 mm
+  manual_ir      raw counts at 1 Hz, steady 5 mm, IR toggle / estop / auto
+  storm_labelled steady 5 mm labelled as a flood from 200 s to 300 s
+  malformed_row  a non-numeric row: reported with its line number
+  no_header      no t/raw/mm header: reported, nothing replayed
+"""
+
+import math
+import os
+import random
+
+OUT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "replay", "traces")
+
+
+def write(name, rows, cols="t,mm", comment=None):
+    with open(os.path.join(OUT, name + ".csv"), "w") as f:
+        if comment:
+            f.write("# %s\n" % comment)
+        f.write(cols + "\n")
+        for r in rows:
+            f.write(",".join(str(x) for x in r) + "\n")
+
+
+def storm(peak, hours=1.0, dt=0.1, slosh=0.0, seed=0):
+    rnd = random.Random(seed)
+    rows = []
+    for i in range(int(hours * 3600 / dt)):
+        t = i * dt
+        if t < 600:
+            lvl = 3
+        elif t < 1800:
+            lvl = 3 + (peak - 3) * (t - 600) / 1200
+        elif t < 2400:
+            lvl = peak
+        else:
+            lvl = max(3, peak - (peak - 3) * (t - 2400) / 1200)
+        lvl += rnd.gauss(0, 0.3) + slosh * math.sin(2 * math.pi * 1.2 * t)
+        rows.append((round(t, 3), round(lvl, 3)))
+    return rows
+
+
+def manual_ir():
+    keys = {300: "toggle", 400: "toggle", 900: "estop", 1000: "auto"}
+    return [(t, int(5 / 40 * 4095), keys.get(t, "")) for t in range(3600)]
+
+
+def main():
+    os.makedirs(OUT, exist_ok=True)
+    write("storm_major", storm(38))
+    write("storm_minor", storm(25, seed=2))
+    write("storm_slosh", storm(38, slosh=3, seed=3))
+    write("drizzle", storm(10, seed=4))
+    write("manual_ir", manual_ir(), "t,raw,ir")
+    write("storm_labelled", [("%.1f" % (i / 10), "5.00", int(2000 <= i < 3000)) for i in range(6000)],
+          "t,mm,flood", "labelled")
+    with open(os.path.join(OUT, "malformed_row.csv"), "w") as f:
+        f.write("t,mm\n0,1\n0.1,x\n")
+    with open(os.path.join(OUT, "no_header.csv"), "w") as f:
+        f.write("a,b\n0,1\n")
+
+
+if __name__ == "__main__":
+    main()
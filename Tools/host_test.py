@@ -0,0 +1,415 @@
+#!/usr/bin/env python3
+"""Host tests and benchmarks for the firmware modules.
+
+Each test is a driver in Tools/host_test/, compiled with the same host
+build as Tools/replay.py (replay.build(): the controller sources and the
+CMSIS-DSP/NN files the firmware links) plus the modules and host
+stand-in headers listed for it below. A driver prints what it measured
+and exits non-zero when a check fails. The figures quoted for these
+modules come from these runs on an x86 host at -O2: timings compare
+alternatives, they are not MCU cycles.
+
+    python3 Tools/host_test.py                      # every test
+    python3 Tools/host_test.py replay calib_store
+    python3 Tools/host_test.py --list
+    python3 Tools/host_test.py --update replay      # accept the current replay output
+
+replay runs every trace in Tools/replay/traces/ (Tools/gen_replay_traces.py)
+and compares its timeline and metrics with Tools/replay/expected/; a
+change to the level pipeline that moves an event shows up as a diff. A
+trace with a false raise fails whatever the expected file says, and
+--update will not record one.
+"""
+
+import argparse
+import contextlib
+import difflib
+import glob
+import io
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import replay  # noqa: E402  (shared host build)
+
+ROOT = replay.ROOT
+TRACES = os.path.join(ROOT, "Tools", "replay", "traces")
+EXPECTED = os.path.join(ROOT, "Tools", "replay", "expected")
+
+
+def replay_output(exe, path):
+    """Timeline and metrics of one trace, without the wall-clock figures, or its error."""
+    res = subprocess.run([exe, path], capture_output=True, text=True)
+    if res.returncode != 0:
+        return "error: " + res.stderr.strip().replace(path, os.path.basename(path)) + "\n"
+    lines = res.stdout.splitlines()
+    lines[-1] = " ".join(kv for kv in lines[-1].split() if not kv.startswith(("wall_s=", "speedup=")))
+    return "\n".join(lines) + "\n"
+
+
+def false_raises(out):
+    """false_raises of a replay output, 0 for an error"""
+    last = out.splitlines()[-1]
+    if not last.startswith("# metrics "):
+        return 0
+    return int(dict(kv.split("=") for kv in last.split()[2:])["false_raises"])
+
+
+def run_replay(test, args):
+    exe = replay.build(args.build_dir, args.cc)
+    failed = 0
+    for path in sorted(glob.glob(os.path.join(TRACES, "*.csv"))):
+        name = os.path.splitext(os.path.basename(path))[0]
+        out = replay_output(exe, path)
+        ref = os.path.join(EXPECTED, name + ".txt")
+        if false_raises(out):
+            failed += 1
+            print("  %-16s %d false raises: barrier driven up with no flood" % (name, false_raises(out)))
+            continue
+        if args.update:
+            os.makedirs(EXPECTED, exist_ok=True)
+            with open(ref, "w") as f:
+                f.write(out)
+            print("  %-16s written" % name)
+            continue
+        want = open(ref).read() if os.path.exists(ref) else ""
+        if out == want:
+            print("  %-16s %s" % (name, out.splitlines()[-1].replace("# metrics ", "")))
+            continue
+        failed += 1
+        print("  %-16s differs from %s" % (name, os.path.relpath(ref, ROOT)))
+        diff = difflib.unified_diff(want.splitlines(), out.splitlines(), "expected", "now", lineterm="")
+        for line in list(diff)[:20]:
+            print("    " + line)
+    return failed == 0
+
+
+def run_driver(test, args):
+    exe = replay.build(args.build_dir, args.cc, main=test["main"], flags=test.get("flags", ()),
+                       sources=test.get("sources", ()), includes=test.get("includes", ()), name=test["name"])
+    argv = test.get("args", ())
+    return subprocess.run([exe] + list(argv() if callable(argv) else argv)).returncode == 0
+
+
+def calib_py_record(remotes=((0xEF10, [0x01, 0x02, 0x03, 0x04, 0x05]),)):
+    """A W line as Tools/calib.py sends it: warning at 30 mm and the given learned remotes."""
+    import calib
+    rec = dict(seq=0, normal_mm=15.0, warning_mm=30.0, sensor_max_mm=40.0, raw_clamp=4095, risk_raise=192,
+               remotes=list(remotes))
+    return ["W " + calib.pack(rec).hex()]
+
+
+def run_fleet(test, args):
+    """Same storm and seed under different thread and batch counts: same events and telemetry."""
+    exe = replay.build(args.build_dir, args.cc, main="Tools/fleet/fleet.c", flags=["-pthread"])
+    ref = None
+    for threads, batch in ((1, 64), (2, 7), (4, 1), (3, 1000)):
+        cmd = [exe, "-n", "300", "-hours", "0.25", "-threads", str(threads), "-batch", str(batch), "-faults", "0.05"]
+        out = subprocess.run(cmd, capture_output=True, text=True, check=True).stdout.splitlines()
+        report = [line for line in out if not line.startswith(("fleet:", "steps:"))]
+        if ref is None:
+            ref = report
+            for line in report:
+                print("  " + line)
+        same = report == ref
+        print("  threads %d batch %4d: %s" % (threads, batch, "same" if same else "DIFFERENT"))
+        if not same:
+            return False
+    return True
+
+
+def run_sensor_curve(test, args):
+    """Every SENSOR_CURVE_MODE on a fitted table; the C output matches the fit tool's emulation."""
+    import fit_sensor_curve as fit
+    points = os.path.join(ROOT, "Tools", "host_test", "sensor_curve_points.csv")
+    res = subprocess.run([sys.executable, os.path.join(ROOT, "Tools", "fit_sensor_curve.py"), points],
+                         capture_output=True, text=True, check=True)
+    for line in res.stderr.splitlines():
+        print("  fit at the points: " + line)
+    table = os.path.join(args.build_dir, "sensor_curve_table.c")
+    os.makedirs(args.build_dir, exist_ok=True)
+    if not os.path.exists(table) or open(table).read() != res.stdout:
+        with open(table, "w") as f:
+            f.write(res.stdout)
+
+    scale = 4095.0 / fit.SENSOR_MAX_MM
+    _, _, knots, lut, spline = fit.curve(fit.monotone([(raw, mm * scale) for raw, mm in fit.read_points(points)]))
+    emulation = [lambda r: fit.linear_interp_q15(knots, r) / fit.LSB, spline, lambda r: lut[r] / fit.LSB]
+    core = [f for f in replay.CORE_SOURCES if f != "sensor_curve_table.c"]
+    ok = True
+    for mode, tolerance in ((0, 1e-5), (1, 1e-3), (2, 1e-5)):
+        exe = replay.build(args.build_dir, args.cc, main=test["main"], flags=["-DSENSOR_CURVE_MODE=%d" % mode],
+                           sources=[table], name="sensor_curve_%d" % mode, core=core)
+        dump = os.path.join(args.build_dir, "sensor_curve_%d.txt" % mode)
+        ok &= subprocess.run([exe, dump]).returncode == 0
+        worst = max(abs(float(v) - emulation[mode](r)) for r, v in enumerate(open(dump).read().split()))
+        print("  %-6s against the fit tool's emulation: max %.2g count" % (("LINEAR", "SPLINE", "LUT")[mode], worst))
+        ok &= worst <= tolerance
+    return ok
+
+
+def run_level_comp(test, args):
+    """Both probe kinds, with K1/K2 left at 0 and fitted to the probe (1/gain to second order)."""
+    a1, a2 = 0.004, 2e-5
+    ok = True
+    for probe in (1, 0):
+        for k1, k2 in ((0.0, 0.0), (-a1, a1 * a1 - a2)):
+            flags = ["-DLEVEL_COMP_ABSOLUTE_PROBE=%d" % probe, "-DLEVEL_COMP_K1=%r" % k1, "-DLEVEL_COMP_K2=%r" % k2,
+                     "-DPROBE_A1=%r" % a1, "-DPROBE_A2=%r" % a2]
+            exe = replay.build(args.build_dir, args.cc, main=test["main"], flags=flags, sources=["Core/Src/level_comp.c"],
+                               name="level_comp_%d_%s" % (probe, "fit" if k1 else "0"))
+            ok &= subprocess.run([exe]).returncode == 0
+    return ok
+
+
+def run_nn(test, args):
+    """Logits bit for bit against Tools/train_flood_risk.py's integer forward pass, on random and level inputs"""
+    import random
+    import train_flood_risk as tfr
+    layers = tfr.load_model(os.path.join(ROOT, "Core", "Src", "flood_risk_model.c"))
+    rng = random.Random(1)
+    inputs = [[rng.randint(-128, 127) for _ in range(tfr.LAYERS[0])] for _ in range(2000)]
+    inputs += [[tfr.quantize_input(v) for v in tfr.features(tfr.synth(rng)[1])] for _ in range(2000)]
+    os.makedirs(args.build_dir, exist_ok=True)
+    path = os.path.join(args.build_dir, "nn_inputs.txt")
+    dump = os.path.join(args.build_dir, "nn_outputs.txt")
+    with open(path, "w") as f:
+        f.writelines(" ".join(map(str, x)) + "\n" for x in inputs)
+    exe = replay.build(args.build_dir, args.cc, main=test["main"], name=test["name"])
+    if subprocess.run([exe, path, dump]).returncode != 0:
+        return False
+    out = [[int(v) for v in line.split()] for line in open(dump)]
+    differ = sum(row[:3] != tfr.run_int8_q(layers, x) for x, row in zip(inputs, out))
+    # softmax keeps the order of the logits (ties aside)
+    order = sum(tfr.argmax(row[3:]) != tfr.argmax(row[:3]) and len(set(row[:3])) == 3 for row in out)
+    print("  %d inputs (half level histories): %d logits differ from the trainer's int8 pass, "
+          "%d softmax outputs out of order" % (len(out), differ, order))
+    return len(out) == len(inputs) and differ == 0 and order == 0
+
+
+def fft_all_sizes(build_dir):
+    """dsp_config.h with every FFT length declared and the tables for it, in build_dir"""
+    import gen_fft_tables
+    out = os.path.join(build_dir, "fft_all")
+    os.makedirs(out, exist_ok=True)
+    config = os.path.join(out, "dsp_config.h")
+    text = re.sub(r"^(#define\s+DSP_[RC]FFT_F32_\d+\s+)0", r"\g<1>1",
+                  open(os.path.join(ROOT, "Core", "Inc", "dsp_config.h")).read(), flags=re.M)
+    tables = os.path.join(out, "dsp_tables.c")
+    buf = io.StringIO()
+    with open(config + ".new", "w") as f:
+        f.write(text)
+    with contextlib.redirect_stdout(buf):
+        gen_fft_tables.main(["--config", config + ".new"])
+    for path, content in ((config, text), (tables, buf.getvalue())):
+        if not os.path.exists(path) or open(path).read() != content:
+            with open(path, "w") as f:
+                f.write(content)
+    os.remove(config + ".new")
+    return config, tables
+
+
+def run_slosh(test, args):
+    """The slosh stage, and the analysis cost of every FFT length"""
+    config, tables = fft_all_sizes(args.build_dir)
+    core = [f for f in replay.CORE_SOURCES if f != "dsp_tables.c"]
+    exe = replay.build(args.build_dir, args.cc, main=test["main"], sources=[tables], core=core, config=config)
+    return subprocess.run([exe]).returncode == 0
+
+
+def run_fft(test, args):
+    """The firmware's dsp_tables.c as generated from its dsp_config.h, and every FFT length against the DFT"""
+    import gen_fft_tables
+    config = os.path.join(ROOT, "Core", "Inc", "dsp_config.h")
+    buf = io.StringIO()
+    with contextlib.redirect_stdout(buf):
+        gen_fft_tables.main(["--config", config])
+    ok = buf.getvalue() == open(os.path.join(ROOT, "Core", "Src", "dsp_tables.c")).read()
+    print("  Core/Src/dsp_tables.c %s Tools/gen_fft_tables.py's output for Core/Inc/dsp_config.h"
+          % ("matches" if ok else "DIFFERS from"))
+    print("  lengths selected in Core/Inc/dsp_config.h:")
+    exe = replay.build(args.build_dir, args.cc, main=test["main"], name="fft_selected")
+    ok &= subprocess.run([exe]).returncode == 0
+    print("  every length:")
+    config, tables = fft_all_sizes(args.build_dir)
+    core = [f for f in replay.CORE_SOURCES if f != "dsp_tables.c"]
+    exe = replay.build(args.build_dir, args.cc, main=test["main"], sources=[tables], core=core, config=config,
+                       name="fft_every")
+    return subprocess.run([exe]).returncode == 0 and ok
+
+
+def run_heap(test, args):
+    """Both kernel heaps: the random workload at the firmware's heap size, the hole sweep in a larger one."""
+    heap = FREERTOS + "/portable/MemMang/"
+    ok = True
+    for mode, size, argv in (("random", None, ["random"]), ("holes", 262144, ["holes", "16", "64", "256", "1024"])):
+        for name, flags in (("heap_tlsf", ["-DHEAP_TLSF"]), ("heap_4", [])):
+            if size:
+                flags = flags + ["-DHOST_HEAP_SIZE=%d" % size]
+            exe = replay.build(args.build_dir, args.cc, main=test["main"], flags=flags, sources=RTOS_SOURCES,
+                               includes=RTOS_INCLUDES + [heap], deps=[heap + name + ".c"],
+                               name="%s_%s" % (name, mode))
+            ok &= subprocess.run([exe] + argv).returncode == 0
+    return ok
+
+
+def run_trace(test, args):
+    """Two snapshot dumps from trace_recorder.c decoded by Tools/trace_decode.py: events, header, task table"""
+    import random
+    import trace_decode as td
+    os.makedirs(args.build_dir, exist_ok=True)
+    capture = os.path.join(args.build_dir, "trace_capture.bin")
+    expected = os.path.join(args.build_dir, "trace_expected.txt")
+    exe = replay.build(args.build_dir, args.cc, main=test["main"], flags=test["flags"], sources=test["sources"],
+                       includes=test["includes"], name=test["name"])
+    if subprocess.run([exe, capture, expected]).returncode != 0:
+        return False
+    tasks, events, lost = {}, [], {}
+    for line in open(expected):
+        f = line.split()
+        if f[0] == "task":
+            tasks[int(f[1])] = (f[3], int(f[2]))
+        elif f[0] == "event":
+            events.append(tuple(int(v) for v in f[2:]))
+        elif f[0] == "lost":
+            lost[int(f[1])] = int(f[2])
+    data = open(capture, "rb").read()
+    runs = td.parse(data)
+    ok = len(runs) == 2 and all(r.tasks == tasks and r.cpu_hz == 100000000 and r.tick_hz == 1000 and r.ring == 512
+                                for r in runs)
+    ok &= len(runs) == 2 and runs[0].events == events and runs[1].lost == lost[1]
+    print("  dump 1: %d of %d events decoded as written, %d reported lost in dump 2"
+          % (sum(a == b for a, b in zip(runs[0].events, events)) if runs else 0, len(events),
+             runs[1].lost if len(runs) > 1 else -1))
+
+    # Line noise ahead of the capture (no sync byte in it) and a frame cut short after it
+    rng = random.Random(1)
+    noise = bytes(rng.choice([b for b in range(256) if b != 0xA5]) for _ in range(1000))
+    noisy = td.parse(noise + data + data[:200])
+    same = [(r.tasks, r.events, r.lost) for r in noisy] == [(r.tasks, r.events, r.lost) for r in runs]
+    print("  with line noise ahead and a cut frame behind: %s" % ("same runs" if same else "DIFFERENT"))
+    ok &= same
+    if len(runs) != 2:
+        return False
+
+    # Dump 2, from the schedule in trace_recorder_test.c: control (3) runs 1-3, 10.5-12 and 20-22 ms
+    stats, slices, marks, end = td.analyse(runs[1])
+    ctl, idle = stats.get(3), stats.get(1)
+    blocked = {}
+
+    def near(a, b):
+        return abs(a - b) < 1e-9
+
+    ok &= ctl is not None and idle is not None and near(end, 22e-3)
+    if ok:
+        blocked = {k: (s.n, round(s.max * 1e3, 6)) for k, s in ctl["blocked"].items()}
+        ok &= (near(ctl["cpu"], 5.5e-3) and near(idle["cpu"], 16.5e-3) and near(ctl["run"].max, 2e-3)
+               and ctl["latency"].n == 3 and near(ctl["latency"].max, 0.5e-3)
+               and near(ctl["latency"].mean(), 0.5e-3 / 3)
+               and blocked == {"delay": (1, 7.0), "wait queue#5": (1, 8.0)}
+               and ctl["period"].n == 1 and near(ctl["period"].mean(), 10e-3)
+               and len(slices) == 7 and marks[0][1] == "trigger" and near(marks[0][0], 21e-3))
+    print("  dump 2 across the CYCCNT wrap: %.1f ms, control %.1f%% CPU, blocked %s"
+          % (end * 1e3, 100 * ctl["cpu"] / end if ctl else 0, sorted(blocked.items())))
+    return ok
+
+
+# arm_sort_f32 and the methods it dispatches to; the firmware does not link them
+MEDIAN_SORT_SOURCES = ["Drivers/CMSIS/DSP/Source/SupportFunctions/arm_%s.c" % f for f in
+                       ("sort_f32", "sort_init_f32", "bitonic_sort_f32", "bubble_sort_f32", "heap_sort_f32",
+                        "insertion_sort_f32", "merge_sort_f32", "merge_sort_init_f32", "quick_sort_f32",
+                        "selection_sort_f32")]
+
+# Kernel files on the host: Tools/host_test/rtos stands in for the port and the scheduler
+FREERTOS = "Middlewares/Third_Party/FreeRTOS/Source"
+RTOS_INCLUDES = ["Tools/host_test/rtos", FREERTOS + "/include"]
+RTOS_SOURCES = ["Tools/host_test/rtos/rtos_host.c"]
+
+TESTS = [
+    dict(name="replay", what="level traces: timelines and metrics against Tools/replay/expected", run=run_replay),
+    dict(name="controller_isolation", what="controllers stepped interleaved match each run alone",
+         main="Tools/host_test/controller_isolation.c"),
+    dict(name="barrier_fsm", what="barrier state machine: every event sequence against a reference, dispatch cost",
+         main="Tools/host_test/barrier_fsm_test.c"),
+    dict(name="indicator", what="status outputs: table against its rules, storm through the controller, register writes",
+         main="Tools/host_test/indicator_test.c", sources=["Core/Src/alarm_pattern.c"],
+         includes=["Tools/host_test/pattern"], flags=["-fno-pie", "-no-pie"]),
+    dict(name="alarm_pattern", what="alarm patterns: step table to 20 ms BSRR slots, slot rate, pin timing when played",
+         main="Tools/host_test/alarm_pattern_test.c", sources=["Core/Src/alarm_pattern.c"],
+         includes=["Tools/host_test/pattern"], flags=["-fno-pie", "-no-pie"]),
+    dict(name="lcd_init", what="LCD init: stepped, blocking and the pre-table sequence send the same, waits kept",
+         main="Tools/host_test/lcd_init_test.c", sources=["Core/Src/lcd_i2c.c"], includes=["Tools/host_test/lcd"]),
+    dict(name="fleet", what="fleet report independent of thread and batch counts", run=run_fleet),
+    dict(name="calib_store", what="calibration A/B slots over simulated flash: commands, recovery, erases",
+         main="Tools/host_test/calib_store_test.c", sources=["Core/Src/calib_store.c", "Core/Src/fmt.c"],
+         includes=["Tools/host_test/flash"] + RTOS_INCLUDES + [FREERTOS + "/CMSIS_RTOS_V2"], args=calib_py_record),
+    dict(name="clock_profile", what="clock profiles: prescaler math at 48 and 100 MHz, switches masked and retimed",
+         main="Tools/host_test/clock_profile_test.c", sources=["Core/Src/clock_profile.c"],
+         includes=["Tools/host_test/clock"] + RTOS_INCLUDES + [FREERTOS + "/CMSIS_RTOS_V2"]),
+    dict(name="sensor_curve", what="sensor curve methods on a fitted S-shaped sensor: error, time, emulation",
+         main="Tools/host_test/sensor_curve_bench.c", run=run_sensor_curve),
+    dict(name="level_comp", what="level counts under 24 h of VDDA and temperature drift, both probe kinds",
+         main="Tools/host_test/level_comp_drift.c", run=run_level_comp),
+    dict(name="ir_decode", what="IR edges to barrier action: NEC decoder, key map, hold tracking, learned remotes",
+         main="Tools/host_test/ir_decode.c",
+         args=lambda: calib_py_record([(0x1234, [0x10, 0x11, 0x12, 0x13, 0x14]), (0xBF40, [0x20, 0x21, 0x22, 0x23, 0x24])])),
+    dict(name="nn_runtime", what="int8 flood-risk network: bit-exact logits, arena plans, inference time",
+         main="Tools/host_test/nn_runtime_test.c", run=run_nn),
+    dict(name="fmt", what="fixed-width formatting against snprintf: edge values, every width, random sweep",
+         main="Tools/host_test/fmt_test.c", sources=["Core/Src/fmt.c"]),
+    dict(name="median", what="sliding median, q15 and f32, against re-sorting the window with arm_sort_f32",
+         main="Tools/host_test/median_bench.c", sources=MEDIAN_SORT_SOURCES),
+    dict(name="fft", what="FFT tables: every length dsp_config.h declares against a double-precision DFT",
+         main="Tools/host_test/fft_check.c", run=run_fft),
+    dict(name="slosh", what="slosh notch: attenuation across the band, level gain; FFT analysis cost per block size",
+         main="Tools/host_test/slosh_bench.c", run=run_slosh),
+    dict(name="stream_buffer", what="stream buffer reserve/commit and peek/consume: sequence, wakeups, cost per block",
+         main="Tools/host_test/stream_buffer_test.c", includes=RTOS_INCLUDES,
+         sources=RTOS_SOURCES + [FREERTOS + "/stream_buffer.c", FREERTOS + "/portable/MemMang/heap_tlsf.c"]),
+    dict(name="trace_recorder", what="trace recorder: snapshot dumps decoded by trace_decode.py, cost per event",
+         main="Tools/host_test/trace_recorder_test.c", flags=["-DconfigUSE_TRACE_RECORDER=1"],
+         sources=RTOS_SOURCES + ["Core/Src/trace_recorder.c"],
+         includes=["Tools/host_test/trace"] + RTOS_INCLUDES + [FREERTOS + "/CMSIS_RTOS_V2"], run=run_trace),
+    dict(name="heap", what="TLSF and heap_4 kernel heaps: structure under random load, latency, fragmented worst case",
+         main="Tools/host_test/heap_check.c", run=run_heap),
+    dict(name="mpool", what="osMemoryPool lock-free free list: threads, latency against a spinlock, interrupts",
+         main="Tools/host_test/mpool_stress.c", includes=RTOS_INCLUDES + [FREERTOS + "/CMSIS_RTOS_V2"],
+         flags=["-pthread"]),
+]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("tests", nargs="*", help="tests to run (default: all)")
+    ap.add_argument("--list", action="store_true", help="list the tests and exit")
+    ap.add_argument("--update", action="store_true", help="replay: rewrite the expected output")
+    ap.add_argument("--build-dir", default=os.path.join(tempfile.gettempdir(), "flood_barrier_host_test"))
+    ap.add_argument("--cc", default=os.environ.get("CC", "gcc"))
+    args = ap.parse_args()
+
+    if args.list:
+        for t in TESTS:
+            print("%-22s %s" % (t["name"], t["what"]))
+        return
+    names = {t["name"] for t in TESTS}
+    unknown = [n for n in args.tests if n not in names]
+    if unknown:
+        sys.exit("unknown test: " + ", ".join(unknown))
+
+    failed = []
+    for t in TESTS:
+        if args.tests and t["name"] not in args.tests:
+            continue
+        print("%s: %s" % (t["name"], t["what"]))
+        sys.stdout.flush()
+        if not t.get("run", run_driver)(t, args):
+            failed.append(t["name"])
+    if failed:
+        sys.exit("failed: " + ", ".join(failed))
+
+
+if __name__ == "__main__":
+    main()
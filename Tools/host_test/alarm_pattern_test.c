@@ -0,0 +1,196 @@
+// Alarm patterns: alarm_pattern.c unchanged on the host TIM1/DMA2/GPIOC
+// of Tools/host_test/pattern. pattern_expand() for every pattern, with
+// and without the green steady bit, against the step table: slot i covers
+// i * PATTERN_SLOT_MS .. +PATTERN_SLOT_MS and its BSRR word must set the
+// pins of the step in force then and reset the others, each step taking
+// its ms rounded to whole slots (at least one). Patterns longer than
+// PATTERN_MAX_SLOTS are refused. pattern_init() must pace TIM1 at one slot
+// per PATTERN_SLOT_MS, with APB2 divided or not. Then each pattern is
+// played and its stream run for two cycles: every pin's on and off times,
+// from the edges, must be the step table's.
+//
+// Built and run by Tools/host_test.py (alarm_pattern).
+#include "alarm_pattern.h"
+#include "stm32f4xx_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CHECK(c)        do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define PINS            (GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3)
+
+GPIO_TypeDef host_gpioc;
+TIM_TypeDef host_tim1;
+DMA_Stream_TypeDef host_dma2_stream5;
+RCC_TypeDef host_rcc;
+
+static int failures;
+static const uint32_t *stream;
+static uint32_t stream_len, stream_pos, pclk2;
+static TIM_HandleTypeDef tim_init;
+
+void Error_Handler(void) {
+    CHECK(0);
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void) { return pclk2; }
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma) { (void)hdma; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim) {
+    tim_init = *htim;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma) {
+    (void)hdma;
+    stream = NULL;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t src, uint32_t dst, uint32_t n) {
+    (void)hdma;
+    CHECK(dst == (uint32_t)(uintptr_t)&GPIOC->BSRR);
+    stream = (const uint32_t *)(uintptr_t)src;
+    stream_len = n;
+    return HAL_OK;
+}
+
+static void dma_slot(void) {
+    uint32_t w = stream[stream_pos];
+
+    GPIOC->ODR = (GPIOC->ODR | (w & 0xFFFFU)) & ~(w >> 16);
+    stream_pos = (stream_pos + 1) % stream_len;
+}
+
+static uint32_t pin(uint8_t output_bits) {
+    uint32_t p = 0;
+
+    if (output_bits & PATTERN_GREEN) p |= GPIO_PIN_0;
+    if (output_bits & PATTERN_YELLOW) p |= GPIO_PIN_1;
+    if (output_bits & PATTERN_RED) p |= GPIO_PIN_2;
+    if (output_bits & PATTERN_BUZZER) p |= GPIO_PIN_3;
+    return p;
+}
+
+/* Step ms in whole slots, as the stream plays it */
+static uint32_t step_ms(const pattern_step_t *s) {
+    uint32_t slots = (s->ms + PATTERN_SLOT_MS / 2) / PATTERN_SLOT_MS;
+
+    return (slots ? slots : 1) * PATTERN_SLOT_MS;
+}
+
+/* The outputs in force at t ms into the pattern, from the step table */
+static uint8_t outputs_at(const pattern_t *p, uint32_t t) {
+    for (uint8_t s = 0;; s = (s + 1) % p->nsteps) {
+        if (t < step_ms(&p->steps[s])) return p->steps[s].outputs;
+        t -= step_ms(&p->steps[s]);
+    }
+}
+
+/* How long the pin keeps the level it has at step boundary t (ms into the cycle), from the nominal ms */
+static uint32_t run_ms(const pattern_t *p, uint32_t pin_mask, uint32_t t) {
+    uint8_t s = 0, bit_mask = 0;
+    uint32_t ms = 0;
+
+    for (uint8_t b = 0; b < 4; b++) {
+        if (pin(1U << b) == pin_mask) bit_mask = (uint8_t)(1U << b);
+    }
+    while (t >= p->steps[s].ms) t -= p->steps[s++].ms;
+    CHECK(t == 0);
+    uint8_t level = p->steps[s].outputs & bit_mask;
+    for (uint8_t k = 0; k < p->nsteps && (p->steps[s].outputs & bit_mask) == level; k++) {
+        ms += p->steps[s].ms;
+        s = (s + 1) % p->nsteps;
+    }
+    return ms;
+}
+
+/* Slot words against the step table; returns the slot count */
+static uint32_t check_expand(const pattern_t *p, uint8_t steady) {
+    static uint32_t slots[PATTERN_MAX_SLOTS];
+    uint32_t n = pattern_expand(p, steady, slots, PATTERN_MAX_SLOTS), cycle = 0;
+
+    for (uint8_t s = 0; s < p->nsteps; s++) cycle += step_ms(&p->steps[s]);
+    CHECK(n * PATTERN_SLOT_MS == cycle);
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t on = pin(outputs_at(p, i * PATTERN_SLOT_MS) | steady);
+        CHECK(slots[i] == (on | (PINS & ~on) << 16));
+    }
+    return n;
+}
+
+int main(void) {
+    static pattern_step_t long_steps[PATTERN_MAX_SLOTS + 1];
+    static const char *const names[PATTERN_COUNT] = { "off", "warning", "flood", "manual" };
+
+    // The firmware's patterns: nominal ms are whole slots, so cycles are exact
+    for (uint32_t id = 0; id < PATTERN_COUNT; id++) {
+        uint32_t nominal = 0, n;
+        for (uint8_t s = 0; s < patterns[id].nsteps; s++) nominal += patterns[id].steps[s].ms;
+        n = check_expand(&patterns[id], 0);
+        CHECK(check_expand(&patterns[id], PATTERN_GREEN) == n);
+        CHECK(n * PATTERN_SLOT_MS == nominal);
+        printf("  %-8s %3u slots, %4u ms cycle\n", names[id], n, n * PATTERN_SLOT_MS);
+    }
+
+    // Rounding to slots: half a slot and up rounds up, never below one
+    static const pattern_step_t odd[] = { { 9, PATTERN_RED }, { 10, 0 }, { 29, PATTERN_BUZZER }, { 30, PATTERN_YELLOW },
+                                          { 0, PATTERN_RED | PATTERN_BUZZER } };
+    const pattern_t odd_p = { odd, sizeof(odd) / sizeof(odd[0]) };
+    CHECK(check_expand(&odd_p, PATTERN_GREEN) == 1 + 1 + 1 + 2 + 1);
+
+    // Longest cycle: PATTERN_MAX_SLOTS slots fit, one more is refused
+    uint32_t scratch[PATTERN_MAX_SLOTS];
+    for (uint32_t i = 0; i <= PATTERN_MAX_SLOTS; i++) long_steps[i] = (pattern_step_t){ PATTERN_SLOT_MS, (uint8_t)(i & 7U) };
+    const pattern_t fits = { long_steps, PATTERN_MAX_SLOTS }, over = { long_steps, PATTERN_MAX_SLOTS + 1 };
+    const pattern_step_t one_long = { PATTERN_MAX_SLOTS * PATTERN_SLOT_MS + PATTERN_SLOT_MS / 2, PATTERN_RED };
+    const pattern_t too_long = { &one_long, 1 };
+    CHECK(check_expand(&fits, 0) == PATTERN_MAX_SLOTS);
+    CHECK(pattern_expand(&over, 0, scratch, PATTERN_MAX_SLOTS) == 0);
+    CHECK(pattern_expand(&too_long, 0, scratch, PATTERN_MAX_SLOTS) == 0);
+    printf("  rounding to %u ms slots, %u slots fit, longer patterns refused\n", PATTERN_SLOT_MS, PATTERN_MAX_SLOTS);
+
+    // Slot rate: TIM1 runs at PCLK2, or twice it when APB2 is divided
+    for (int div2 = 0; div2 < 2; div2++) {
+        uint32_t tim_clk;
+        pclk2 = div2 ? SystemCoreClock / 2 : SystemCoreClock;
+        RCC->CFGR = div2 ? 0x8000U : RCC_CFGR_PPRE2_DIV1;      // PPRE2 = /2
+        tim_clk = div2 ? 2 * pclk2 : pclk2;
+        pattern_init();
+        CHECK((uint64_t)(tim_init.Init.Prescaler + 1) * (tim_init.Init.Period + 1) * 1000U ==
+              (uint64_t)tim_clk * PATTERN_SLOT_MS);
+        CHECK((TIM1->DIER & TIM_DMA_UPDATE) && (TIM1->CR1 & 1U));
+    }
+
+    // Played: every run of a pin between two edges lasts as the steps say
+    for (uint32_t id = 1; id < PATTERN_COUNT; id++) {
+        const pattern_t *p = &patterns[id];
+        uint32_t last_edge[4] = { 0 }, prev, runs = 0, n;
+
+        TIM1->EGR = 0;
+        GPIOC->ODR = PINS;
+        pattern_play((pattern_id_t)id, PATTERN_GREEN);
+        CHECK(TIM1->EGR == TIM_EGR_UG && pattern_current() == id);
+        n = stream_len;
+        stream_pos = 0;
+        prev = GPIOC->ODR & PINS;
+        for (uint32_t i = 0; i < 2 * n; i++) {
+            uint32_t t = i * PATTERN_SLOT_MS, now;
+
+            dma_slot();     // slot 0 is the one UG lands at once
+            now = GPIOC->ODR & PINS;
+            CHECK(now == pin(outputs_at(p, t) | PATTERN_GREEN));
+            for (uint32_t b = 0; b < 4; b++) {
+                if (i == 0 || ((now ^ prev) >> b & 1U) == 0) continue;
+                CHECK(t - last_edge[b] == run_ms(p, 1U << b, last_edge[b] % (n * PATTERN_SLOT_MS)));
+                last_edge[b] = t;
+                runs++;
+            }
+            prev = now;
+        }
+        CHECK(runs > 0 && (GPIOC->ODR & GPIO_PIN_0));
+        printf("  %-8s played for two cycles: %u on/off runs, each as long as its steps\n", names[id], runs);
+    }
+
+    printf("  %s\n", failures ? "FAILED" : "passed");
+    return failures != 0;
+}
@@ -0,0 +1,220 @@
+// Barrier state machine: barrier_fsm.c unchanged. Every event sequence up
+// to DEPTH events long from power-up is dispatched, and after each event
+// the machine must equal a reference written as plain if/else from the
+// rules in barrier_fsm.h, and hold the invariants: a leaf state, the servo
+// command agreeing with it, e-stop left only by IR "auto", FLOOD left on a
+// level event only once the level is low. Then the dispatch cost per event,
+// for a random mix and for the level event every water slot sends.
+//
+// Built and run by Tools/host_test.py (barrier_fsm).
+#include "barrier_fsm.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK(c)        do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define DEPTH           7
+#define BENCH_EVENTS    (1 << 16)
+#define BENCH_MS        200
+
+static int failures;
+static uint64_t transitions, mismatches, broken;
+static uint32_t reached[BARRIER_STATES];
+static uint32_t rng = 2463534242U;
+
+static uint32_t xorshift(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void ref_enter(barrier_fsm_t *f, uint8_t state) {
+    if (f->state == BARRIER_ESTOP && state != BARRIER_ESTOP) f->servo = f->barrier_up ? SERVO_UP : SERVO_DOWN;
+    if (state != f->state) {
+        if (state == BARRIER_NORMAL || state == BARRIER_WARNING) {
+            f->servo = SERVO_DOWN;
+            f->barrier_up = 0;
+        } else if (state == BARRIER_FLOOD) {
+            f->servo = SERVO_UP;
+            f->barrier_up = 1;
+        } else if (state == BARRIER_ESTOP) {
+            f->servo = SERVO_OFF;
+        }
+    }
+    f->state = state;
+}
+
+static void ref_raise(barrier_fsm_t *f) {
+    f->servo = SERVO_UP;
+    f->barrier_up = 1;
+}
+
+/* AUTO leaf for the last level: between the thresholds the barrier stays put */
+static uint8_t ref_auto(const barrier_fsm_t *f) {
+    if (f->level == BEV_LEVEL_LOW) return BARRIER_NORMAL;
+    if (f->level == BEV_LEVEL_MID && !f->barrier_up) return BARRIER_WARNING;
+    return BARRIER_FLOOD;
+}
+
+/* The rules of barrier_fsm.h, without the table */
+static void ref_dispatch(barrier_fsm_t *f, uint8_t ev) {
+    uint8_t in_auto = f->state == BARRIER_NORMAL || f->state == BARRIER_WARNING || f->state == BARRIER_FLOOD;
+
+    if (ev <= BEV_SENSOR_FAULT) f->level = ev;
+    if (f->state == BARRIER_ESTOP) {
+        if (ev == BEV_IR_AUTO) ref_enter(f, ref_auto(f));
+        return;
+    }
+    if (ev == BEV_IR_ESTOP) {
+        ref_enter(f, BARRIER_ESTOP);
+        return;
+    }
+    if (in_auto) {
+        switch (ev) {
+        case BEV_LEVEL_LOW:
+            ref_enter(f, BARRIER_NORMAL);
+            break;
+        case BEV_LEVEL_MID:
+            ref_enter(f, f->state == BARRIER_FLOOD ? BARRIER_FLOOD : BARRIER_WARNING);     // hysteresis
+            break;
+        case BEV_LEVEL_HIGH:
+        case BEV_SENSOR_FAULT:
+            ref_enter(f, BARRIER_FLOOD);
+            break;
+        case BEV_IR_TOGGLE:
+        case BEV_IR_DOWN:
+            if (f->state == BARRIER_FLOOD) {
+                ref_enter(f, BARRIER_WARNING);      // lowered by hand, still AUTO
+            } else if (ev == BEV_IR_TOGGLE) {
+                ref_raise(f);
+                ref_enter(f, BARRIER_MANUAL);
+            }
+            break;
+        case BEV_IR_UP:
+            ref_raise(f);
+            ref_enter(f, BARRIER_MANUAL);
+            break;
+        default:
+            break;
+        }
+        return;
+    }
+    // MANUAL: level events only update the level
+    switch (ev) {
+    case BEV_IR_TOGGLE:
+    case BEV_IR_DOWN:
+        ref_enter(f, BARRIER_WARNING);
+        break;
+    case BEV_IR_UP:
+        ref_raise(f);
+        break;
+    case BEV_IR_STOP:
+        f->servo = SERVO_OFF;
+        break;
+    case BEV_IR_AUTO:
+        ref_enter(f, ref_auto(f));
+        break;
+    default:
+        break;
+    }
+}
+
+static int invariants(const barrier_fsm_t *before, uint8_t ev, const barrier_fsm_t *f) {
+    int ok = f->state < BARRIER_AUTO && f->level <= BEV_SENSOR_FAULT;
+
+    switch (f->state) {
+    case BARRIER_NORMAL:
+    case BARRIER_WARNING:
+        ok &= f->servo == SERVO_DOWN && !f->barrier_up;
+        break;
+    case BARRIER_FLOOD:
+        ok &= f->servo == SERVO_UP && f->barrier_up;
+        break;
+    case BARRIER_MANUAL:
+        ok &= f->servo == SERVO_OFF || f->servo == (f->barrier_up ? SERVO_UP : SERVO_DOWN);
+        break;
+    default:
+        ok &= f->servo == SERVO_OFF;
+        break;
+    }
+    if (before->state == BARRIER_ESTOP && f->state != BARRIER_ESTOP) ok &= ev == BEV_IR_AUTO;
+    if (ev == BEV_IR_ESTOP) ok &= f->state == BARRIER_ESTOP;
+    if (before->state == BARRIER_FLOOD && ev <= BEV_SENSOR_FAULT) ok &= (f->state == BARRIER_FLOOD) == (ev != BEV_LEVEL_LOW);
+    ok &= barrier_fsm_manual(f) == (f->state == BARRIER_MANUAL || f->state == BARRIER_ESTOP);
+    ok &= barrier_fsm_raised(f) == (f->state != BARRIER_ESTOP && f->barrier_up);
+    return ok;
+}
+
+static void walk(const barrier_fsm_t *f, const barrier_fsm_t *ref, int depth) {
+    for (uint8_t ev = 0; ev < BARRIER_EVENTS; ev++) {
+        barrier_fsm_t next = *f, next_ref = *ref;
+
+        barrier_fsm_dispatch(&next, ev);
+        ref_dispatch(&next_ref, ev);
+        transitions++;
+        reached[next.state]++;
+        if (memcmp(&next, &next_ref, sizeof(next)) != 0) {
+            if (mismatches++ == 0) {
+                printf("  first mismatch: event %u from %s: %s servo %u, reference %s servo %u\n", ev,
+                       barrier_state_text[f->state], barrier_state_text[next.state], next.servo,
+                       barrier_state_text[next_ref.state], next_ref.servo);
+            }
+            continue;
+        }
+        if (!invariants(f, ev, &next)) broken++;
+        if (depth > 1) walk(&next, &next_ref, depth - 1);
+    }
+}
+
+static double elapsed_ns(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) * 1e9 + (b->tv_nsec - a->tv_nsec);
+}
+
+/* ns per event over events[], repeated for at least BENCH_MS */
+static double bench(const uint8_t *events) {
+    static barrier_fsm_t f;
+    struct timespec a, b;
+    uint64_t n = 0;
+    volatile uint8_t sink;
+
+    barrier_fsm_init(&f);
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    do {
+        for (uint32_t i = 0; i < BENCH_EVENTS; i++) barrier_fsm_dispatch(&f, events[i]);
+        n += BENCH_EVENTS;
+        clock_gettime(CLOCK_MONOTONIC, &b);
+    } while (elapsed_ns(&a, &b) < BENCH_MS * 1e6);
+    sink = f.servo;
+    (void)sink;
+    return elapsed_ns(&a, &b) / n;
+}
+
+int main(void) {
+    static uint8_t events[BENCH_EVENTS];
+    barrier_fsm_t f;
+
+    barrier_fsm_init(&f);
+    CHECK(f.state == BARRIER_NORMAL && f.servo == SERVO_DOWN && !f.barrier_up);
+    walk(&f, &f, DEPTH);
+    CHECK(mismatches == 0 && broken == 0);
+    for (uint8_t s = 0; s < BARRIER_AUTO; s++) CHECK(reached[s] != 0);
+    CHECK(reached[BARRIER_AUTO] == 0);
+    printf("  every sequence of up to %d events: %llu transitions, %llu differ from the reference, %llu break an invariant\n",
+           DEPTH, (unsigned long long)transitions, (unsigned long long)mismatches, (unsigned long long)broken);
+
+    // Unknown events are ignored
+    barrier_fsm_t g = f;
+    barrier_fsm_dispatch(&g, BARRIER_EVENTS);
+    barrier_fsm_dispatch(&g, 0xFF);
+    CHECK(memcmp(&f, &g, sizeof(f)) == 0);
+
+    // Dispatch cost
+    for (uint32_t i = 0; i < BENCH_EVENTS; i++) events[i] = (uint8_t)(xorshift() % BARRIER_EVENTS);
+    printf("  dispatch, random events: %.1f ns per event\n", bench(events));
+    for (uint32_t i = 0; i < BENCH_EVENTS; i++) events[i] = (uint8_t)(xorshift() % (BEV_LEVEL_HIGH + 1));
+    printf("  dispatch, level events only (one per water slot): %.1f ns per event\n", bench(events));
+
+    printf("  %s\n", failures ? "FAILED" : "passed");
+    return failures != 0;
+}
@@ -0,0 +1,330 @@
+// Calibration store over simulated flash: calib_store.c unchanged, its HAL
+// flash calls backed by a RAM image of sectors 6 and 7 mapped at their
+// real address (programming only clears bits, an erase sets a sector to
+// 0xFF). The work queue, uart_tx and the memory pool are stand-ins: a
+// posted item runs when the test says so, a reply is kept for checking,
+// line buffers come off freertos_mpool.h's free list as osMemoryPool's do.
+// Covers the USART2 commands, lines arriving while one is answered, torn
+// and corrupted records, the A/B switch and when the stale slot is erased:
+// never at boot, only after a quiet slot once due, a write that finds its
+// slot full refused until then. The K reply must read the IR frame and its
+// count together, before a frame pending in the EXTI ISR lands.
+//
+//     calib_store_test [W line]    a record packed by Tools/calib.py, stored first
+//
+// Built and run by Tools/host_test.py (calib_store).
+#include "calib_store.h"
+#include "cmsis_os.h"
+#include "freertos_mpool.h"
+#include "ir_nec.h"
+#include "stm32f4xx_hal.h"
+#include "uart_tx.h"
+#include "work_queue.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define FLASH_BYTES     (CALIB_SLOTS * CALIB_SLOT_BYTES)
+#define CHECK(c)        do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+
+ir_nec_rx_t ir_rx;
+static uint8_t *flash;
+static int unlocked, failures;
+static int program_fail_after = -1, programs, erase_fail;
+static char tx[CALIB_LINE_MAX + 8];
+static work_item_t queue[WORK_QUEUE_LEN];
+static uint32_t queued;
+static MemPool_t pool;
+static uint32_t primask, ir_pending;       // a frame word the EXTI ISR holds while masked
+
+uint32_t host_get_primask(void) { return primask; }
+void host_disable_irq(void) { primask = 1; }
+
+/* Unmasking runs the pending EXTI ISR: a new frame and its count */
+void host_set_primask(uint32_t p) {
+    primask = p;
+    if (primask == 0 && ir_pending) {
+        ir_rx.last = ir_pending;
+        ir_rx.frames++;
+        ir_pending = 0;
+    }
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) { unlocked = 1; return HAL_OK; }
+HAL_StatusTypeDef HAL_FLASH_Lock(void) { unlocked = 0; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t type, uint32_t addr, uint64_t data) {
+    uint32_t *w = (uint32_t *)(uintptr_t)addr;
+
+    CHECK(unlocked && type == FLASH_TYPEPROGRAM_WORD && addr % 4 == 0);
+    CHECK(addr >= CALIB_FLASH_BASE && addr < CALIB_FLASH_BASE + FLASH_BYTES);
+    if (program_fail_after >= 0 && programs++ >= program_fail_after) {
+        *w &= (uint32_t)data | 0xFFFF0000U;     // reset mid-word: half the bits made it
+        return HAL_ERROR;
+    }
+    *w &= (uint32_t)data;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *erase, uint32_t *bad_sector) {
+    CHECK(unlocked && erase->NbSectors == 1);
+    CHECK(erase->Sector == CALIB_SECTOR_FIRST || erase->Sector == CALIB_SECTOR_FIRST + 1);
+    if (erase_fail) {
+        *bad_sector = erase->Sector;
+        return HAL_ERROR;
+    }
+    memset(flash + (erase->Sector - CALIB_SECTOR_FIRST) * CALIB_SLOT_BYTES, 0xFF, CALIB_SLOT_BYTES);
+    *bad_sector = 0xFFFFFFFFU;
+    return HAL_OK;
+}
+
+int uart_tx_write(const void *data, uint32_t len, uint32_t timeout_ms) {
+    (void)timeout_ms;
+    memcpy(tx, data, len);
+    tx[len] = '\0';
+    return 0;
+}
+
+int work_post(work_fn_t fn, uint32_t arg) {
+    if (queued == WORK_QUEUE_LEN) return -1;
+    queue[queued].fn = fn;
+    queue[queued++].arg = arg;
+    return 0;
+}
+
+/* No waiting: the store only allocates from the RX ISR */
+osMemoryPoolId_t osMemoryPoolNew(uint32_t block_count, uint32_t block_size, const osMemoryPoolAttr_t *attr) {
+    CHECK(attr != NULL && attr->mp_size >= MEMPOOL_ARR_SIZE(block_count, block_size));
+    pool.mem_arr = attr->mp_mem;
+    pool.mem_sz = MEMPOOL_ARR_SIZE(block_count, block_size);
+    pool.bl_sz = block_size;
+    pool.bl_cnt = block_count;
+    pool.bl_step = MEMPOOL_BL_STEP(block_size);
+    MemPoolInitList(&pool);
+    return &pool;
+}
+
+void *osMemoryPoolAlloc(osMemoryPoolId_t mp_id, uint32_t timeout) {
+    void *block;
+
+    CHECK(mp_id == &pool && timeout == 0);
+    block = MemPoolPop(&pool);
+    if (block != NULL) MemPoolAtomicAdd(&pool.used, 1);
+    return block;
+}
+
+osStatus_t osMemoryPoolFree(osMemoryPoolId_t mp_id, void *block) {
+    CHECK(mp_id == &pool && pool.used > 0 && ((uint8_t *)block - pool.mem_arr) % pool.bl_step == 0);
+    MemPoolAtomicAdd(&pool.used, (uint32_t)-1);
+    MemPoolPush(&pool, block);
+    return osOK;
+}
+
+static void busy_item(uint32_t arg) {
+    (void)arg;
+}
+
+/* Records programmed in a slot, torn ones included */
+static uint32_t slot_records(uint8_t slot) {
+    const uint32_t *w = (const uint32_t *)(flash + slot * CALIB_SLOT_BYTES);
+    uint32_t n = 0;
+
+    while (n < CALIB_SLOT_RECORDS && w[n * sizeof(calib_record_t) / 4] != 0xFFFFFFFFU) n++;
+    return n;
+}
+
+/* Runs the oldest posted item; 0 when there was none */
+static int run_work(void) {
+    work_item_t item;
+
+    if (queued == 0) return 0;
+    item = queue[0];
+    memmove(queue, queue + 1, --queued * sizeof(queue[0]));
+    item.fn(item.arg);
+    return 1;
+}
+
+static void feed(const char *line) {
+    for (const char *c = line; *c; c++) calib_store_rx((uint8_t)*c);
+    calib_store_rx('\r');
+    calib_store_rx('\n');
+}
+
+/* One command line through the RX path and the work thread; the reply */
+static const char *command(const char *line) {
+    tx[0] = '\0';
+    feed(line);
+    while (run_work()) {}
+    return tx;
+}
+
+static const char *write_line(const calib_record_t *r, char *line) {
+    const uint8_t *p = (const uint8_t *)r;
+    char *o = line + sprintf(line, "W ");
+
+    for (uint32_t i = 0; i < sizeof(*r); i++) o += sprintf(o, "%02x", p[i]);
+    return line;
+}
+
+static uint32_t seq(void) {
+    return calib_store_active()->seq;
+}
+
+int main(int argc, char **argv) {
+    char line[2 * sizeof(calib_record_t) + 8];
+    calib_record_t r;
+    uint32_t n, erases;
+
+    flash = mmap((void *)(uintptr_t)CALIB_FLASH_BASE, FLASH_BYTES, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (flash != (void *)(uintptr_t)CALIB_FLASH_BASE) {
+        printf("  cannot map the flash image at 0x%08x\n", CALIB_FLASH_BASE);
+        return 1;
+    }
+    memset(flash, 0xFF, FLASH_BYTES);
+
+    // Blank flash: factory values
+    CHECK(calib_store_init() == 1 && seq() == 0 && calib_store_active()->warning_mm == WARNING_RAIN_MM);
+    CHECK(calib_store_start() == 0 && pool.bl_cnt == CALIB_LINES);
+    CHECK(strncmp(command("R"), "C ", 2) == 0 && strlen(tx) == 2 + 128 + 2);
+
+    // A record as Tools/calib.py packs it, or one built here
+    if (argc > 1) {
+        CHECK(strcmp(command(argv[1]), "OK 1\r\n") == 0);
+        printf("  calib.py record: %s", tx);
+    } else {
+        calib_defaults(&r);
+        r.warning_mm = 30.0f;
+        calib_seal(&r);
+        CHECK(strcmp(command(write_line(&r, line)), "OK 1\r\n") == 0);
+    }
+    CHECK(seq() == 1 && calib_store_active()->warning_mm == 30.0f);
+
+    // Refused: wire CRC, ranges, NaN, bad hex, unknown command; a line too long is dropped unanswered
+    r = *calib_store_record();
+    r.crc ^= 1;
+    CHECK(strcmp(command(write_line(&r, line)), "ERR crc\r\n") == 0);
+    r = *calib_store_record();
+    r.normal_mm = 31.0f;
+    calib_seal(&r);
+    CHECK(strcmp(command(write_line(&r, line)), "ERR range\r\n") == 0);
+    r.normal_mm = 0.0f / 0.0f;
+    calib_seal(&r);
+    CHECK(strcmp(command(write_line(&r, line)), "ERR range\r\n") == 0);
+    CHECK(strcmp(command("W 12zz"), "ERR format\r\n") == 0);
+    CHECK(strcmp(command("X"), "ERR format\r\n") == 0);
+    char longer[CALIB_LINE_MAX + 16];
+    memset(longer, 'A', sizeof(longer) - 1);
+    longer[sizeof(longer) - 1] = '\0';
+    CHECK(command(longer)[0] == '\0' && seq() == 1);
+
+    // A line arrives while the one before waits: answered in order. With
+    // both buffers queued the next is lost; so is one the queue cannot take.
+    uint32_t dropped = calib_store_stats.lines_dropped;
+    feed("K");
+    feed("R");
+    feed("K");
+    CHECK(queued == 2 && calib_store_stats.lines_dropped == dropped + 1);
+    CHECK(run_work() && strncmp(tx, "K ", 2) == 0);
+    CHECK(run_work() && strncmp(tx, "C ", 2) == 0 && pool.used == 0);
+    while (work_post(busy_item, 0) == 0) {}
+    feed("R");
+    CHECK(calib_store_stats.lines_dropped == dropped + 2 && pool.used == 1);   // kept for the next line
+    queued = 0;
+    CHECK(strncmp(command("R"), "C ", 2) == 0 && pool.used == 0);
+
+    // K: frame and count as one pair, the frame that arrives meanwhile left for the next K
+    ir_rx.last = ir_nec_word(0xEF10, 0x01);
+    ir_rx.frames = 5;
+    ir_pending = ir_nec_word(0xEF10, 0x02);
+    CHECK(strcmp(command("K"), "K 10EF01FE05000000\r\n") == 0);
+    CHECK(ir_pending == 0 && ir_rx.frames == 6 && primask == 0);
+    CHECK(strcmp(command("K"), "K 10EF02FD06000000\r\n") == 0);
+
+    // Factory, then another update; both take effect by a pointer swap
+    const calib_t *before = calib_store_active();
+    CHECK(strcmp(command("F"), "OK 2\r\n") == 0 && calib_store_active() != before);
+    CHECK(calib_store_active()->warning_mm == calib_factory.warning_mm);
+    r = *calib_store_record();
+    r.sensor_max_mm = 50.0f;
+    calib_seal(&r);
+    CHECK(strcmp(command(write_line(&r, line)), "OK 3\r\n") == 0);
+    CHECK(calib_store_active()->mm_per_count == 50.0f / 4095);
+
+    // Reboot keeps the newest; a corrupted newest falls back to the one before
+    CHECK(calib_store_init() == 0 && seq() == 3);
+    flash[2 * sizeof(calib_record_t) + 20] ^= 0x10;
+    calib_store_stats.skipped = 0;
+    CHECK(calib_store_init() == 0 && seq() == 2 && calib_store_stats.skipped == 1);
+
+    // Torn write: refused, the block in force stays, and after a reboot too
+    program_fail_after = 5;
+    programs = 0;
+    CHECK(strcmp(command("F"), "ERR flash\r\n") == 0 && seq() == 2);
+    program_fail_after = -1;
+    calib_store_stats.skipped = 0;
+    CHECK(calib_store_init() == 0 && seq() == 2 && calib_store_stats.skipped == 2);
+    CHECK(strcmp(command("F"), "OK 3\r\n") == 0);
+    printf("  commands, torn and corrupted records: seq %u in force\n", seq());
+
+    // Fill slot A and switch to B: B is blank, nothing to erase
+    erases = calib_store_stats.erases;
+    r = *calib_store_record();
+    while (slot_records(0) < CALIB_SLOT_RECORDS) CHECK(calib_store_write(&r) == CALIB_OK);
+    CHECK(calib_store_write(&r) == CALIB_OK && slot_records(1) == 1 && calib_store_stats.erases == erases);
+
+    // B past half full with A still holding records: due, but boot never erases
+    while (slot_records(1) <= CALIB_SLOT_RECORDS / 2) CHECK(calib_store_write(&r) == CALIB_OK);
+    CHECK(calib_store_init() == 0 && calib_store_stats.erases == erases);
+    // A quiet slot posts the erase; with the queue full it waits for the next quiet slot
+    while (work_post(busy_item, 0) == 0) {}
+    calib_store_quiet();
+    queued = 0;
+    calib_store_quiet();
+    calib_store_quiet();
+    CHECK(queued == 1 && queue[0].fn != busy_item);     // posted once
+    run_work();
+    CHECK(calib_store_stats.erases == erases + 1 && slot_records(0) == 0);
+    calib_store_quiet();
+    CHECK(queued == 0);
+    printf("  slot B half full: stale slot A erased after a quiet slot, not at boot\n");
+
+    // Fill B, go on in the erased A and fill it with no quiet slot: the
+    // write that finds A full is refused, nothing erased outside a quiet slot
+    n = 0;
+    while (calib_store_write(&r) == CALIB_OK && n < 3 * CALIB_SLOT_RECORDS) n++;
+    CHECK(slot_records(0) == CALIB_SLOT_RECORDS && slot_records(1) == CALIB_SLOT_RECORDS);
+    CHECK(calib_store_stats.erases == erases + 1 && strcmp(command("F"), "ERR full\r\n") == 0);
+    calib_store_quiet();
+    CHECK(queued == 1 && run_work() && calib_store_stats.erases == erases + 2 && slot_records(1) == 0);
+    CHECK(strncmp(command("F"), "OK ", 3) == 0 && slot_records(1) == 1);
+    printf("  %u writes later slot A full: ERR full until a quiet slot erased B\n", n);
+    CHECK(calib_store_init() == 0 && seq() == calib_store_record()->seq);
+
+    // That erase fails: still full, and due again at the next quiet slot
+    while (slot_records(1) < CALIB_SLOT_RECORDS) CHECK(calib_store_write(&r) == CALIB_OK);
+    CHECK(strcmp(command("F"), "ERR full\r\n") == 0);
+    erase_fail = 1;
+    calib_store_quiet();
+    CHECK(queued == 1 && run_work() && calib_store_stats.erases == erases + 2);
+    erase_fail = 0;
+    CHECK(strcmp(command("F"), "ERR full\r\n") == 0);
+    calib_store_quiet();
+    CHECK(queued == 1 && run_work() && calib_store_stats.erases == erases + 3);
+    CHECK(strncmp(command("F"), "OK ", 3) == 0 && slot_records(0) == 1);
+
+    // A corrupted record alone in its slot falls back to the other slot's newest
+    uint32_t newest = seq();
+    CHECK(calib_store_init() == 0 && seq() == newest);
+    flash[8] ^= 0x01;
+    CHECK(calib_store_init() == 0 && seq() == newest - 1);
+
+    // Nothing valid anywhere: factory values, and still no erase at boot
+    erases = calib_store_stats.erases;
+    memset(flash, 0x00, FLASH_BYTES);
+    CHECK(calib_store_init() == 1 && calib_store_stats.erases == erases);
+
+    printf("  %s: %u writes, %u erases, %u errors\n", failures ? "FAILED" : "passed",
+           calib_store_stats.writes, calib_store_stats.erases, calib_store_stats.errors);
+    return failures != 0;
+}
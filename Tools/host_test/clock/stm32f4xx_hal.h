@@ -0,0 +1,132 @@
+#ifndef __HOST_CLOCK_HAL_H__
+#define __HOST_CLOCK_HAL_H__
+
+// Host stand-in for the RCC, timer and bus registers clock_profile.c
+// touches, ahead of the replay one (which it includes for DWT). Registers
+// are plain words; clock_profile_test.c implements the RCC calls over a
+// simulated clock tree and PRIMASK, and checks what the interrupts would
+// see each time they are unmasked.
+#include_next "stm32f4xx_hal.h"
+
+#define HSI_VALUE                   16000000U
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+
+typedef struct {
+    volatile uint32_t CR1, CR2, DIER, SR, EGR, CNT, PSC, ARR, CCR1, CCR2;
+} TIM_TypeDef;
+
+typedef struct {
+    volatile uint32_t BRR;
+} USART_TypeDef;
+
+typedef struct {
+    volatile uint32_t CR1, CR2, CCR, TRISE;
+} I2C_TypeDef;
+
+typedef struct {
+    volatile uint32_t LOAD, VAL;
+} SysTick_Type;
+
+typedef struct {
+    volatile uint32_t CSR;
+} PWR_TypeDef;
+
+typedef struct {
+    TIM_TypeDef *Instance;
+    struct {
+        uint32_t Prescaler;
+    } Init;
+} TIM_HandleTypeDef;
+
+typedef struct {
+    uint32_t PLLState, PLLSource, PLLM, PLLN, PLLP, PLLQ;
+} RCC_PLLInitTypeDef;
+
+typedef struct {
+    uint32_t OscillatorType;
+    uint32_t HSIState;
+    uint32_t HSICalibrationValue;
+    RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct {
+    uint32_t ClockType;
+    uint32_t SYSCLKSource;
+    uint32_t AHBCLKDivider;
+    uint32_t APB1CLKDivider;
+    uint32_t APB2CLKDivider;
+} RCC_ClkInitTypeDef;
+
+extern TIM_TypeDef host_tim1, host_tim3, host_tim4, host_tim9;
+extern USART_TypeDef host_usart2;
+extern I2C_TypeDef host_i2c1;
+extern SysTick_Type host_systick;
+extern PWR_TypeDef host_pwr;
+extern uint32_t host_sysclk_source, host_flash_latency;
+extern volatile uint32_t uwTick;
+
+#define TIM1                        (&host_tim1)
+#define TIM3                        (&host_tim3)
+#define TIM4                        (&host_tim4)
+#define TIM9                        (&host_tim9)
+#define USART2                      (&host_usart2)
+#define I2C1                        (&host_i2c1)
+#define SysTick                     (&host_systick)
+#define PWR                         (&host_pwr)
+
+#define TIM_EGR_UG                  0x1U
+#define TIM_IT_UPDATE               0x1U
+#define TIM_FLAG_UPDATE             0x1U
+#define I2C_CR1_PE                  0x1U
+#define I2C_CR2_FREQ                0x3FU
+#define PWR_CSR_VOSRDY              0x4000U
+
+#define __HAL_TIM_GET_IT_SOURCE(h, it)  (((h)->Instance->DIER & (it)) == (it))
+#define __HAL_TIM_GET_FLAG(h, f)        (((h)->Instance->SR & (f)) == (f))
+#define __HAL_TIM_CLEAR_FLAG(h, f)      ((h)->Instance->SR = ~(uint32_t)(f))
+
+#define RCC_CLOCKTYPE_SYSCLK        0x1U
+#define RCC_CLOCKTYPE_HCLK          0x2U
+#define RCC_CLOCKTYPE_PCLK1         0x4U
+#define RCC_CLOCKTYPE_PCLK2         0x8U
+#define RCC_SYSCLKSOURCE_HSI        0U
+#define RCC_SYSCLKSOURCE_PLLCLK     2U
+#define RCC_SYSCLKSOURCE_STATUS_PLLCLK  8U      // SWS: SW << 2
+#define RCC_SYSCLK_DIV1             0U
+#define RCC_HCLK_DIV1               1U          // the divider itself, unlike the PPRE encoding
+#define RCC_HCLK_DIV2               2U
+#define RCC_HCLK_DIV4               4U
+#define RCC_HCLK_DIV8               8U
+#define RCC_HCLK_DIV16              16U
+#define RCC_OSCILLATORTYPE_NONE     0U
+#define RCC_OSCILLATORTYPE_HSI      2U
+#define RCC_HSI_ON                  1U
+#define RCC_HSICALIBRATION_DEFAULT  16U
+#define RCC_PLL_OFF                 1U
+#define RCC_PLL_ON                  2U
+#define RCC_PLLSOURCE_HSI           0U
+#define PWR_REGULATOR_VOLTAGE_SCALE1    3U
+#define PWR_REGULATOR_VOLTAGE_SCALE3    1U
+
+#define __HAL_RCC_GET_SYSCLK_SOURCE()   (host_sysclk_source << 2)
+#define __HAL_FLASH_GET_LATENCY()       (host_flash_latency)
+#define __HAL_RCC_PWR_CLK_ENABLE()      ((void)0)
+#define __HAL_PWR_VOLTAGESCALING_CONFIG(v)  host_set_vos(v)
+
+void host_set_vos(uint32_t scale);
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *osc);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *clk, uint32_t latency);
+void HAL_IncTick(void);
+uint32_t HAL_GetTick(void);
+
+// cmsis_gcc.h has these as Cortex-M asm: taken first, then renamed
+#include "cmsis_compiler.h"
+#define __get_PRIMASK               host_get_primask
+#define __set_PRIMASK               host_set_primask
+#define __disable_irq               host_disable_irq
+uint32_t host_get_primask(void);
+void host_set_primask(uint32_t primask);
+void host_disable_irq(void);
+
+#endif // __HOST_CLOCK_HAL_H__
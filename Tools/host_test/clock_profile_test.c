@@ -0,0 +1,253 @@
+// Clock profiles: clock_profile.c unchanged over a simulated clock tree
+// (Tools/host_test/clock). First the prescaler math of the 48 MHz and
+// 100 MHz profiles, against register values worked out by hand and against
+// the rates they give; profiles breaking a limit are refused. Then switches
+// between them: every RCC change must happen with interrupts masked, and
+// each time they are unmasked the timers, USART2, I2C and SysTick must be
+// timed for the clock actually running. A PLL that never locks must time
+// out with interrupts masked (HAL_GetTick() counting by hand) and leave the
+// previous profile in force.
+//
+// Built and run by Tools/host_test.py (clock_profile).
+#include "clock_profile.h"
+#include "cmsis_os.h"
+#include "main.h"
+#include "uart_tx.h"
+#include "work_queue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(c)        do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define SERVO_ARR       19999       // 20 ms period at 1 MHz
+#define SWITCHES        20
+
+TIM_TypeDef host_tim1, host_tim3, host_tim4, host_tim9;
+USART_TypeDef host_usart2;
+I2C_TypeDef host_i2c1;
+SysTick_Type host_systick;
+PWR_TypeDef host_pwr;
+uint32_t host_sysclk_source, host_flash_latency;
+volatile uint32_t uwTick;
+TIM_HandleTypeDef htim1 = { TIM1 }, htim3 = { TIM3 }, htim4 = { TIM4 }, htim9 = { TIM9 };
+
+static int failures;
+static uint32_t primask, rcc_unmasked, unmasks, stale, pll_fail;
+static uint32_t pll_on, pllm = 1, plln = 16, pllp = 2, vos = PWR_REGULATOR_VOLTAGE_SCALE1, apb1 = 1, apb2 = 1;
+static const uint32_t flash_max_hz[] = { 30000000U, 64000000U, 90000000U, 100000000U };
+
+// Register values worked out by hand from the two profiles
+static const struct {
+    uint32_t sysclk_hz, pclk1_hz, pclk2_hz;
+    uint16_t tim3_psc, tim1_psc, tim9_psc, usart2_brr;
+    uint8_t i2c_freq;
+    uint16_t i2c_ccr;
+    uint32_t systick_load, adc_hz;
+} expect[CLOCK_PROFILE_COUNT] = {
+    [CLOCK_LOW]  = {  48000000U, 48000000U,  48000000U, 47, 4799, 47, 417, 48, 240, 47999, 12000000U },
+    [CLOCK_FULL] = { 100000000U, 50000000U, 100000000U, 99, 9999, 99, 434, 50, 250, 99999, 25000000U },
+};
+
+static uint32_t sim_sysclk(void) {
+    return host_sysclk_source == RCC_SYSCLKSOURCE_PLLCLK ? HSI_VALUE / pllm * plln / pllp : HSI_VALUE;
+}
+
+/* What an interrupt would see now: every derived rate at its nominal value */
+static int sim_retimed(void) {
+    uint32_t pclk1 = sim_sysclk() / apb1, pclk2 = sim_sysclk() / apb2;
+    uint32_t tim1 = apb1 == 1 ? pclk1 : 2 * pclk1, tim2 = apb2 == 1 ? pclk2 : 2 * pclk2;
+    uint32_t baud = pclk1 / USART2->BRR;
+    int ok = 1;
+
+    ok &= (TIM3->PSC + 1) * CLOCK_SERVO_HZ == tim1 && (TIM4->PSC + 1) * CLOCK_IR_HZ == tim1;
+    ok &= (TIM1->PSC + 1) * CLOCK_PATTERN_HZ == tim2 && (TIM9->PSC + 1) * CLOCK_HALTICK_HZ == tim2;
+    ok &= (baud > CLOCK_UART_BAUD ? baud - CLOCK_UART_BAUD : CLOCK_UART_BAUD - baud) * 1000000ULL
+          <= (uint64_t)CLOCK_UART_MAX_PPM * CLOCK_UART_BAUD;
+    ok &= (I2C1->CR2 & I2C_CR2_FREQ) * 1000000U == pclk1 && 2 * I2C1->CCR * CLOCK_I2C_HZ == pclk1;
+    ok &= (I2C1->CR1 & I2C_CR1_PE) != 0;
+    ok &= (SysTick->LOAD + 1) * configTICK_RATE_HZ == sim_sysclk();
+    return ok;
+}
+
+uint32_t host_get_primask(void) {
+    return primask;
+}
+
+void host_disable_irq(void) {
+    primask = 1;
+}
+
+void host_set_primask(uint32_t mask) {
+    if (primask && !mask) {
+        unmasks++;
+        if (!sim_retimed()) stale++;
+    }
+    primask = mask;
+}
+
+void HAL_IncTick(void) {
+    uwTick++;
+}
+
+/* VOS only changes with the PLL off */
+void host_set_vos(uint32_t scale) {
+    CHECK(!pll_on);
+    vos = scale;
+}
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *osc) {
+    uint32_t start = HAL_GetTick();
+
+    if (!primask) rcc_unmasked++;
+    if (osc->PLL.PLLState == RCC_PLL_OFF) {
+        CHECK(host_sysclk_source != RCC_SYSCLKSOURCE_PLLCLK);
+        pll_on = 0;
+        host_pwr.CSR &= ~PWR_CSR_VOSRDY;
+        return HAL_OK;
+    }
+    CHECK(osc->PLL.PLLState == RCC_PLL_ON && !pll_on && osc->PLL.PLLSource == RCC_PLLSOURCE_HSI);
+    pllm = osc->PLL.PLLM;
+    plln = osc->PLL.PLLN;
+    pllp = osc->PLL.PLLP;
+    if (pll_fail) {
+        // PLL_TIMEOUT_VALUE as the HAL waits it: each pass, a millisecond goes by on TIM9
+        pll_fail--;
+        for (uint32_t spin = 0; spin < 1000; spin++) {
+            TIM9->SR |= TIM_FLAG_UPDATE;
+            if (HAL_GetTick() - start > 2) return HAL_TIMEOUT;
+        }
+        CHECK(!"PLL wait never timed out");
+        return HAL_TIMEOUT;
+    }
+    pll_on = 1;
+    host_pwr.CSR |= PWR_CSR_VOSRDY;
+    return HAL_OK;
+}
+
+/* Flash latency and regulator scale must cover the new clock; the HAL tick follows it */
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *clk, uint32_t latency) {
+    uint32_t hz;
+
+    if (!primask) rcc_unmasked++;
+    CHECK(clk->SYSCLKSource != RCC_SYSCLKSOURCE_PLLCLK || pll_on);
+    host_sysclk_source = clk->SYSCLKSource;
+    host_flash_latency = latency;
+    apb1 = clk->APB1CLKDivider;
+    apb2 = clk->APB2CLKDivider;
+    hz = sim_sysclk();
+    CHECK(latency < 4 && hz <= flash_max_hz[latency]);
+    CHECK(hz <= (vos == PWR_REGULATOR_VOLTAGE_SCALE3 ? 64000000U : 100000000U));
+    TIM9->PSC = (apb2 == 1 ? hz : 2 * hz / apb2) / CLOCK_HALTICK_HZ - 1;
+    TIM9->DIER |= TIM_IT_UPDATE;
+    return HAL_OK;
+}
+
+int32_t osKernelLock(void) { return 0; }
+int32_t osKernelUnlock(void) { return 1; }
+uint32_t osKernelGetTickCount(void) { return uwTick; }
+int uart_tx_pause(uint32_t timeout_ms) { (void)timeout_ms; return 0; }
+void uart_tx_resume(void) {}
+int work_post(work_fn_t fn, uint32_t arg) { (void)fn; (void)arg; return -1; }
+
+/* A servo pulse was in flight: it has ended by the next tick */
+osStatus_t osDelay(uint32_t ticks) {
+    (void)ticks;
+    TIM3->CNT = 5000;
+    return osOK;
+}
+
+void Error_Handler(void) {
+    printf("  FAIL: Error_Handler, the previous profile could not be restored\n");
+    exit(1);
+}
+
+/* MX_*_Init at boot: the peripherals timed for the boot profile */
+static void mx_init(const clock_timing_t *t) {
+    TIM3->PSC = t->tim3_psc;
+    TIM4->PSC = t->tim4_psc;
+    TIM1->PSC = t->tim1_psc;
+    USART2->BRR = t->usart2_brr;
+    I2C1->CR2 = t->i2c_freq;
+    I2C1->CCR = t->i2c_ccr;
+    I2C1->TRISE = t->i2c_trise;
+    I2C1->CR1 = I2C_CR1_PE;
+    SysTick->LOAD = t->systick_load;
+    TIM3->ARR = SERVO_ARR;
+    TIM3->CCR1 = 1500;
+    TIM3->CCR2 = 1000;
+    TIM3->CNT = 5000;
+}
+
+int main(void) {
+    clock_timing_t t;
+    clock_profile_t bad;
+
+    // Prescaler math: the registers by hand and the rates they give
+    for (uint32_t i = 0; i < CLOCK_PROFILE_COUNT; i++) {
+        const clock_profile_t *p = &clock_profiles[i];
+
+        CHECK(clock_timing(p, &t) == 0 && p->sysclk_hz == expect[i].sysclk_hz);
+        CHECK(t.pclk1_hz == expect[i].pclk1_hz && t.pclk2_hz == expect[i].pclk2_hz);
+        CHECK(t.tim3_psc == expect[i].tim3_psc && t.tim4_psc == expect[i].tim3_psc);
+        CHECK(t.tim1_psc == expect[i].tim1_psc && t.tim9_psc == expect[i].tim9_psc);
+        CHECK(t.usart2_brr == expect[i].usart2_brr && t.usart2_ppm <= CLOCK_UART_MAX_PPM);
+        CHECK(t.i2c_freq == expect[i].i2c_freq && t.i2c_ccr == expect[i].i2c_ccr && t.i2c_trise == t.i2c_freq + 1);
+        CHECK(t.systick_load == expect[i].systick_load && t.adc_hz == expect[i].adc_hz);
+        CHECK((t.tim3_psc + 1U) * CLOCK_SERVO_HZ == t.tim_apb1_hz && (t.tim1_psc + 1U) * CLOCK_PATTERN_HZ == t.tim_apb2_hz);
+        CHECK(2U * t.i2c_ccr * CLOCK_I2C_HZ == t.pclk1_hz && (t.systick_load + 1U) * configTICK_RATE_HZ == p->sysclk_hz);
+        printf("  %-4s %3u MHz: APB1 %u MHz, TIM3/4 PSC %u, TIM1 PSC %u, TIM9 PSC %u, BRR %u (%u ppm), "
+               "I2C FREQ %u CCR %u TRISE %u, SysTick %u, ADC %u MHz\n",
+               p->name, p->sysclk_hz / 1000000U, t.pclk1_hz / 1000000U, t.tim3_psc, t.tim1_psc, t.tim9_psc,
+               t.usart2_brr, t.usart2_ppm, t.i2c_freq, t.i2c_ccr, t.i2c_trise, t.systick_load, t.adc_hz / 1000000U);
+    }
+
+    // Refused: APB1 over 50 MHz, 100 MHz at scale 3, too few or too many wait states, USB clock over 48 MHz
+    bad = clock_profiles[CLOCK_FULL];
+    bad.apb1_div = 1;
+    CHECK(clock_timing(&bad, &t) != 0);
+    bad = clock_profiles[CLOCK_FULL];
+    bad.vos = 3;
+    CHECK(clock_timing(&bad, &t) != 0);
+    bad.vos = 1;
+    bad.flash_ws = 2;
+    CHECK(clock_timing(&bad, &t) != 0);
+    bad = clock_profiles[CLOCK_LOW];
+    bad.flash_ws = 2;
+    CHECK(clock_timing(&bad, &t) != 0);
+    bad = clock_profiles[CLOCK_FULL];
+    bad.pllq = 2;
+    CHECK(clock_timing(&bad, &t) != 0);
+
+    // Boot from HSI, before any interrupt is enabled
+    CHECK(clock_profile_boot() == 0 && clock_profile_current() == CLOCK_BOOT);
+    mx_init(clock_timing_now());
+    CHECK(sim_retimed());
+    rcc_unmasked = 0;
+
+    // Switches: RCC only with interrupts masked, everything retimed at the unmask
+    for (uint32_t i = 0; i < SWITCHES; i++) {
+        clock_profile_id_t id = i % 2 == 0 ? CLOCK_LOW : CLOCK_FULL;
+        CHECK(clock_profile_set(id) == 0 && clock_profile_current() == id && sim_sysclk() == clock_profiles[id].sysclk_hz);
+        CHECK(primask == 0 && sim_retimed());
+    }
+    CHECK(rcc_unmasked == 0 && stale == 0 && unmasks == SWITCHES && clock_profile_stats.switches == SWITCHES);
+    printf("  %u switches: %u RCC calls with interrupts enabled, %u unmasks on stale prescalers\n",
+           SWITCHES, rcc_unmasked, stale);
+
+    // A servo pulse in flight holds the switch back a tick
+    TIM3->CNT = 1200;
+    CHECK(clock_profile_set(CLOCK_LOW) == 0 && clock_profile_stats.servo_waits == 1);
+
+    // The PLL never locks: times out with interrupts masked, the previous profile comes back
+    uint32_t tick = uwTick;
+    pll_fail = 1;
+    CHECK(clock_profile_set(CLOCK_FULL) == -1 && clock_profile_current() == CLOCK_LOW);
+    CHECK(clock_profile_stats.failures == 1 && sim_sysclk() == clock_profiles[CLOCK_LOW].sysclk_hz);
+    CHECK(primask == 0 && sim_retimed() && stale == 0 && rcc_unmasked == 0 && uwTick - tick > 2);
+    printf("  PLL lock timeout: %u ms counted with interrupts masked, %s profile restored\n",
+           uwTick - tick, clock_profiles[clock_profile_current()].name);
+    CHECK(clock_profile_set(CLOCK_FULL) == 0 && sim_retimed());
+
+    printf("  %s\n", failures ? "FAILED" : "passed");
+    return failures != 0;
+}
@@ -0,0 +1,109 @@
+// Controller isolation: controller.c keeps all of a unit's state in its
+// controller_t, so units stepped interleaved (Tools/fleet, batches on a
+// thread pool) behave exactly as each run on its own. UNITS controllers get
+// different level histories, faults and IR presses; every slot's outputs
+// are folded into a per-unit digest, once round-robin slot by slot and once
+// unit after unit, and the digests must match. Unit 0 is then run again
+// after all the others, to catch state left behind in a static.
+// Built and run by Tools/host_test.py (controller_isolation).
+#include "controller.h"
+#include <stdio.h>
+#include <string.h>
+
+#define UNITS       16
+#define SLOTS       36000       // one hour of water slots
+#define MM_TO_RAW   (4095.0f / 40.0f)
+
+typedef struct {
+    uint32_t rng;
+    uint32_t digest;
+} unit_input_t;
+
+static controller_t ctrl[UNITS];
+static unit_input_t in[UNITS];
+
+static uint32_t xorshift(uint32_t *s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 17;
+    *s ^= *s << 5;
+    return *s;
+}
+
+static void fnv(uint32_t *h, uint32_t v) {
+    for (int i = 0; i < 4; i++, v >>= 8) *h = (*h ^ (v & 0xFFU)) * 16777619U;
+}
+
+/* A storm whose peak, timing and sensor depend on the unit only */
+static uint16_t unit_raw(int u, uint32_t k) {
+    float peak = 10.0f + 2.3f * u, t = k * 0.1f - 40.0f * u, mm;
+    float noise = ((int32_t)(xorshift(&in[u].rng) & 0xFFFF) - 0x8000) * (0.6f / 0x8000);
+
+    if (t < 600) mm = 3.0f;
+    else if (t < 1800) mm = 3.0f + (peak - 3.0f) * (t - 600) / 1200;
+    else if (t < 2400) mm = peak;
+    else mm = peak - (peak - 3.0f) * (t - 2400) / 1200;
+    if (mm < 3.0f) mm = 3.0f;
+    if ((xorshift(&in[u].rng) & 511) == 0) mm += 15.0f;            // splash spike
+    if (u % 5 == 4 && k > 20000 && k < 24000) return 4095;         // open sensor for a while
+    mm += noise;
+    return mm <= 0 ? 0 : (uint16_t)(mm * MM_TO_RAW);
+}
+
+static void unit_start(int u) {
+    controller_init(&ctrl[u], &calib_factory);
+    in[u].rng = 0x9E3779B9U * (u + 1);
+    in[u].digest = 2166136261U;
+}
+
+static void unit_step(int u, uint32_t k) {
+    controller_t *c = &ctrl[u];
+    uint8_t changed = controller_slot(c, unit_raw(u, k));
+
+    // Operator presses at unit-specific times, between slots as in the firmware
+    if (k == 5000 + 97 * u || k == 9000 + 53 * u) changed |= controller_dispatch(c, BEV_IR_TOGGLE);
+    if (u % 3 == 0 && k == 15000) changed |= controller_dispatch(c, BEV_IR_ESTOP);
+    if (u % 3 == 0 && k == 16000) changed |= controller_dispatch(c, BEV_IR_AUTO);
+
+    uint32_t mm;
+    memcpy(&mm, &c->slot.mm, sizeof(mm));
+    fnv(&in[u].digest, changed | c->fsm.state << 8 | c->fsm.servo << 16 | c->slot.status << 24);
+    fnv(&in[u].digest, mm);
+    if (changed & CTRL_INDICATOR) fnv(&in[u].digest, c->indicator_out->pattern | c->indicator_out->steady << 8);
+}
+
+int main(void) {
+    uint32_t interleaved[UNITS], alone[UNITS], states[UNITS];
+    int failed = 0;
+
+    for (int u = 0; u < UNITS; u++) unit_start(u);
+    for (uint32_t k = 0; k < SLOTS; k++) {
+        for (int u = 0; u < UNITS; u++) unit_step(u, k);
+    }
+    for (int u = 0; u < UNITS; u++) {
+        interleaved[u] = in[u].digest;
+        states[u] = ctrl[u].fsm.state;
+    }
+
+    // In reverse order, so every unit runs after different neighbours
+    for (int u = UNITS - 1; u >= 0; u--) {
+        unit_start(u);
+        for (uint32_t k = 0; k < SLOTS; k++) unit_step(u, k);
+        alone[u] = in[u].digest;
+    }
+    unit_start(0);
+    for (uint32_t k = 0; k < SLOTS; k++) unit_step(0, k);
+
+    for (int u = 0; u < UNITS; u++) {
+        if (interleaved[u] != alone[u]) {
+            printf("  unit %2d: interleaved %08x, alone %08x\n", u, interleaved[u], alone[u]);
+            failed++;
+        }
+    }
+    if (in[0].digest != alone[0]) {
+        printf("  unit 0 run again after the others: %08x, first %08x\n", in[0].digest, alone[0]);
+        failed++;
+    }
+    printf("  %d units x %d slots, interleaved and alone: %s (unit 0 %08x, final state %u)\n",
+           UNITS, SLOTS, failed ? "DIFFERENT" : "identical", alone[0], states[0]);
+    return failed != 0;
+}
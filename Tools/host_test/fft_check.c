@@ -0,0 +1,126 @@
+// FFT tables: every transform dsp_config.h declares, run through CMSIS-DSP
+// with the generated dsp_tables.c, against a DFT in double precision. A
+// random real block through arm_rfft_fast_f32 (packed: DC, Nyquist, then
+// bins 1 .. N/2-1) and a random complex block through arm_cfft_f32 must
+// match it to MAX_REL_ERR of the spectrum's RMS, and the inverse transform
+// must give the block back. A wrong twiddle or bit-reversal entry in a
+// table shows up as an error near 1.
+//
+// Built and run by Tools/host_test.py (fft) twice: with the firmware's
+// dsp_config.h and tables, and with every length declared.
+#include "arm_math.h"
+#include <math.h>
+#include <stdio.h>
+
+#define CHECK(c)        do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define MAX_LEN         4096
+#define MAX_REL_ERR     1e-5
+
+static int failures;
+static uint32_t rng = 2463534242U;
+
+static const struct {
+    uint16_t len;
+    uint8_t on;
+} rfft[] = {
+    { 32, DSP_RFFT_F32_32 }, { 64, DSP_RFFT_F32_64 }, { 128, DSP_RFFT_F32_128 }, { 256, DSP_RFFT_F32_256 },
+    { 512, DSP_RFFT_F32_512 }, { 1024, DSP_RFFT_F32_1024 }, { 2048, DSP_RFFT_F32_2048 }, { 4096, DSP_RFFT_F32_4096 },
+}, cfft[] = {
+    { 16, DSP_CFFT_F32_16 }, { 32, DSP_CFFT_F32_32 }, { 64, DSP_CFFT_F32_64 }, { 128, DSP_CFFT_F32_128 },
+    { 256, DSP_CFFT_F32_256 }, { 512, DSP_CFFT_F32_512 }, { 1024, DSP_CFFT_F32_1024 },
+    { 2048, DSP_CFFT_F32_2048 }, { 4096, DSP_CFFT_F32_4096 },
+};
+
+static double re_ref[MAX_LEN], im_ref[MAX_LEN], cos_n[MAX_LEN], sin_n[MAX_LEN];
+
+static float uniform(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (float)(rng >> 8) / 8388608.0f - 1.0f;
+}
+
+/* X[k] = sum x[j] e^(-2 pi i jk / n) for k < bins; x real, or interleaved re, im */
+static void dft(const float *x, int complex_in, uint32_t n, uint32_t bins) {
+    for (uint32_t j = 0; j < n; j++) {
+        cos_n[j] = cos(2.0 * M_PI * j / n);
+        sin_n[j] = sin(2.0 * M_PI * j / n);
+    }
+    for (uint32_t k = 0; k < bins; k++) {
+        double re = 0.0, im = 0.0;
+        for (uint32_t j = 0; j < n; j++) {
+            double xr = complex_in ? x[2 * j] : x[j], xi = complex_in ? x[2 * j + 1] : 0.0;
+            uint32_t w = (uint32_t)(((uint64_t)j * k) % n);
+            re += xr * cos_n[w] + xi * sin_n[w];
+            im += xi * cos_n[w] - xr * sin_n[w];
+        }
+        re_ref[k] = re;
+        im_ref[k] = im;
+    }
+}
+
+/* RMS error over RMS of b, for n interleaved complex values */
+static double rel_err(const float *a, const float *b, uint32_t n) {
+    double e = 0.0, s = 0.0;
+
+    for (uint32_t i = 0; i < 2 * n; i++) {
+        e += ((double)a[i] - b[i]) * ((double)a[i] - b[i]);
+        s += (double)b[i] * b[i];
+    }
+    return sqrt(e / s);
+}
+
+int main(void) {
+    static float x[2 * MAX_LEN], y[2 * MAX_LEN], z[2 * MAX_LEN], want[2 * MAX_LEN];
+    uint32_t tested = 0;
+
+    for (uint32_t t = 0; t < sizeof(rfft) / sizeof(rfft[0]); t++) {
+        arm_rfft_fast_instance_f32 S;
+        uint32_t n = rfft[t].len;
+        double fwd, inv;
+
+        if (!rfft[t].on) continue;
+        CHECK(arm_rfft_fast_init_f32(&S, n) == ARM_MATH_SUCCESS);
+        for (uint32_t i = 0; i < n; i++) x[i] = z[i] = uniform();
+        dft(x, 0, n, n / 2 + 1);
+        want[0] = (float)re_ref[0];
+        want[1] = (float)re_ref[n / 2];
+        for (uint32_t k = 1; k < n / 2; k++) {
+            want[2 * k] = (float)re_ref[k];
+            want[2 * k + 1] = (float)im_ref[k];
+        }
+        arm_rfft_fast_f32(&S, x, y, 0);
+        fwd = rel_err(y, want, n / 2);
+        arm_rfft_fast_f32(&S, y, x, 1);
+        inv = rel_err(x, z, n / 2);
+        CHECK(fwd < MAX_REL_ERR && inv < MAX_REL_ERR);
+        printf("  rfft %4u: %.1e against the DFT, %.1e round trip\n", n, fwd, inv);
+        tested++;
+    }
+
+    for (uint32_t t = 0; t < sizeof(cfft) / sizeof(cfft[0]); t++) {
+        arm_cfft_instance_f32 S;
+        uint32_t n = cfft[t].len;
+        double fwd, inv;
+
+        if (!cfft[t].on) continue;
+        CHECK(arm_cfft_init_f32(&S, n) == ARM_MATH_SUCCESS);
+        for (uint32_t i = 0; i < 2 * n; i++) x[i] = z[i] = uniform();
+        dft(x, 1, n, n);
+        for (uint32_t k = 0; k < n; k++) {
+            want[2 * k] = (float)re_ref[k];
+            want[2 * k + 1] = (float)im_ref[k];
+        }
+        arm_cfft_f32(&S, x, 0, 1);
+        fwd = rel_err(x, want, n);
+        arm_cfft_f32(&S, x, 1, 1);
+        inv = rel_err(x, z, n);
+        CHECK(fwd < MAX_REL_ERR && inv < MAX_REL_ERR);
+        printf("  cfft %4u: %.1e against the DFT, %.1e round trip\n", n, fwd, inv);
+        tested++;
+    }
+
+    CHECK(tested > 0);
+    printf("  %s: %u transforms\n", failures ? "FAILED" : "passed", tested);
+    return failures != 0;
+}
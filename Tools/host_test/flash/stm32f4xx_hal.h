@@ -0,0 +1,48 @@
+#ifndef __HOST_FLASH_HAL_H__
+#define __HOST_FLASH_HAL_H__
+
+// Host stand-in for the flash part of stm32f4xx_hal.h, ahead of the replay
+// one (which it includes for DWT). calib_store_test.c implements the calls
+// over a RAM image of sectors 6 and 7 that only clears bits, as flash does,
+// and keeps PRIMASK as a word so an IR frame can land as interrupts return.
+#include_next "stm32f4xx_hal.h"
+
+// cmsis_gcc.h has these as Cortex-M asm: taken first, then renamed
+#include "cmsis_compiler.h"
+#define __get_PRIMASK               host_get_primask
+#define __set_PRIMASK               host_set_primask
+#define __disable_irq               host_disable_irq
+uint32_t host_get_primask(void);
+void host_set_primask(uint32_t primask);
+void host_disable_irq(void);
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+
+typedef struct {
+    uint32_t TypeErase;
+    uint32_t Banks;
+    uint32_t Sector;
+    uint32_t NbSectors;
+    uint32_t VoltageRange;
+} FLASH_EraseInitTypeDef;
+
+#define FLASH_TYPEERASE_SECTORS     0U
+#define FLASH_VOLTAGE_RANGE_3       2U
+#define FLASH_TYPEPROGRAM_WORD      2U
+#define FLASH_FLAG_EOP              0x01U
+#define FLASH_FLAG_OPERR            0x02U
+#define FLASH_FLAG_WRPERR           0x10U
+#define FLASH_FLAG_PGAERR           0x20U
+#define FLASH_FLAG_PGPERR           0x40U
+#define FLASH_FLAG_PGSERR           0x80U
+#define __HAL_FLASH_CLEAR_FLAG(f)           ((void)(f))
+#define __HAL_FLASH_DATA_CACHE_DISABLE()    ((void)0)
+#define __HAL_FLASH_DATA_CACHE_RESET()      ((void)0)
+#define __HAL_FLASH_DATA_CACHE_ENABLE()     ((void)0)
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t type, uint32_t addr, uint64_t data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *erase, uint32_t *bad_sector);
+
+#endif // __HOST_FLASH_HAL_H__
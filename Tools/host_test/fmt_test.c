@@ -0,0 +1,194 @@
+// Fixed-width formatting: fmt.c unchanged, each call against the snprintf
+// that would have written the same field. fmt_uint and fmt_int against
+// "%*u" and "%*d", fmt_fixed against the integer and fraction parts
+// printed apart, fmt_str against "%-*.*s"; a number wider than its field
+// must fill it with FMT_OVERFLOW instead. Edge values (0, powers of ten
+// either side, INT32_MIN, INT32_MAX, UINT32_MAX) for every width up to 12
+// and every fraction up to 10 digits, then random values. Every call must
+// write its field and nothing past it, and return its end. Then the time
+// per field against snprintf.
+//
+// Built and run by Tools/host_test.py (fmt).
+#include "fmt.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK(c)        do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define GUARD           '~'
+#define MAX_WIDTH       12
+#define MAX_FRAC        10
+#define RANDOM_VALUES   200000
+#define BENCH_CALLS     (1 << 16)
+#define BENCH_MS        200
+
+static int failures;
+static uint64_t checks, mismatches;
+static uint32_t rng = 2463534242U;
+
+static uint32_t xorshift(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+/* snprintf's text for the field, or the overflow fill if it is wider */
+static void expect(char *out, const char *text, uint8_t width) {
+    size_t len = strlen(text);
+
+    if (width == 0) {
+        strcpy(out, text);
+    } else if (len > width) {
+        memset(out, FMT_OVERFLOW, width);
+        out[width] = '\0';
+    } else {
+        snprintf(out, MAX_WIDTH + 1, "%*s", width, text);
+    }
+}
+
+/* The field at buf, ended at end, against want; nothing written past it */
+static void compare(const char *buf, const char *end, const char *want, const char *what, int64_t v, int w, int f) {
+    size_t len = strlen(want);
+    int ok = end == buf + len && memcmp(buf, want, len) == 0 && buf[len] == GUARD;
+
+    checks++;
+    if (!ok && mismatches++ < 5) {
+        printf("  %s(%" PRId64 ", frac %d, width %d): \"%.*s\", snprintf \"%s\"\n", what, v, f, w,
+               (int)(end > buf && end - buf < 64 ? end - buf : 0), buf, want);
+    }
+}
+
+static void check_uint(uint32_t v, uint8_t width) {
+    char buf[64], text[32], want[32];
+
+    memset(buf, GUARD, sizeof(buf));
+    snprintf(text, sizeof(text), "%" PRIu32, v);
+    expect(want, text, width);
+    compare(buf, fmt_uint(buf, v, width), want, "fmt_uint", v, width, 0);
+}
+
+static void check_int(int32_t v, uint8_t width) {
+    char buf[64], text[32], want[32];
+
+    memset(buf, GUARD, sizeof(buf));
+    snprintf(text, sizeof(text), "%" PRId32, v);
+    expect(want, text, width);
+    compare(buf, fmt_int(buf, v, width), want, "fmt_int", v, width, 0);
+}
+
+static void check_fixed(int32_t v, uint8_t frac, uint8_t width) {
+    char buf[64], text[32], want[32];
+    uint8_t f = frac > 9 ? 9 : frac;            // fmt_fixed's limit
+    uint64_t mag = v < 0 ? -(int64_t)v : v, p = 1;
+
+    for (uint8_t i = 0; i < f; i++) p *= 10;
+    if (f == 0) {
+        snprintf(text, sizeof(text), "%" PRId32, v);
+    } else {
+        snprintf(text, sizeof(text), "%s%" PRIu64 ".%0*" PRIu64, v < 0 ? "-" : "", mag / p, f, mag % p);
+    }
+    memset(buf, GUARD, sizeof(buf));
+    expect(want, text, width);
+    compare(buf, fmt_fixed(buf, v, frac, width), want, "fmt_fixed", v, width, frac);
+}
+
+static void check_str(const char *s, uint8_t width) {
+    char buf[64], want[64];
+
+    memset(buf, GUARD, sizeof(buf));
+    if (width == 0) {
+        snprintf(want, sizeof(want), "%s", s);
+    } else {
+        snprintf(want, sizeof(want), "%-*.*s", width, width, s);
+    }
+    compare(buf, fmt_str(buf, s, width), want, "fmt_str", (int64_t)strlen(s), width, 0);
+}
+
+static double elapsed_ns(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) * 1e9 + (b->tv_nsec - a->tv_nsec);
+}
+
+/* ns per "-123.4" style field in a width of 8, fmt_fixed or snprintf */
+static double bench(int use_fmt) {
+    static char line[32];
+    struct timespec a, b;
+    uint64_t n = 0;
+    volatile char sink;
+
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    do {
+        for (int32_t i = 0; i < BENCH_CALLS; i++) {
+            int32_t v = i - BENCH_CALLS / 2;
+            if (use_fmt) {
+                fmt_fixed(line, v, 1, 8);
+            } else {
+                snprintf(line, sizeof(line), "%s%6" PRId32 ".%" PRId32, v < 0 ? "-" : " ", (v < 0 ? -v : v) / 10,
+                         (v < 0 ? -v : v) % 10);
+            }
+        }
+        n += BENCH_CALLS;
+        clock_gettime(CLOCK_MONOTONIC, &b);
+    } while (elapsed_ns(&a, &b) < BENCH_MS * 1e6);
+    sink = line[0];
+    (void)sink;
+    return elapsed_ns(&a, &b) / n;
+}
+
+int main(void) {
+    static const char *strs[] = { "", "a", "OK", "Status: !!FLOOD!!", "Status: SENSOR ERR", "exactly12chr",
+                                  "thirteen char" };
+    uint32_t edges[64];
+    uint32_t n_edges = 0;
+
+    // Edge values: 0, 1, each power of ten and its neighbours, the type limits
+    edges[n_edges++] = 0;
+    for (uint64_t p = 1; p <= UINT32_MAX; p *= 10) {
+        edges[n_edges++] = (uint32_t)p;
+        edges[n_edges++] = (uint32_t)(p - 1);
+        if (p + 1 <= UINT32_MAX) edges[n_edges++] = (uint32_t)(p + 1);
+    }
+    edges[n_edges++] = INT32_MAX;
+    edges[n_edges++] = (uint32_t)INT32_MAX + 1;
+    edges[n_edges++] = UINT32_MAX;
+
+    for (uint8_t w = 0; w <= MAX_WIDTH; w++) {
+        for (uint32_t e = 0; e < n_edges; e++) {
+            uint32_t u = edges[e];
+            check_uint(u, w);
+            check_int((int32_t)u, w);
+            check_int((int32_t)(0U - u), w);
+            for (uint8_t f = 0; f <= MAX_FRAC; f++) {
+                check_fixed((int32_t)u, f, w);
+                check_fixed((int32_t)(0U - u), f, w);
+            }
+        }
+        check_int(INT32_MIN, w);
+        for (uint8_t f = 0; f <= MAX_FRAC; f++) check_fixed(INT32_MIN, f, w);
+        for (uint32_t s = 0; s < sizeof(strs) / sizeof(strs[0]); s++) check_str(strs[s], w);
+    }
+    printf("  edge values, widths 0-%d, fractions 0-%d: %" PRIu64 " fields\n", MAX_WIDTH, MAX_FRAC, checks);
+
+    // Random values, biased to every magnitude
+    for (uint32_t i = 0; i < RANDOM_VALUES; i++) {
+        uint32_t v = xorshift() >> (xorshift() % 32);
+        uint8_t w = (uint8_t)(xorshift() % (MAX_WIDTH + 1)), f = (uint8_t)(xorshift() % 5);
+        check_uint(v, w);
+        check_int((int32_t)v, w);
+        check_fixed((int32_t)v, f, w);
+    }
+
+    // fmt_copy and fmt_lit: exactly n bytes
+    char buf[16];
+    memset(buf, GUARD, sizeof(buf));
+    CHECK(fmt_lit(buf, "kbench") == buf + 6 && memcmp(buf, "kbench~", 7) == 0);
+    CHECK(fmt_copy(buf, "xyz", 0) == buf && buf[0] == 'k');
+
+    CHECK(mismatches == 0);
+    printf("  %" PRIu64 " fields in all, %" PRIu64 " differ from snprintf\n", checks, mismatches);
+    printf("  fmt_fixed %.1f ns per field, snprintf %.1f ns (width 8, one decimal)\n", bench(1), bench(0));
+
+    printf("  %s\n", failures ? "FAILED" : "passed");
+    return failures != 0;
+}
@@ -0,0 +1,213 @@
+// Kernel heaps: heap_tlsf.c (-DHEAP_TLSF, what the firmware links) or
+// heap_4.c, included here unchanged so their internals can be checked over
+// the host kernel stand-in (Tools/host_test/rtos).
+//
+//     heap_check random [ops]      random malloc/free of 1..512 bytes (one in
+//                                  eight up to 2 KiB) over 128 slots, every
+//                                  block's contents checked before its free
+//                                  and the heap structure every 4096 steps;
+//                                  per-call latency (host tails, not MCU),
+//                                  and freeing everything must leave one block
+//     heap_check holes K...        cut the heap into K free holes, then the
+//                                  best time of a 1 KiB malloc no hole fits
+//                                  and of freeing a block above them all
+//
+// TLSF structure: physical links, no two free neighbours, every free block
+// on the list of its class with the bitmaps agreeing, the free byte count.
+// heap_4: the free list in address order, no two free blocks touching, the
+// free byte count. Built per heap and heap size by Tools/host_test.py (heap).
+#include <string.h>
+#include <time.h>
+#ifdef HEAP_TLSF
+#include "heap_tlsf.c"
+#define HEAP_NAME   "tlsf"
+#else
+#include "heap_4.c"
+#define HEAP_NAME   "heap_4"
+#endif
+#include "rtos_host.h"
+
+#define CHECK(c)    do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define SLOTS       128
+#define MAX_SIZE    512
+#define CHECK_EVERY 4096
+#define MAX_OPS     (1L << 23)
+#define MAX_HOLES   4096
+#define HOLE_ROUNDS 200
+
+static int failures;
+static uint32_t rng = 12345;
+static uint8_t *slot[SLOTS];
+static size_t slot_size[SLOTS];
+static uint32_t lat_malloc[MAX_OPS], lat_free[MAX_OPS];
+static void *hold[2 * MAX_HOLES];
+
+static uint32_t xorshift(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &t);
+    return (uint64_t)t.tv_sec * 1000000000U + t.tv_nsec;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+#ifdef HEAP_TLSF
+/* Walks the heap in address order, then every class list; non-zero when sound */
+static int heap_sound(void) {
+    size_t free_bytes = 0, free_blocks = 0, listed = 0;
+    TLSFBlock_t *prev = NULL;
+
+    if (pxFirst == NULL) return 1;
+    for (TLSFBlock_t *b = pxFirst; b != pxEnd; prev = b, b = prvNextPhysBlock(b)) {
+        if (b->pxPrevPhysBlock != prev || (uint8_t *)b >= (uint8_t *)pxEnd) return 0;
+        if (!prvBlockIsFree(b)) continue;
+        if (prev != NULL && prvBlockIsFree(prev)) return 0;
+        free_bytes += prvBlockSize(b);
+        free_blocks++;
+    }
+    if (pxEnd->pxPrevPhysBlock != prev) return 0;
+    for (UBaseType_t fl = 0; fl < heapFL_INDEX_COUNT; fl++) {
+        if (((ulFLBitmap >> fl) & 1) != (ulSLBitmap[fl] != 0)) return 0;
+        for (UBaseType_t sl = 0; sl < heapSL_INDEX_COUNT; sl++) {
+            if (((ulSLBitmap[fl] >> sl) & 1) != (pxFreeLists[fl][sl] != NULL)) return 0;
+            for (TLSFBlock_t *b = pxFreeLists[fl][sl]; b != NULL; b = b->pxNextFreeBlock) {
+                UBaseType_t f, s;
+                prvMappingInsert(prvBlockSize(b), &f, &s);
+                if (!prvBlockIsFree(b) || f != fl || s != sl) return 0;
+                if (b->pxNextFreeBlock != NULL && b->pxNextFreeBlock->pxPrevFreeBlock != b) return 0;
+                listed++;
+            }
+        }
+    }
+    return listed == free_blocks && free_bytes == xFreeBytesRemaining;
+}
+#else
+static int heap_sound(void) {
+    size_t free_bytes = 0;
+
+    if (pxEnd == NULL) return 1;
+    for (BlockLink_t *b = xStart.pxNextFreeBlock; b != pxEnd; b = b->pxNextFreeBlock) {
+        if (b->pxNextFreeBlock <= b) return 0;
+        if ((uint8_t *)b + b->xBlockSize >= (uint8_t *)b->pxNextFreeBlock && b->pxNextFreeBlock != pxEnd) return 0;
+        free_bytes += b->xBlockSize;
+    }
+    return free_bytes == xFreeBytesRemaining;
+}
+#endif
+
+static void run_random(long ops) {
+    uint64_t sum_m = 0, sum_f = 0;
+    long n_m = 0, n_f = 0, failed = 0;
+    HeapStats_t st;
+
+    for (long k = 0; k < ops; k++) {
+        int i = xorshift() % SLOTS;
+        if (slot[i] != NULL) {
+            for (size_t j = 0; j < slot_size[i]; j++) {
+                if (slot[i][j] != (uint8_t)(i + j)) {
+                    CHECK(!"block contents overwritten");
+                    break;
+                }
+            }
+            uint64_t t0 = now_ns();
+            vPortFree(slot[i]);
+            lat_free[n_f] = (uint32_t)(now_ns() - t0);
+            sum_f += lat_free[n_f++];
+            slot[i] = NULL;
+        } else {
+            size_t size = xorshift() % 8 == 0 ? 1 + xorshift() % (4 * MAX_SIZE) : 1 + xorshift() % MAX_SIZE;
+            uint64_t t0 = now_ns();
+            slot[i] = pvPortMalloc(size);
+            lat_malloc[n_m] = (uint32_t)(now_ns() - t0);
+            sum_m += lat_malloc[n_m++];
+            if (slot[i] == NULL) {
+                failed++;
+                continue;
+            }
+            CHECK(((uintptr_t)slot[i] & portBYTE_ALIGNMENT_MASK) == 0);
+            slot_size[i] = size;
+            for (size_t j = 0; j < size; j++) slot[i][j] = (uint8_t)(i + j);
+        }
+        if (k % CHECK_EVERY == 0 && !heap_sound()) {
+            CHECK(!"heap structure broken");
+            return;
+        }
+    }
+    CHECK(heap_sound() && rtos_host.suspended == 0 && rtos_host.critical == 0);
+    vPortGetHeapStats(&st);
+    qsort(lat_malloc, n_m, sizeof(lat_malloc[0]), cmp_u32);
+    qsort(lat_free, n_f, sizeof(lat_free[0]), cmp_u32);
+    printf("  %-6s malloc mean %3.0f p99 %4u p99.99 %5u ns, free mean %3.0f p99 %4u p99.99 %5u ns\n",
+           HEAP_NAME, (double)sum_m / n_m, lat_malloc[(long)(n_m * 0.99)], lat_malloc[(long)(n_m * 0.9999)],
+           (double)sum_f / n_f, lat_free[(long)(n_f * 0.99)], lat_free[(long)(n_f * 0.9999)]);
+    printf("  %-6s %ld of %ld mallocs failed, free %zu (min ever %zu) in %zu blocks, largest %zu",
+           HEAP_NAME, failed, n_m, xPortGetFreeHeapSize(), xPortGetMinimumEverFreeHeapSize(),
+           st.xNumberOfFreeBlocks, st.xSizeOfLargestFreeBlockInBytes);
+#ifdef HEAP_TLSF
+    printf(", fragmentation %zu%%", xPortGetHeapFragmentation());
+#endif
+    printf("\n");
+
+    for (int i = 0; i < SLOTS; i++) vPortFree(slot[i]);
+    vPortGetHeapStats(&st);
+    CHECK(heap_sound() && st.xNumberOfFreeBlocks == 1 && st.xSizeOfLargestFreeBlockInBytes == xPortGetFreeHeapSize());
+}
+
+static void run_holes(int holes) {
+    uint64_t best_malloc = UINT64_MAX, best_free = UINT64_MAX;
+    size_t blocks = 0;
+    HeapStats_t st;
+
+    if (holes < 1 || holes > MAX_HOLES) {
+        CHECK(!"hole count out of range");
+        return;
+    }
+    // The same layout each round, the free timed on a block above every hole
+    for (int r = 0; r < HOLE_ROUNDS; r++) {
+        for (int i = 0; i < 2 * holes; i++) CHECK((hold[i] = pvPortMalloc(24)) != NULL);
+        void *top = pvPortMalloc(24);
+        for (int i = 0; i < 2 * holes; i += 2) vPortFree(hold[i]);
+        vPortGetHeapStats(&st);
+        blocks = st.xNumberOfFreeBlocks;
+        uint64_t t0 = now_ns();
+        void *big = pvPortMalloc(1024);
+        uint64_t t1 = now_ns();
+        vPortFree(big);
+        if (t1 - t0 < best_malloc) best_malloc = t1 - t0;
+        t0 = now_ns();
+        vPortFree(top);
+        t1 = now_ns();
+        if (t1 - t0 < best_free) best_free = t1 - t0;
+        CHECK(big != NULL && heap_sound());
+        for (int i = 1; i < 2 * holes; i += 2) vPortFree(hold[i]);
+    }
+    vPortGetHeapStats(&st);
+    CHECK(heap_sound() && blocks >= (size_t)holes && st.xNumberOfFreeBlocks == 1);
+    printf("  %-6s %4zu holes: malloc(1024) %5llu ns, free above them %5llu ns\n", HEAP_NAME, blocks,
+           (unsigned long long)best_malloc, (unsigned long long)best_free);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "random") == 0) {
+        long ops = argc > 2 ? atol(argv[2]) : 2000000;
+        run_random(ops < MAX_OPS ? ops : MAX_OPS);
+    } else if (argc > 2 && strcmp(argv[1], "holes") == 0) {
+        for (int i = 2; i < argc; i++) run_holes(atoi(argv[i]));
+    } else {
+        printf("usage: heap_check random [ops] | holes K...\n");
+        return 2;
+    }
+    if (failures) printf("  FAILED\n");
+    return failures != 0;
+}
@@ -0,0 +1,184 @@
+// Status outputs: indicator.c, alarm_pattern.c and controller.c unchanged,
+// the pattern stream on a host TIM1/DMA2/GPIOC (Tools/host_test/pattern).
+// Every one of the INDICATOR_STATES table entries against the rules in
+// indicator.c written as if/else, with no steady bit on a pattern pin and
+// every slot word setting or resetting all of PC0-PC3. Then a storm with
+// IR presses and a sensor fault through controller_slot(), applied as
+// barrier_apply() in main.c does: after every water slot the outputs in
+// force must be the table entry for the controller's state, and the pins
+// as the DMA stream leaves them must agree with it. Counted: outputs
+// returned, stream restarts, and the registers the CPU writes for them.
+//
+// Built and run by Tools/host_test.py (indicator).
+#include "alarm_pattern.h"
+#include "controller.h"
+#include "stm32f4xx_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CHECK(c)        do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define PINS            (GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3)
+#define SLOTS           3000
+#define MM_TO_RAW       (4095.0f / 40.0f)
+
+GPIO_TypeDef host_gpioc;
+TIM_TypeDef host_tim1;
+DMA_Stream_TypeDef host_dma2_stream5;
+RCC_TypeDef host_rcc;
+
+static int failures;
+static const uint32_t *stream;      // the slots the DMA reads, NULL when stopped
+static uint32_t stream_len, stream_pos, dma_starts, dma_aborts, egr_writes;
+
+void Error_Handler(void) {
+    CHECK(0);
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void) { return SystemCoreClock; }
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim) { (void)htim; return HAL_OK; }
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma) { (void)hdma; return HAL_OK; }
+
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma) {
+    CHECK(hdma->Instance == DMA2_Stream5);
+    stream = NULL;
+    dma_aborts++;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t src, uint32_t dst, uint32_t n) {
+    CHECK(hdma->Instance == DMA2_Stream5 && hdma->Init.Mode == DMA_CIRCULAR && stream == NULL);
+    CHECK(dst == (uint32_t)(uintptr_t)&GPIOC->BSRR && n > 0 && n <= PATTERN_MAX_SLOTS);
+    stream = (const uint32_t *)(uintptr_t)src;
+    stream_len = n;
+    dma_starts++;
+    return HAL_OK;
+}
+
+/* One TIM1 update request: the next slot's BSRR word lands on the pins */
+static void dma_slot(void) {
+    uint32_t w = stream[stream_pos];
+
+    GPIOC->ODR = (GPIOC->ODR | (w & 0xFFFFU)) & ~(w >> 16);
+    stream_pos = (stream_pos + 1) % stream_len;
+}
+
+/* The UG write restarts the stream at slot 0 and lands it at once */
+static void apply_egr(void) {
+    if (TIM1->EGR & TIM_EGR_UG) {
+        TIM1->EGR = 0;
+        egr_writes++;
+        stream_pos = 0;
+        dma_slot();
+    }
+}
+
+/* indicator.c's rules, without the table */
+static indicator_out_t ref_out(uint8_t status, uint8_t barrier_up, uint8_t manual) {
+    indicator_out_t o = { 0, PATTERN_OFF };
+
+    if (status == RAIN_NORMAL && !manual) o.steady = PATTERN_GREEN;
+    if (manual) {
+        o.pattern = barrier_up ? PATTERN_MANUAL : PATTERN_FLOOD;    // not up: the emergency stop
+    } else if (barrier_up) {
+        o.pattern = PATTERN_FLOOD;
+    } else if (status == RAIN_WARNING) {
+        o.pattern = PATTERN_WARNING;
+    }
+    return o;
+}
+
+static uint32_t pin(uint8_t output_bits) {
+    uint32_t p = 0;
+
+    if (output_bits & PATTERN_GREEN) p |= GPIO_PIN_0;
+    if (output_bits & PATTERN_YELLOW) p |= GPIO_PIN_1;
+    if (output_bits & PATTERN_RED) p |= GPIO_PIN_2;
+    if (output_bits & PATTERN_BUZZER) p |= GPIO_PIN_3;
+    return p;
+}
+
+/* A 0 -> 40 -> 0 mm storm, with an open sensor late in it */
+static uint16_t storm_raw(uint32_t k) {
+    float mm;
+
+    if (k < 200) mm = 0.0f;
+    else if (k < 1200) mm = 40.0f * (k - 200) / 1000;
+    else if (k < 1700) mm = 40.0f;
+    else if (k < 2700) mm = 40.0f - 40.0f * (k - 1700) / 1000;
+    else mm = 0.0f;
+    if (k >= 2750 && k < 2850) return 4095;
+    return (uint16_t)(mm * MM_TO_RAW);
+}
+
+int main(void) {
+    static uint32_t slots[PATTERN_MAX_SLOTS];
+    static controller_t ctrl;
+    uint32_t played[PATTERN_COUNT] = { 0 }, writes_before, restarts_before;
+
+    // The table, entry by entry
+    for (uint8_t s = 0; s < INDICATOR_STATES; s++) {
+        uint8_t status = s & 3U, up = (s & 4U) != 0, manual = (s & 8U) != 0;
+        indicator_out_t want = ref_out(status, up, manual);
+        const indicator_out_t *got = &indicator_table[INDICATOR_STATE(status, up, manual)];
+        uint8_t pattern_bits = 0;
+        uint32_t n;
+
+        CHECK(got->steady == want.steady && got->pattern == want.pattern);
+        for (uint8_t i = 0; i < patterns[got->pattern].nsteps; i++) pattern_bits |= patterns[got->pattern].steps[i].outputs;
+        CHECK((got->steady & pattern_bits) == 0);
+        n = pattern_expand(&patterns[got->pattern], got->steady, slots, PATTERN_MAX_SLOTS);
+        CHECK(n > 0);
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t set = slots[i] & 0xFFFFU, reset = slots[i] >> 16;
+            CHECK((set | reset) == PINS && (set & reset) == 0);
+            CHECK((set & GPIO_PIN_0) == pin(got->steady & PATTERN_GREEN));
+        }
+    }
+    printf("  %d table entries match the rules; every slot word sets or resets all of PC0-PC3\n", INDICATOR_STATES);
+
+    // The storm, applied as barrier_apply() does
+    pattern_init();
+    apply_egr();
+    CHECK(pattern_current() == PATTERN_OFF && (GPIOC->ODR & PINS) == 0);
+    controller_init(&ctrl, &calib_factory);
+    writes_before = ctrl.indicator.stats.writes;
+    restarts_before = pattern_restarts;
+    for (uint32_t k = 0; k < SLOTS; k++) {
+        uint8_t changed = controller_slot(&ctrl, storm_raw(k));
+
+        if (k == 100 || k == 1300) changed |= controller_dispatch(&ctrl, BEV_IR_UP);
+        if (k == 150 || k == 2200) changed |= controller_dispatch(&ctrl, BEV_IR_ESTOP);
+        if (k == 180 || k == 1350 || k == 2250) changed |= controller_dispatch(&ctrl, BEV_IR_AUTO);
+        if (changed & CTRL_INDICATOR) {
+            pattern_play((pattern_id_t)ctrl.indicator_out->pattern, ctrl.indicator_out->steady);
+            played[ctrl.indicator_out->pattern]++;
+        }
+        apply_egr();
+        CHECK(GPIOC->BSRR == 0);        // the CPU never writes the pins
+
+        const indicator_out_t *want = &indicator_table[INDICATOR_STATE(ctrl.slot.status, barrier_fsm_raised(&ctrl.fsm),
+                                                                       barrier_fsm_manual(&ctrl.fsm))];
+        CHECK(ctrl.indicator_out->steady == want->steady && ctrl.indicator_out->pattern == want->pattern);
+        CHECK(pattern_current() == want->pattern);
+
+        uint8_t pattern_bits = 0;
+        for (uint8_t i = 0; i < patterns[want->pattern].nsteps; i++) pattern_bits |= patterns[want->pattern].steps[i].outputs;
+        for (uint32_t t = 0; t < REPLAY_SLOT_MS; t += PATTERN_SLOT_MS) {
+            uint32_t odr = GPIOC->ODR & PINS;
+            CHECK((odr & GPIO_PIN_0) == pin(want->steady) && (odr & ~pin(pattern_bits | want->steady)) == 0);
+            dma_slot();
+        }
+    }
+    uint32_t writes = ctrl.indicator.stats.writes - writes_before, restarts = pattern_restarts - restarts_before;
+    uint32_t returned = 0;
+    for (uint32_t p = 0; p < PATTERN_COUNT; p++) returned += played[p];
+    CHECK(ctrl.indicator.stats.updates == SLOTS + 7);
+    CHECK(returned == writes && writes == restarts && dma_starts == dma_aborts && dma_starts == egr_writes);
+    for (uint32_t p = 0; p < PATTERN_COUNT; p++) CHECK(played[p] > 0);
+    printf("  storm, %d water slots and 7 IR presses: %u output changes, %u stream restarts, "
+           "each 1 DMA abort + 1 start + 1 EGR write; 0 GPIO writes from the CPU (the per-slot code made %d)\n",
+           SLOTS, writes, restarts, 2 * SLOTS);
+
+    printf("  %s\n", failures ? "FAILED" : "passed");
+    return failures != 0;
+}
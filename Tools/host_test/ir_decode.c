@@ -0,0 +1,170 @@
+// IR remote, edge to barrier action: ir_nec.c decoding edge spacings as
+// the EXTI callback feeds them, ir_keymap.c resolving frames (built-in
+// perfect hash, learned remotes from the calibration block) and the
+// controller's press/hold tracking and dispatch, all unchanged. Also the
+// decode and lookup cost.
+//
+//     ir_decode [W line]      a record packed by Tools/calib.py with learned remotes
+//
+// Built and run by Tools/host_test.py (ir_decode).
+#include "controller.h"
+#include "ir_keymap.h"
+#include "ir_nec.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK(c)    do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define BENCH_FRAMES    200000
+
+static int failures;
+static uint32_t rng = 2463534242U;
+
+static uint32_t xorshift(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+/* +-100 us of capture jitter */
+static int jitter(void) {
+    return (int)(xorshift() % 201) - 100;
+}
+
+/* One frame as edge spacings after an idle gap; the result of its last edge */
+static ir_nec_result_t send(ir_nec_rx_t *rx, uint32_t word) {
+    ir_nec_result_t r = ir_nec_edge(rx, 40000 + jitter());
+
+    r = ir_nec_edge(rx, 13500 + jitter());
+    for (int i = 0; i < 32; i++) r = ir_nec_edge(rx, ((word >> i) & 1 ? 2250 : 1125) + jitter());
+    return r;
+}
+
+static uint8_t lookup(const calib_t *cal, uint32_t word) {
+    ir_frame_t f;
+
+    if (ir_nec_frame(word, &f) != 0) return BARRIER_EVENTS;
+    return ir_keymap_lookup(cal, &f);
+}
+
+static int unhex(uint8_t *p, uint32_t len, const char *s) {
+    unsigned v;
+
+    for (uint32_t i = 0; i < len; i++) {
+        if (sscanf(s + 2 * i, "%2x", &v) != 1) return -1;
+        p[i] = (uint8_t)v;
+    }
+    return 0;
+}
+
+static double elapsed_ns(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) * 1e9 + (b->tv_nsec - a->tv_nsec);
+}
+
+int main(int argc, char **argv) {
+    ir_nec_rx_t rx;
+    controller_t c;
+    calib_t cal = calib_factory;
+    uint8_t cmds[CALIB_IR_KEYS] = { 0x10, 0x11, 0x12, 0x13, 0x14 };
+
+    // Decoder: random frames under jitter, then the ways a frame goes wrong
+    ir_nec_init(&rx);
+    for (int k = 0; k < 1000; k++) {
+        uint32_t word = ir_nec_word((uint16_t)xorshift(), (uint8_t)xorshift());
+        CHECK(send(&rx, word) == IR_NEC_FRAME && rx.word == word);
+    }
+    CHECK(rx.frames == 1000 && rx.errors == 0);
+    CHECK(send(&rx, ir_nec_word(0xFF00, 0x45) ^ 0x01000000U) == IR_NEC_NONE && rx.errors == 1);  // bad complement
+    CHECK(ir_nec_edge(&rx, 11250) == IR_NEC_HOLD);
+    ir_nec_edge(&rx, 13500);                                    // cut short by a new leader
+    for (int i = 0; i < 10; i++) ir_nec_edge(&rx, 1125);
+    CHECK(send(&rx, ir_nec_word(0xFF00, 0x47)) == IR_NEC_FRAME);
+    ir_nec_edge(&rx, 13500);                                    // glitch mid-frame
+    ir_nec_edge(&rx, 300);
+    for (int i = 0; i < 31; i++) CHECK(ir_nec_edge(&rx, 1125) == IR_NEC_NONE);
+    printf("  decoder: %u frames under +-100 us jitter, %u rejected\n", rx.frames, rx.errors);
+
+    // Key map: built-in keys, other keys of a known remote toggle, unknown remotes are ignored
+    for (int i = 0; i < ir_key_count; i++) {
+        CHECK(lookup(&cal, ir_nec_word(ir_keys[i].address, ir_keys[i].command)) == ir_keys[i].event);
+    }
+    CHECK(lookup(&cal, ir_nec_word(0xFF00, 0x16)) == BEV_IR_TOGGLE);
+    CHECK(lookup(&cal, ir_nec_word(0x7F80, 0x47)) == BARRIER_EVENTS);
+    // A learned remote with an extended address, matched ahead of the built-in one
+    cal.ir_remotes = 1;
+    cal.ir[0].address = 0x1234;
+    memcpy(cal.ir[0].command, cmds, sizeof(cmds));
+    for (int k = 0; k < CALIB_IR_KEYS; k++) CHECK(lookup(&cal, ir_nec_word(0x1234, cmds[k])) == BEV_IR_UP + k);
+    CHECK(lookup(&cal, ir_nec_word(0x1234, 0x55)) == BEV_IR_TOGGLE);
+    CHECK(lookup(&cal, ir_nec_word(0xFF00, 0x45)) == BEV_IR_DOWN);
+
+    // Press and hold: one event per press, repeat codes and resent frames keep it held
+    controller_init(&c, &cal);
+    uint32_t up = ir_nec_word(0xFF00, 0x47), t = 1000;
+    CHECK(controller_ir_event(&c, IR_NEC_REPEAT, t) == CTRL_NO_EVENT);        // repeat with no press
+    CHECK(controller_ir_event(&c, up, t) == BEV_IR_UP);
+    for (int i = 0; i < 20; i++) CHECK(controller_ir_event(&c, IR_NEC_REPEAT, t += 108) == CTRL_NO_EVENT);
+    CHECK(controller_ir_event(&c, up, t += 108) == CTRL_NO_EVENT);            // resent while held
+    CHECK(controller_ir_event(&c, up, t += 400) == BEV_IR_UP);                // a new press
+    CHECK(controller_ir_event(&c, ir_nec_word(0xFF00, 0x45), t += 50) == BEV_IR_DOWN);
+    CHECK(controller_ir_event(&c, IR_NEC_REPEAT, t += 50) == CTRL_NO_EVENT);
+    CHECK(controller_ir_event(&c, ir_nec_word(0x1234, 0x14), t += 500) == BEV_IR_ESTOP);
+    CHECK(controller_ir_event(&c, ir_nec_word(0x7F80, 0x14), t += 500) == CTRL_NO_EVENT);
+
+    // Edge to action, as the EXTI callback and ir_command_work() chain them
+    controller_init(&c, &cal);
+    ir_nec_init(&rx);
+    t = 5000;
+    CHECK(send(&rx, ir_nec_word(0xFF00, 0x47)) == IR_NEC_FRAME);
+    uint8_t ev = controller_ir_event(&c, rx.word, t);
+    uint8_t changed = ev == CTRL_NO_EVENT ? 0 : controller_dispatch(&c, ev);
+    CHECK(ev == BEV_IR_UP && (changed & CTRL_SERVO) && c.fsm.barrier_up && c.fsm.state == BARRIER_MANUAL);
+    CHECK(ir_nec_edge(&rx, 11250) == IR_NEC_HOLD && controller_ir_event(&c, IR_NEC_REPEAT, t += 108) == CTRL_NO_EVENT);
+    CHECK(send(&rx, ir_nec_word(0xFF00, 0x45)) == IR_NEC_FRAME);
+    ev = controller_ir_event(&c, rx.word, t += 300);
+    changed = ev == CTRL_NO_EVENT ? 0 : controller_dispatch(&c, ev);
+    CHECK(ev == BEV_IR_DOWN && (changed & CTRL_SERVO) && !c.fsm.barrier_up);
+    printf("  key map, hold tracking and edge-to-servo path checked\n");
+
+    // A record as Tools/calib.py --learn stores it
+    if (argc > 1) {
+        calib_record_t rec;
+        calib_t learned;
+        CHECK(strncmp(argv[1], "W ", 2) == 0 && unhex((uint8_t *)&rec, sizeof(rec), argv[1] + 2) == 0);
+        CHECK(calib_check(&rec) == CALIB_OK);
+        calib_apply(&learned, &rec);
+        CHECK(learned.ir_remotes == 2 && lookup(&learned, ir_nec_word(learned.ir[1].address, learned.ir[1].command[4])) == BEV_IR_ESTOP);
+        rec.ir_remotes = CALIB_IR_REMOTES + 1;
+        calib_seal(&rec);
+        CHECK(calib_check(&rec) == CALIB_ERR_RANGE);
+        printf("  calib.py record: %u learned remotes, remote 1 e-stop resolves\n", learned.ir_remotes);
+    }
+
+    // Cost: a whole frame through the decoder, and one lookup
+    static uint16_t spacing[BENCH_FRAMES / 100][33];
+    struct timespec a, b;
+    volatile uint32_t sink = 0;
+    ir_frame_t frames[256];
+    for (int k = 0; k < BENCH_FRAMES / 100; k++) {
+        uint32_t w = ir_nec_word(0xFF00, (uint8_t)xorshift());
+        spacing[k][0] = 13500;
+        for (int i = 0; i < 32; i++) spacing[k][i + 1] = (w >> i) & 1 ? 2250 : 1125;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (int n = 0; n < BENCH_FRAMES; n++) {
+        const uint16_t *s = spacing[n % (BENCH_FRAMES / 100)];
+        for (int i = 0; i < 33; i++) sink += ir_nec_edge(&rx, s[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    double decode_ns = elapsed_ns(&a, &b) / BENCH_FRAMES;
+    for (int i = 0; i < 256; i++) ir_nec_frame(ir_nec_word(0xFF00, (uint8_t)i), &frames[i]);
+    cal.ir_remotes = 0;
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (int n = 0; n < 10 * BENCH_FRAMES; n++) sink += ir_keymap_lookup(&cal, &frames[n & 255]);
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    printf("  decode %.0f ns per frame (33 edges), lookup %.1f ns (built-in keys)\n",
+           decode_ns, elapsed_ns(&a, &b) / (10.0 * BENCH_FRAMES));
+    printf("  %s\n", failures ? "FAILED" : "passed");
+    return failures != 0;
+}
@@ -0,0 +1,21 @@
+#ifndef __HOST_LCD_HAL_H__
+#define __HOST_LCD_HAL_H__
+
+// Host stand-in for the I2C and delay calls lcd_i2c.c makes, ahead of the
+// replay one (which it includes for DWT). lcd_init_test.c implements them
+// over a millisecond clock, recording each transfer and each delay.
+#include_next "stm32f4xx_hal.h"
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+
+typedef struct {
+    void *Instance;
+} I2C_HandleTypeDef;
+
+#define HAL_MAX_DELAY               0xFFFFFFFFU
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t addr, uint8_t *data, uint16_t size,
+                                          uint32_t timeout);
+void HAL_Delay(uint32_t ms);
+
+#endif // __HOST_LCD_HAL_H__
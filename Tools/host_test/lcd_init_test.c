@@ -0,0 +1,127 @@
+// LCD init: lcd_i2c.c unchanged, its I2C transfers and HAL_Delay() on a
+// millisecond clock (Tools/host_test/lcd), each transfer taking its time
+// at 100 kHz. The HD44780 sequence is run three ways: stepped as
+// lcd_boot_work() in main.c does it (a one-shot osTimer of wait + 1 ticks,
+// 1 ms each, between steps), by the blocking lcd_init(), and by the
+// blocking lcd_init() from before the table, kept here as the reference.
+// All three must send the same transfers in the same order; lcd_init()
+// must make the reference's delays; every gap between two transfers on the
+// stepped path must be at least the delay the reference makes there. Once
+// done, lcd_init_step() sends nothing more.
+//
+// Built and run by Tools/host_test.py (lcd_init).
+#include "i2c-lcd.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CHECK(c)        do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define MAX_XFERS       32
+#define I2C_MS_PER_BYTE (9.0 / 100.0)       // 9 bits at 100 kHz
+
+typedef struct {
+    uint32_t n, delays;
+    uint8_t bytes[MAX_XFERS][4];
+    uint8_t len[MAX_XFERS];
+    double start[MAX_XFERS], end[MAX_XFERS];
+    uint32_t delay_before[MAX_XFERS];       // HAL_Delay() ms since the transfer before
+    uint32_t delay_total;
+} run_t;
+
+I2C_HandleTypeDef hi2c1;
+void lcd_send_raw_cmd(uint8_t cmd);     // lcd_i2c.c, not in its header
+
+static int failures;
+static double now_ms;
+static run_t *rec;
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t addr, uint8_t *data, uint16_t size,
+                                          uint32_t timeout) {
+    (void)timeout;
+    CHECK(hi2c == &hi2c1 && addr == LCD_I2C_ADDR && size <= 4 && rec->n < MAX_XFERS);
+    memcpy(rec->bytes[rec->n], data, size);
+    rec->len[rec->n] = (uint8_t)size;
+    rec->start[rec->n] = now_ms;
+    now_ms += (1 + size) * I2C_MS_PER_BYTE;             // address byte, then the data
+    rec->end[rec->n] = now_ms;
+    rec->n++;
+    rec->delay_before[rec->n] = 0;
+    return HAL_OK;
+}
+
+void HAL_Delay(uint32_t ms) {
+    rec->delay_before[rec->n] += ms;
+    rec->delay_total += ms;
+    rec->delays++;
+    now_ms += ms;
+}
+
+/* lcd_init() before the table, as it was */
+static void ref_lcd_init(void) {
+    HAL_Delay(100);
+    for (int i = 0; i < 3; i++) {
+        lcd_send_raw_cmd(0x30);
+        HAL_Delay(i == 0 ? 5 : 1);
+    }
+    lcd_send_raw_cmd(0x20); // 4-bit mode
+    HAL_Delay(1);
+
+    lcd_send_cmd(0x28); // Function set: 4-bit, 2-line, 5x8 dots
+    lcd_send_cmd(0x08); // Display off
+    lcd_send_cmd(0x01); // Clear display
+    HAL_Delay(2);
+    lcd_send_cmd(0x06); // Entry mode set: increment, no shift
+    lcd_send_cmd(0x0C); // Display on, cursor off, blink off
+}
+
+static int same_transfers(const run_t *a, const run_t *b) {
+    int same = a->n == b->n;
+
+    for (uint32_t i = 0; same && i < a->n; i++) {
+        same = a->len[i] == b->len[i] && memcmp(a->bytes[i], b->bytes[i], a->len[i]) == 0;
+    }
+    return same;
+}
+
+int main(void) {
+    static run_t stepped, blocking, ref;
+    double margin = 1e9, done_ms;
+    uint32_t steps = 0, wait;
+
+    // Stepped first: lcd_init_step() starts from its table's first entry once.
+    // A one-shot started at t fires on the (wait + 1)th tick after it
+    rec = &stepped;
+    now_ms = 0.37;
+    while ((wait = lcd_init_step()) != 0) {
+        now_ms = (double)(uint32_t)now_ms + wait + 1 + 0.05;   // the work thread picks it up 50 us on
+        steps++;
+    }
+    done_ms = now_ms;
+    CHECK(lcd_init_step() == 0 && stepped.n == 9);
+
+    rec = &blocking;
+    now_ms = 0;
+    lcd_init();
+
+    rec = &ref;
+    now_ms = 0;
+    ref_lcd_init();
+
+    CHECK(same_transfers(&stepped, &ref) && same_transfers(&blocking, &ref));
+    CHECK(blocking.delays == ref.delays && blocking.delay_total == ref.delay_total);
+    for (uint32_t i = 0; i < ref.n; i++) {
+        CHECK(blocking.delay_before[i] == ref.delay_before[i]);
+        if (i > 0) {
+            double gap = stepped.start[i] - stepped.end[i - 1];
+            CHECK(gap >= ref.delay_before[i]);
+            if (ref.delay_before[i] && gap - ref.delay_before[i] < margin) margin = gap - ref.delay_before[i];
+        }
+    }
+    CHECK(ref.delay_before[0] == 100 && stepped.start[0] >= 100);
+    printf("  %u transfers, the same on all three paths; lcd_init() %u delays, %u ms, as before the table\n",
+           ref.n, blocking.delays, blocking.delay_total);
+    printf("  stepped: %u timer steps, ready %.1f ms after start, every wait kept (least margin %.2f ms)\n",
+           steps, done_ms - 0.37, margin);
+
+    printf("  %s\n", failures ? "FAILED" : "passed");
+    return failures != 0;
+}
@@ -0,0 +1,94 @@
+// Level compensation under supply and temperature drift: level_comp.c
+// unchanged, fed 24 h of 10 Hz blocks and a VREFINT/TS pair every tenth
+// block, as adc_scan.c does. VDDA wanders 3.1-3.5 V, the water 5-35 C; the
+// probe's gain drifts by PROBE_A1 per degC and PROBE_A2 per degC^2 from
+// 25 C. A ratiometric probe (fed from VDDA) reads the same counts whatever
+// VDDA is; an absolute one (LEVEL_COMP_ABSOLUTE_PROBE) reads its voltage
+// against the wandering VDDA. The error is the level the counts stand for,
+// against the true one, once the reference averages have settled.
+// Built per probe and K1/K2 by Tools/host_test.py (level_comp).
+#include "level_comp.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifndef PROBE_A1
+#define PROBE_A1        0.0
+#endif
+#ifndef PROBE_A2
+#define PROBE_A2        0.0
+#endif
+#define BLOCKS          864000      // 24 h at 10 Hz
+#define SETTLE_BLOCKS   6000
+#define MM_PER_COUNT    (40.0 / 4095)
+#define MAX_FITTED_MM   0.25        // with K1/K2 fitted to the probe
+
+static uint32_t rng = 12345;
+
+/* Gaussian ADC noise, 0.7 count rms */
+static double noise(void) {
+    double u, v;
+
+    rng = rng * 1664525U + 1013904223U;
+    u = ((rng >> 8) + 1.0) / 16777218.0;
+    rng = rng * 1664525U + 1013904223U;
+    v = ((rng >> 8) + 1.0) / 16777218.0;
+    return 0.7 * sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+static uint16_t adc(double v, double vdda) {
+    long r = lround(v / vdda * 4095 + noise());
+    return r < 0 ? 0 : r > 4095 ? 4095 : (uint16_t)r;
+}
+
+int main(void) {
+    // Factory words of a typical part: VREFINT 1.209 V, sensor 0.758 V at 30 C and 2.5 mV/C
+    const level_comp_factory_t fac = { 1500, 940, 1188 };
+    const double vref_v = 1500 * 3.3 / 4095, ts30_v = 940 * 3.3 / 4095, ts_slope = (1188 - 940) * 3.3 / 4095 / 80;
+    double e_raw_max = 0, e_raw_sum = 0, e_max = 0, e_sum = 0;
+    long n = 0;
+    level_comp_t c;
+    struct timespec a, b;
+    volatile uint32_t sink = 0;
+
+    level_comp_init(&c, &fac);
+    for (long k = 0; k < BLOCKS; k++) {
+        double t = k / 10.0;
+        double vdda = 3.3 + 0.15 * sin(2 * M_PI * t / 3600) + 0.05 * sin(2 * M_PI * t / 600);
+        double temp = 20 + 15 * sin(2 * M_PI * t / 86400), dt = temp - 25;
+        double lin = 2000 + 1500 * sin(2 * M_PI * t / 7200);    // true level, counts at 3.3 V
+        double gain = 1 + PROBE_A1 * dt + PROBE_A2 * dt * dt;
+#if LEVEL_COMP_ABSOLUTE_PROBE
+        double v = lin * 3.3 / 4095 * gain;
+#else
+        double v = lin * vdda / 4095 * gain;
+#endif
+        if (k % 10 == 0) level_comp_ref(&c, adc(vref_v, vdda), adc(ts30_v + ts_slope * (temp - 30), vdda));
+        uint16_t raw = adc(v, vdda), out = level_comp_apply(&c, raw);
+        if (k < SETTLE_BLOCKS) continue;
+        double er = fabs(raw - lin) * MM_PER_COUNT, ec = fabs(out - lin) * MM_PER_COUNT;
+        if (er > e_raw_max) e_raw_max = er;
+        if (ec > e_max) e_max = ec;
+        e_raw_sum += er;
+        e_sum += ec;
+        n++;
+    }
+
+    uint32_t refs = c.refs, rejects = c.rejects;
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (int i = 0; i < 10000000; i++) sink += level_comp_apply(&c, (uint16_t)(i & 4095));
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    double apply_ns = ((b.tv_sec - a.tv_sec) * 1e9 + (b.tv_nsec - a.tv_nsec)) / 1e7;
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (int i = 0; i < 10000000; i++) level_comp_ref(&c, 1480 + (i & 15), 930 + (i & 7));
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    double ref_ns = ((b.tv_sec - a.tv_sec) * 1e9 + (b.tv_nsec - a.tv_nsec)) / 1e7;
+
+    printf("  %-11s K1 %+.1e K2 %+.1e: raw max %.2f mean %.2f mm, compensated max %.2f mean %.2f mm"
+           " (%u refs, %u rejected; apply %.1f ns, ref %.1f ns)\n",
+           LEVEL_COMP_ABSOLUTE_PROBE ? "absolute" : "ratiometric", LEVEL_COMP_K1, LEVEL_COMP_K2,
+           e_raw_max, e_raw_sum / n, e_max, e_sum / n, refs, rejects, apply_ns, ref_ns);
+    if (rejects != 0 || (LEVEL_COMP_K1 != 0.0 && e_max > MAX_FITTED_MM)) return 1;
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Sliding median: median_filter.c unchanged, q15 and f32, against a window
+// re-sorted every sample with arm_sort_f32 (insertion and quick sort, the
+// CMSIS-DSP way to a median). Every output must equal the middle of the
+// re-sorted window, over random samples with plenty of ties; the cost per
+// sample is reported for window sizes from the spike filter's up.
+//
+// Built and run by Tools/host_test.py (median).
+#include "median_filter.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK(c)    do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define SAMPLES     20000
+#define REPEATS     10
+
+static int failures;
+static uint32_t rng = 2463534242U;
+
+static uint32_t xorshift(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static double elapsed_ns(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) * 1e9 + (b->tv_nsec - a->tv_nsec);
+}
+
+/* ns per sample of re-sorting a zero-started window after every sample; the medians into ref */
+static double resort(const arm_sort_instance_f32 *sort, const float32_t *x, float32_t *ref, uint16_t n) {
+    float32_t win[MEDIAN_MAX_WINDOW], sorted[MEDIAN_MAX_WINDOW];
+    struct timespec a, b;
+
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (int k = 0; k < REPEATS; k++) {
+        uint16_t h = 0;
+        memset(win, 0, sizeof(win));
+        for (int i = 0; i < SAMPLES; i++) {
+            win[h] = x[i];
+            h = h + 1 == n ? 0 : h + 1;
+            arm_sort_f32(sort, win, sorted, n);
+            ref[i] = sorted[n / 2];
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    return elapsed_ns(&a, &b) / (REPEATS * SAMPLES);
+}
+
+int main(void) {
+    static float32_t x[SAMPLES], y[SAMPLES], ref[SAMPLES], state[2 * MEDIAN_MAX_WINDOW];
+    static q15_t xq[SAMPLES], yq[SAMPLES], state_q[2 * MEDIAN_MAX_WINDOW];
+    static const uint16_t windows[] = { 1, 5, 7, 9, 15, 31, 63, 127, MEDIAN_MAX_WINDOW };
+    arm_sort_instance_f32 insertion, quick;
+    median_instance_f32 S;
+    median_instance_q15 Q;
+    struct timespec a, b;
+
+    for (int i = 0; i < SAMPLES; i++) {
+        x[i] = (float32_t)(xorshift() % 200) - 100.0f;      // ties in every window past a few samples
+        xq[i] = (q15_t)(xorshift() % 4096);
+    }
+    arm_sort_init_f32(&insertion, ARM_SORT_INSERTION, ARM_SORT_ASCENDING);
+    arm_sort_init_f32(&quick, ARM_SORT_QUICK, ARM_SORT_ASCENDING);
+    CHECK(median_init_f32(&S, 4, state) == ARM_MATH_ARGUMENT_ERROR);
+    CHECK(median_init_q15(&Q, MEDIAN_MAX_WINDOW + 2, state_q) == ARM_MATH_ARGUMENT_ERROR);
+
+    for (unsigned w = 0; w < sizeof(windows) / sizeof(windows[0]); w++) {
+        uint16_t n = windows[w];
+        uint32_t bad = 0, bad_q = 0;
+
+        clock_gettime(CLOCK_MONOTONIC, &a);
+        for (int k = 0; k < REPEATS; k++) {
+            median_init_f32(&S, n, state);
+            median_f32(&S, x, y, SAMPLES);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &b);
+        double median_ns = elapsed_ns(&a, &b) / (REPEATS * SAMPLES);
+        double quick_ns = resort(&quick, x, ref, n);
+        double insertion_ns = resort(&insertion, x, ref, n);
+        for (int i = 0; i < SAMPLES; i++) bad += y[i] != ref[i];
+
+        // q15 one sample per call, as the water task feeds it, against the same reference
+        CHECK(median_init_q15(&Q, n, state_q) == ARM_MATH_SUCCESS);
+        for (int i = 0; i < SAMPLES; i++) median_q15(&Q, &xq[i], &yq[i], 1);
+        for (int i = 0; i < SAMPLES; i++) y[i] = (float32_t)xq[i];
+        resort(&insertion, y, ref, n);
+        for (int i = 0; i < SAMPLES; i++) bad_q += (float32_t)yq[i] != ref[i];
+        CHECK(bad == 0 && bad_q == 0);
+
+        printf("  N=%3u median %6.1f ns/sample, re-sort: insertion %7.1f quick %7.1f (%u/%u mismatches)\n",
+               n, median_ns, insertion_ns, quick_ns, bad, bad_q);
+    }
+    printf("  %s\n", failures ? "FAILED" : "passed");
+    return failures != 0;
+}
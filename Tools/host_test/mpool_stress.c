@@ -0,0 +1,251 @@
+// osMemoryPool free list under contention: freertos_mpool.h unchanged, its
+// host (C11 compare-exchange) pop and push hammered by threads that take
+// and return blocks at random, scribbling over each block they hold as a
+// user would over the link. Ownership is tracked per block: a block handed
+// to two holders at once, or a free list that does not hold every block
+// exactly once at the end, fails. Per-call latency against the same list
+// behind a spinlock. Then interrupts: a signal handler pops and pushes while
+// the main loop is inside a pop or push, as the ADC DMA or USART2 RX handler
+// would preempt a task, returning a block to the top of the list under the
+// interrupted call (the ABA case the head tag is for).
+//
+// Built and run by Tools/host_test.py (mpool).
+#include "freertos_mpool.h"
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CHECK(c)        do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define BLOCK_SIZE      48
+#define MAX_BLOCKS      1000
+#define MAX_THREADS     8
+#define OPS             400000
+#define HELD_MAX        8
+#define ISR_BLOCKS      4
+#define ISR_LOOPS       2000000
+
+typedef struct {
+    uint32_t seed;
+    long n;
+    uint32_t lat[OPS];
+} worker_t;
+
+static int failures, use_lock;
+static MemPool_t mp;
+static uint8_t pool_mem[MEMPOOL_ARR_SIZE(MAX_BLOCKS, BLOCK_SIZE)] __attribute__((aligned(8)));
+static _Atomic int owner[MAX_BLOCKS];
+static _Atomic long ownership_errors;
+static pthread_spinlock_t lock;
+static uint32_t locked_head;                // index + 1, the same links as the pool
+static worker_t workers[MAX_THREADS];
+
+static uint64_t now_ns(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000U + t.tv_nsec;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+static int block_index(const void *b) {
+    return (int)(((const uint8_t *)b - mp.mem_arr) / mp.bl_step);
+}
+
+static void *locked_pop(void) {
+    void *b = NULL;
+
+    pthread_spin_lock(&lock);
+    if (locked_head != 0) {
+        b = mp.mem_arr + mp.bl_step * (locked_head - 1);
+        locked_head = ((MemPoolBlock_t *)b)->next;
+    }
+    pthread_spin_unlock(&lock);
+    return b;
+}
+
+static void locked_push(void *b) {
+    pthread_spin_lock(&lock);
+    ((MemPoolBlock_t *)b)->next = locked_head;
+    locked_head = (uint32_t)block_index(b) + 1;
+    pthread_spin_unlock(&lock);
+}
+
+static void take(void *b, uint8_t fill) {
+    int expected = 0;
+
+    if (!atomic_compare_exchange_strong(&owner[block_index(b)], &expected, 1)) ownership_errors++;
+    memset(b, fill, BLOCK_SIZE);
+}
+
+static void give(void *b) {
+    int expected = 1;
+
+    if (!atomic_compare_exchange_strong(&owner[block_index(b)], &expected, 0)) ownership_errors++;
+}
+
+static void *worker(void *arg) {
+    worker_t *w = arg;
+    void *held[HELD_MAX];
+    int n_held = 0;
+
+    for (long i = 0; i < OPS; i++) {
+        w->seed ^= w->seed << 13;
+        w->seed ^= w->seed >> 17;
+        w->seed ^= w->seed << 5;
+        uint64_t t0 = now_ns();
+        if (n_held < HELD_MAX && (n_held == 0 || (w->seed & 1))) {
+            void *b = use_lock ? locked_pop() : MemPoolPop(&mp);
+            w->lat[w->n++] = (uint32_t)(now_ns() - t0);
+            if (b == NULL) continue;
+            take(b, (uint8_t)w->seed);
+            held[n_held++] = b;
+        } else {
+            void *b = held[--n_held];
+            give(b);
+            t0 = now_ns();
+            if (use_lock) locked_push(b);
+            else MemPoolPush(&mp, b);
+            w->lat[w->n++] = (uint32_t)(now_ns() - t0);
+        }
+    }
+    while (n_held > 0) {
+        void *b = held[--n_held];
+        give(b);
+        if (use_lock) locked_push(b);
+        else MemPoolPush(&mp, b);
+    }
+    return NULL;
+}
+
+static void pool_init(uint32_t blocks) {
+    mp.mem_arr = pool_mem;
+    mp.bl_cnt = blocks;
+    mp.bl_sz = BLOCK_SIZE;
+    mp.bl_step = MEMPOOL_BL_STEP(BLOCK_SIZE);
+    mp.mem_sz = MEMPOOL_ARR_SIZE(blocks, BLOCK_SIZE);
+    MemPoolInitList(&mp);
+    locked_head = mp.head & MPOOL_HEAD_IDX_MSK;
+    memset(owner, 0, sizeof(owner));
+}
+
+/* Blocks on the free list, each seen once; -1 if one repeats */
+static int list_count(uint32_t head) {
+    static uint8_t seen[MAX_BLOCKS];
+    int n = 0;
+
+    memset(seen, 0, sizeof(seen));
+    for (uint32_t i = head; i != 0; i = ((MemPoolBlock_t *)(mp.mem_arr + mp.bl_step * (i - 1)))->next) {
+        if (i > mp.bl_cnt || seen[i - 1]++) return -1;
+        n++;
+    }
+    return n;
+}
+
+static void run_threads(uint32_t blocks, int threads, int locked) {
+    static uint32_t all[MAX_THREADS * OPS];
+    pthread_t th[MAX_THREADS];
+    long total = 0;
+
+    pool_init(blocks);
+    use_lock = locked;
+    ownership_errors = 0;
+    for (int i = 0; i < threads; i++) {
+        workers[i].seed = 2463534242U + 7919U * (uint32_t)i;
+        workers[i].n = 0;
+        pthread_create(&th[i], NULL, worker, &workers[i]);
+    }
+    for (int i = 0; i < threads; i++) pthread_join(th[i], NULL);
+    int listed = list_count(locked ? locked_head : (mp.head & MPOOL_HEAD_IDX_MSK));
+    CHECK(ownership_errors == 0 && listed == (int)blocks);
+
+    for (int i = 0; i < threads; i++) {
+        memcpy(all + total, workers[i].lat, workers[i].n * sizeof(all[0]));
+        total += workers[i].n;
+    }
+    qsort(all, total, sizeof(all[0]), cmp_u32);
+    printf("  %-9s %4u blocks %d threads: %ld ownership errors, list %d/%u, p50 %3u p99 %4u p99.99 %5u ns\n",
+           locked ? "spinlock" : "lock-free", blocks, threads, (long)ownership_errors, listed, blocks,
+           all[total / 2], all[(long)(total * 0.99)], all[(long)(total * 0.9999)]);
+}
+
+// Interrupt analogue: the handler takes two blocks, returns the first (back
+// on top: the head index the interrupted call read), then the second, then
+// cycles one more. owner[] is only touched with the main loop preempted or
+// between its own calls, so plain counts suffice.
+static volatile long irqs, isr_errors;
+static volatile int isr_owner[ISR_BLOCKS];
+
+static void isr_take(void *b) {
+    if (isr_owner[block_index(b)]++ != 0) isr_errors++;
+    memset(b, 0xA5, BLOCK_SIZE);
+}
+
+static void isr_give(void *b) {
+    if (--isr_owner[block_index(b)] != 0) isr_errors++;
+}
+
+static void isr(int sig) {
+    (void)sig;
+    irqs++;
+    void *a = MemPoolPop(&mp), *b = MemPoolPop(&mp);
+    if (a != NULL) isr_take(a);
+    if (b != NULL) isr_take(b);
+    if (a != NULL) {
+        isr_give(a);
+        MemPoolPush(&mp, a);
+    }
+    if (b != NULL) {
+        isr_give(b);
+        MemPoolPush(&mp, b);
+    }
+    if (a != NULL && b != NULL) {
+        void *c = MemPoolPop(&mp);
+        isr_take(c);
+        isr_give(c);
+        MemPoolPush(&mp, c);
+    }
+}
+
+static void run_isr(void) {
+    struct itimerval every = { { 0, 7 }, { 0, 7 } }, off = { { 0, 0 }, { 0, 0 } };
+
+    pool_init(ISR_BLOCKS);
+    signal(SIGALRM, isr);
+    setitimer(ITIMER_REAL, &every, NULL);
+    for (long i = 0; i < ISR_LOOPS && isr_errors == 0; i++) {
+        void *b = MemPoolPop(&mp);
+        if (b == NULL) continue;
+        isr_take(b);
+        isr_give(b);
+        MemPoolPush(&mp, b);
+    }
+    setitimer(ITIMER_REAL, &off, NULL);
+    signal(SIGALRM, SIG_DFL);
+    int listed = list_count(mp.head & MPOOL_HEAD_IDX_MSK);
+    CHECK(isr_errors == 0 && listed == ISR_BLOCKS && irqs > 0);
+    printf("  interrupts: %ld during %d pop/push pairs on %d blocks, %ld ownership errors, list %d/%d\n",
+           (long)irqs, ISR_LOOPS, ISR_BLOCKS, (long)isr_errors, listed, ISR_BLOCKS);
+}
+
+int main(void) {
+    static const struct { uint32_t blocks; int threads; } runs[] = { { 4, 4 }, { 4, 8 }, { 64, 8 }, { 1000, 4 } };
+
+    pthread_spin_init(&lock, PTHREAD_PROCESS_PRIVATE);
+    printf("  %ld CPUs online%s\n", sysconf(_SC_NPROCESSORS_ONLN),
+           sysconf(_SC_NPROCESSORS_ONLN) > 1 ? "" : ": threads interleave by preemption only");
+    for (unsigned i = 0; i < sizeof(runs) / sizeof(runs[0]); i++) {
+        run_threads(runs[i].blocks, runs[i].threads, 0);
+        run_threads(runs[i].blocks, runs[i].threads, 1);
+    }
+    run_isr();
+    printf("  %s\n", failures ? "FAILED" : "passed");
+    return failures != 0;
+}
@@ -0,0 +1,210 @@
+// Int8 runtime: nn_runtime.c and the flood-risk model unchanged, on the
+// CMSIS-NN C kernels. Each input line (ten int8 features) is run through
+// the model and through the model cut before its softmax; logits and
+// probabilities go to the dump for Tools/host_test.py to compare bit for
+// bit with the trainer's integer forward pass. Here: the arena plan of the
+// model and of random FC chains is checked (4-byte aligned, inside
+// arena_used, no two buffers live at once overlapping, no larger than the
+// tensors live at its busiest layer need twice over), nn_run() must leave
+// the arena past arena_used untouched, models over the build limits are
+// refused, and the time per inference is measured.
+//
+//     nn_runtime_test <inputs> <dump>
+//
+// Built and run by Tools/host_test.py (nn_runtime).
+#include "flood_risk.h"
+#include "nn_runtime.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK(c)        do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define CANARY          0x5A
+#define MAX_WIDTH       64
+#define RANDOM_MODELS   2000
+#define BENCH_MS        200
+
+static int failures;
+static uint32_t rng = 2463534242U;
+
+static uint32_t xorshift(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static double elapsed_ns(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) * 1e9 + (b->tv_nsec - a->tv_nsec);
+}
+
+/* Every planned buffer: offset, bytes and the layers it is live for */
+typedef struct {
+    uint16_t off, size;
+    uint8_t first, last;
+} plan_buf_t;
+
+static uint32_t plan_bufs(const nn_instance_t *S, plan_buf_t *b) {
+    const nn_model_t *m = S->model;
+    uint32_t n = 0;
+
+    for (uint8_t t = 0; t < m->num_tensors; t++) {
+        if (t == m->input || t == m->output) continue;
+        b[n].off = S->tensor_off[t];
+        b[n].size = (m->tensors[t].size + 3U) & ~3U;
+        b[n].first = 0xFF;
+        b[n].last = 0;
+        for (uint8_t i = 0; i < m->num_layers; i++) {
+            if (m->layers[i].out == t && b[n].first == 0xFF) b[n].first = i;
+            if (m->layers[i].in == t || m->layers[i].out == t) b[n].last = i;
+        }
+        n++;
+    }
+    for (uint8_t i = 0; i < m->num_layers; i++) {
+        if (S->scratch_size[i] == 0) continue;
+        b[n].off = S->scratch_off[i];
+        b[n].size = (S->scratch_size[i] + 3U) & ~3U;
+        b[n].first = b[n].last = i;
+        n++;
+    }
+    return n;
+}
+
+/* 1 if the plan is sound; *live_peak: bytes live at the busiest layer */
+static int plan_ok(const nn_instance_t *S, uint32_t *live_peak) {
+    plan_buf_t b[NN_MAX_TENSORS + NN_MAX_LAYERS];
+    uint32_t n = plan_bufs(S, b), end = 0;
+    int ok = S->stats.arena_used <= NN_ARENA_BYTES;
+
+    *live_peak = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        ok &= b[i].off % 4 == 0 && b[i].off + b[i].size <= S->stats.arena_used;
+        if (b[i].off + b[i].size > end) end = b[i].off + b[i].size;
+        for (uint32_t j = 0; j < i; j++) {
+            if (b[i].last < b[j].first || b[j].last < b[i].first) continue;
+            ok &= b[i].off + b[i].size <= b[j].off || b[j].off + b[j].size <= b[i].off;
+        }
+    }
+    for (uint8_t l = 0; l < S->model->num_layers; l++) {
+        uint32_t live = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            if (b[i].first <= l && l <= b[i].last) live += b[i].size;
+        }
+        if (live > *live_peak) *live_peak = live;
+    }
+    return ok && end == S->stats.arena_used && S->stats.arena_used <= 2 * *live_peak;
+}
+
+/* nn_run() with the arena past the plan filled: 1 if it stayed so */
+static int run_guarded(nn_instance_t *S, const int8_t *in, int8_t *out) {
+    int ok;
+
+    memset(S->arena + S->stats.arena_used, CANARY, NN_ARENA_BYTES - S->stats.arena_used);
+    ok = nn_run(S, in, out) == 0;
+    for (uint32_t i = S->stats.arena_used; i < NN_ARENA_BYTES; i++) ok &= S->arena[i] == CANARY;
+    return ok;
+}
+
+/* A chain of FC layers and a softmax with random widths, weights and quantisation */
+static void random_chain(nn_model_t *m, nn_tensor_t *tensors, nn_layer_t *layers, int8_t (*w)[MAX_WIDTH * MAX_WIDTH],
+                         int32_t (*bias)[MAX_WIDTH], uint8_t fc) {
+    for (uint8_t t = 0; t <= fc; t++) tensors[t].size = 1 + xorshift() % MAX_WIDTH;
+    tensors[fc + 1].size = tensors[fc].size;
+    for (uint8_t i = 0; i < fc; i++) {
+        for (uint32_t k = 0; k < MAX_WIDTH * MAX_WIDTH; k++) w[i][k] = (int8_t)xorshift();
+        for (uint32_t k = 0; k < MAX_WIDTH; k++) bias[i][k] = (int32_t)(xorshift() % 8192) - 4096;
+        layers[i] = (nn_layer_t){ NN_OP_FULLY_CONNECTED, i, i + 1, w[i], bias[i], (int32_t)(xorshift() % 256) - 128,
+                                  (int32_t)(xorshift() % 256) - 128, 1073741824 + (int32_t)(xorshift() % 1073741824),
+                                  -(int32_t)(xorshift() % 10), -128, 127, 0 };
+    }
+    layers[fc] = (nn_layer_t){ NN_OP_SOFTMAX, fc, fc + 1, NULL, NULL, 0, 0, 1924256235, 23, 0, 0, -248 };
+    *m = (nn_model_t){ tensors, fc + 2, layers, fc + 1, 0, fc + 1 };
+}
+
+int main(int argc, char **argv) {
+    static nn_instance_t S, L;
+    nn_model_t cut = flood_risk_model;
+    int8_t in[FLOOD_RISK_HIST + 2], logits[3], probs[3];
+    uint32_t live, inputs = 0;
+    FILE *fin, *fdump;
+
+    if (argc != 3 || (fin = fopen(argv[1], "r")) == NULL || (fdump = fopen(argv[2], "w")) == NULL) {
+        printf("  usage: nn_runtime_test <inputs> <dump>\n");
+        return 1;
+    }
+
+    // The model, and the same layers without the softmax for the logits
+    cut.num_layers--;
+    cut.output = cut.layers[cut.num_layers - 1].out;
+    cut.num_tensors = cut.output + 1;
+    CHECK(nn_init(&S, &flood_risk_model) == 0 && nn_init(&L, &cut) == 0);
+    CHECK(flood_risk_model.tensors[flood_risk_model.input].size == sizeof(in));
+    CHECK(plan_ok(&S, &live) && plan_ok(&L, &live));
+    plan_ok(&S, &live);
+    printf("  flood-risk model: arena %u of %u bytes, %u live at the busiest layer\n",
+           S.stats.arena_used, NN_ARENA_BYTES, live);
+
+    for (;;) {
+        int v[FLOOD_RISK_HIST + 2];
+        if (fscanf(fin, "%d %d %d %d %d %d %d %d %d %d", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7],
+                   &v[8], &v[9]) != FLOOD_RISK_HIST + 2) break;
+        for (int i = 0; i < FLOOD_RISK_HIST + 2; i++) in[i] = (int8_t)v[i];
+        CHECK(run_guarded(&S, in, probs) && run_guarded(&L, in, logits));
+        fprintf(fdump, "%d %d %d %d %d %d\n", logits[0], logits[1], logits[2], probs[0], probs[1], probs[2]);
+        inputs++;
+    }
+    fclose(fin);
+    fclose(fdump);
+    CHECK(inputs > 0);
+
+    // Random chains: every plan sound, every run inside it
+    uint32_t fits = 0, unsound = 0, worst_ratio_num = 0, worst_ratio_den = 1;
+    for (uint32_t r = 0; r < RANDOM_MODELS; r++) {
+        static nn_tensor_t tensors[NN_MAX_TENSORS];
+        static nn_layer_t layers[NN_MAX_LAYERS];
+        static int8_t w[NN_MAX_LAYERS][MAX_WIDTH * MAX_WIDTH], x[MAX_WIDTH], y[MAX_WIDTH];
+        static int32_t bias[NN_MAX_LAYERS][MAX_WIDTH];
+        static nn_instance_t R;
+        nn_model_t m;
+
+        random_chain(&m, tensors, layers, w, bias, 1 + xorshift() % (NN_MAX_TENSORS - 2));
+        if (nn_init(&R, &m) != 0) {
+            CHECK(R.model == NULL && nn_run(&R, x, y) == -1);
+            continue;
+        }
+        fits++;
+        for (uint32_t k = 0; k < MAX_WIDTH; k++) x[k] = (int8_t)xorshift();
+        if (!plan_ok(&R, &live) || !run_guarded(&R, x, y)) unsound++;
+        if (R.stats.arena_used * worst_ratio_den > worst_ratio_num * live) {
+            worst_ratio_num = R.stats.arena_used;
+            worst_ratio_den = live;
+        }
+    }
+    CHECK(fits > RANDOM_MODELS / 4 && unsound == 0);
+    printf("  %u random FC chains: %u fit the arena, %u unsound, worst %u bytes where %u are live at once\n",
+           RANDOM_MODELS, fits, unsound, worst_ratio_num, worst_ratio_den);
+
+    // Over the build limits: refused, and nn_run() then does nothing
+    nn_model_t big = flood_risk_model;
+    big.num_layers = NN_MAX_LAYERS + 1;
+    CHECK(nn_init(&L, &big) == -1 && L.model == NULL && nn_run(&L, in, probs) == -1);
+
+    // Time per inference
+    struct timespec a, b;
+    uint64_t runs = 0;
+    volatile int8_t sink;
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    do {
+        for (int i = 0; i < 1024; i++, runs++) {
+            in[i % (FLOOD_RISK_HIST + 2)] = (int8_t)i;
+            nn_run(&S, in, probs);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &b);
+    } while (elapsed_ns(&a, &b) < BENCH_MS * 1e6);
+    sink = probs[0];
+    (void)sink;
+    printf("  %u inputs run; inference %.0f ns (10-12-8-3 FC + softmax)\n", inputs, elapsed_ns(&a, &b) / runs);
+
+    printf("  %s\n", failures ? "FAILED" : "passed");
+    return failures != 0;
+}
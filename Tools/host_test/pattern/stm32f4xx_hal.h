@@ -0,0 +1,87 @@
+#ifndef __HOST_PATTERN_HAL_H__
+#define __HOST_PATTERN_HAL_H__
+
+// Host stand-in for the TIM1, DMA2 and GPIOC parts of stm32f4xx_hal.h that
+// alarm_pattern.c uses, ahead of the replay one (which it includes for
+// DWT). Registers are plain words; the test implements the DMA calls,
+// keeping the stream's source and length, and plays the slots into
+// GPIOC->ODR itself as TIM1 update requests would. The source address goes
+// through uint32_t as on the target, so these tests link without PIE.
+#include_next "stm32f4xx_hal.h"
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+
+typedef struct {
+    volatile uint32_t ODR, BSRR;
+} GPIO_TypeDef;
+
+typedef struct {
+    volatile uint32_t CR1, DIER, EGR;
+} TIM_TypeDef;
+
+typedef struct {
+    volatile uint32_t CR;
+} DMA_Stream_TypeDef;
+
+typedef struct {
+    volatile uint32_t CFGR;
+} RCC_TypeDef;
+
+typedef struct {
+    TIM_TypeDef *Instance;
+    struct {
+        uint32_t Prescaler, CounterMode, Period, ClockDivision, RepetitionCounter, AutoReloadPreload;
+    } Init;
+} TIM_HandleTypeDef;
+
+typedef struct {
+    DMA_Stream_TypeDef *Instance;
+    struct {
+        uint32_t Channel, Direction, PeriphInc, MemInc, PeriphDataAlignment, MemDataAlignment, Mode, Priority,
+                 FIFOMode;
+    } Init;
+} DMA_HandleTypeDef;
+
+extern GPIO_TypeDef host_gpioc;
+extern TIM_TypeDef host_tim1;
+extern DMA_Stream_TypeDef host_dma2_stream5;
+extern RCC_TypeDef host_rcc;
+
+#define GPIOC                       (&host_gpioc)
+#define TIM1                        (&host_tim1)
+#define DMA2_Stream5                (&host_dma2_stream5)
+#define RCC                         (&host_rcc)
+
+#define GPIO_PIN_0                  0x0001U
+#define GPIO_PIN_1                  0x0002U
+#define GPIO_PIN_2                  0x0004U
+#define GPIO_PIN_3                  0x0008U
+#define RCC_CFGR_PPRE2              0xE000U
+#define RCC_CFGR_PPRE2_DIV1         0x0000U
+#define TIM_EGR_UG                  0x1U
+#define TIM_DMA_UPDATE              0x100U
+#define TIM_COUNTERMODE_UP          0U
+#define TIM_CLOCKDIVISION_DIV1      0U
+#define TIM_AUTORELOAD_PRELOAD_ENABLE   0x80U
+#define DMA_CHANNEL_6               0x0C000000U
+#define DMA_MEMORY_TO_PERIPH        0x40U
+#define DMA_PINC_DISABLE            0U
+#define DMA_MINC_ENABLE             0x400U
+#define DMA_PDATAALIGN_WORD         0x1000U
+#define DMA_MDATAALIGN_WORD         0x4000U
+#define DMA_CIRCULAR                0x100U
+#define DMA_PRIORITY_LOW            0U
+#define DMA_FIFOMODE_DISABLE        0U
+
+#define __HAL_RCC_TIM1_CLK_ENABLE()     ((void)0)
+#define __HAL_RCC_DMA2_CLK_ENABLE()     ((void)0)
+#define __HAL_TIM_ENABLE_DMA(h, d)      ((h)->Instance->DIER |= (d))
+#define __HAL_TIM_ENABLE(h)             ((h)->Instance->CR1 |= 1U)
+
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_Start(DMA_HandleTypeDef *hdma, uint32_t src, uint32_t dst, uint32_t n);
+
+#endif // __HOST_PATTERN_HAL_H__
@@ -0,0 +1,39 @@
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+// Host stand-in for Core/Inc/FreeRTOSConfig.h: enough of the kernel
+// configuration to build stream_buffer.c, the heaps and the memory pool on
+// the host, with the firmware's heap size. There is no scheduler;
+// rtos_host.c stands in for the task calls those files make. A failed
+// configASSERT reports where and aborts.
+#include <stdio.h>
+#include <stdlib.h>
+
+#define configUSE_PREEMPTION                    1
+#define configUSE_IDLE_HOOK                     0
+#define configUSE_TICK_HOOK                     0
+#define configTICK_RATE_HZ                      ((TickType_t)1000)
+#define configMAX_PRIORITIES                    56
+#define configMINIMAL_STACK_SIZE                ((uint16_t)128)
+#define configUSE_16_BIT_TICKS                  0
+#define configUSE_TASK_NOTIFICATIONS            1
+#define configUSE_MUTEXES                       1
+#define configSUPPORT_STATIC_ALLOCATION         1
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+
+// -DHOST_HEAP_SIZE=n to try another heap; the TLSF classes follow it
+#ifndef HOST_HEAP_SIZE
+#define HOST_HEAP_SIZE                          15360
+#endif
+#define configTOTAL_HEAP_SIZE                   ((size_t)HOST_HEAP_SIZE)
+#if HOST_HEAP_SIZE < (1 << 14)
+#define configTLSF_FL_INDEX_MAX                 14
+#else
+#define configTLSF_FL_INDEX_MAX                 20
+#endif
+
+#define configASSERT(x)     do { if (!(x)) { printf("  ASSERT %s:%d: %s\n", __FILE__, __LINE__, #x); fflush(stdout); abort(); } } while (0)
+
+#endif // FREERTOS_CONFIG_H
@@ -0,0 +1,36 @@
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+// Host port for the stand-in kernel: native word sizes, one thread, no
+// interrupts to mask. Critical sections go through rtos_host.c, which
+// checks they nest and balance.
+#include <stdint.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+#define portSTACK_TYPE                          uint32_t
+#define portBASE_TYPE                           long
+#define portMAX_DELAY                           ((TickType_t)0xFFFFFFFFUL)
+#define portBYTE_ALIGNMENT                      8
+#define portSTACK_GROWTH                        (-1)
+#define portTICK_PERIOD_MS                      ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portPOINTER_SIZE_TYPE                   uintptr_t
+
+void vPortEnterCritical(void);
+void vPortExitCritical(void);
+#define portENTER_CRITICAL()                    vPortEnterCritical()
+#define portEXIT_CRITICAL()                     vPortExitCritical()
+#define portSET_INTERRUPT_MASK_FROM_ISR()       0
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x)    ((void)(x))
+#define portDISABLE_INTERRUPTS()
+#define portENABLE_INTERRUPTS()
+#define portYIELD()
+#define portYIELD_FROM_ISR(x)                   ((void)(x))
+#define portNOP()
+#define portTASK_FUNCTION_PROTO(f, p)           void f(void *p)
+#define portTASK_FUNCTION(f, p)                 void f(void *p)
+
+#endif // PORTMACRO_H
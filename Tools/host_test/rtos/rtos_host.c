@@ -0,0 +1,89 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "rtos_host.h"
+
+// The task calls made by the kernel files built on the host. One thread
+// and no scheduler: a notification is counted, a wait runs the driver's
+// blocked hook (if any) and then times out. The current task is a fixed
+// non-NULL handle, so a blocking call registers itself as the waiter and
+// the other side's call wakes it as with the kernel.
+
+rtos_host_t rtos_host;
+
+void vTaskSuspendAll(void) {
+    rtos_host.suspended++;
+}
+
+BaseType_t xTaskResumeAll(void) {
+    configASSERT(rtos_host.suspended > 0);
+    rtos_host.suspended--;
+    return pdFALSE;
+}
+
+void vPortEnterCritical(void) {
+    rtos_host.critical++;
+}
+
+void vPortExitCritical(void) {
+    configASSERT(rtos_host.critical > 0);
+    rtos_host.critical--;
+}
+
+void vTaskEnterCritical(void) {
+    vPortEnterCritical();
+}
+
+void vTaskExitCritical(void) {
+    vPortExitCritical();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return (TaskHandle_t)&rtos_host;
+}
+
+BaseType_t xTaskGenericNotify(TaskHandle_t task, uint32_t value, eNotifyAction action, uint32_t *previous) {
+    (void)value;
+    (void)action;
+    configASSERT(task != NULL);
+    if (previous != NULL) *previous = 0;
+    rtos_host.notifies++;
+    return pdPASS;
+}
+
+BaseType_t xTaskGenericNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, uint32_t *previous,
+                                     BaseType_t *woken) {
+    (void)value;
+    (void)action;
+    configASSERT(task != NULL);
+    if (previous != NULL) *previous = 0;
+    if (woken != NULL) *woken = pdTRUE;
+    rtos_host.notifies_isr++;
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks) {
+    (void)clear_on_entry;
+    (void)clear_on_exit;
+    (void)value;
+    (void)ticks;
+    if (rtos_host.blocked == NULL) return pdFALSE;
+    uint32_t before = rtos_host.notifies + rtos_host.notifies_isr;
+    rtos_host.blocked();
+    return rtos_host.notifies + rtos_host.notifies_isr != before;
+}
+
+BaseType_t xTaskNotifyStateClear(TaskHandle_t task) {
+    (void)task;
+    return pdFALSE;
+}
+
+void vTaskSetTimeOutState(TimeOut_t *timeout) {
+    timeout->xOverflowCount = 0;
+    timeout->xTimeOnEntering = 0;
+}
+
+BaseType_t xTaskCheckForTimeOut(TimeOut_t *timeout, TickType_t *ticks) {
+    (void)timeout;
+    *ticks = 0;
+    return pdTRUE;
+}
@@ -0,0 +1,20 @@
+#ifndef __RTOS_HOST_H__
+#define __RTOS_HOST_H__
+
+#include <stdint.h>
+
+// What the kernel stand-in saw, for the drivers to check: suspend and
+// critical nesting must be back at zero between calls, notifications are
+// the wakeups a real kernel would have delivered. blocked, when set, runs
+// while a task waits for a notification, as the other side would.
+typedef struct {
+    int suspended;          // vTaskSuspendAll() depth
+    int critical;           // critical section depth
+    uint32_t notifies;      // task notifications given, from tasks
+    uint32_t notifies_isr;  // ... and from ISRs
+    void (*blocked)(void);
+} rtos_host_t;
+
+extern rtos_host_t rtos_host;
+
+#endif // __RTOS_HOST_H__
@@ -0,0 +1,72 @@
+// Sensor curve methods: sensor_curve.c, built once per SENSOR_CURVE_MODE
+// with a table fitted from Tools/host_test/sensor_curve_points.csv (bench
+// points of the synthetic S-shaped sensor below). Reports the error against
+// the true curve over the whole 0..4095 sweep, the conversion time against
+// the straight formula it replaces and the instance size.
+//
+//     sensor_curve_bench [out.txt]     also write every conversion, one per line,
+//                                      for the comparison with the fit tool
+//
+// Built and run by Tools/host_test.py (sensor_curve).
+#include "sensor_curve.h"
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define SWEEPS      2000
+#define MM_FULL     40.0
+
+static const char *const mode_names[] = { "LINEAR", "SPLINE", "LUT" };
+
+/* Linear counts the sensor reads as, inverting raw = 4095 (u + 0.08 sin 2 pi u) */
+static double truth_lin(int raw) {
+    double lo = 0.0, hi = 1.0;
+
+    for (int i = 0; i < 60; i++) {
+        double u = (lo + hi) / 2;
+        if (4095 * (u + 0.08 * sin(2 * M_PI * u)) < raw) lo = u;
+        else hi = u;
+    }
+    return lo * 4095;
+}
+
+static double elapsed_ns(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) * 1e9 + (b->tv_nsec - a->tv_nsec);
+}
+
+int main(int argc, char **argv) {
+    sensor_curve_instance_t S;
+    struct timespec a, b;
+    volatile float sink = 0.0f;
+    double max_mm = 0.0, sum_mm = 0.0, curve_ns, formula_ns;
+    FILE *out = argc > 1 ? fopen(argv[1], "w") : NULL;
+
+    sensor_curve_init(&S);
+    for (int raw = 0; raw < 4096; raw++) {
+        float lin = sensor_curve(&S, (uint16_t)raw);
+        double e = fabs(lin - truth_lin(raw)) * MM_FULL / 4095;
+        if (e > max_mm) max_mm = e;
+        sum_mm += e;
+        if (out) fprintf(out, "%.6f\n", lin);
+    }
+    if (out) fclose(out);
+
+    // Scrambled order, as noisy samples arrive: no help from a warm neighbour
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (int k = 0; k < SWEEPS; k++) {
+        for (uint32_t r = 0; r < 4096; r++) sink += sensor_curve(&S, (uint16_t)((r * 2654435761U) >> 20));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    curve_ns = elapsed_ns(&a, &b) / (SWEEPS * 4096.0);
+
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (int k = 0; k < SWEEPS; k++) {
+        for (uint32_t r = 0; r < 4096; r++) sink += (float)((r * 2654435761U) >> 20) * (40.0f / 4095.0f);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    formula_ns = elapsed_ns(&a, &b) / (SWEEPS * 4096.0);
+
+    printf("  %-6s %6.1f ns (straight formula %.1f ns), max %.3f mm, mean %.3f mm, instance %zu B\n",
+           mode_names[SENSOR_CURVE_MODE], curve_ns, formula_ns, max_mm, sum_mm / 4096, sizeof(S));
+    return 0;
+}
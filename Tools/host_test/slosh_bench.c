@@ -0,0 +1,127 @@
+// Slosh stage: slosh_filter.c unchanged. A level with 3 mm of slosh (the
+// storm_slosh trace: 1.2 Hz, 0.3 mm of sensor noise) and other frequencies
+// across the search band goes through slosh_filter(); the wave left at its
+// frequency once the notch has locked must be 20 dB down, the level itself
+// must pass at unity gain, and noise alone must not engage the notch. Then
+// the analysis cost per block for every real FFT length (Hann window,
+// arm_rfft_fast_f32, magnitudes, peak search and flatness, as
+// slosh_analyse() does), built with tables for all of them.
+//
+// Built and run by Tools/host_test.py (slosh).
+#include "slosh_filter.h"
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define CHECK(c)        do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define LEVEL_MM        30.0f
+#define SLOSH_MM        3.0f
+#define NOISE_MM        0.3f
+#define SETTLE          (3 * SLOSH_ANALYSE_EVERY * SLOSH_FFT_LEN)   // two analyses to lock and settle
+#define MEASURE         512
+#define MIN_ATTEN_DB    20.0
+#define MAX_FFT_LEN     4096
+#define BENCH_MS        200
+
+static int failures;
+static uint32_t rng = 2463534242U;
+
+static uint32_t xorshift(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static float gauss(void) {
+    float u = ((xorshift() >> 8) + 1.0f) / 16777217.0f, v = (xorshift() >> 8) / 16777216.0f;
+
+    return sqrtf(-2.0f * logf(u)) * cosf(2.0f * PI * v);
+}
+
+/* Amplitude of the hz component of x after its mean is removed */
+static double tone_mm(const float *x, int n, float hz) {
+    double mean = 0.0, re = 0.0, im = 0.0;
+
+    for (int i = 0; i < n; i++) mean += x[i];
+    mean /= n;
+    for (int i = 0; i < n; i++) {
+        double w = 2.0 * M_PI * hz * i / SLOSH_SAMPLE_HZ;
+        re += (x[i] - mean) * cos(w);
+        im += (x[i] - mean) * sin(w);
+    }
+    return 2.0 * sqrt(re * re + im * im) / n;
+}
+
+static double elapsed_ns(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) * 1e9 + (b->tv_nsec - a->tv_nsec);
+}
+
+int main(void) {
+    static const float freqs[] = { 0.5f, 0.8f, 1.0f, 1.2f, 1.6f, 2.0f, 2.5f, 2.9f };
+    static float in[MEASURE], out[MEASURE], block[MAX_FFT_LEN], win[MAX_FFT_LEN], spec[MAX_FFT_LEN];
+    static slosh_instance_t S;
+    slosh_info_t info;
+    volatile float sink;
+
+    // A wave on a steady level: locked, removed, the level untouched
+    for (unsigned k = 0; k < sizeof(freqs) / sizeof(freqs[0]); k++) {
+        float hz = freqs[k];
+        slosh_init(&S);
+        for (int i = 0; i < SETTLE + MEASURE; i++) {
+            float x = LEVEL_MM + SLOSH_MM * sinf(2.0f * PI * hz * i / SLOSH_SAMPLE_HZ) + NOISE_MM * gauss();
+            float y = slosh_filter(&S, x);
+            if (i >= SETTLE) {
+                in[i - SETTLE] = x;
+                out[i - SETTLE] = y;
+            }
+        }
+        slosh_get_info(&S, &info);
+        double mean = 0.0;
+        for (int i = 0; i < MEASURE; i++) mean += out[i];
+        mean /= MEASURE;
+        double left = tone_mm(out, MEASURE, hz), atten = 20.0 * log10(tone_mm(in, MEASURE, hz) / left);
+        CHECK(info.notch_on && fabsf(info.freq_hz - hz) < 0.05f && atten >= MIN_ATTEN_DB);
+        CHECK(fabs(mean - LEVEL_MM) < 0.05);
+        printf("  %.1f Hz slosh: notch at %.3f Hz, %.2f mm left (%.1f dB), level %.2f mm, amplitude read %.2f mm\n",
+               hz, info.freq_hz, left, atten, mean, info.amp_mm);
+    }
+
+    // Sensor noise alone stays under SLOSH_MIN_AMP_MM
+    slosh_init(&S);
+    for (int i = 0; i < SETTLE + MEASURE; i++) slosh_filter(&S, LEVEL_MM + NOISE_MM * gauss());
+    slosh_get_info(&S, &info);
+    CHECK(!info.notch_on);
+    printf("  noise only: notch %s, peak read %.2f mm\n", info.notch_on ? "on" : "off", info.amp_mm);
+
+    // Analysis cost per block, every real FFT length
+    for (int i = 0; i < MAX_FFT_LEN; i++) block[i] = LEVEL_MM + NOISE_MM * gauss();
+    for (uint32_t n = 32; n <= MAX_FFT_LEN; n *= 2) {
+        arm_rfft_fast_instance_f32 fft;
+        struct timespec a, b;
+        float32_t peak, mean;
+        uint32_t bin, blocks = 0;
+        double ns;
+
+        CHECK(arm_rfft_fast_init_f32(&fft, n) == ARM_MATH_SUCCESS);
+        clock_gettime(CLOCK_MONOTONIC, &a);
+        do {
+            for (int r = 0; r < 16; r++, blocks++) {
+                arm_mean_f32(block, n, &mean);
+                for (uint32_t i = 0; i < n; i++) win[i] = (block[i] - mean) * (0.5f - 0.5f * cosf(2.0f * PI * i / (n - 1)));
+                arm_rfft_fast_f32(&fft, win, spec, 0);
+                arm_cmplx_mag_f32(spec, spec, n / 2);
+                arm_max_f32(&spec[1], n / 2 - 1, &peak, &bin);
+                float log_sum = 0.0f;
+                for (uint32_t i = 1; i < n / 2; i++) log_sum += logf(spec[i] * spec[i] + 1e-9f);
+                sink = log_sum + peak;
+            }
+            clock_gettime(CLOCK_MONOTONIC, &b);
+        } while (elapsed_ns(&a, &b) < BENCH_MS * 1e6);
+        ns = elapsed_ns(&a, &b) / blocks;
+        printf("  N=%4u analysis %8.0f ns per block, %5.1f ns per sample%s\n", n, ns, ns / n,
+               n == SLOSH_FFT_LEN ? " (SLOSH_FFT_LEN)" : "");
+    }
+    printf("  %s\n", failures ? "FAILED" : "passed");
+    return failures != 0;
+}
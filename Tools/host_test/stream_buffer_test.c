@@ -0,0 +1,187 @@
+// Stream buffer zero-copy calls: stream_buffer.c unchanged over the host
+// kernel stand-in (Tools/host_test/rtos). A random mix of reserve/commit,
+// peek/consume, send and receive, task and FromISR variants, carries a byte
+// sequence through wrapping spans; trigger-level and space wakeups are
+// checked with the other side running while a call is blocked. Then the
+// cost per 64-byte block, copy API against zero-copy with the block filled
+// and read in place, as uart_tx.c does.
+//
+// Built and run by Tools/host_test.py (stream_buffer).
+#include "FreeRTOS.h"
+#include "rtos_host.h"
+#include "stream_buffer.h"
+#include <string.h>
+#include <time.h>
+
+#define CHECK(c)    do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define RING        1000
+#define OPS         200000
+#define MAX_CHUNK   300
+#define BLOCK       64
+#define BLOCKS      2000000
+#define TRIGGER     16
+
+static int failures;
+static uint32_t rng = 2463534242U;
+static StreamBufferHandle_t sb;
+static uint8_t seq_w, seq_r;
+
+static uint32_t xorshift(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static uint8_t *span_byte(const StreamBufferSpan_t *s, size_t i) {
+    return i < s->xFirstLength ? s->pucFirst + i : s->pucSecond + (i - s->xFirstLength);
+}
+
+/* Reserve up to want, write n of the sequence and commit; n */
+static size_t produce(size_t want, int from_isr) {
+    StreamBufferSpan_t s;
+    BaseType_t woken = pdFALSE;
+    size_t got = from_isr ? xStreamBufferReserveFromISR(sb, want, &s) : xStreamBufferReserve(sb, want, &s, 0);
+    size_t n = got ? xorshift() % (got + 1) : 0;
+
+    CHECK(got == s.xFirstLength + s.xSecondLength && got <= want);
+    CHECK(s.xSecondLength == 0 || s.xFirstLength > 0);
+    for (size_t i = 0; i < n; i++) *span_byte(&s, i) = seq_w++;
+    if (from_isr) vStreamBufferCommitFromISR(sb, n, &woken);
+    else vStreamBufferCommit(sb, n);
+    return n;
+}
+
+/* Peek, check part of what is there against the sequence and consume it */
+static size_t drain(int from_isr) {
+    StreamBufferSpan_t s;
+    BaseType_t woken = pdFALSE;
+    size_t avail = from_isr ? xStreamBufferPeekFromISR(sb, &s) : xStreamBufferPeek(sb, &s, 0);
+    size_t m = avail ? xorshift() % (avail + 1) : 0;
+
+    CHECK(avail == s.xFirstLength + s.xSecondLength && avail == xStreamBufferBytesAvailable(sb));
+    for (size_t i = 0; i < m; i++) {
+        if (*span_byte(&s, i) != seq_r++) {
+            CHECK(!"peeked byte out of sequence");
+            break;
+        }
+    }
+    if (from_isr) vStreamBufferConsumeFromISR(sb, m, &woken);
+    else vStreamBufferConsume(sb, m);
+    return s.xSecondLength;
+}
+
+static void commit_below_trigger(void) {
+    StreamBufferSpan_t s;
+
+    CHECK(xStreamBufferReserve(sb, TRIGGER - 1, &s, 0) == TRIGGER - 1);
+    vStreamBufferCommit(sb, TRIGGER - 1);
+}
+
+static void commit_trigger(void) {
+    StreamBufferSpan_t s;
+
+    CHECK(xStreamBufferReserve(sb, TRIGGER, &s, 0) == TRIGGER);
+    vStreamBufferCommit(sb, TRIGGER);
+}
+
+static void consume_some(void) {
+    StreamBufferSpan_t s;
+
+    CHECK(xStreamBufferPeek(sb, &s, 0) == RING);
+    vStreamBufferConsume(sb, 100);
+}
+
+static double elapsed_ns(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) * 1e9 + (b->tv_nsec - a->tv_nsec);
+}
+
+int main(void) {
+    StreamBufferSpan_t s;
+    uint8_t src[MAX_CHUNK], dst[MAX_CHUNK];
+    uint32_t through = 0, wrapped = 0, n;
+    struct timespec a, b;
+    volatile uint8_t sink;
+
+    // Random mix: the reader and the writer each pick an API per step
+    sb = xStreamBufferCreate(RING, 1);
+    CHECK(sb != NULL);
+    for (int k = 0; k < OPS; k++) {
+        if (xorshift() & 1) {
+            through += produce(xorshift() % MAX_CHUNK, xorshift() & 1);
+        } else {
+            n = 1 + xorshift() % (MAX_CHUNK - 1);          // the copy calls assert on 0 bytes
+            for (uint32_t i = 0; i < n; i++) src[i] = (uint8_t)(seq_w + i);
+            n = xStreamBufferSend(sb, src, n, 0);
+            seq_w += n;
+            through += n;
+        }
+        if (xorshift() & 1) {
+            wrapped += drain(xorshift() & 1) != 0;
+        } else {
+            size_t m = xStreamBufferReceive(sb, dst, 1 + xorshift() % (MAX_CHUNK - 1), 0);
+            for (size_t i = 0; i < m; i++) {
+                if (dst[i] != seq_r++) {
+                    CHECK(!"received byte out of sequence");
+                    break;
+                }
+            }
+        }
+    }
+    CHECK(wrapped > 0 && rtos_host.critical == 0 && rtos_host.suspended == 0);
+    printf("  %u random operations: %u bytes through, %u peeks across the wrap\n", OPS, through, wrapped);
+
+    // Reserve is capped by the free space, an abandoned reservation commits 0
+    xStreamBufferReset(sb);
+    CHECK(xStreamBufferReserve(sb, RING + 50, &s, 0) == RING);
+    vStreamBufferCommit(sb, 0);
+    CHECK(xStreamBufferIsEmpty(sb) == pdTRUE && xStreamBufferPeek(sb, &s, 0) == 0);
+    vStreamBufferDelete(sb);
+
+    // A blocked peek is woken when a commit reaches the trigger level, not before
+    sb = xStreamBufferCreate(RING, TRIGGER);
+    n = rtos_host.notifies;
+    rtos_host.blocked = commit_below_trigger;
+    CHECK(xStreamBufferPeek(sb, &s, 10) == TRIGGER - 1 && rtos_host.notifies == n);
+    vStreamBufferConsume(sb, TRIGGER - 1);
+    rtos_host.blocked = commit_trigger;
+    CHECK(xStreamBufferPeek(sb, &s, 10) == TRIGGER && rtos_host.notifies == n + 1);
+    vStreamBufferConsume(sb, TRIGGER);
+    // ... and a writer blocked on a full ring by the consume that frees space
+    CHECK(xStreamBufferReserve(sb, RING, &s, 0) == RING);
+    vStreamBufferCommit(sb, RING);
+    rtos_host.blocked = consume_some;
+    CHECK(xStreamBufferReserve(sb, 50, &s, 10) == 50 && rtos_host.notifies == n + 2);
+    vStreamBufferCommit(sb, 0);
+    rtos_host.blocked = NULL;
+    CHECK(rtos_host.critical == 0 && rtos_host.suspended == 0);
+    vStreamBufferDelete(sb);
+
+    // Cost per block, an ISR-sized producer and consumer
+    sb = xStreamBufferCreate(RING, 1);
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (int i = 0; i < BLOCKS; i++) {
+        memset(src, i, BLOCK);
+        xStreamBufferSend(sb, src, BLOCK, 0);
+        xStreamBufferReceive(sb, dst, BLOCK, 0);
+        sink = dst[BLOCK - 1];
+    }
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    double copy_ns = elapsed_ns(&a, &b) / BLOCKS;
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (int i = 0; i < BLOCKS; i++) {
+        xStreamBufferReserve(sb, BLOCK, &s, 0);
+        memset(s.pucFirst, i, s.xFirstLength);
+        memset(s.pucSecond, i, s.xSecondLength);
+        vStreamBufferCommit(sb, BLOCK);
+        xStreamBufferPeek(sb, &s, 0);
+        sink = *span_byte(&s, BLOCK - 1);
+        vStreamBufferConsume(sb, BLOCK);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    double zero_ns = elapsed_ns(&a, &b) / BLOCKS;
+    (void)sink;
+    printf("  %d-byte blocks: copy %.1f ns, zero-copy %.1f ns per block\n", BLOCK, copy_ns, zero_ns);
+    printf("  %s\n", failures ? "FAILED" : "passed");
+    return failures != 0;
+}
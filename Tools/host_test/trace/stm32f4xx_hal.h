@@ -0,0 +1,21 @@
+#ifndef __HOST_TRACE_HAL_H__
+#define __HOST_TRACE_HAL_H__
+
+// Host stand-in for the interrupt masking trace_recorder.c does, ahead of
+// the replay one (which it includes for DWT). trace_recorder_test.c keeps
+// PRIMASK as a word and sets DWT->CYCCNT itself, so every event carries
+// the timestamp the test chose.
+#include_next "stm32f4xx_hal.h"
+
+// cmsis_gcc.h has these as Cortex-M asm: taken first, then renamed
+#include "cmsis_compiler.h"
+#define __get_PRIMASK               host_get_primask
+#define __set_PRIMASK               host_set_primask
+#define __disable_irq               host_disable_irq
+#define __enable_irq                host_enable_irq
+uint32_t host_get_primask(void);
+void host_set_primask(uint32_t primask);
+void host_disable_irq(void);
+void host_enable_irq(void);
+
+#endif // __HOST_TRACE_HAL_H__
@@ -0,0 +1,205 @@
+// Trace recorder: trace_recorder.c unchanged, snapshot mode, on the host
+// kernel stand-in. USART2 is the capture file, PRIMASK a word, and the
+// test sets DWT->CYCCNT before each event so every timestamp is known. Two
+// dumps go to the capture for Tools/host_test.py to decode with
+// Tools/trace_decode.py. The first is random events around a trigger,
+// with one frame refused by the UART and events written after the ring
+// froze; the events it must hold go to <expected>. The second is a short
+// schedule across a CYCCNT wrap whose task table host_test.py has worked
+// out by hand. Then the cost of trace_write() per event, against an empty
+// call of the same shape.
+//
+//     trace_recorder_test <capture> <expected>
+//
+// Built and run by Tools/host_test.py (trace_recorder).
+#include "FreeRTOS.h"
+#include "task.h"
+#include "cmsis_os.h"
+#include "stm32f4xx_hal.h"
+#include "trace_recorder.h"
+#include "uart_tx.h"
+#include <setjmp.h>
+#include <stdio.h>
+#include <time.h>
+
+#define CHECK(c)        do { if (!(c)) { printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failures++; } } while (0)
+#define BEFORE          1000        // random events ahead of the trigger
+#define AFTER           300         // ... and after it; TRACE_POST_TRIGGER of them are kept
+#define REFUSED_FRAME   8           // header, four tasks, then the fourth events frame
+#define FRAME_EVENTS    64          // TRACE_PKT_MAX_EVENTS
+#define MS              100000U     // cycles at SystemCoreClock
+#define BENCH_EVENTS    (1 << 16)
+#define BENCH_MS        200
+
+static const struct {
+    uint8_t number, priority;
+    const char *name;
+} tasks[] = { { 1, 0, "IDLE" }, { 2, 40, "water" }, { 3, 24, "control" }, { 4, 1, "trace" } };
+
+static int failures;
+static uint32_t primask, frames;
+static FILE *capture;
+static jmp_buf dumped;
+static trace_event_t written[BEFORE + 1 + AFTER];
+static uint32_t count;
+static uint32_t rng = 2463534242U;
+
+uint32_t host_get_primask(void) { return primask; }
+void host_set_primask(uint32_t p) { primask = p; }
+void host_disable_irq(void) { primask = 1; }
+void host_enable_irq(void) { primask = 0; }
+
+/* Whole frames only; REFUSED_FRAME is turned away as a full TX buffer would */
+int uart_tx_write_bulk(const void *data, uint32_t len, uint32_t timeout_ms) {
+    const uint8_t *b = data;
+
+    (void)timeout_ms;
+    CHECK(len >= 5 && b[0] == 0xA5 && b[1] == 0x5A && len == 5U + (b[3] | b[4] << 8));
+    if (frames++ == REFUSED_FRAME) return -1;
+    fwrite(data, 1, len, capture);
+    return 0;
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *const status, const UBaseType_t size, uint32_t *const total) {
+    UBaseType_t n = 0;
+
+    (void)total;
+    for (; n < sizeof(tasks) / sizeof(tasks[0]) && n < size; n++) {
+        status[n] = (TaskStatus_t){ .pcTaskName = tasks[n].name, .xTaskNumber = tasks[n].number,
+                                    .uxCurrentPriority = tasks[n].priority, .uxBasePriority = tasks[n].priority };
+    }
+    return n;
+}
+
+size_t xPortGetFreeHeapSize(void) { return 4096; }
+size_t xPortGetMinimumEverFreeHeapSize(void) { return 1024; }
+uint32_t osKernelGetTickCount(void) { return 0; }
+
+/* trace_task() checks the ring, then sleeps: back to the test */
+osStatus_t osDelay(uint32_t ticks) {
+    (void)ticks;
+    longjmp(dumped, 1);
+}
+
+static void dump(void) {
+    if (setjmp(dumped) == 0) trace_task(NULL);
+    CHECK(primask == 0);
+}
+
+static uint32_t xorshift(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void event(uint32_t ts, uint8_t type, uint8_t obj, uint16_t arg) {
+    DWT->CYCCNT = ts;
+    trace_write(type, obj, arg);
+    CHECK(primask == 0);
+    written[count++] = (trace_event_t){ ts, type, obj, arg };
+}
+
+static void trigger(uint32_t ts) {
+    DWT->CYCCNT = ts;
+    trace_trigger();
+    written[count++] = (trace_event_t){ ts, TRC_TRIGGER, 0, TRACE_POST_TRIGGER };
+}
+
+static double elapsed_ns(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) * 1e9 + (b->tv_nsec - a->tv_nsec);
+}
+
+static void __attribute__((noinline)) no_trace(uint8_t type, uint8_t obj, uint16_t arg) {
+    __asm__ volatile("" : : "r"(type), "r"(obj), "r"(arg) : "memory");
+}
+
+/* ns per call over at least BENCH_MS */
+static double bench(void (*write)(uint8_t, uint8_t, uint16_t)) {
+    struct timespec a, b;
+    uint64_t n = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    do {
+        for (uint32_t i = 0; i < BENCH_EVENTS; i++) write(TRC_USER, (uint8_t)i, (uint16_t)i);
+        n += BENCH_EVENTS;
+        clock_gettime(CLOCK_MONOTONIC, &b);
+    } while (elapsed_ns(&a, &b) < BENCH_MS * 1e6);
+    return elapsed_ns(&a, &b) / n;
+}
+
+int main(int argc, char **argv) {
+    FILE *expected;
+    uint32_t ts = 0, stop, from;
+
+    if (argc != 3 || (capture = fopen(argv[1], "wb")) == NULL || (expected = fopen(argv[2], "w")) == NULL) {
+        printf("  usage: trace_recorder_test <capture> <expected>\n");
+        return 1;
+    }
+    trace_init();
+    for (uint32_t i = 0; i < sizeof(tasks) / sizeof(tasks[0]); i++) {
+        fprintf(expected, "task %u %u %s\n", tasks[i].number, tasks[i].priority, tasks[i].name);
+    }
+
+    // Nothing to send until a trigger freezes the ring
+    dump();
+    CHECK(frames == 0);
+
+    // Dump 1: random events; the ring keeps the last TRACE_RING_EVENTS up to
+    // TRACE_POST_TRIGGER past the trigger, less the refused frame's
+    for (uint32_t i = 0; i < BEFORE + 1 + AFTER; i++) {
+        ts += 1 + xorshift() % 5000;
+        if (i == BEFORE) {
+            trigger(ts);
+        } else {
+            event(ts, 1 + xorshift() % (TRC_CLOCK - 1), (uint8_t)xorshift(), (uint16_t)xorshift());
+        }
+    }
+    primask = 1;        // from the kernel or an ISR: left masked
+    trace_write(TRC_USER, 0, 0);
+    CHECK(primask == 1);
+    primask = 0;
+    dump();
+    stop = BEFORE + 1 + TRACE_POST_TRIGGER;
+    from = stop - TRACE_RING_EVENTS;
+    for (uint32_t i = from; i < stop; i++) {
+        uint32_t frame = (i - from) / FRAME_EVENTS + 1 + sizeof(tasks) / sizeof(tasks[0]);
+        if (frame == REFUSED_FRAME) continue;
+        fprintf(expected, "event 0 %u %u %u %u\n", written[i].ts, written[i].type, written[i].obj, written[i].arg);
+    }
+    fprintf(expected, "lost 1 %u\n", FRAME_EVENTS);
+    CHECK(trace_frames_dropped == 1);
+    printf("  dump 1: %u random events, trigger after %u, frame %u refused\n", BEFORE + 1 + AFTER, BEFORE,
+           REFUSED_FRAME);
+
+    // Dump 2: IDLE and control (task 3) at 100 MHz, CYCCNT wrapping 2.5 ms in
+    uint32_t t0 = 0U - 250U * MS / 100U;
+    count = 0;
+    event(t0, TRC_OBJ_CREATE, 5, 0);
+    event(t0, TRC_SWITCH_IN, 1, 0);
+    event(t0 + 1 * MS, TRC_READY, 3, 0);
+    event(t0 + 1 * MS, TRC_SWITCH_IN, 3, 0);
+    event(t0 + 3 * MS, TRC_DELAY, 3, 7);
+    event(t0 + 3 * MS, TRC_SWITCH_IN, 1, 0);
+    event(t0 + 10 * MS, TRC_READY, 3, 0);
+    event(t0 + 10 * MS + MS / 2, TRC_SWITCH_IN, 3, 0);
+    event(t0 + 12 * MS, TRC_BLOCK_RECV, 3, 5);
+    event(t0 + 12 * MS, TRC_SWITCH_IN, 1, 0);
+    event(t0 + 20 * MS, TRC_READY, 3, 0);
+    event(t0 + 20 * MS, TRC_SWITCH_IN, 3, 0);
+    trigger(t0 + 21 * MS);
+    event(t0 + 22 * MS, TRC_SWITCH_IN, 1, 0);
+    for (uint32_t i = 1; i < TRACE_POST_TRIGGER; i++) event(t0 + 22 * MS, TRC_USER, 1, (uint16_t)i);
+    dump();
+    printf("  dump 2: %u events of a hand-worked schedule\n", count);
+    fclose(capture);
+    fclose(expected);
+
+    // Cost per event; the ring wraps freely once dumped
+    double ns = bench(trace_write), base = bench(no_trace);
+    printf("  trace_write: %.1f ns per event, %.1f ns over an empty call (host; PRIMASK is a function call here)\n",
+           ns, ns - base);
+
+    printf("  %s\n", failures ? "FAILED" : "passed");
+    return failures != 0;
+}
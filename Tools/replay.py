@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""Replay level traces through the firmware's control code on the host.
+
+Builds Tools/replay/replay.c against the unchanged controller
+(controller.c: level pipeline, barrier_fsm.c, indicator.c) and the
+CMSIS-DSP/NN sources the firmware links
+(STM32CubeIDE/.project), then runs each trace in virtual time: one water
+slot per TASK_WATER_PERIOD_MS of trace time, as fast as the host allows.
+See replay.c for the CSV format (t, raw or mm, optional flood and ir).
+
+    python3 Tools/replay.py storm.csv                   # timeline, then metrics
+    python3 Tools/replay.py Tools/replay/traces/        # every *.csv, one process per core
+    python3 Tools/replay.py traces/ --jobs 4 --timelines out/
+    python3 Tools/replay.py traces/ --strict            # exit 1 on a missed flood too
+
+Metrics per trace: time-to-raise (flood start to barrier up, negative when
+the flood risk model raised ahead of the level; first, max, mean),
+automatic raises without a flood (false raises), floods the barrier
+never rose for (missed), time up and time in SENSOR ERR, and the speed-up
+over real time. A false raise (level, flood risk or a sensor fault
+fail-safe driving the barrier up with no flood) always exits 1.
+"""
+
+import argparse
+import glob
+import multiprocessing
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+CORE_SOURCES = ["controller.c", "water_ctrl.c", "calib.c", "sensor_curve.c", "sensor_curve_table.c",
+                "ir_nec.c", "ir_keymap.c", "ir_keymap_table.c", "median_filter.c", "slosh_filter.c", "sensor_fault.c",
+                "sensor_fault_model.c", "flood_risk.c", "flood_risk_model.c", "nn_runtime.c",
+                "barrier_fsm.c", "indicator.c", "dsp_tables.c"]
+INCLUDES = ["Tools/replay/host", "Core/Inc", "Drivers/CMSIS/Include", "Drivers/CMSIS/DSP/Include",
+            "Drivers/CMSIS/DSP/PrivateInclude", "Drivers/CMSIS/NN/Include"]
+COLUMNS = [("trace", "{}"), ("slots", "{:.0f}"), ("raises", "{:.0f}"), ("false_raises", "{:.0f}"),
+           ("floods", "{:.0f}"), ("missed", "{:.0f}"), ("ttr_first_s", "{:.1f}"),
+           ("ttr_max_s", "{:.1f}"), ("up_s", "{:.0f}"), ("fault_s", "{:.0f}"), ("speedup", "{:.0f}")]
+
+
+def cmsis_sources():
+    """CMSIS-DSP/NN files linked into the firmware, from the CubeIDE project."""
+    text = open(os.path.join(ROOT, "STM32CubeIDE", ".project")).read()
+    return [os.path.join(ROOT, loc) for loc in
+            re.findall(r"<locationURI>PARENT-1-PROJECT_LOC/(Drivers/CMSIS/(?:DSP|NN)/Source/[^<]+\.c)</locationURI>", text)]
+
+
+def slot_ms():
+    text = open(os.path.join(ROOT, "Core", "Inc", "task_model.h")).read()
+    return int(re.search(r"#define\s+TASK_WATER_PERIOD_MS\s+(\d+)", text).group(1))
+
+
+def build(out_dir, cc, main="Tools/replay/replay.c", flags=(), sources=(), includes=(), name=None, core=CORE_SOURCES,
+          deps=(), config="Core/Inc/dsp_config.h"):
+    """Host build of the controller around one driver; reused by fleet.py and host_test.py.
+
+    sources adds repo-relative files (other modules, stubs); includes puts
+    directories of host stand-in headers ahead of the replay's own. name
+    keeps builds of one driver with different flags apart; core swaps the
+    Core/Src list, e.g. for a generated table in place of the checked-in one.
+    deps are files the driver #includes besides headers, so an edit to one
+    rebuilds it. config swaps the pre-included FFT selection (dsp_config.h),
+    e.g. for every size with tables generated to match."""
+    includes = list(includes) + INCLUDES
+    sources = ([os.path.join(ROOT, main), os.path.join(ROOT, "Tools", "replay", "host", "hal_host.c")]
+               + [os.path.join(ROOT, "Core", "Src", f) for f in core]
+               + [os.path.join(ROOT, f) for f in sources] + cmsis_sources())
+    headers = ([h for i in includes if not i.startswith("Drivers") for h in glob.glob(os.path.join(ROOT, i, "*.h"))]
+               + [os.path.join(ROOT, f) for f in deps] + [os.path.join(ROOT, config)])
+    exe = os.path.join(out_dir, name or os.path.splitext(os.path.basename(main))[0])
+    if os.path.exists(exe) and os.path.getmtime(exe) >= max(os.path.getmtime(f) for f in sources + headers):
+        return exe
+    os.makedirs(out_dir, exist_ok=True)
+    cmd = ([cc, "-O2", "-std=gnu11", "-w", "-DREPLAY_SLOT_MS=%d" % slot_ms(),
+            "-include", os.path.join(ROOT, config)]
+           + list(flags) + ["-I" + os.path.join(ROOT, i) for i in includes] + sources + ["-lm", "-o", exe])
+    subprocess.run(cmd, check=True)
+    return exe
+
+
+def run_one(job):
+    exe, path, timeline_dir = job
+    quiet = [] if timeline_dir else ["-q"]
+    res = subprocess.run([exe] + quiet + [path], capture_output=True, text=True)
+    if res.returncode != 0:
+        return path, None, res.stderr.strip()
+    lines = res.stdout.splitlines()
+    metrics = dict(kv.split("=") for kv in lines[-1].split()[2:])
+    if timeline_dir:
+        name = os.path.splitext(os.path.basename(path))[0] + ".timeline.csv"
+        with open(os.path.join(timeline_dir, name), "w") as f:
+            f.write("\n".join(lines[:-1]) + "\n")
+    return path, {k: float(v) for k, v in metrics.items()}, None
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("traces", nargs="+", help="trace files or directories of *.csv")
+    ap.add_argument("--jobs", type=int, default=os.cpu_count(), help="parallel replays (default: all cores)")
+    ap.add_argument("--timelines", metavar="DIR", help="write each barrier-event timeline to DIR")
+    ap.add_argument("--build-dir", default=os.path.join(tempfile.gettempdir(), "flood_barrier_replay"))
+    ap.add_argument("--cc", default=os.environ.get("CC", "gcc"))
+    ap.add_argument("--strict", action="store_true", help="exit 1 on a missed flood as well as a false raise")
+    args = ap.parse_args()
+
+    paths = []
+    for t in args.traces:
+        paths += sorted(glob.glob(os.path.join(t, "*.csv"))) if os.path.isdir(t) else [t]
+    if not paths:
+        sys.exit("no traces")
+    exe = build(args.build_dir, args.cc)
+
+    # A single trace prints its timeline; a batch prints one table row per trace
+    if len(paths) == 1 and not args.timelines:
+        res = subprocess.run([exe, paths[0]], capture_output=True, text=True)
+        sys.stdout.write(res.stdout)
+        sys.stderr.write(res.stderr)
+        if res.returncode != 0:
+            sys.exit(res.returncode)
+        m = dict(kv.split("=") for kv in res.stdout.splitlines()[-1].split()[2:])
+        if float(m["false_raises"]) or (args.strict and float(m["missed"])):
+            sys.exit("%s: %s false raises, %s missed floods" % (paths[0], m["false_raises"], m["missed"]))
+        return
+    if args.timelines:
+        os.makedirs(args.timelines, exist_ok=True)
+
+    jobs = [(exe, p, args.timelines) for p in paths]
+    with multiprocessing.Pool(max(1, args.jobs)) as pool:
+        results = pool.map(run_one, jobs, chunksize=1)
+
+    print("  ".join("%12s" % c[0] for c in COLUMNS))
+    total = {}
+    failed = 0
+    for path, m, err in results:
+        if m is None:
+            print("%12s  error: %s" % (os.path.basename(path), err))
+            failed += 1
+            continue
+        row = [os.path.basename(path)] + [m[c[0]] for c in COLUMNS[1:]]
+        print("  ".join("%12s" % fmt.format(v) for (_, fmt), v in zip(COLUMNS, row)))
+        for k, v in m.items():
+            total[k] = total.get(k, 0.0) + v
+    if total:
+        ok = len(paths) - failed
+        print("\n%d traces, %.1f h virtual in %.2f s CPU: %d raises, %d false, %d floods, %d missed"
+              % (ok, total["virtual_s"] / 3600, total["wall_s"], total["raises"], total["false_raises"],
+                 total["floods"], total["missed"]))
+        ttr = [(m["ttr_max_s"], os.path.basename(p)) for p, m, _ in results
+               if m is not None and m["ttr_max_s"] == m["ttr_max_s"]]
+        if ttr:
+            print("worst time-to-raise %.1f s (%s)" % max(ttr))
+    if failed or total.get("false_raises", 0) or (args.strict and total.get("missed", 0)):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,7 @@
+#include "stm32f4xx_hal.h"
+
+// One set for the whole process: every host instance reads the same idle
+// cycle counter
+replay_dwt_t replay_dwt;
+replay_core_debug_t replay_core_debug;
+uint32_t SystemCoreClock = 100000000U;
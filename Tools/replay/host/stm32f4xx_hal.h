@@ -0,0 +1,28 @@
+#ifndef __REPLAY_HAL_H__
+#define __REPLAY_HAL_H__
+
+#include <stdint.h>
+
+// Host stand-in for stm32f4xx_hal.h, first on the replay include path. The
+// level pipeline only touches the DWT cycle counter (inference budgets in
+// sensor_fault.c and nn_runtime.c); on the host it stays at 0, so budget
+// statistics are meaningless in a replay and nothing else changes.
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} replay_dwt_t;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} replay_core_debug_t;
+
+extern replay_dwt_t replay_dwt;
+extern replay_core_debug_t replay_core_debug;
+extern uint32_t SystemCoreClock;
+
+#define DWT                         (&replay_dwt)
+#define CoreDebug                   (&replay_core_debug)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+
+#endif // __REPLAY_HAL_H__
@@ -0,0 +1,344 @@
+// Scenario replay: the firmware's controller (controller.c: level pipeline,
+// barrier state machine, indicator table), unchanged, built for the host
+// with the factory calibration (calib.h) and fed from a trace file instead
+// of ADC1. Time is
+// virtual: one water slot per REPLAY_SLOT_MS of trace time, as fast as the
+// host runs. Built and batch-run by Tools/replay.py.
+//
+//     replay [-q] trace.csv       -q: metrics only, no timeline
+//
+// Trace: CSV with a header row naming the columns; '#' lines are ignored.
+//   t      seconds, non-decreasing
+//   raw    ADC counts (0..4095), or
+//   mm     level, turned into the counts the sensor reads at it (sensor curve)
+//   flood  optional ground truth: 1 while the barrier should be up
+//   ir     optional IR command at t: up, down, stop, auto, estop, toggle
+// The ADC value is held between rows: each slot samples the last row at or
+// before it. IR commands are dispatched at their own time, between slots,
+// as the water task does. Without a flood column the truth is the trace
+// level with the table's hysteresis: a flood starts at WARNING_RAIN_MM and
+// ends under NORMAL_RAIN_MM.
+//
+// Output: timeline rows "t_s,what,detail", then one "# metrics k=v ..." line
+// (time-to-raise is nan without a flood).
+#include "controller.h"
+#include "stm32f4xx_hal.h"
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef REPLAY_SLOT_MS
+#define REPLAY_SLOT_MS  100     // TASK_WATER_PERIOD_MS; replay.py passes it from task_model.h
+#endif
+#define REPLAY_COLS     8
+
+enum { COL_T = 0, COL_RAW, COL_MM, COL_FLOOD, COL_IR, COL_KINDS };
+static const char *const col_names[COL_KINDS] = { "t", "raw", "mm", "flood", "ir" };
+
+static const struct {
+    const char *name;
+    uint8_t event;
+} ir_names[] = {
+    { "up", BEV_IR_UP },
+    { "down", BEV_IR_DOWN },
+    { "stop", BEV_IR_STOP },
+    { "auto", BEV_IR_AUTO },
+    { "estop", BEV_IR_ESTOP },
+    { "toggle", BEV_IR_TOGGLE },
+};
+
+static const char *const status_names[] = { "NORMAL", "WARNING", "FLOOD", "SENSOR_ERR" };
+static const char *const servo_names[] = { "DOWN", "UP", "OFF" };
+static const char *const pattern_names[PATTERN_COUNT] = { "OFF", "WARNING", "FLOOD", "MANUAL" };
+
+typedef struct {
+    const char *p, *end;    // unread part of the mapping
+    int8_t col[COL_KINDS];  // field index of each column, -1 if absent
+    uint32_t line;
+} trace_t;
+
+typedef struct {
+    int64_t t_ms;
+    uint16_t raw;
+    int8_t flood;           // -1: not in the trace
+    int8_t ir;              // index in ir_names, -1: none
+} trace_row_t;
+
+typedef struct {
+    uint64_t slots;
+    uint32_t raises, raises_auto, false_raises;
+    uint32_t floods, missed;
+    int64_t ttr_first_ms, ttr_max_ms, ttr_sum_ms;
+    uint32_t ttr_n;
+    int64_t up_ms, fault_ms;
+} replay_metrics_t;
+
+static controller_t ctrl;
+static uint8_t quiet;
+static replay_metrics_t m;
+
+// Truth and raise bookkeeping, updated on every change
+static uint8_t truth, flood_raised, raise_open, raise_auto, raise_justified;
+static int64_t flood_start_ms, up_since_ms;
+
+static void emit(int64_t t_ms, const char *what, const char *detail) {
+    if (!quiet) printf("%lld.%03lld,%s,%s\n", (long long)(t_ms / 1000), (long long)(t_ms % 1000), what, detail);
+}
+
+static void raise_close(void) {
+    if (raise_open && raise_auto && !raise_justified) m.false_raises++;
+    raise_open = 0;
+}
+
+static void record_ttr(int64_t ttr) {
+    flood_raised = 1;
+    if (m.ttr_n == 0) m.ttr_first_ms = m.ttr_max_ms = ttr;
+    if (ttr > m.ttr_max_ms) m.ttr_max_ms = ttr;
+    m.ttr_sum_ms += ttr;
+    m.ttr_n++;
+}
+
+static void set_truth(int64_t t_ms, uint8_t on) {
+    if (on == truth) return;
+    truth = on;
+    emit(t_ms, "truth", on ? "FLOOD" : "CLEAR");
+    if (on) {
+        m.floods++;
+        flood_start_ms = t_ms;
+        flood_raised = 0;
+        if (ctrl.fsm.barrier_up) record_ttr(up_since_ms - t_ms);    // negative: raised ahead of the level
+        if (raise_open) raise_justified = 1;
+    } else if (!flood_raised) {
+        m.missed++;
+    }
+}
+
+static void barrier_up_changed(int64_t t_ms) {
+    if (ctrl.fsm.barrier_up) {
+        m.raises++;
+        raise_open = 1;
+        raise_auto = ctrl.fsm.state == BARRIER_FLOOD;
+        if (raise_auto) m.raises_auto++;
+        raise_justified = truth;
+        up_since_ms = t_ms;
+        if (truth && !flood_raised) record_ttr(t_ms - flood_start_ms);
+    } else {
+        m.up_ms += t_ms - up_since_ms;
+        raise_close();
+    }
+}
+
+/* Timeline rows for the outputs one controller call changed (main.c barrier_apply()) */
+static void replay_outputs(int64_t t_ms, uint8_t state, uint8_t up, uint8_t changed) {
+    char detail[32];
+
+    if (changed & CTRL_STATUS) emit(t_ms, "status", status_names[ctrl.slot.status]);
+    if (changed & CTRL_STATE) {
+        snprintf(detail, sizeof(detail), "%s>%s", barrier_state_text[state], barrier_state_text[ctrl.fsm.state]);
+        emit(t_ms, "state", detail);
+    }
+    if (changed & CTRL_SERVO) emit(t_ms, "servo", servo_names[ctrl.fsm.servo]);
+    if (changed & CTRL_INDICATOR) emit(t_ms, "pattern", pattern_names[ctrl.indicator_out->pattern]);
+    if (ctrl.fsm.barrier_up != up) barrier_up_changed(t_ms);
+}
+
+/* Decimal with optional sign and fraction; exponents are not needed here */
+static int parse_num(const char *p, const char *end, double *v) {
+    double x = 0.0, scale = 1.0;
+    int neg = 0, digits = 0;
+
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    if (p < end && (*p == '-' || *p == '+')) neg = *p++ == '-';
+    for (; p < end && *p >= '0' && *p <= '9'; p++, digits++) x = x * 10.0 + (*p - '0');
+    if (p < end && *p == '.') {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++) x += (*p - '0') * (scale *= 0.1);
+    }
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    if (digits == 0 || p != end) return -1;
+    *v = neg ? -x : x;
+    return 0;
+}
+
+static int field_is(const char *p, const char *end, const char *word) {
+    size_t n = strlen(word);
+    while (p < end && (end[-1] == '\r' || end[-1] == ' ')) end--;
+    while (p < end && *p == ' ') p++;
+    return (size_t)(end - p) == n && memcmp(p, word, n) == 0;
+}
+
+/* Next data line split into fields; 0 at the end of the trace */
+static int next_line(trace_t *tr, const char **f, const char **fe, int *nf) {
+    while (tr->p < tr->end) {
+        const char *s = tr->p;
+        const char *e = memchr(s, '\n', (size_t)(tr->end - s));
+        if (e == NULL) e = tr->end;
+        tr->p = e < tr->end ? e + 1 : e;
+        tr->line++;
+        if (e == s || *s == '#' || (e - s == 1 && *s == '\r')) continue;
+        *nf = 0;
+        for (const char *q = s; *nf < REPLAY_COLS; ) {
+            const char *c = memchr(q, ',', (size_t)(e - q));
+            f[*nf] = q;
+            fe[(*nf)++] = c ? c : e;
+            if (c == NULL) break;
+            q = c + 1;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static int trace_header(trace_t *tr) {
+    const char *f[REPLAY_COLS], *fe[REPLAY_COLS];
+    int nf;
+
+    memset(tr->col, -1, sizeof(tr->col));
+    if (!next_line(tr, f, fe, &nf)) return -1;
+    for (int i = 0; i < nf; i++) {
+        for (int c = 0; c < COL_KINDS; c++) {
+            if (field_is(f[i], fe[i], col_names[c])) tr->col[c] = (int8_t)i;
+        }
+    }
+    if (tr->col[COL_T] < 0 || (tr->col[COL_RAW] < 0) == (tr->col[COL_MM] < 0)) return -1;
+    return 0;
+}
+
+/* 1: row read, 0: end of trace, -1: malformed (line number in tr->line) */
+static int trace_row(trace_t *tr, trace_row_t *row) {
+    const char *f[REPLAY_COLS], *fe[REPLAY_COLS];
+    int nf, c;
+    double v;
+
+    if (!next_line(tr, f, fe, &nf)) return 0;
+    for (c = 0; c < COL_KINDS; c++) {
+        if (tr->col[c] >= nf) return -1;
+    }
+    if (parse_num(f[tr->col[COL_T]], fe[tr->col[COL_T]], &v) != 0) return -1;
+    row->t_ms = (int64_t)(v * 1000.0 + 0.5);
+    if (tr->col[COL_RAW] >= 0) {
+        if (parse_num(f[tr->col[COL_RAW]], fe[tr->col[COL_RAW]], &v) != 0) return -1;
+    } else {
+        if (parse_num(f[tr->col[COL_MM]], fe[tr->col[COL_MM]], &v) != 0) return -1;
+        v = sensor_curve_raw(&ctrl.water.curve, (float)(v / calib_factory.mm_per_count));
+    }
+    row->raw = v < 0.0 ? 0 : v > 4095.0 ? 4095 : (uint16_t)v;
+    row->flood = -1;
+    if (tr->col[COL_FLOOD] >= 0) {
+        if (parse_num(f[tr->col[COL_FLOOD]], fe[tr->col[COL_FLOOD]], &v) != 0) return -1;
+        row->flood = v != 0.0;
+    }
+    row->ir = -1;
+    if (tr->col[COL_IR] >= 0) {
+        const char *s = f[tr->col[COL_IR]], *e = fe[tr->col[COL_IR]];
+        if (!field_is(s, e, "")) {
+            for (c = 0; c < (int)(sizeof(ir_names) / sizeof(ir_names[0])); c++) {
+                if (field_is(s, e, ir_names[c].name)) row->ir = (int8_t)c;
+            }
+            if (row->ir < 0) return -1;
+        }
+    }
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    struct timespec w0, w1;
+    struct stat st;
+    trace_t tr = { 0 };
+    trace_row_t row;
+    int64_t now_ms;
+    uint16_t raw = 0;
+    int have, fd;
+    void *map;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-q") == 0) quiet = 1;
+        else path = argv[i];
+    }
+    if (path == NULL) {
+        fprintf(stderr, "usage: %s [-q] trace.csv\n", argv[0]);
+        return 2;
+    }
+    fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+        fprintf(stderr, "%s: cannot read\n", path);
+        return 2;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "%s: mmap failed\n", path);
+        return 2;
+    }
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+    tr.p = map;
+    tr.end = tr.p + st.st_size;
+    if (trace_header(&tr) != 0) {
+        fprintf(stderr, "%s: header needs t and one of raw/mm\n", path);
+        return 2;
+    }
+    setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+    if (!quiet) printf("t_s,what,detail\n");
+
+    clock_gettime(CLOCK_MONOTONIC, &w0);
+    controller_init(&ctrl, &calib_factory);
+    have = trace_row(&tr, &row);
+    for (now_ms = 0; have > 0; now_ms += REPLAY_SLOT_MS) {
+        uint8_t state, up;
+
+        // Rows up to this slot: the last level is held, commands are dispatched on time
+        while (have > 0 && row.t_ms <= now_ms) {
+            raw = row.raw;
+            if (row.flood >= 0) {
+                set_truth(row.t_ms, (uint8_t)row.flood);
+            } else {
+                float mm = rain_raw_to_mm(&ctrl.water, raw);
+                set_truth(row.t_ms, truth ? mm >= NORMAL_RAIN_MM : mm >= WARNING_RAIN_MM);
+            }
+            if (row.ir >= 0) {
+                emit(row.t_ms, "ir", ir_names[row.ir].name);
+                state = ctrl.fsm.state;
+                up = ctrl.fsm.barrier_up;
+                replay_outputs(row.t_ms, state, up, controller_dispatch(&ctrl, ir_names[row.ir].event));
+            }
+            have = trace_row(&tr, &row);
+        }
+        if (have < 0) break;
+
+        state = ctrl.fsm.state;
+        up = ctrl.fsm.barrier_up;
+        replay_outputs(now_ms, state, up, controller_slot(&ctrl, raw));
+        m.slots++;
+        if (ctrl.slot.status == RAIN_SENSOR_ERR) m.fault_ms += REPLAY_SLOT_MS;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &w1);
+    if (have < 0) {
+        fprintf(stderr, "%s:%u: malformed row\n", path, tr.line);
+        return 2;
+    }
+
+    // Open episodes at the end of the trace
+    if (ctrl.fsm.barrier_up) {
+        m.up_ms += now_ms - up_since_ms;
+        raise_close();
+    }
+    if (truth && !flood_raised) m.missed++;
+
+    double wall = (double)(w1.tv_sec - w0.tv_sec) + (double)(w1.tv_nsec - w0.tv_nsec) * 1e-9;
+    printf("# metrics slots=%llu virtual_s=%.1f wall_s=%.6f speedup=%.0f"
+           " raises=%u raises_auto=%u false_raises=%u floods=%u missed=%u"
+           " ttr_first_s=%.1f ttr_max_s=%.1f ttr_mean_s=%.1f up_s=%.1f fault_s=%.1f\n",
+           (unsigned long long)m.slots, now_ms / 1000.0, wall, wall > 0.0 ? now_ms / 1000.0 / wall : 0.0,
+           m.raises, m.raises_auto, m.false_raises, m.floods, m.missed,
+           m.ttr_n ? m.ttr_first_ms / 1000.0 : NAN, m.ttr_n ? m.ttr_max_ms / 1000.0 : NAN,
+           m.ttr_n ? m.ttr_sum_ms / 1000.0 / m.ttr_n : NAN,
+           m.up_ms / 1000.0, m.fault_ms / 1000.0);
+    munmap(map, (size_t)st.st_size);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+"""Simulate the firmware task set and measure worst-case response times.
+
+Reads periods, WCETs, priorities and mutex holds from Core/Inc/task_model.h
+and runs a preemptive fixed-priority scheduler (with priority inheritance
+on a shared mutex and the modelled interrupts on top) at 1 us
+resolution.  By default the work thread saturates I2C: it is always ready
+and spends its whole budget in polled LCD transfers, the worst case for
+everything below the water task.
+
+    python3 Tools/sched_sim.py                      # current priorities
+    python3 Tools/sched_sim.py --baseline           # all threads at osPriorityNormal, round robin
+    python3 Tools/sched_sim.py --saturate none --seconds 120 --runs 20
+    python3 Tools/sched_sim.py --mhz 48             # budgets stretched to the low clock profile
+
+Each run uses random release phases (one run starts all tasks together,
+the critical instant).  The table compares the simulated worst case with
+the response-time bound task_model_check() computes at startup; the
+water task's bound with a flash erase stall at a quiet slot follows it.
+"""
+
+import argparse
+import os
+import random
+import re
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Core", "Inc", "task_model.h")
+TICK_US = 1000
+ISR_PRIO = 0x100
+INF = float("inf")
+
+PRIO_BASE = {"Idle": 1, "Low": 8, "BelowNormal": 16, "Normal": 24, "AboveNormal": 32,
+             "High": 40, "Realtime": 48}
+
+
+def os_priority(name):
+    m = re.match(r"osPriority([A-Za-z]+?)(\d?)$", name)
+    return PRIO_BASE[m.group(1)] + int(m.group(2) or 0)
+
+
+def load_tasks(path, mhz=None):
+    defs = dict(re.findall(r"#define\s+(\w+)\s+(\w+)", open(path).read()))
+    ref = int(defs["TASK_MODEL_REF_HZ"].rstrip("U"))
+    hz = mhz * 1000000 if mhz else ref
+
+    def scale(us):
+        # as task_model_scale(): stretched below the reference clock only
+        return us if hz >= ref else -(-us * ref // hz)
+
+    tasks = []
+    for name in ("TICK", "HALTICK", "IR", "UART"):
+        tasks.append(dict(name="isr_" + name.lower(), period=int(defs["ISR_%s_PERIOD_US" % name]),
+                          wcet=scale(int(defs["ISR_%s_WCET_US" % name])), cs=0, prio=ISR_PRIO))
+    for name in ("WATER", "TIMER", "WORK"):
+        tasks.append(dict(name=name.lower(), period=int(defs["TASK_%s_PERIOD_MS" % name]) * 1000,
+                          wcet=scale(int(defs["TASK_%s_WCET_US" % name])),
+                          cs=scale(int(defs["TASK_%s_CS_US" % name])),
+                          prio=os_priority(defs["TASK_%s_PRIO" % name]),
+                          quiet=int(defs.get("TASK_%s_QUIET_MS" % name, 0)) * 1000))
+    # Background (trace): never released here, but its mutex hold blocks the others
+    background = [dict(name="trace", cs=scale(int(defs["TASK_TRACE_CS_US"])),
+                       prio=os_priority(defs["TASK_TRACE_PRIO"]))]
+    # Flash erase at a quiet slot: blocks everything, not scaled with the clock
+    stall = int(defs["WORK_ERASE_STALL_US"])
+    return tasks, background, stall
+
+
+def rta(tasks, background=(), stall=0):
+    """Same analysis as task_model_check(); "<name> quiet" with the erase stall as blocking"""
+    holders = list(tasks) + list(background)
+    ceiling = max([t["prio"] for t in holders if t["cs"]] or [0])
+    out = {}
+
+    def response(t, b, deadline):
+        r, prev = t["wcet"] + b, None
+        while r != prev and r <= deadline:
+            prev = r
+            r = t["wcet"] + b + sum(-(-prev // u["period"]) * u["wcet"]
+                                    for u in tasks if u is not t and u["prio"] >= t["prio"])
+        return r
+
+    for t in tasks:
+        b = 0
+        if ceiling >= t["prio"]:
+            b = max([u["cs"] for u in holders if u["prio"] < t["prio"]] or [0])
+        out[t["name"]] = response(t, b, t["period"])
+        if t.get("quiet"):
+            out[t["name"] + " quiet"] = response(t, max(b, stall), t["quiet"])
+    return out
+
+
+class Job:
+    def __init__(self, task, release, seq):
+        self.task = task
+        self.release = release
+        self.left = task["wcet"]
+        self.seq = seq          # ready-queue order (FIFO within a priority)
+        self.holds = False
+        self.blocked = False
+
+
+def simulate(tasks, duration, phases, saturate):
+    """Returns the worst response time per task name"""
+    nxt = {t["name"]: phases[t["name"]] for t in tasks}
+    ready = []
+    worst = {t["name"]: 0 for t in tasks}
+    holder = None
+    seq = 0
+    t = 0
+    if saturate in nxt:
+        nxt[saturate] = 0
+
+    def prio(job):
+        p = job.task["prio"]
+        if job is holder:
+            p = max([p] + [w.task["prio"] for w in ready if w.blocked])
+        return p
+
+    while t < duration:
+        for task in tasks:
+            while nxt[task["name"]] <= t:
+                seq += 1
+                ready.append(Job(task, nxt[task["name"]], seq))
+                # A saturating task is re-released as soon as its job completes
+                nxt[task["name"]] = INF if task["name"] == saturate else nxt[task["name"]] + task["period"]
+        runnable = [j for j in ready if not j.blocked]
+        if not runnable:
+            t = min(nxt.values())
+            continue
+        job = max(runnable, key=lambda j: (prio(j), -j.seq))
+        # Critical section is the tail of the job (compute, then actuate)
+        if job.task["cs"] and not job.holds and job.left <= job.task["cs"]:
+            if holder is None:
+                holder, job.holds = job, True
+            else:
+                job.blocked = True
+                continue
+        step = min(nxt.values()) - t
+        if job.task["cs"] and not job.holds:
+            step = min(step, job.left - job.task["cs"])
+        step = min(step, job.left)
+        if job.task["prio"] != ISR_PRIO:
+            step = min(step, TICK_US - t % TICK_US)
+        step = max(step, 1)
+        job.left -= step
+        t += step
+        if job.left <= 0:
+            ready.remove(job)
+            if job.task["name"] == saturate:
+                nxt[saturate] = t
+            worst[job.task["name"]] = max(worst[job.task["name"]], t - job.release)
+            if job.holds:
+                holder = None
+                waiters = [w for w in ready if w.blocked]
+                if waiters:
+                    w = max(waiters, key=lambda j: (j.task["prio"], -j.seq))
+                    w.blocked, w.holds, holder = False, True, w
+        elif t % TICK_US == 0 and job.task["prio"] != ISR_PRIO:
+            # Tick: an equal-priority peer gets the CPU (configUSE_TIME_SLICING)
+            seq += 1
+            job.seq = seq
+    return worst
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--seconds", type=float, default=30.0)
+    ap.add_argument("--runs", type=int, default=5)
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--saturate", default="work", help="task kept permanently busy, or 'none'")
+    ap.add_argument("--baseline", action="store_true", help="all threads at osPriorityNormal")
+    ap.add_argument("--mhz", type=int, help="core clock (clock_profile.h); default TASK_MODEL_REF_HZ")
+    args = ap.parse_args()
+
+    tasks, background, stall = load_tasks(HEADER, args.mhz)
+    if args.baseline:
+        for t in tasks:
+            if t["prio"] != ISR_PRIO:
+                t["prio"] = PRIO_BASE["Normal"]
+    bound = rta(tasks, background, stall)
+    rng = random.Random(args.seed)
+    worst = {t["name"]: 0 for t in tasks}
+    for run in range(args.runs):
+        phases = {t["name"]: 0 if run == 0 else rng.randrange(t["period"]) for t in tasks}
+        w = simulate(tasks, int(args.seconds * 1e6), phases, args.saturate)
+        for k, v in w.items():
+            worst[k] = max(worst[k], v)
+
+    print("%-12s %5s %9s %8s %10s %10s  %s" % ("task", "prio", "period", "wcet", "sim wcrt", "rta bound", ""))
+    for t in tasks:
+        n = t["name"]
+        late = "MISS" if worst[n] > t["period"] else ""
+        prio = "isr" if t["prio"] == ISR_PRIO else str(t["prio"])
+        print("%-12s %5s %9d %8d %10d %10s  %s" % (n, prio, t["period"], t["wcet"], worst[n],
+                                                    bound[n] if bound[n] <= t["period"] else "-", late))
+    for t in tasks:
+        q = bound.get(t["name"] + " quiet")
+        if q is not None:
+            print("%s at a quiet slot, %d us flash erase: rta bound %d us, deadline %d us%s" %
+                  (t["name"], stall, q, t["quiet"], "  MISS" if q > t["quiet"] else ""))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,285 @@
+#!/usr/bin/env python3
+"""Decode scheduling traces written by Core/Src/trace_recorder.c.
+
+Capture the USART2 output (115200 8N1) to a file, then:
+
+    python3 Tools/trace_decode.py capture.bin
+    python3 Tools/trace_decode.py capture.bin --gantt 120 --from-ms 0 --to-ms 400
+    python3 Tools/trace_decode.py capture.bin --chrome trace.json
+    python3 Tools/trace_decode.py --port /dev/ttyACM0 --seconds 30 --save capture.bin
+
+Prints the context switch rate and kernel heap use, a per-task table (CPU
+share, longest slice, time blocked and why, ready-to-run latency, activation
+period) and a text Gantt chart; --chrome writes Chrome trace JSON (chrome://tracing, ui.perfetto.dev).  A snapshot
+capture may hold several dumps; the last one is decoded unless --snapshot
+picks another.  A stream capture is decoded as a single run.
+"""
+
+import argparse
+import json
+import struct
+
+SYNC = b"\xa5\x5a"
+PKT_HEADER, PKT_TASK, PKT_EVENTS, PKT_END = 1, 2, 3, 4
+
+# trace_type_t in Core/Inc/trace_recorder.h
+EVENT_NAMES = [
+    "none", "switch_in", "ready", "delay", "delay_until", "block_recv", "block_send",
+    "block_notify", "send", "recv", "send_fail", "recv_fail", "inherit", "disinherit",
+    "task_create", "task_delete", "obj_create", "tick", "isr_enter", "isr_exit", "user",
+    "trigger", "clock",
+]
+EV = {name: i for i, name in enumerate(EVENT_NAMES)}
+QUEUE_TYPES = {0: "queue", 1: "mutex", 2: "csem", 3: "bsem", 4: "rmutex"}
+
+
+class Run:
+    def __init__(self):
+        self.cpu_hz = 0
+        self.tick_hz = 1000
+        self.ring = 0
+        self.cycles_per_event = 0
+        self.lost = 0
+        self.heap_free = self.heap_min = None   # older firmware: not sent
+        self.tasks = {}         # number -> (name, priority)
+        self.events = []        # (ts, type, obj, arg), raw 32-bit timestamps
+
+
+def parse(data):
+    """Split a capture into runs: one per snapshot (END packet) or one stream."""
+    runs, cur, pos = [], Run(), 0
+    while True:
+        pos = data.find(SYNC, pos)
+        if pos < 0 or pos + 5 > len(data):
+            break
+        ptype = data[pos + 2]
+        (length,) = struct.unpack_from("<H", data, pos + 3)
+        body = data[pos + 5:pos + 5 + length]
+        if len(body) < length or ptype not in (PKT_HEADER, PKT_TASK, PKT_EVENTS, PKT_END):
+            pos += 1
+            continue
+        pos += 5 + length
+        if ptype == PKT_HEADER and length >= 16:
+            cur.cpu_hz, cur.tick_hz, cur.ring, cur.cycles_per_event, cur.lost = \
+                struct.unpack_from("<IIHHI", body)
+            if length >= 24:
+                cur.heap_free, cur.heap_min = struct.unpack_from("<II", body, 16)
+        elif ptype == PKT_TASK and length >= 2:
+            cur.tasks[body[0]] = (body[2:].decode("ascii", "replace"), body[1])
+        elif ptype == PKT_EVENTS:
+            cur.events.extend(struct.iter_unpack("<IBBH", body[:length - length % 8]))
+        elif ptype == PKT_END:
+            runs.append(cur)
+            prev, cur = cur, Run()
+            cur.tasks = dict(prev.tasks)
+    if cur.events:
+        runs.append(cur)
+    return runs
+
+
+def unwrap(events, cpu_hz):
+    """32-bit cycle stamps -> seconds from the first event.
+
+    A clock event (clock_profile.c) carries the core clock in MHz before and
+    after the switch; cycles are converted at the rate of their own segment.
+    The header rate is the one at dump time, so it only applies when the
+    ring holds no switch."""
+    hz = float(cpu_hz)
+    for ts, typ, obj, arg in events:
+        if typ == EV["clock"] and obj:
+            hz = obj * 1e6
+            break
+    out, t, last = [], 0.0, None
+    for ts, typ, obj, arg in events:
+        if last is not None:
+            t += ((ts - last) & 0xFFFFFFFF) / hz
+        last = ts
+        out.append((t, typ, obj, arg))
+        if typ == EV["clock"] and arg:
+            hz = arg * 1e6
+    return out
+
+
+class Stat:
+    def __init__(self):
+        self.n = 0
+        self.total = 0.0
+        self.max = 0.0
+
+    def add(self, v):
+        self.n += 1
+        self.total += v
+        self.max = max(self.max, v)
+
+    def mean(self):
+        return self.total / self.n if self.n else 0.0
+
+
+def analyse(run):
+    events = unwrap(run.events, run.cpu_hz or 100000000)
+    tasks, objects = {}, {}
+    running = None
+    running_since = None
+    slices = []             # (task, start, end)
+    blocked_since = {}      # task -> (t, reason)
+    ready_since = {}
+    marks = []
+
+    def task(n):
+        if n not in tasks:
+            tasks[n] = dict(run=Stat(), blocked={}, latency=Stat(), period=Stat(),
+                            last_wake=None, cpu=0.0)
+        return tasks[n]
+
+    def obj_name(o):
+        return "%s#%d" % (objects.get(o, "obj"), o)
+
+    for t, typ, obj, arg in events:
+        if typ == EV["switch_in"]:
+            if running is not None:
+                task(running)["run"].add(t - running_since)
+                task(running)["cpu"] += t - running_since
+                slices.append((running, running_since, t))
+            running, running_since = obj, t
+            if obj in ready_since:
+                task(obj)["latency"].add(t - ready_since.pop(obj))
+        elif typ == EV["ready"]:
+            if obj in blocked_since:
+                since, reason = blocked_since.pop(obj)
+                task(obj)["blocked"].setdefault(reason, Stat()).add(t - since)
+                tk = task(obj)
+                if tk["last_wake"] is not None:
+                    tk["period"].add(t - tk["last_wake"])
+                tk["last_wake"] = t
+            ready_since.setdefault(obj, t)
+        elif typ in (EV["delay"], EV["delay_until"]):
+            blocked_since[obj] = (t, "delay")
+        elif typ in (EV["block_recv"], EV["block_send"]):
+            blocked_since[obj] = (t, ("wait " if typ == EV["block_recv"] else "send ") + obj_name(arg))
+        elif typ == EV["block_notify"]:
+            blocked_since[obj] = (t, "notify")
+        elif typ == EV["obj_create"]:
+            objects[obj] = QUEUE_TYPES.get(arg, "queue")
+        elif typ == EV["task_create"]:
+            task(obj)
+        elif typ == EV["trigger"]:
+            marks.append((t, "trigger"))
+        elif typ in (EV["inherit"], EV["disinherit"]):
+            marks.append((t, "%s %s -> prio %d" % (EVENT_NAMES[typ], name_of(run, obj), arg)))
+        elif typ == EV["user"]:
+            marks.append((t, "user %d = %d" % (obj, arg)))
+    end = events[-1][0] if events else 0.0
+    if running is not None:
+        task(running)["cpu"] += end - running_since
+        slices.append((running, running_since, end))
+    return tasks, slices, marks, end
+
+
+def name_of(run, n):
+    name = run.tasks.get(n, ("", 0))[0]
+    return name if name else "task%d" % n
+
+
+def print_table(run, tasks, end):
+    print("%-12s %4s %6s %9s %9s %9s %9s  %s" % (
+        "task", "prio", "cpu%", "slice max", "lat mean", "lat max", "period", "blocked (count, mean / max ms)"))
+    for n in sorted(tasks, key=lambda k: -tasks[k]["cpu"]):
+        tk = tasks[n]
+        prio = run.tasks.get(n, ("", 0))[1]
+        blocked = ", ".join("%s %d, %.1f/%.1f" % (r, s.n, s.mean() * 1e3, s.max * 1e3)
+                            for r, s in sorted(tk["blocked"].items(), key=lambda kv: -kv[1].total))
+        period = "%.1f" % (tk["period"].mean() * 1e3) if tk["period"].n else "-"
+        print("%-12s %4d %6.1f %9.3f %9.3f %9.3f %9s  %s" % (
+            name_of(run, n)[:12], prio, 100.0 * tk["cpu"] / end if end else 0.0,
+            tk["run"].max * 1e3, tk["latency"].mean() * 1e3, tk["latency"].max * 1e3, period, blocked))
+
+
+def print_gantt(run, tasks, slices, marks, t_from, t_to, width):
+    span = t_to - t_from
+    if span <= 0:
+        return
+    print()
+    print("Gantt %.1f .. %.1f ms, %.3f ms per column ('#' running)" % (t_from * 1e3, t_to * 1e3, span * 1e3 / width))
+    for n in sorted(tasks, key=lambda k: -run.tasks.get(k, ("", 0))[1]):
+        row = [" "] * width
+        for task, a, b in slices:
+            if task != n or b < t_from or a > t_to:
+                continue
+            c0 = int((max(a, t_from) - t_from) / span * width)
+            c1 = int((min(b, t_to) - t_from) / span * width)
+            for c in range(max(c0, 0), min(c1 + 1, width)):
+                row[c] = "#"
+        print("%-12s|%s|" % (name_of(run, n)[:12], "".join(row)))
+    for t, text in marks:
+        if t_from <= t <= t_to:
+            print("%12s %s^ %.3f ms %s" % ("", " " * int((t - t_from) / span * width), t * 1e3, text))
+
+
+def write_chrome(path, run, slices, marks):
+    out = []
+    for task, a, b in slices:
+        out.append(dict(name=name_of(run, task), ph="X", pid=1, tid=task, ts=a * 1e6, dur=(b - a) * 1e6))
+    for n, (name, prio) in run.tasks.items():
+        out.append(dict(name="thread_name", ph="M", pid=1, tid=n, args=dict(name="%s (p%d)" % (name or n, prio))))
+    for t, text in marks:
+        out.append(dict(name=text, ph="i", pid=1, tid=0, ts=t * 1e6, s="g"))
+    with open(path, "w") as f:
+        json.dump(dict(traceEvents=out, displayTimeUnit="ms"), f)
+
+
+def capture(port, seconds, path):
+    import serial   # pyserial, only needed for live capture
+    import time
+    data = bytearray()
+    with serial.Serial(port, 115200, timeout=0.2) as s:
+        stop = time.time() + seconds
+        while time.time() < stop:
+            data += s.read(4096)
+    if path:
+        open(path, "wb").write(data)
+    return bytes(data)
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("capture", nargs="?")
+    ap.add_argument("--port")
+    ap.add_argument("--seconds", type=float, default=10.0)
+    ap.add_argument("--save")
+    ap.add_argument("--snapshot", type=int, default=-1)
+    ap.add_argument("--gantt", type=int, default=100, metavar="COLUMNS")
+    ap.add_argument("--from-ms", type=float)
+    ap.add_argument("--to-ms", type=float)
+    ap.add_argument("--chrome")
+    args = ap.parse_args()
+
+    if args.port:
+        data = capture(args.port, args.seconds, args.save)
+    elif args.capture:
+        data = open(args.capture, "rb").read()
+    else:
+        ap.error("capture file or --port required")
+
+    runs = parse(data)
+    if not runs:
+        raise SystemExit("no trace packets found")
+    run = runs[args.snapshot]
+    tasks, slices, marks, end = analyse(run)
+    print("%d snapshot(s), decoding #%d: %d events over %.1f ms, %d cycles/event, %d lost"
+          % (len(runs), args.snapshot % len(runs), len(run.events), end * 1e3, run.cycles_per_event, run.lost))
+    switches = sum(1 for ev in run.events if ev[1] == EV["switch_in"])
+    line = "%d context switches, %.1f/s" % (switches, switches / end if end else 0.0)
+    if run.heap_free is not None:
+        line += "; heap free %d bytes, %d at the low point" % (run.heap_free, run.heap_min)
+    print(line)
+    print_table(run, tasks, end)
+    if args.gantt:
+        t_from = args.from_ms / 1e3 if args.from_ms is not None else 0.0
+        t_to = args.to_ms / 1e3 if args.to_ms is not None else end
+        print_gantt(run, tasks, slices, marks, t_from, t_to, args.gantt)
+    if args.chrome:
+        write_chrome(args.chrome, run, slices, marks)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+"""Train the level-sensor fault classifier and export it as C tables.
+
+Fits the Gaussian naive Bayes model used by Core/Src/sensor_fault.c
+(arm_gaussian_naive_bayes_predict_f32) and writes sensor_fault_model.c.
+Features are computed exactly as the firmware does, from windows of raw
+ADC counts:
+
+    python3 Tools/train_fault_model.py --csv windows.csv > Core/Src/sensor_fault_model.c
+    python3 Tools/train_fault_model.py --synthetic 400 > Core/Src/sensor_fault_model.c
+
+A CSV row is "label,raw0,raw1,...,rawN-1" with label one of the model
+classes below and N = SENSOR_FAULT_WIN (256).  --synthetic generates that
+many windows per class from simple signal models instead.  Accuracy on a
+held-out quarter of the data, per sensor state, is printed to stderr.
+
+A healthy sensor gets three classes (a moving level, a still one, slosh):
+one Gaussian per class cannot cover both a constant reading and a 3 mm
+wave. There is no stuck class: a frozen output has the same features as a
+steady level read without noise, so it is OK and left to the thresholds.
+"""
+
+import argparse
+import math
+import random
+import sys
+
+CLASSES = ["ok", "still", "slosh", "open", "shorted"]                    # model classes
+STATES = ["SENSOR_OK", "SENSOR_OK", "SENSOR_OK", "SENSOR_OPEN", "SENSOR_SHORTED"]  # sensor_state_t of each
+WIN = 256               # SENSOR_FAULT_WIN
+FFT_LEN = 128           # SLOSH_FFT_LEN
+SAMPLE_HZ = 10.0        # SLOSH_SAMPLE_HZ
+CLAMP_HIGH = 4000       # SENSOR_CLAMP_HIGH_RAW
+CLAMP_LOW = 5           # SENSOR_CLAMP_LOW_RAW
+SENSOR_MAX_MM = 40.0
+SPIKE_MEDIAN_LEN = 5    # main.c: the slosh stage sees median-filtered counts
+VAR_SMOOTHING = 1e-9
+
+
+def median_filtered(raw):
+    """median_q15() output for the last FFT_LEN samples of the window"""
+    h = SPIKE_MEDIAN_LEN
+    out = []
+    for i in range(len(raw) - FFT_LEN, len(raw)):
+        win = sorted(raw[i - h + 1:i + 1])
+        out.append(win[h // 2])
+    return out
+
+
+def flatness(raw):
+    """Spectral flatness as computed by slosh_filter.c on the last block."""
+    block = [min(r, CLAMP_HIGH) / 4095.0 * SENSOR_MAX_MM for r in median_filtered(raw)]
+    mean = sum(block) / FFT_LEN
+    x = [(v - mean) * (0.5 - 0.5 * math.cos(2 * math.pi * i / (FFT_LEN - 1)))
+         for i, v in enumerate(block)]
+    eps = 1e-9
+    log_sum = 0.0
+    total = 0.0
+    for k in range(1, FFT_LEN // 2):
+        re = sum(v * math.cos(2 * math.pi * k * i / FFT_LEN) for i, v in enumerate(x))
+        im = sum(v * math.sin(2 * math.pi * k * i / FFT_LEN) for i, v in enumerate(x))
+        p = re * re + im * im
+        log_sum += math.log(p + eps)
+        total += p
+    bins = FFT_LEN // 2 - 1
+    return math.exp(log_sum / bins) / (total / bins + eps)
+
+
+def features(raw):
+    n = len(raw)
+    s = sum(raw)
+    ss = sum(r * r for r in raw)
+    six = sum(i * r for i, r in enumerate(raw))
+    sum_i = n * (n - 1) // 2
+    sum_ii = (n - 1) * n * (2 * n - 1) // 6
+    var = (n * ss - s * s) / float(n * n)
+    slope = (n * six - sum_i * s) / float(n * sum_ii - sum_i * sum_i) * SAMPLE_HZ
+    clamp = sum(1 for r in raw if r >= CLAMP_HIGH) - sum(1 for r in raw if r <= CLAMP_LOW)
+    return [math.log10(var + 1.0), math.log10(abs(slope) + 1.0), flatness(raw), clamp / float(n)]
+
+
+def adc(v):
+    return max(0, min(4095, int(round(v))))
+
+
+def synth(label, rng):
+    t = [i / SAMPLE_HZ for i in range(WIN)]
+    if label == "ok":
+        # a moving level: ripple, and sensor noise up to about 0.6 mm
+        level = rng.uniform(200, 3800)
+        rate = rng.uniform(-15, 15)
+        amp = rng.choice([0.0, rng.uniform(0, 120)])
+        f = rng.uniform(0.3, 3.0)
+        sigma = rng.uniform(1.5, 60)
+        return [adc(min(3990, level + rate * x + amp * math.sin(2 * math.pi * f * x) + rng.gauss(0, sigma)))
+                for x in t]
+    if label == "still":
+        if rng.random() < 0.5:
+            # dry sensor: at or near zero, tiny noise
+            sigma = rng.uniform(0.0, 2.0)
+            return [adc(abs(rng.gauss(0, sigma))) for _ in t]
+        # steady level: constant, or dithering by a count
+        level = rng.uniform(20, 3950)
+        sigma = rng.choice([0.0, rng.uniform(0.0, 0.6)])
+        return [adc(level + rng.gauss(0, sigma)) for _ in t]
+    if label == "slosh":
+        # a few mm of one wave on a slow level, cut off by the rails
+        level = rng.uniform(0, 3800)
+        rate = rng.uniform(-3, 3)
+        amp = rng.uniform(100, 450)
+        f = rng.uniform(0.5, 2.5)
+        sigma = rng.uniform(1.5, 40)
+        return [adc(min(3990, level + rate * x + amp * math.sin(2 * math.pi * f * x) + rng.gauss(0, sigma)))
+                for x in t]
+    if label == "open":
+        # floating input: large, spectrally flat noise around a random mid-scale bias
+        bias = rng.uniform(300, 3000)
+        sigma = rng.uniform(150, 800)
+        return [adc(bias + rng.gauss(0, sigma)) for _ in t]
+    if label == "shorted":
+        return [adc(4095 - abs(rng.gauss(0, rng.uniform(0, 20)))) for _ in t]
+    raise ValueError(label)
+
+
+def fit(rows):
+    theta, sigma, priors = [], [], []
+    allvar = 0.0
+    for c in range(len(CLASSES)):
+        xs = [f for lbl, f in rows if lbl == c]
+        means = [sum(col) / len(xs) for col in zip(*xs)]
+        vars_ = [sum((v - m) ** 2 for v in col) / len(xs) for col, m in zip(zip(*xs), means)]
+        theta += means
+        sigma += vars_
+        priors.append(len(xs))
+        allvar = max(allvar, max(vars_))
+    total = float(sum(priors))
+    return theta, sigma, [p / total for p in priors], VAR_SMOOTHING * max(allvar, 1e-6)
+
+
+def predict(model, f):
+    theta, sigma, priors, eps = model
+    nf = len(f)
+    best, best_c = None, 0
+    for c in range(len(CLASSES)):
+        acc1 = acc2 = 0.0
+        for d in range(nf):
+            s = sigma[c * nf + d] + eps
+            acc1 += math.log(2 * math.pi * s)
+            acc2 += (f[d] - theta[c * nf + d]) ** 2 / s
+        score = -0.5 * acc1 - 0.5 * acc2 + math.log(priors[c])
+        if best is None or score > best:
+            best, best_c = score, c
+    return best_c
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--csv")
+    ap.add_argument("--synthetic", type=int, default=0)
+    ap.add_argument("--seed", type=int, default=1)
+    args = ap.parse_args()
+
+    rng = random.Random(args.seed)
+    rows = []
+    if args.csv:
+        for line in open(args.csv):
+            parts = line.strip().split(",")
+            if not parts or parts[0] not in CLASSES:
+                continue
+            raw = [int(v) for v in parts[1:]]
+            if len(raw) != WIN:
+                raise SystemExit("window of %d samples, expected %d" % (len(raw), WIN))
+            rows.append((CLASSES.index(parts[0]), features(raw)))
+    for c, label in enumerate(CLASSES):
+        for _ in range(args.synthetic):
+            rows.append((c, features(synth(label, rng))))
+    if not rows:
+        raise SystemExit("no training data")
+
+    rng.shuffle(rows)
+    split = len(rows) // 4
+    model = fit(rows[split:])
+    hits = sum(1 for lbl, f in rows[:split] if STATES[predict(model, f)] == STATES[lbl])
+    print("held-out accuracy: %d/%d (%.1f%%)" % (hits, split, 100.0 * hits / max(split, 1)),
+          file=sys.stderr)
+    for state in sorted(set(STATES), key=STATES.index):
+        held = [f for lbl, f in rows[:split] if STATES[lbl] == state]
+        wrong = sum(1 for f in held if STATES[predict(model, f)] != state)
+        print("  %-14s %d of %d misread" % (state, wrong, len(held)), file=sys.stderr)
+    model = fit(rows)
+
+    theta, sigma, priors, eps = model
+    src = "synthetic, %d windows/class, seed %d" % (args.synthetic, args.seed) \
+        if not args.csv else args.csv
+    print("/* Generated by Tools/train_fault_model.py (%s) -- do not edit. */" % src)
+    print('#include "sensor_fault.h"')
+    print()
+    print("// Per class (%s): mean of log10 var, log10 |slope|, flatness, clamp ratio"
+          % ", ".join(CLASSES))
+    for name, vals in (("sensor_fault_theta", theta), ("sensor_fault_sigma", sigma)):
+        print("const float %s[SENSOR_FAULT_NCLASS * SENSOR_FAULT_NFEAT] = {" % name)
+        for c in range(len(CLASSES)):
+            print("    " + ", ".join("%.8ef" % v for v in vals[c * 4:c * 4 + 4]) + ",")
+        print("};")
+        print()
+    print("const float sensor_fault_priors[SENSOR_FAULT_NCLASS] = {")
+    print("    " + ", ".join("%.8ef" % p for p in priors))
+    print("};")
+    print()
+    print("const float sensor_fault_epsilon = %.8ef;" % eps)
+    print()
+    print("const sensor_state_t sensor_fault_class_state[SENSOR_FAULT_NCLASS] = {")
+    print("    " + ", ".join(STATES))
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
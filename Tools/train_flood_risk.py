@@ -0,0 +1,295 @@
+#!/usr/bin/env python3
+"""Train the int8 flood-risk network and export it for Core/Src/nn_runtime.c.
+
+The network maps the last FLOOD_RISK_HIST level samples (1 Hz) plus two
+rate features to three classes -- safe, rising, flood within the horizon --
+and is run on target with CMSIS-NN (arm_fully_connected_s8, arm_softmax_s8):
+
+    python3 Tools/train_flood_risk.py > Core/Src/flood_risk_model.c
+    python3 Tools/train_flood_risk.py --csv levels.csv > Core/Src/flood_risk_model.c
+
+A CSV row is "label,mm0,...,mm7" (label 0/1/2, oldest sample first).
+Without --csv, histories are synthesised from random level/rate/acceleration
+scenarios.  Quantisation follows the TFLite int8 scheme that CMSIS-NN
+implements; the integer forward pass below reproduces arm_nn_requantize()
+bit for bit, and float vs int8 agreement is printed to stderr.
+"""
+
+import argparse
+import math
+import random
+import re
+import sys
+
+HIST = 8                # FLOOD_RISK_HIST
+SENSOR_MAX_MM = 40.0
+WARNING_RAIN_MM = 34.0
+NORMAL_RAIN_MM = 15.0
+HORIZON_S = 30.0        # label looks this far ahead
+RATE_FULL = 1.0         # mm/s mapped to feature value 1.0
+LAYERS = [HIST + 2, 12, 8, 3]
+CLASSES = ["safe", "rising", "flood"]
+
+
+def features(hist):
+    """hist: HIST level samples in mm, oldest first -> values in [-1, 1]"""
+    x = [min(max(v / SENSOR_MAX_MM, 0.0), 1.0) * 2.0 - 1.0 for v in hist]
+    short = (hist[-1] - hist[-3]) / 2.0
+    long_ = (hist[-1] - hist[0]) / (HIST - 1.0)
+    x.append(max(-1.0, min(1.0, short / RATE_FULL)))
+    x.append(max(-1.0, min(1.0, long_ / RATE_FULL)))
+    return x
+
+
+def synth(rng):
+    level = rng.uniform(0.0, 38.0)
+    rate = rng.choice([0.0, rng.uniform(-0.3, 0.3), rng.uniform(0.0, 1.0)])
+    accel = rng.uniform(-0.01, 0.02)
+    noise = rng.uniform(0.0, 0.4)
+    hist = []
+    for t in range(HIST):
+        dt = t - (HIST - 1)
+        hist.append(max(0.0, level + rate * dt + 0.5 * accel * dt * dt + rng.gauss(0, noise)))
+    future = level + rate * HORIZON_S + 0.5 * accel * HORIZON_S * HORIZON_S
+    future = max(future, level)
+    if future >= WARNING_RAIN_MM:
+        label = 2
+    elif future >= NORMAL_RAIN_MM:
+        label = 1
+    else:
+        label = 0
+    return label, hist
+
+
+# --- float training (plain SGD, softmax cross entropy) -------------------
+
+def init_net(rng):
+    net = []
+    for n_in, n_out in zip(LAYERS, LAYERS[1:]):
+        lim = math.sqrt(6.0 / (n_in + n_out))
+        w = [[rng.uniform(-lim, lim) for _ in range(n_in)] for _ in range(n_out)]
+        net.append((w, [0.0] * n_out))
+    return net
+
+
+def forward(net, x):
+    acts = [x]
+    for i, (w, b) in enumerate(net):
+        y = [sum(wi * xi for wi, xi in zip(row, acts[-1])) + bi for row, bi in zip(w, b)]
+        if i < len(net) - 1:
+            y = [max(0.0, v) for v in y]
+        acts.append(y)
+    return acts
+
+
+def softmax(z):
+    m = max(z)
+    e = [math.exp(v - m) for v in z]
+    s = sum(e)
+    return [v / s for v in e]
+
+
+def train(net, data, epochs, lr, rng):
+    for ep in range(epochs):
+        rng.shuffle(data)
+        for label, x in data:
+            acts = forward(net, x)
+            grad = softmax(acts[-1])
+            grad[label] -= 1.0
+            for i in range(len(net) - 1, -1, -1):
+                w, b = net[i]
+                a_in = acts[i]
+                g_in = [0.0] * len(a_in)
+                for o, g in enumerate(grad):
+                    if g == 0.0:
+                        continue
+                    row = w[o]
+                    for k in range(len(a_in)):
+                        g_in[k] += row[k] * g
+                        row[k] -= lr * g * a_in[k]
+                    b[o] -= lr * g
+                if i > 0:
+                    grad = [gi if ai > 0.0 else 0.0 for gi, ai in zip(g_in, a_in)]
+        lr *= 0.9
+
+
+# --- int8 quantisation (TFLite scheme) ------------------------------------
+
+def quantize_multiplier(real):
+    if real == 0.0:
+        return 0, 0
+    q, shift = math.frexp(real)
+    q_fixed = int(round(q * (1 << 31)))
+    if q_fixed == (1 << 31):
+        q_fixed //= 2
+        shift += 1
+    return q_fixed, shift
+
+
+def act_qparams(lo, hi):
+    lo, hi = min(lo, 0.0), max(hi, 0.0)
+    scale = (hi - lo) / 255.0 or 1.0
+    zp = int(round(-128 - lo / scale))
+    return scale, max(-128, min(127, zp))
+
+
+def requantize(val, mult, shift):
+    """arm_nn_requantize() without CMSIS_NN_USE_SINGLE_ROUNDING"""
+    left = shift if shift > 0 else 0
+    right = -shift if shift < 0 else 0
+    v = val * (1 << left)
+    v = ((v * mult + (1 << 30)) >> 31)
+    v = (v + (1 << 31)) % (1 << 32) - (1 << 31)     # int32 wrap
+    mask = (1 << right) - 1
+    rem = v & mask
+    res = v >> right
+    thr = (mask >> 1) + (1 if res < 0 else 0)
+    return res + 1 if rem > thr else res
+
+
+def quantize(net, calib):
+    in_scale, in_zp = 1.0 / 127.0, 0
+    ranges = [[0.0, 0.0] for _ in net]
+    for x in calib:
+        for i, a in enumerate(forward(net, x)[1:]):
+            ranges[i][0] = min(ranges[i][0], min(a))
+            ranges[i][1] = max(ranges[i][1], max(a))
+    layers = []
+    s_in, zp_in = in_scale, in_zp
+    for i, (w, b) in enumerate(net):
+        s_w = max(abs(v) for row in w for v in row) / 127.0
+        qw = [[int(round(v / s_w)) for v in row] for row in w]
+        qb = [int(round(v / (s_in * s_w))) for v in b]
+        s_out, zp_out = act_qparams(*ranges[i])
+        mult, shift = quantize_multiplier(s_in * s_w / s_out)
+        relu = i < len(net) - 1
+        layers.append(dict(w=qw, b=qb, in_off=-zp_in, out_off=zp_out, mult=mult, shift=shift,
+                           act_min=zp_out if relu else -128, act_max=127, s_out=s_out))
+        s_in, zp_in = s_out, zp_out
+    # softmax: beta = 1, 5 integer bits for the scaled difference (TFLite)
+    real = min(s_in * (1 << (31 - 5)), (1 << 31) - 1.0)
+    sm_mult, sm_shift = quantize_multiplier(real)
+    radius = ((1 << 5) - 1) * (1 << (31 - 5)) / (1 << sm_shift)
+    return layers, (sm_mult, sm_shift, -int(math.floor(radius)))
+
+
+def quantize_input(v):
+    """scale 1/127, zero point 0, rounding half away from zero like lroundf()"""
+    q = int(math.floor(abs(v) * 127.0 + 0.5))
+    return max(-128, min(127, q if v >= 0 else -q))
+
+
+def run_int8(layers, x):
+    return run_int8_q(layers, [quantize_input(v) for v in x])
+
+
+def run_int8_q(layers, a):
+    """Logits for an already quantised input"""
+    for L in layers:
+        out = []
+        for row, bias in zip(L["w"], L["b"]):
+            acc = bias + sum(wi * (ai + L["in_off"]) for wi, ai in zip(row, a))
+            v = requantize(acc, L["mult"], L["shift"]) + L["out_off"]
+            out.append(max(L["act_min"], min(L["act_max"], v)))
+        a = out
+    return a    # logits; softmax preserves the argmax
+
+
+def load_model(path):
+    """Layers (as quantize() returns them) read back from a model file this script wrote"""
+    text = open(path).read()
+    arrays = {m.group(1): [int(v) for v in m.group(2).replace(",", " ").split()]
+              for m in re.finditer(r"static const int(?:8|32)_t (\w+)\[\d+\] = \{(.*?)\};", text, re.S)}
+    row = r"\{ NN_OP_FULLY_CONNECTED, (\d+), \d+, \w+, \w+, " + ", ".join([r"(-?\d+)"] * 6) + ", 0 \}"
+    layers = []
+    for m in re.finditer(row, text):
+        i, in_off, out_off, mult, shift, act_min, act_max = (int(v) for v in m.groups())
+        w, n_in = arrays["fc%d_weights" % i], LAYERS[i]
+        layers.append(dict(w=[w[k:k + n_in] for k in range(0, len(w), n_in)], b=arrays["fc%d_bias" % i],
+                           in_off=in_off, out_off=out_off, mult=mult, shift=shift, act_min=act_min, act_max=act_max))
+    return layers
+
+
+def argmax(v):
+    return max(range(len(v)), key=lambda i: v[i])
+
+
+def c_array(ctype, name, vals, per_line=12):
+    out = ["static const %s %s[%d] = {" % (ctype, name, len(vals))]
+    for i in range(0, len(vals), per_line):
+        out.append("    " + ", ".join(str(v) for v in vals[i:i + per_line]) + ",")
+    out.append("};")
+    return "\n".join(out)
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--csv")
+    ap.add_argument("--samples", type=int, default=6000)
+    ap.add_argument("--epochs", type=int, default=40)
+    ap.add_argument("--seed", type=int, default=7)
+    args = ap.parse_args()
+    rng = random.Random(args.seed)
+
+    data = []
+    if args.csv:
+        for line in open(args.csv):
+            parts = line.strip().split(",")
+            if len(parts) != HIST + 1 or not parts[0].isdigit():
+                continue
+            data.append((int(parts[0]), features([float(v) for v in parts[1:]])))
+    else:
+        for _ in range(args.samples):
+            label, hist = synth(rng)
+            data.append((label, features(hist)))
+    split = len(data) // 5
+    test, trainset = data[:split], data[split:]
+
+    net = init_net(rng)
+    train(net, trainset, args.epochs, 0.02, rng)
+    layers, softmax_q = quantize(net, [x for _, x in trainset])
+
+    f_hits = q_hits = agree = 0
+    for label, x in test:
+        f = argmax(forward(net, x)[-1])
+        q = argmax(run_int8(layers, x))
+        f_hits += f == label
+        q_hits += q == label
+        agree += f == q
+    n = max(len(test), 1)
+    print("held-out accuracy: float %.1f%%, int8 %.1f%%, float/int8 agreement %.1f%% (%d windows)"
+          % (100.0 * f_hits / n, 100.0 * q_hits / n, 100.0 * agree / n, len(test)), file=sys.stderr)
+
+    print("/* Generated by Tools/train_flood_risk.py (%s) -- do not edit. */"
+          % (args.csv or "synthetic, %d samples, seed %d" % (args.samples, args.seed)))
+    print('#include "flood_risk.h"')
+    print()
+    for i, L in enumerate(layers):
+        print(c_array("int8_t", "fc%d_weights" % i, [v for row in L["w"] for v in row]))
+        print(c_array("int32_t", "fc%d_bias" % i, L["b"], 8))
+        print()
+    # tensor 0 = input, 1..n = layer outputs, n+1 = softmax output
+    sizes = LAYERS + [LAYERS[-1]]
+    print("static const nn_tensor_t tensors[] = {")
+    print("    " + ", ".join("{ %d }" % s for s in sizes) + ",")
+    print("};")
+    print()
+    print("static const nn_layer_t layers[] = {")
+    for i, L in enumerate(layers):
+        print("    { NN_OP_FULLY_CONNECTED, %d, %d, fc%d_weights, fc%d_bias, %d, %d, %d, %d, %d, %d, 0 },"
+              % (i, i + 1, i, i, L["in_off"], L["out_off"], L["mult"], L["shift"],
+                 L["act_min"], L["act_max"]))
+    sm_mult, sm_shift, diff_min = softmax_q
+    print("    { NN_OP_SOFTMAX, %d, %d, NULL, NULL, 0, 0, %d, %d, 0, 0, %d },"
+          % (len(layers), len(layers) + 1, sm_mult, sm_shift, diff_min))
+    print("};")
+    print()
+    print("const nn_model_t flood_risk_model = {")
+    print("    tensors, sizeof(tensors) / sizeof(tensors[0]),")
+    print("    layers, sizeof(layers) / sizeof(layers[0]),")
+    print("    0, %d," % (len(sizes) - 1))
+    print("};")
+
+
+if __name__ == "__main__":
+    main()